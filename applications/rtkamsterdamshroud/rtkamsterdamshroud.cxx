@@ -17,7 +17,7 @@
  *=========================================================================*/
 
 #include "rtkamsterdamshroud_ggo.h"
-#include "rtkMacro.h"
+#include "rtkGgoFunctions.h"
 
 #include "rtkProjectionsReader.h"
 #include "rtkAmsterdamShroudImageFilter.h"
@@ -29,6 +29,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkamsterdamshroud, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef double OutputPixelType;
   const unsigned int Dimension = 3;
@@ -46,12 +47,14 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
 
   // Amsterdam shroud
   typedef rtk::AmsterdamShroudImageFilter<OutputImageType> shroudFilterType;
   shroudFilterType::Pointer shroudFilter = shroudFilterType::New();
   shroudFilter->SetInput( reader->GetOutput() );
   shroudFilter->SetUnsharpMaskSize(args_info.unsharp_arg);
+  telemetry->Watch(shroudFilter.GetPointer(), "amsterdam shroud");
 
   // Write
   typedef itk::ImageFileWriter< shroudFilterType::OutputImageType > WriterType;
@@ -60,7 +63,11 @@ int main(int argc, char * argv[])
   writer->SetInput( shroudFilter->GetOutput() );
   writer->SetNumberOfStreamDivisions(names->GetFileNames().size());
 
+  telemetry->Watch(writer.GetPointer(), "writer");
+
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -38,6 +38,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkbackprojections, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -55,7 +56,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
   if(args_info.verbose_flag)
     std::cout << " done." << std::endl;
 
@@ -83,6 +86,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() );
   readerProbe.Stop();
   if(args_info.verbose_flag)
@@ -154,6 +158,7 @@ int main(int argc, char * argv[])
   bp->SetInput( constantImageSource->GetOutput() );
   bp->SetInput( 1, reader->GetOutput() );
   bp->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(bp.GetPointer(), "backprojection", rtk::Telemetry::VOXEL_UPDATES);
   bpProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( bp->Update() )
   bpProbe.Stop();
@@ -170,6 +175,7 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( bp->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   writeProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
   writeProbe.Stop();
@@ -178,5 +184,7 @@ int main(int argc, char * argv[])
               << writeProbe.GetMean() << ' ' << writeProbe.GetUnit()
               << '.' << std::endl;
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,677 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkbenchmarks_ggo.h"
+#include "rtkGgoFunctions.h"
+
+#include "rtkConstantImageSource.h"
+#include "rtkSheppLoganPhantomFilter.h"
+#include "rtkDrawSheppLoganFilter.h"
+#include "rtkFDKWeightProjectionFilter.h"
+#include "rtkFFTRampImageFilter.h"
+#include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkFieldOfViewImageFilter.h"
+#include "rtkJosephBackProjectionImageFilter.h"
+#include "rtkJosephForwardProjectionImageFilter.h"
+#include "rtkSiddonForwardProjectionImageFilter.h"
+#include "rtkRayCastInterpolatorForwardProjectionImageFilter.h"
+#include "rtkMedianImageFilter.h"
+#include "rtkBinningImageFilter.h"
+#include "rtkHndImageIO.h"
+#include "rtkHisImageIO.h"
+#include "rtkMemoryMappedProjectionsReader.h"
+
+#include <itkTimeProbe.h>
+#include <itkMultiThreader.h>
+#include <itkVersion.h>
+#include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIterator.h>
+#include <itksys/SystemTools.hxx>
+#include <vnl/vnl_math.h>
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+typedef float                                    PixelType;
+typedef itk::Image< PixelType, 3 >               ImageType;
+typedef itk::Image< unsigned short, 2 >          RawImageType;
+typedef rtk::ThreeDCircularProjectionGeometry    GeometryType;
+typedef rtk::ConstantImageSource< ImageType >    ConstantImageSourceType;
+
+/** Timings of one kernel for one size and one number of threads */
+struct BenchmarkResult
+{
+  std::string         kernel;
+  unsigned int        size;
+  unsigned int        threads;
+  unsigned int        tiles; // Tiles per thread, 0 for the static split
+  double              work;  // Number of elementary operations, e.g. voxel updates
+  std::vector<double> times; // In seconds
+};
+
+/** Common settings and results of all benchmarks */
+struct Benchmark
+{
+  std::vector<std::string>     kernels;
+  unsigned int                 repeat;
+  bool                         verbose;
+  std::vector<BenchmarkResult> results;
+
+  bool IsSelected(const std::string &kernel) const
+    {
+    return kernels.empty() || std::find(kernels.begin(), kernels.end(), kernel) != kernels.end();
+    }
+
+  /** Time repeat executions of filter, the pipeline being forced to execute
+   * each time. The inputs of filter must not have a source so that only the
+   * filter is timed. */
+  void Time(itk::ProcessObject *filter, const std::string &kernel,
+            const unsigned int size, const unsigned int threads, const double work,
+            const unsigned int tiles=0)
+    {
+    BenchmarkResult r;
+    r.kernel = kernel;
+    r.size = size;
+    r.threads = threads;
+    r.tiles = tiles;
+    r.work = work;
+    filter->SetNumberOfThreads(threads);
+    for(unsigned int i=0; i<repeat; i++)
+      {
+      filter->Modified();
+      itk::TimeProbe probe;
+      probe.Start();
+      filter->Update();
+      probe.Stop();
+      r.times.push_back(probe.GetTotal());
+      }
+    Report(r);
+    }
+
+  void Report(const BenchmarkResult &r)
+    {
+    if(verbose)
+      std::cerr << r.kernel << " size=" << r.size << " threads=" << r.threads << " tiles=" << r.tiles
+                << " min=" << *std::min_element(r.times.begin(), r.times.end())
+                << " s" << std::endl;
+    results.push_back(r);
+    }
+};
+
+/** Circular geometry of nProj projections regularly spaced on arc degrees
+ * from firstAngle. */
+GeometryType::Pointer MakeGeometry(const unsigned int nProj, const double firstAngle, const double arc)
+{
+  std::vector<double> angles(nProj);
+  for(unsigned int i=0; i<nProj; i++)
+    angles[i] = firstAngle + i * arc / nProj;
+  const std::vector<double> zeros(nProj, 0.);
+  GeometryType::Pointer geometry = GeometryType::New();
+  geometry->AddProjections(std::vector<double>(nProj, 1000.),
+                           std::vector<double>(nProj, 1500.),
+                           angles, zeros, zeros, zeros, zeros, zeros, zeros);
+  return geometry;
+}
+
+/** Constant image of size[0]*size[1]*size[2] voxels centered on the origin */
+ImageType::Pointer MakeConstantImage(const unsigned int size0, const unsigned int size1, const unsigned int size2,
+                                     const double spacing,
+                                     const ImageType::DirectionType &direction)
+{
+  ConstantImageSourceType::PointType   origin;
+  ConstantImageSourceType::SpacingType spacings;
+  ConstantImageSourceType::SizeType    size;
+  size[0] = size0;
+  size[1] = size1;
+  size[2] = size2;
+  for(unsigned int i=0; i<3; i++)
+    {
+    spacings[i] = spacing;
+    origin[i] = -0.5 * (size[i]-1) * spacing;
+    }
+  ConstantImageSourceType::Pointer source = ConstantImageSourceType::New();
+  source->SetOrigin( origin );
+  source->SetSpacing( spacings );
+  source->SetSize( size );
+  source->SetDirection( direction );
+  source->SetConstant( 0. );
+  source->Update();
+  ImageType::Pointer image = source->GetOutput();
+  image->DisconnectPipeline();
+  return image;
+}
+
+/** Scale the values of a projection to 12 bits unsigned integers */
+std::vector<unsigned int> ToTwelveBits(ImageType *projections, const unsigned int noProj)
+{
+  ImageType::RegionType region = projections->GetLargestPossibleRegion();
+  region.SetIndex(2, region.GetIndex(2) + noProj);
+  region.SetSize(2, 1);
+  const PixelType maxValue = *std::max_element(projections->GetBufferPointer(),
+                                               projections->GetBufferPointer()+projections->GetPixelContainer()->Size() );
+  std::vector<unsigned int> result;
+  result.reserve(region.GetNumberOfPixels());
+  itk::ImageRegionConstIterator<ImageType> it(projections, region);
+  for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+    result.push_back( (maxValue>0.)?(unsigned int)(4095. * it.Get() / maxValue):0 );
+  return result;
+}
+
+/** Write an hnd file, the compressed format of Varian OBI projections, with
+ * differences coded on one or two bytes. */
+void WriteHnd(const std::string &fileName, const std::vector<unsigned int> &img,
+              const unsigned int w, const unsigned int h)
+{
+  std::vector<char> header(1024, 0);
+  const double resolution = 0.388;
+  memcpy(&header[120], &w, 4);           // SizeX
+  memcpy(&header[124], &h, 4);           // SizeY
+  memcpy(&header[352], &resolution, 8);  // dIDUResolutionX
+  memcpy(&header[360], &resolution, 8);  // dIDUResolutionY
+
+  std::vector<unsigned char> lut((h-1)*w/4, 0);
+  std::vector<char> diffs;
+  for(unsigned int i=w+1; i<w*h; i++)
+    {
+    const unsigned int k = i-w-1;
+    const int diff = int(img[i]) - int(img[i-1] + img[i-w] - img[i-w-1]);
+    unsigned char code = 0;
+    if(diff>=-128 && diff<128)
+      {
+      const char dc = diff;
+      diffs.push_back(dc);
+      }
+    else
+      {
+      const short ds = diff;
+      diffs.insert(diffs.end(), (const char *)&ds, (const char *)&ds+2);
+      code = 1;
+      }
+    if(k/4<lut.size())
+      lut[k/4] |= code << (2*(k%4));
+    }
+
+  std::ofstream output(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+  output.write(&header[0], header.size());
+  output.write((const char *)&lut[0], lut.size());
+  output.write((const char *)&img[0], (w+1)*4);
+  output.write(&diffs[0], diffs.size());
+}
+
+/** Write an uncompressed his file, the format of Elekta Synergy projections */
+void WriteHis(const std::string &fileName, const std::vector<unsigned int> &img,
+              const unsigned int w, const unsigned int h)
+{
+  // HisImageIO adds signed bytes so the corners are chosen with low bytes
+  // lower than 128
+  unsigned int ulx = 0, uly = 0;
+  while( (ulx&0x80) || ((ulx+h-1)&0x80) )
+    ulx++;
+  while( (uly&0x80) || ((uly+w-1)&0x80) )
+    uly++;
+  const unsigned int brx = ulx+h-1, bry = uly+w-1;
+
+  std::vector<char> header(100, 0);
+  header[1] = 112;
+  header[2] = 68;
+  header[10] = 32; // Size of the header after the 68 first bytes
+  header[12] = ulx & 0xFF;
+  header[13] = ulx >> 8;
+  header[14] = uly & 0xFF;
+  header[15] = uly >> 8;
+  header[16] = brx & 0xFF;
+  header[17] = brx >> 8;
+  header[18] = bry & 0xFF;
+  header[19] = bry >> 8;
+  header[20] = 1;  // Number of frames
+  header[32] = 4;  // Unsigned short
+
+  std::vector<unsigned short> data(img.begin(), img.end());
+  std::ofstream output(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+  output.write(&header[0], header.size());
+  output.write((const char *)&data[0], data.size()*2);
+}
+
+/** Remove a file from the page cache so that the next read is from disk.
+ * Return false if this is not supported. */
+bool DropFromPageCache(const std::string &fileName)
+{
+#if defined(POSIX_FADV_DONTNEED)
+  const int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd<0)
+    return false;
+  fsync(fd);
+  const bool ok = (posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0);
+  close(fd);
+  return ok;
+#else
+  (void)fileName;
+  return false;
+#endif
+}
+
+/** Minimum time of the run of kernel with size, threads and tiles, 0 if it
+ * has not been run */
+double GetMinimumTime(const Benchmark &benchmark, const std::string &kernel,
+                      const unsigned int size, const unsigned int threads, const unsigned int tiles)
+{
+  for(unsigned int i=0; i<benchmark.results.size(); i++)
+    {
+    const BenchmarkResult &r = benchmark.results[i];
+    if(r.kernel == kernel && r.size == size && r.threads == threads && r.tiles == tiles)
+      return *std::min_element(r.times.begin(), r.times.end());
+    }
+  return 0.;
+}
+
+/** Ratio of two times in JSON, null if one of them is missing */
+std::string GetSpeedup(const double reference, const double time)
+{
+  if(reference<=0. || time<=0.)
+    return "null";
+  std::ostringstream oss;
+  oss.precision(9);
+  oss << reference / time;
+  return oss.str();
+}
+
+void WriteJSON(std::ostream &os, const Benchmark &benchmark, const unsigned int nProjArg, const char *pin)
+{
+  os.precision(9);
+  os << "{\n"
+     << "  \"benchmark\": \"rtkbenchmarks\",\n"
+     << "  \"itk_version\": \"" << itk::Version::GetITKVersion() << "\",\n"
+     << "  \"default_threads\": " << itk::MultiThreader::GetGlobalDefaultNumberOfThreads() << ",\n"
+     << "  \"max_threads\": " << itk::MultiThreader::GetGlobalMaximumNumberOfThreads() << ",\n"
+     << "  \"numa_nodes\": " << rtk::ThreadAffinity::GetNumberOfNodes() << ",\n"
+     << "  \"pin\": \"" << pin << "\",\n"
+     << "  \"replicate\": " << (rtk::ThreadAffinity::GetReplicateReadOnlyData()?"true":"false") << ",\n"
+     << "  \"nproj\": " << nProjArg << ",\n"
+     << "  \"repeat\": " << benchmark.repeat << ",\n"
+     << "  \"results\": [";
+  for(unsigned int i=0; i<benchmark.results.size(); i++)
+    {
+    const BenchmarkResult &r = benchmark.results[i];
+    std::vector<double> sorted = r.times;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0.;
+    for(unsigned int j=0; j<sorted.size(); j++)
+      mean += sorted[j] / sorted.size();
+
+    os << ((i)?",":"") << "\n    {\n"
+       << "      \"kernel\": \"" << r.kernel << "\",\n"
+       << "      \"size\": " << r.size << ",\n"
+       << "      \"threads\": " << r.threads << ",\n"
+       << "      \"tiles_per_thread\": " << r.tiles << ",\n"
+       << "      \"work\": " << r.work << ",\n"
+       << "      \"times\": [";
+    for(unsigned int j=0; j<r.times.size(); j++)
+      os << ((j)?", ":"") << r.times[j];
+    os << "],\n"
+       << "      \"min\": " << sorted.front() << ",\n"
+       << "      \"median\": " << sorted[sorted.size()/2] << ",\n"
+       << "      \"mean\": " << mean << ",\n"
+       << "      \"throughput\": " << ((sorted.front()>0.)?r.work/sorted.front():0.) << ",\n"
+       << "      \"speedup_vs_static_split\": "
+       << GetSpeedup(GetMinimumTime(benchmark, r.kernel, r.size, r.threads, 0), sorted.front()) << ",\n"
+       << "      \"speedup_vs_one_thread\": "
+       << GetSpeedup(GetMinimumTime(benchmark, r.kernel, r.size, 1, r.tiles), sorted.front()) << "\n"
+       << "    }";
+    }
+  os << "\n  ]\n}\n";
+}
+
+int main(int argc, char * argv[])
+{
+  GGO(rtkbenchmarks, args_info);
+  rtk::SetThreadAffinityFromGgo(args_info);
+
+  Benchmark benchmark;
+  benchmark.repeat = vnl_math_max(args_info.repeat_arg, 1);
+  benchmark.verbose = args_info.verbose_flag;
+  for(unsigned int i=0; i<args_info.kernel_given; i++)
+    benchmark.kernels.push_back(args_info.kernel_arg[i]);
+
+  std::vector<unsigned int> threads;
+  for(unsigned int i=0; i<args_info.threads_given || i<1; i++)
+    {
+    const int t = (args_info.threads_given)?args_info.threads_arg[i]:0;
+    threads.push_back( (t>0)?t:itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
+    }
+
+  std::vector<unsigned int> tiles;
+  for(unsigned int i=0; i<args_info.tiles_given || i<1; i++)
+    tiles.push_back( vnl_math_max( (args_info.tiles_given)?args_info.tiles_arg[i]:8, 0 ) );
+
+  ImageType::DirectionType identity;
+  identity.SetIdentity();
+
+  // Direction of the volume for the Y path of the FDK backprojection: the
+  // second index axis is along z and the third along the rotation axis y.
+  ImageType::DirectionType permutation;
+  permutation.Fill(0.);
+  permutation[0][0] = 1.;
+  permutation[2][1] = 1.;
+  permutation[1][2] = 1.;
+
+  for(unsigned int s=0; s<args_info.size_given || s<1; s++)
+    {
+    const unsigned int size = (args_info.size_given)?args_info.size_arg[s]:64;
+    const unsigned int nProj = (args_info.nproj_arg>0)?args_info.nproj_arg:size;
+    const double volumeSpacing = 256. / size;
+    const double projectionSpacing = 1.65 * 256. / size;
+    const double voxels = double(size) * size * size;
+    const double pixels = double(size) * size * nProj;
+
+    // Synthetic data: geometries avoiding the optimized backprojection
+    // paths, or using the X or the Y path, Shepp-Logan volume and projections
+    GeometryType::Pointer geometry = MakeGeometry(nProj, 0.123, 360.);
+    GeometryType::Pointer geometryX = MakeGeometry(nProj, 0., 180.*nProj);
+    GeometryType::Pointer geometryY = MakeGeometry(nProj, 90., 180.*nProj);
+
+    ImageType::Pointer zeroVolume = MakeConstantImage(size, size, size, volumeSpacing, identity);
+    ImageType::Pointer zeroVolumeY = MakeConstantImage(size, size, size, volumeSpacing, permutation);
+    ImageType::Pointer zeroProjections = MakeConstantImage(size, size, nProj, projectionSpacing, identity);
+
+    typedef rtk::DrawSheppLoganFilter<ImageType, ImageType> DSLType;
+    DSLType::Pointer dsl = DSLType::New();
+    dsl->SetInput( MakeConstantImage(size, size, size, volumeSpacing, identity) );
+    dsl->SetPhantomScale( 128. );
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( dsl->Update() )
+    ImageType::Pointer volume = dsl->GetOutput();
+    volume->DisconnectPipeline();
+
+    typedef rtk::SheppLoganPhantomFilter<ImageType, ImageType> SLPType;
+    SLPType::Pointer slp = SLPType::New();
+    slp->SetInput( MakeConstantImage(size, size, nProj, projectionSpacing, identity) );
+    slp->SetGeometry( geometry );
+    slp->SetPhantomScale( 128. );
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( slp->Update() )
+    ImageType::Pointer projections = slp->GetOutput();
+    projections->DisconnectPipeline();
+
+    // Raw projection for the 2D filters
+    const std::vector<unsigned int> raw = ToTwelveBits(projections, 0);
+    RawImageType::Pointer rawImage = RawImageType::New();
+    RawImageType::RegionType rawRegion;
+    rawRegion.SetSize(0, size);
+    rawRegion.SetSize(1, size);
+    rawImage->SetRegions(rawRegion);
+    rawImage->Allocate();
+    std::copy(raw.begin(), raw.end(), rawImage->GetBufferPointer());
+
+    for(unsigned int t=0; t<threads.size(); t++)
+      {
+      const unsigned int nThreads = threads[t];
+
+      if(benchmark.IsSelected("fdk_weighting"))
+        {
+        typedef rtk::FDKWeightProjectionFilter<ImageType, ImageType> FilterType;
+        FilterType::Pointer f = FilterType::New();
+        f->SetInput( projections );
+        f->SetGeometry( geometry );
+        f->InPlaceOff();
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, "fdk_weighting", size, nThreads, pixels) )
+        }
+
+      for(unsigned int ti=0; ti<tiles.size(); ti++)
+        {
+        const unsigned int nTiles = tiles[ti];
+
+        if(benchmark.IsSelected("ramp"))
+          {
+          typedef rtk::FFTRampImageFilter<ImageType, ImageType, double> FilterType;
+          FilterType::Pointer f = FilterType::New();
+          f->SetInput( projections );
+          f->SetTilesPerThread( nTiles );
+          TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, "ramp", size, nThreads, pixels, nTiles) )
+          }
+
+        // The last FDK kernel only backprojects the voxels in the field of
+        // view, which makes the slabs at the edge of the volume cheaper
+        typedef rtk::FDKBackProjectionImageFilter<ImageType, ImageType> FDKBPType;
+        const char *fdkKernels[4] = {"fdk_bp_x", "fdk_bp_y", "fdk_bp_general", "fdk_bp_fov"};
+        GeometryType::Pointer fdkGeometries[4] = {geometryX, geometryY, geometry, geometry};
+        ImageType::Pointer fdkVolumes[4] = {zeroVolume, zeroVolumeY, zeroVolume, zeroVolume};
+        for(unsigned int k=0; k<4; k++)
+          {
+          if(!benchmark.IsSelected(fdkKernels[k]))
+            continue;
+          FDKBPType::Pointer f = FDKBPType::New();
+          f->SetInput( fdkVolumes[k] );
+          f->SetInput( 1, projections );
+          f->SetGeometry( fdkGeometries[k] );
+          f->SetTilesPerThread( nTiles );
+          f->InPlaceOff();
+          if(k==3)
+            {
+            typedef rtk::FieldOfViewImageFilter<ImageType, ImageType> FOVType;
+            FOVType::Pointer fov = FOVType::New();
+            fov->SetGeometry( fdkGeometries[k] );
+            fov->SetProjectionsStack( projections.GetPointer() );
+            TRY_AND_EXIT_ON_ITK_EXCEPTION( f->SetFieldOfViewSpanTable( fov->ComputeSpanTable(fdkVolumes[k]) ) )
+            }
+          TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, fdkKernels[k], size, nThreads, voxels*nProj, nTiles) )
+          }
+
+        // In place backprojection in a volume allocated and first touched
+        // by the source at each repetition, with the same tiles and threads,
+        // as in rtkfdk. With pinned threads, each tile is in the memory of
+        // the node of the thread which backprojects it.
+        if(benchmark.IsSelected("fdk_bp_numa"))
+          {
+          ConstantImageSourceType::Pointer source = ConstantImageSourceType::New();
+          source->SetOrigin( zeroVolume->GetOrigin() );
+          source->SetSpacing( zeroVolume->GetSpacing() );
+          source->SetSize( zeroVolume->GetLargestPossibleRegion().GetSize() );
+          source->SetConstant( 0. );
+          source->SetNumberOfThreads( nThreads );
+          source->SetTilesPerThread( nTiles );
+          FDKBPType::Pointer f = FDKBPType::New();
+          f->SetInput( source->GetOutput() );
+          f->SetInput( 1, projections );
+          f->SetGeometry( geometry );
+          f->SetTilesPerThread( nTiles );
+          f->SetNumberOfThreads( nThreads );
+          BenchmarkResult r;
+          r.kernel = "fdk_bp_numa";
+          r.size = size;
+          r.threads = nThreads;
+          r.tiles = nTiles;
+          r.work = voxels*nProj;
+          for(unsigned int i=0; i<benchmark.repeat; i++)
+            {
+            source->Modified();
+            f->Modified();
+            itk::TimeProbe probe;
+            probe.Start();
+            TRY_AND_EXIT_ON_ITK_EXCEPTION( f->Update() )
+            probe.Stop();
+            r.times.push_back(probe.GetTotal());
+            }
+          benchmark.Report(r);
+          }
+
+        typedef rtk::ForwardProjectionImageFilter<ImageType, ImageType> FPType;
+        const char *fpKernels[3] = {"joseph_fp", "siddon_fp", "raycast_fp"};
+        for(unsigned int k=0; k<3; k++)
+          {
+          if(!benchmark.IsSelected(fpKernels[k]))
+            continue;
+          FPType::Pointer f;
+          if(k==0)
+            f = rtk::JosephForwardProjectionImageFilter<ImageType, ImageType>::New();
+          else if(k==1)
+            f = rtk::SiddonForwardProjectionImageFilter<ImageType, ImageType>::New();
+          else
+            f = rtk::RayCastInterpolatorForwardProjectionImageFilter<ImageType, ImageType>::New();
+          f->SetInput( zeroProjections );
+          f->SetInput( 1, volume );
+          f->SetGeometry( geometry );
+          f->SetTilesPerThread( nTiles );
+          f->InPlaceOff();
+          TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, fpKernels[k], size, nThreads, pixels*size, nTiles) )
+          }
+        }
+
+      if(benchmark.IsSelected("joseph_bp"))
+        {
+        typedef rtk::JosephBackProjectionImageFilter<ImageType, ImageType> FilterType;
+        FilterType::Pointer f = FilterType::New();
+        f->SetInput( zeroVolume );
+        f->SetInput( 1, projections );
+        f->SetGeometry( geometry );
+        f->InPlaceOff();
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, "joseph_bp", size, nThreads, pixels*size) )
+        }
+
+      if(benchmark.IsSelected("median"))
+        {
+        rtk::MedianImageFilter::Pointer f = rtk::MedianImageFilter::New();
+        rtk::MedianImageFilter::VectorType window;
+        window.Fill(3);
+        f->SetInput( rawImage );
+        f->SetMedianWindow( window );
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, "median", size, nThreads, double(size)*size) )
+        }
+
+      if(benchmark.IsSelected("binning"))
+        {
+        rtk::BinningImageFilter::Pointer f = rtk::BinningImageFilter::New();
+        rtk::BinningImageFilter::VectorType factors;
+        factors.Fill(2);
+        f->SetInput( rawImage );
+        f->SetBinningFactors( factors );
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(f, "binning", size, nThreads, double(size)*size) )
+        }
+      }
+
+    // Decoding of one hnd file, single threaded
+    if(benchmark.IsSelected("hnd_decode"))
+      {
+      const std::string fileName = std::string(args_info.tmpdir_arg) + "/rtkbenchmarks.hnd";
+      WriteHnd(fileName, raw, size, size);
+      rtk::HndImageIO::Pointer io = rtk::HndImageIO::New();
+      io->SetFileName(fileName);
+      std::vector<unsigned int> buffer(size*size);
+      BenchmarkResult r;
+      r.kernel = "hnd_decode";
+      r.size = size;
+      r.threads = 1;
+      r.tiles = 0;
+      r.work = double(size)*size;
+      for(unsigned int i=0; i<benchmark.repeat; i++)
+        {
+        itk::TimeProbe probe;
+        probe.Start();
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( io->ReadImageInformation() )
+        TRY_AND_EXIT_ON_ITK_EXCEPTION( io->Read(&buffer[0]) )
+        probe.Stop();
+        r.times.push_back(probe.GetTotal());
+        }
+      itksys::SystemTools::RemoveFile(fileName.c_str());
+      if(buffer != raw)
+        {
+        std::cerr << "Error while decoding the hnd file." << std::endl;
+        return EXIT_FAILURE;
+        }
+      benchmark.Report(r);
+      }
+
+    // Memory mapped ingestion of his files from the disk (cold) and from the
+    // page cache (warm)
+    const bool cold = benchmark.IsSelected("his_ingestion_cold");
+    const bool warm = benchmark.IsSelected("his_ingestion_warm");
+    if(cold || warm)
+      {
+      std::vector<std::string> fileNames;
+      for(unsigned int i=0; i<nProj; i++)
+        {
+        std::ostringstream fileName;
+        fileName << args_info.tmpdir_arg << "/rtkbenchmarks" << i << ".his";
+        fileNames.push_back(fileName.str());
+        WriteHis(fileNames.back(), ToTwelveBits(projections, i), size, size);
+        }
+
+      typedef itk::Image<unsigned short, 3> RawStackType;
+      typedef rtk::MemoryMappedProjectionsReader<RawStackType, rtk::HisImageIO> ReaderType;
+      for(unsigned int t=0; t<threads.size(); t++)
+        {
+        ReaderType::Pointer reader = ReaderType::New();
+        reader->SetImageIO( rtk::HisImageIO::New() );
+        reader->SetFileNames( fileNames );
+        reader->SetNumberOfThreads( threads[t] );
+        if(cold)
+          {
+          BenchmarkResult r;
+          r.kernel = "his_ingestion_cold";
+          r.size = size;
+          r.threads = threads[t];
+          r.tiles = 0;
+          r.work = pixels;
+          bool supported = true;
+          for(unsigned int i=0; i<benchmark.repeat && supported; i++)
+            {
+            for(unsigned int j=0; j<fileNames.size(); j++)
+              supported &= DropFromPageCache(fileNames[j]);
+            reader->Modified();
+            itk::TimeProbe probe;
+            probe.Start();
+            TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
+            probe.Stop();
+            r.times.push_back(probe.GetTotal());
+            }
+          if(supported)
+            benchmark.Report(r);
+          else if(benchmark.verbose)
+            std::cerr << "his_ingestion_cold skipped, the page cache can not be dropped." << std::endl;
+          }
+        if(warm)
+          {
+          TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
+          TRY_AND_EXIT_ON_ITK_EXCEPTION( benchmark.Time(reader, "his_ingestion_warm", size, threads[t], pixels) )
+          }
+        }
+      for(unsigned int i=0; i<fileNames.size(); i++)
+        itksys::SystemTools::RemoveFile(fileNames[i].c_str());
+      }
+    }
+
+  // Write
+  if(args_info.output_given)
+    {
+    std::ofstream output(args_info.output_arg);
+    if(!output.is_open())
+      {
+      std::cerr << "Could not open " << args_info.output_arg << std::endl;
+      return EXIT_FAILURE;
+      }
+    WriteJSON(output, benchmark, args_info.nproj_arg, args_info.pin_arg);
+    }
+  else
+    WriteJSON(std::cout, benchmark, args_info.nproj_arg, args_info.pin_arg);
+
+  return EXIT_SUCCESS;
+}
@@ -33,6 +33,7 @@ int main(int argc, char * argv[])
 {
   GGO(rtkbinning, args_info);
   rtk::RegisterIOFactories();
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef unsigned short OutputPixelType;
   const unsigned int     Dimension = 2;
@@ -50,6 +51,7 @@ int main(int argc, char * argv[])
   typedef itk::ImageFileReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileName( args_info.input_arg );
+  telemetry->Watch(reader.GetPointer(), "reader");
   readerProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
   readerProbe.Stop();
@@ -73,6 +75,7 @@ int main(int argc, char * argv[])
   BINFilterType::Pointer binning=BINFilterType::New();
   binning->SetInput(reader->GetOutput());
   binning->SetBinningFactors(binningFactors);
+  telemetry->Watch(binning.GetPointer(), "binning");
   binningProbe.Start();
   binning->Update();
   binningProbe.Stop();
@@ -85,9 +88,12 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( binning->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Writing... " << std::cout;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
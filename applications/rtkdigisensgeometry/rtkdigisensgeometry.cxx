@@ -25,6 +25,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkdigisensgeometry, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // RTK geometry object
   typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
@@ -33,14 +34,20 @@ int main(int argc, char * argv[])
   // Create geometry reader
   rtk::DigisensGeometryReader::Pointer reader = rtk::DigisensGeometryReader::New();
   reader->SetXMLFileName(args_info.xml_file_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->UpdateOutputData() );
+  telemetry->StopStage();
 
   // Write
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.output_arg);
   xmlWriter->SetObject(&(*geometry) );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
+
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
 
   return EXIT_SUCCESS;
 }
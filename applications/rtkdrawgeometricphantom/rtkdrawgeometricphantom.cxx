@@ -26,6 +26,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkdrawgeometricphantom, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -43,6 +44,7 @@ int main(int argc, char * argv[])
   DQType::Pointer dq = DQType::New();
   dq->SetInput( constantImageSource->GetOutput() );
   dq->SetConfigFile(args_info.phantomfile_arg);
+  telemetry->Watch(dq.GetPointer(), "draw geometric phantom");
   dq->Update();
 
   // Add noise
@@ -54,6 +56,7 @@ int main(int argc, char * argv[])
     noisy->SetInput( output );
     noisy->SetMean( 0.0 );
     noisy->SetStandardDeviation( args_info.noise_arg );
+    telemetry->Watch(noisy.GetPointer(), "noise");
     TRY_AND_EXIT_ON_ITK_EXCEPTION( noisy->Update() );
     output = noisy->GetOutput();
   }
@@ -63,9 +66,12 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( output );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Writing reference... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -31,6 +31,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkdrawshepploganphantom, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -48,6 +49,7 @@ int main(int argc, char * argv[])
   DSLType::Pointer dsl = DSLType::New();
   dsl->SetPhantomScale( args_info.phantomscale_arg );
   dsl->SetInput( constantImageSource->GetOutput() );
+  telemetry->Watch(dsl.GetPointer(), "draw shepp logan phantom");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( dsl->Update() )
 
   // Add noise
@@ -59,6 +61,7 @@ int main(int argc, char * argv[])
     noisy->SetInput( output );
     noisy->SetMean( 0.0 );
     noisy->SetStandardDeviation( args_info.noise_arg );
+    telemetry->Watch(noisy.GetPointer(), "noise");
     TRY_AND_EXIT_ON_ITK_EXCEPTION( noisy->Update() );
     output = noisy->GetOutput();
   }
@@ -68,7 +71,10 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( output );
+  telemetry->Watch(writer.GetPointer(), "writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
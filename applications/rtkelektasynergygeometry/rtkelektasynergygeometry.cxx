@@ -24,20 +24,31 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkelektasynergygeometry, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // Create geometry reader
   rtk::ElektaSynergyGeometryReader::Pointer reader = rtk::ElektaSynergyGeometryReader::New();
   reader->SetDicomUID(args_info.dicom_uid_arg);
   reader->SetImageDbfFileName(args_info.image_db_arg);
   reader->SetFrameDbfFileName(args_info.frame_db_arg);
+  if(args_info.image_index_given)
+    reader->SetImageDbfIndexFileName(args_info.image_index_arg);
+  if(args_info.frame_index_given)
+    reader->SetFrameDbfIndexFileName(args_info.frame_index_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->UpdateOutputData() );
+  telemetry->StopStage();
 
   // Write
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.output_arg);
   xmlWriter->SetObject( reader->GetGeometry() );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
+
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
 
   return EXIT_SUCCESS;
 }
@@ -17,7 +17,7 @@
  *=========================================================================*/
 
 #include "rtkextractshroudsignal_ggo.h"
-#include "rtkMacro.h"
+#include "rtkGgoFunctions.h"
 
 #include "rtkDPExtractShroudSignalImageFilter.h"
 #include "rtkReg1DExtractShroudSignalImageFilter.h"
@@ -29,6 +29,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkextractshroudsignal, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef double InputPixelType;
   typedef double OutputPixelType;
@@ -40,6 +41,7 @@ int main(int argc, char * argv[])
   // Read
   itk::ImageFileReader<InputImageType>::Pointer reader = itk::ImageFileReader<InputImageType>::New();
   reader->SetFileName(args_info.input_arg);
+  telemetry->Watch(reader.GetPointer(), "reader");
 
   // Extract shroud signal
   OutputImageType::Pointer shroudSignal;
@@ -54,6 +56,7 @@ int main(int argc, char * argv[])
     shroudFilterType::Pointer shroudFilter = shroudFilterType::New();
     shroudFilter->SetInput( reader->GetOutput() );
     shroudFilter->SetAmplitude( args_info.amplitude_arg );
+    telemetry->Watch(shroudFilter.GetPointer(), "extract shroud signal");
     shroudFilter->Update();
     shroudSignal = shroudFilter->GetOutput();
   }
@@ -62,6 +65,7 @@ int main(int argc, char * argv[])
     typedef rtk::Reg1DExtractShroudSignalImageFilter<InputPixelType, OutputPixelType> shroudFilterType;
     shroudFilterType::Pointer shroudFilter = shroudFilterType::New();
     shroudFilter->SetInput( reader->GetOutput() );
+    telemetry->Watch(shroudFilter.GetPointer(), "extract shroud signal");
     shroudFilter->Update();
     shroudSignal = shroudFilter->GetOutput();
   }
@@ -80,5 +84,7 @@ int main(int argc, char * argv[])
   }
   ofs.close();
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -32,15 +32,19 @@
 # include "rtkOpenCLFDKConeBeamReconstructionFilter.h"
 #endif
 #include "rtkFDKWarpBackProjectionImageFilter.h"
+#include "rtkFieldOfViewImageFilter.h"
 #include "rtkCyclicDeformationImageFilter.h"
 
 #include <itkRegularExpressionSeriesFileNames.h>
 #include <itkStreamingImageFilter.h>
 #include <itkImageFileWriter.h>
+#include <itkCastImageFilter.h>
 
 int main(int argc, char * argv[])
 {
   GGO(rtkfdk, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
+  rtk::SetThreadAffinityFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -68,8 +72,32 @@ int main(int argc, char * argv[])
   // Projections reader
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
-  reader->SetFileNames( names->GetFileNames() );
-  TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->GenerateOutputInformation() );
+
+  // Half precision projections reader. On CPU, the stack is kept in half
+  // precision up to the FDK filter which converts each subset to single
+  // precision when it is extracted. The GPU filters only accept single
+  // precision stacks, the half stack is then converted.
+  typedef itk::Image< rtk::Half, Dimension > HalfImageType;
+  typedef rtk::ProjectionsReader< HalfImageType > HalfReaderType;
+  HalfReaderType::Pointer halfReader = HalfReaderType::New();
+  typedef itk::CastImageFilter< HalfImageType, OutputImageType > HalfCastType;
+  HalfCastType::Pointer halfCast = HalfCastType::New();
+  halfCast->SetInput( halfReader->GetOutput() );
+  telemetry->Watch(reader.GetPointer(), "reader");
+  telemetry->Watch(halfReader.GetPointer(), "reader");
+  telemetry->Watch(halfCast.GetPointer(), "half to float");
+
+  itk::ProcessObject *projectionsReader = reader;
+  OutputImageType *projections = reader->GetOutput();
+  if(args_info.fp16_flag)
+    {
+    projectionsReader = halfReader;
+    projections = halfCast->GetOutput();
+    halfReader->SetFileNames( names->GetFileNames() );
+    }
+  else
+    reader->SetFileNames( names->GetFileNames() );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( projectionsReader->UpdateOutputInformation() );
 
   itk::TimeProbe readerProbe;
   if(!args_info.lowmem_flag)
@@ -77,7 +105,7 @@ int main(int argc, char * argv[])
     if(args_info.verbose_flag)
       std::cout << "Reading... " << std::flush;
     readerProbe.Start();
-    TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( projectionsReader->Update() )
     readerProbe.Stop();
     if(args_info.verbose_flag)
       std::cout << "It took " << readerProbe.GetMean() << ' ' << readerProbe.GetUnit() << std::endl;
@@ -92,13 +120,16 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Displaced detector weighting
   typedef rtk::DisplacedDetectorImageFilter< OutputImageType > DDFType;
   DDFType::Pointer ddf = DDFType::New();
-  ddf->SetInput( reader->GetOutput() );
+  ddf->SetInput( projections );
   ddf->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(ddf.GetPointer(), "displaced detector weighting");
 
   // Short scan image filter
   typedef rtk::ParkerShortScanImageFilter< OutputImageType > PSSFType;
@@ -106,12 +137,47 @@ int main(int argc, char * argv[])
   pssf->SetInput( ddf->GetOutput() );
   pssf->SetGeometry( geometryReader->GetOutputObject() );
   pssf->InPlaceOff();
+  telemetry->Watch(pssf.GetPointer(), "short scan weighting");
+
+  // Same weightings of the half precision stack
+  typedef rtk::DisplacedDetectorImageFilter< HalfImageType > HalfDDFType;
+  HalfDDFType::Pointer halfDdf = HalfDDFType::New();
+  halfDdf->SetInput( halfReader->GetOutput() );
+  halfDdf->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(halfDdf.GetPointer(), "displaced detector weighting");
+
+  typedef rtk::ParkerShortScanImageFilter< HalfImageType > HalfPSSFType;
+  HalfPSSFType::Pointer halfPssf = HalfPSSFType::New();
+  halfPssf->SetInput( halfDdf->GetOutput() );
+  halfPssf->SetGeometry( geometryReader->GetOutputObject() );
+  halfPssf->InPlaceOff();
+  telemetry->Watch(halfPssf.GetPointer(), "short scan weighting");
 
   // Create reconstructed image
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
   ConstantImageSourceType::Pointer constantImageSource = ConstantImageSourceType::New();
   rtk::SetConstantImageSourceFromGgo<ConstantImageSourceType, args_info_rtkfdk>(constantImageSource, args_info);
 
+  // Span table of the field of view of the reconstructed volume to skip the
+  // voxels outside in the backprojection. The displaced detector weighting is
+  // applied, the field of view is therefore bounded by the largest radius.
+  rtk::FieldOfViewSpanTable::Pointer fovSpanTable;
+  if(args_info.fov_flag)
+    {
+    typedef rtk::FieldOfViewImageFilter<CPUOutputImageType, CPUOutputImageType> FOVFilterType;
+    FOVFilterType::Pointer fov = FOVFilterType::New();
+    fov->SetGeometry( geometryReader->GetOutputObject() );
+    if(args_info.fp16_flag)
+      fov->SetProjectionsStack( halfReader->GetOutput() );
+    else
+      fov->SetProjectionsStack( reader->GetOutput() );
+    fov->SetDisplacedDetector(true);
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( constantImageSource->UpdateOutputInformation() )
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( fovSpanTable = fov->ComputeSpanTable( constantImageSource->GetOutput() ) )
+    if(fovSpanTable.GetPointer() == NULL && args_info.verbose_flag)
+      std::cout << "The direction of the volume is not the identity, all voxels are backprojected." << std::endl;
+    }
+
   // Motion-compensated objects for the compensation of a cyclic deformation.
   // Although these will only be used if the command line options for motion
   // compensation are set, we still create the object before hand to avoid auto
@@ -132,15 +198,31 @@ int main(int argc, char * argv[])
   // because TFFTPrecision is not the same, e.g. for CPU and CUDA (SR)
 #define SET_FELDKAMP_OPTIONS(f) \
     f->SetInput( 0, constantImageSource->GetOutput() ); \
-    f->SetInput( 1, pssf->GetOutput() ); \
     f->SetGeometry( geometryReader->GetOutputObject() ); \
     f->GetRampFilter()->SetTruncationCorrection(args_info.pad_arg); \
     f->GetRampFilter()->SetHannCutFrequency(args_info.hann_arg); \
     f->GetRampFilter()->SetHannCutFrequencyY(args_info.hannY_arg);
 
+  // Options of the CPU fdk filters, with single and half precision stacks
+#define SET_CPU_FELDKAMP_OPTIONS(f) \
+    SET_FELDKAMP_OPTIONS( f ); \
+    if(args_info.signal_given && args_info.dvf_given) \
+      { \
+      dvfReader->SetFileName(args_info.dvf_arg); \
+      def->SetSignalFilename(args_info.signal_arg); \
+      f->SetBackProjectionFilter( bp.GetPointer() ); \
+      } \
+    else \
+      f->GetBackProjectionFilter()->SetFieldOfViewSpanTable( fovSpanTable ); \
+    telemetry->Watch(f.GetPointer(), "fdk"); \
+    f->WatchSubfilters(telemetry); \
+    pfeldkamp = f->GetOutput();
+
   // FDK reconstruction filtering
   typedef rtk::FDKConeBeamReconstructionFilter< OutputImageType > FDKCPUType;
   FDKCPUType::Pointer feldkamp = FDKCPUType::New();
+  typedef rtk::FDKConeBeamReconstructionFilter< OutputImageType, OutputImageType, double, HalfImageType > FDKHalfCPUType;
+  FDKHalfCPUType::Pointer feldkampHalf = FDKHalfCPUType::New();
 #if OPENCL_FOUND
   typedef rtk::OpenCLFDKConeBeamReconstructionFilter FDKOPENCLType;
   FDKOPENCLType::Pointer feldkampOCL = FDKOPENCLType::New();
@@ -152,23 +234,24 @@ int main(int argc, char * argv[])
   itk::Image< OutputPixelType, Dimension > *pfeldkamp = NULL;
   if(!strcmp(args_info.hardware_arg, "cpu") )
     {
-    typedef rtk::FDKConeBeamReconstructionFilter< OutputImageType > FDKCPUType;
-    feldkamp = FDKCPUType::New();
-    SET_FELDKAMP_OPTIONS( feldkamp );
-
-    // Motion compensated CBCT settings
-    if(args_info.signal_given && args_info.dvf_given)
+    if(args_info.fp16_flag)
+      {
+      feldkampHalf->SetProjectionStack( halfPssf->GetOutput() );
+      SET_CPU_FELDKAMP_OPTIONS( feldkampHalf );
+      }
+    else
       {
-      dvfReader->SetFileName(args_info.dvf_arg);
-      def->SetSignalFilename(args_info.signal_arg);
-      feldkamp->SetBackProjectionFilter( bp.GetPointer() );
+      feldkamp->SetInput( 1, pssf->GetOutput() );
+      SET_CPU_FELDKAMP_OPTIONS( feldkamp );
       }
-    pfeldkamp = feldkamp->GetOutput();
     }
   else if(!strcmp(args_info.hardware_arg, "cuda") )
     {
 #if CUDA_FOUND
+    feldkampCUDA->SetInput( 1, pssf->GetOutput() );
     SET_FELDKAMP_OPTIONS( feldkampCUDA );
+    telemetry->Watch(feldkampCUDA.GetPointer(), "fdk");
+    feldkampCUDA->WatchSubfilters(telemetry);
     pfeldkamp = feldkampCUDA->GetOutput();
 #else
     std::cerr << "The program has not been compiled with cuda option" << std::endl;
@@ -178,6 +261,7 @@ int main(int argc, char * argv[])
   else if(!strcmp(args_info.hardware_arg, "opencl") )
     {
 #if OPENCL_FOUND
+    feldkampOCL->SetInput( 1, pssf->GetOutput() );
     SET_FELDKAMP_OPTIONS( feldkampOCL );
     pfeldkamp = feldkampOCL->GetOutput();
 #else
@@ -192,12 +276,14 @@ int main(int argc, char * argv[])
   StreamerType::Pointer streamerBP = StreamerType::New();
   streamerBP->SetInput( pfeldkamp );
   streamerBP->SetNumberOfStreamDivisions( args_info.divisions_arg );
+  telemetry->Watch(streamerBP.GetPointer(), "streaming");
 
   // Write
   typedef itk::ImageFileWriter<CPUOutputImageType> WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( streamerBP->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
 
   if(args_info.verbose_flag)
     std::cout << "Reconstructing and writing... " << std::flush;
@@ -211,7 +297,13 @@ int main(int argc, char * argv[])
     {
     std::cout << "It took " << writerProbe.GetMean() << ' ' << readerProbe.GetUnit() << std::endl;
     if(!strcmp(args_info.hardware_arg, "cpu") )
-      feldkamp->PrintTiming(std::cout);
+      {
+      if(args_info.fp16_flag)
+        feldkampHalf->PrintTiming(std::cout);
+      else
+        feldkamp->PrintTiming(std::cout);
+      rtk::ImageBufferPool::GetInstance()->PrintStatistics(std::cout);
+      }
 #if CUDA_FOUND
     else if(!strcmp(args_info.hardware_arg, "cuda") )
       feldkampCUDA->PrintTiming(std::cout);
@@ -223,5 +315,7 @@ int main(int argc, char * argv[])
     std::cout << std::endl;
     }
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -29,6 +29,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkfdktwodweights, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -52,6 +53,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->GenerateOutputInformation() )
 
   // Geometry
@@ -63,7 +65,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Weights filter
   typedef rtk::FDKWeightProjectionFilter< OutputImageType > WeightType;
@@ -72,6 +76,7 @@ int main(int argc, char * argv[])
   wf->SetGeometry( geometryReader->GetOutputObject() );
   wf->SetNumberOfThreads(1);
   wf->InPlaceOff();
+  telemetry->Watch(wf.GetPointer(), "weighting");
 
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
@@ -79,7 +84,10 @@ int main(int argc, char * argv[])
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( wf->GetOutput() );
   writer->SetNumberOfStreamDivisions( args_info.divisions_arg );
+  telemetry->Watch(writer.GetPointer(), "writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -31,6 +31,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkfieldofview, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -54,11 +55,14 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
   //Reconstruction reader
   typedef itk::ImageFileReader<  OutputImageType > ImageReaderType;
   ImageReaderType::Pointer unmasked_reconstruction = ImageReaderType::New();
   unmasked_reconstruction->SetFileName(args_info.reconstruction_arg);
+  telemetry->Watch(unmasked_reconstruction.GetPointer(), "reconstruction reader");
   //Projections reader
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer projections = ReaderType::New();
@@ -72,15 +76,19 @@ int main(int argc, char * argv[])
   fieldofview->SetProjectionsStack(projections->GetOutput());
   fieldofview->SetGeometry(geometryReader->GetOutputObject());
   fieldofview->SetDisplacedDetector(args_info.displaced_flag);
+  telemetry->Watch(fieldofview.GetPointer(), "field of view");
   fieldofview->Update();
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( fieldofview->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -34,6 +34,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkforwardprojections, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -53,7 +54,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
   if(args_info.verbose_flag)
     std::cout << " done." << std::endl;
 
@@ -79,6 +82,7 @@ int main(int argc, char * argv[])
   typedef itk::ImageFileReader<  OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileName( args_info.input_arg );
+  telemetry->Watch(reader.GetPointer(), "reader");
   readerProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
   readerProbe.Stop();
@@ -120,6 +124,7 @@ int main(int argc, char * argv[])
   forwardProjection->SetInput( constantImageSource->GetOutput() );
   forwardProjection->SetInput( 1, reader->GetOutput() );
   forwardProjection->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(forwardProjection.GetPointer(), "forward projection", rtk::Telemetry::RAYS);
   projProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( forwardProjection->Update() )
   projProbe.Stop();
@@ -136,6 +141,7 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( forwardProjection->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   writeProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
   writeProbe.Stop();
@@ -144,5 +150,7 @@ int main(int argc, char * argv[])
               << writeProbe.GetMean() << ' ' << projProbe.GetUnit()
               << '.' << std::endl;
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -58,6 +58,7 @@ struct ThreadInfoStruct
   double minimumOffsetX;    // Used for Wang weighting
   double maximumOffsetX;
   std::string fileName;
+  rtk::Telemetry::Pointer telemetry;
   };
 
 void computeOffsetsFromGeometry(rtk::ThreeDCircularProjectionGeometry::Pointer geometry, double *minOffset,
@@ -77,6 +78,7 @@ int main(int argc, char * argv[])
   threadInfo.nproj = 0;
   threadInfo.minimumOffsetX = 0.0;
   threadInfo.maximumOffsetX = 0.0;
+  threadInfo.telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
   threader->SetMultipleMethod(0, AcquisitionCallback, (void*)&threadInfo);
@@ -118,7 +120,9 @@ static ITK_THREAD_RETURN_TYPE AcquisitionCallback(void *arg)
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(threadInfo->args_info->geometry_arg);
+  threadInfo->telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() );
+  threadInfo->telemetry->StopStage();
 
   // Computes the minimum and maximum offsets from Geometry
   computeOffsetsFromGeometry(geometryReader->GetOutputObject(), &minOffset, &maxOffset);
@@ -184,6 +188,7 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
   // Projections reader
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
+  threadInfo->telemetry->Watch(reader.GetPointer(), "reader");
 
   // Create reconstructed image
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
@@ -194,6 +199,7 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
   typedef itk::ExtractImageFilter<OutputImageType, OutputImageType> ExtractFilterType;
   ExtractFilterType::Pointer extract = ExtractFilterType::New();
   extract->SetInput( reader->GetOutput() );
+  threadInfo->telemetry->Watch(extract.GetPointer(), "extract");
   ExtractFilterType::InputImageRegionType subsetRegion;
 
   // Displaced detector weighting
@@ -201,6 +207,7 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
   DDFType::Pointer ddf = DDFType::New();
   ddf->SetInput( extract->GetOutput() );
   ddf->SetGeometry( geometry );
+  threadInfo->telemetry->Watch(ddf.GetPointer(), "displaced detector weighting");
 
   // Short scan image filter
 //  typedef rtk::ParkerShortScanImageFilter< OutputImageType > PSSFType;
@@ -232,11 +239,15 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
   if(!strcmp(threadInfo->args_info->hardware_arg, "cpu") )
     {
     SET_FELDKAMP_OPTIONS(feldkampCPU);
+    threadInfo->telemetry->Watch(feldkampCPU.GetPointer(), "fdk");
+    feldkampCPU->WatchSubfilters(threadInfo->telemetry);
     }
   else if(!strcmp(threadInfo->args_info->hardware_arg, "cuda") )
     {
 #if CUDA_FOUND
     SET_FELDKAMP_OPTIONS( feldkampCUDA );
+    threadInfo->telemetry->Watch(feldkampCUDA.GetPointer(), "fdk");
+    feldkampCUDA->WatchSubfilters(threadInfo->telemetry);
 #else
     std::cerr << "The program has not been compiled with cuda option" << std::endl;
     exit(EXIT_FAILURE);
@@ -256,6 +267,7 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
   typedef itk::ImageFileWriter<  CPUOutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( threadInfo->args_info->output_arg );
+  threadInfo->telemetry->Watch(writer.GetPointer(), "writer");
 
   threadInfo->mutex.Unlock();
 
@@ -426,6 +438,7 @@ static ITK_THREAD_RETURN_TYPE InlineThreadCallback(void *arg)
 
         //Write to disk and exit
         TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
+        rtk::WriteTelemetryFromGgo(threadInfo->telemetry.GetPointer(), *(threadInfo->args_info));
         exit(EXIT_SUCCESS);
         }
       }
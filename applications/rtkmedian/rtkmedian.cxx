@@ -32,6 +32,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkmedian, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef unsigned short OutputPixelType;
   const unsigned int     Dimension = 2;
@@ -49,6 +50,7 @@ int main(int argc, char * argv[])
   typedef itk::ImageFileReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileName( args_info.input_arg );
+  telemetry->Watch(reader.GetPointer(), "reader");
   readerProbe.Start();
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
   readerProbe.Stop();
@@ -72,12 +74,14 @@ int main(int argc, char * argv[])
   MEDFilterType::Pointer median=MEDFilterType::New();
   median->SetInput(reader->GetOutput());
   median->SetMedianWindow(medianWindow);
+  telemetry->Watch(median.GetPointer(), "median");
   median->Update();
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( median->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
@@ -89,5 +93,7 @@ int main(int argc, char * argv[])
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -29,6 +29,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkparkershortscanweighting, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -52,6 +53,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->GenerateOutputInformation() )
 
   // Geometry
@@ -63,7 +65,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Short scan image filter
   typedef rtk::ParkerShortScanImageFilter< OutputImageType > PSSFType;
@@ -72,6 +76,7 @@ int main(int argc, char * argv[])
   pssf->SetGeometry( geometryReader->GetOutputObject() );
   pssf->SetNumberOfThreads(1);
   pssf->InPlaceOff();
+  telemetry->Watch(pssf.GetPointer(), "short scan weighting");
 
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
@@ -79,7 +84,10 @@ int main(int argc, char * argv[])
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( pssf->GetOutput() );
   writer->SetNumberOfStreamDivisions( args_info.divisions_arg );
+  telemetry->Watch(writer.GetPointer(), "writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -30,6 +30,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkprojectgeometricphantom, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -46,7 +47,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Create a stack of empty projection images
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
@@ -65,15 +68,19 @@ int main(int argc, char * argv[])
   ppc->SetInput(constantImageSource->GetOutput());
   ppc->SetGeometry(geometryReader->GetOutputObject());
   ppc->SetConfigFile(args_info.phantomfile_arg);
+  telemetry->Watch(ppc.GetPointer(), "project geometric phantom", rtk::Telemetry::RAYS);
   ppc->Update();
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( ppc->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
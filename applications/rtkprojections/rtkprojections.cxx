@@ -17,17 +17,22 @@
  *=========================================================================*/
 
 #include "rtkprojections_ggo.h"
-#include "rtkMacro.h"
+#include "rtkGgoFunctions.h"
 
 #include "rtkProjectionsReader.h"
+#include "rtkProjectionsCacheImageIO.h"
 
 #include <itkImageFileWriter.h>
 #include <itkRegularExpressionSeriesFileNames.h>
 #include <itkTimeProbe.h>
 
+#include <fstream>
+#include <sstream>
+
 int main(int argc, char * argv[])
 {
   GGO(rtkprojections, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -50,16 +55,42 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
 
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( reader->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
+
+  // Projections cache: decoded once, mapped by subsequent reconstructions
+  rtk::ProjectionsCacheImageIO::Pointer cacheIO = rtk::ProjectionsCacheImageIO::New();
+  if( cacheIO->CanWriteFile(args_info.output_arg) )
+    {
+    cacheIO->SetUseHalfPrecision( args_info.fp16_flag );
+    if(args_info.geometry_given)
+      {
+      std::ifstream is(args_info.geometry_arg);
+      if(!is.is_open())
+        {
+        std::cerr << "Could not open geometry file " << args_info.geometry_arg << std::endl;
+        return EXIT_FAILURE;
+        }
+      std::ostringstream xml;
+      xml << is.rdbuf();
+      cacheIO->SetGeometryXML( xml.str() );
+      }
+    writer->SetImageIO( cacheIO );
+    }
+  else if(args_info.fp16_flag || args_info.geometry_given)
+    std::cerr << "Warning: --fp16 and --geometry are only used with the .rtkproj projections cache" << std::endl;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->UpdateOutputInformation() )
   writer->SetNumberOfStreamDivisions( 1 + reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() / (1024*1024*4) );
 
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
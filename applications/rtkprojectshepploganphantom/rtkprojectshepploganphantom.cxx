@@ -31,6 +31,15 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkprojectshepploganphantom, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
+
+  if(args_info.noise_given && args_info.i0_given)
+    {
+    std::cerr << "Options --noise and --i0 are exclusive, "
+              << "choose either Gaussian or Poisson noise."
+              << std::endl;
+    return EXIT_FAILURE;
+    }
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -47,7 +56,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Create a stack of empty projection images
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
@@ -67,17 +78,23 @@ int main(int argc, char * argv[])
   slp->SetGeometry(geometryReader->GetOutputObject());
   if (args_info.phantomscale_given)
     slp->SetPhantomScale(args_info.phantomscale_arg);
+  telemetry->Watch(slp.GetPointer(), "project shepp logan phantom", rtk::Telemetry::RAYS);
   TRY_AND_EXIT_ON_ITK_EXCEPTION( slp->Update() );
 
   // Add noise
   OutputImageType::Pointer output = slp->GetOutput();
-  if(args_info.noise_given)
+  if(args_info.noise_given || args_info.i0_given)
   {
     typedef rtk::AdditiveGaussianNoiseImageFilter< OutputImageType > NIFType;
     NIFType::Pointer noisy=NIFType::New();
     noisy->SetInput( slp->GetOutput() );
     noisy->SetMean( 0.0 );
-    noisy->SetStandardDeviation( args_info.noise_arg );
+    noisy->SetSeed( args_info.seed_arg );
+    if(args_info.noise_given)
+      noisy->SetStandardDeviation( args_info.noise_arg );
+    if(args_info.i0_given)
+      noisy->SetNumberOfIncidentPhotons( args_info.i0_arg );
+    telemetry->Watch(noisy.GetPointer(), "noise");
     TRY_AND_EXIT_ON_ITK_EXCEPTION( noisy->Update() );
     output = noisy->GetOutput();
   }
@@ -87,9 +104,12 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( output );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
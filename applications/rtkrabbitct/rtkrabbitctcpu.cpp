@@ -0,0 +1,129 @@
+/** RabbitCT - Version 1.0
+
+  RabbitCT enables easy benchmarking of backprojection algorithms.
+  CPU version using the raw-pointer kernel of rtk::FDKBackProjectionImageFilter
+  multithreaded over slabs of slices of the volume.
+*/
+
+// include the required header files
+#include <string.h>
+
+#include "rabbitct.h"
+
+#include "rtkFDKBackProjectionKernel.h"
+
+#include <itkMultiThreader.h>
+
+typedef rtk::FDKBackProjectionKernel<float, float> KernelType;
+
+/** Data shared by the threads for the backprojection of one projection */
+struct RabbitCtThreadData
+  {
+  float                  *vol;
+  int                     vol_dim[3];
+  const float            *img;
+  int                     img_dim[2];
+  KernelType::MatrixType  matrix;
+  };
+
+RabbitCtThreadData        threadData;
+itk::MultiThreader::Pointer threader;
+
+/** Each thread backprojects a slab of consecutive slices */
+ITK_THREAD_RETURN_TYPE RabbitCtBackProjectionCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const RabbitCtThreadData *data = static_cast<const RabbitCtThreadData *>(info->UserData);
+  const int kBegin = (data->vol_dim[2] * info->ThreadID) / info->NumberOfThreads;
+  const int kEnd = (data->vol_dim[2] * (info->ThreadID+1)) / info->NumberOfThreads;
+  KernelType::BackProjectSlab(data->vol, data->vol_dim, kBegin, kEnd, data->matrix, data->img, data->img_dim);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** \brief Initialization routine.
+
+  This method is required for initializing the data required for
+  backprojection. It is called right before the first iteration.
+  Here any time intensive preliminary computations and
+  initializations should be performed.
+*/
+FNCSIGN bool RCTLoadAlgorithm(RabbitCtGlobalData* rcgd)
+{
+  threadData.img_dim[0] = rcgd->S_x;
+  threadData.img_dim[1] = rcgd->S_y;
+
+  threadData.vol_dim[0] = rcgd->L;
+  threadData.vol_dim[1] = rcgd->L;
+  threadData.vol_dim[2] = rcgd->L;
+
+  // calculate the number of voxels
+  int N = rcgd->L * rcgd->L * rcgd->L;
+
+  // allocate the required volume
+  rcgd->f_L = new float[N];
+  memset(rcgd->f_L, 0, N * sizeof(float) );
+  threadData.vol = rcgd->f_L;
+
+  threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
+  threader->SetSingleMethod(RabbitCtBackProjectionCallback, &threadData);
+
+  return true;
+}
+
+/** \brief Finish routine.
+
+  This method is called after the last projection image. Here
+  it should be made sure the the rcgd->out_volume pointer
+  is set correctly.
+*/
+FNCSIGN bool RCTFinishAlgorithm(RabbitCtGlobalData* itkNotUsed(rcgd))
+{
+  // The volume is backprojected in place in rcgd->f_L
+  return true;
+}
+
+/** \brief Cleanup routine.
+
+  This method can be used to clean up the allocated
+  data required for backprojection. It is called just before
+  the benchmark finishes.
+*/
+FNCSIGN bool RCTUnloadAlgorithm(RabbitCtGlobalData* rcgd)
+{
+  threader = NULL;
+
+  // delete the previously allocated volume
+  delete [] (rcgd->f_L);
+  rcgd->f_L = NULL;
+  threadData.vol = NULL;
+  return true;
+}
+
+/** \brief Backprojection iteration.
+
+  This function is the C++ implementation of the pseudo-code
+  in the technical note.
+*/
+FNCSIGN bool RCTAlgorithmBackprojection(RabbitCtGlobalData* rcgd)
+{
+  //Transpose
+  for (unsigned int j=0; j<3; j++)
+    for (unsigned int i=0; i<4; i++)
+      threadData.matrix[j][i] = rcgd->A_n[i*3+j];
+
+  //Transform from volume coordinate to index
+  for (unsigned int j=0; j<3; j++)
+    {
+    for (unsigned int i=0; i<3; i++)
+      threadData.matrix[j][3] += threadData.matrix[j][i]*rcgd->O_L;
+    threadData.matrix[j][0] *= rcgd->R_L;
+    threadData.matrix[j][1] *= rcgd->R_L;
+    threadData.matrix[j][2] *= rcgd->R_L;
+    }
+
+  threadData.img = rcgd->I_n;
+  threader->SingleMethodExecute();
+
+  return true;
+}
@@ -17,7 +17,7 @@
  *=========================================================================*/
 
 #include "rtkramp_ggo.h"
-#include "rtkMacro.h"
+#include "rtkGgoFunctions.h"
 
 #include "rtkProjectionsReader.h"
 #include "rtkFFTRampImageFilter.h"
@@ -34,6 +34,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkramp, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -55,6 +56,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
 
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
 
@@ -73,6 +75,7 @@ int main(int argc, char * argv[])
     cudaRampFilter->SetTruncationCorrection(args_info.pad_arg);
     cudaRampFilter->SetHannCutFrequency(args_info.hann_arg);
     cudaRampFilter->SetHannCutFrequencyY(args_info.hannY_arg);
+    telemetry->Watch(cudaRampFilter.GetPointer(), "ramp");
 #else
     std::cerr << "The program has not been compiled with cuda option" << std::endl;
     return EXIT_FAILURE;
@@ -85,6 +88,7 @@ int main(int argc, char * argv[])
     rampFilter->SetTruncationCorrection(args_info.pad_arg);
     rampFilter->SetHannCutFrequency(args_info.hann_arg);
     rampFilter->SetHannCutFrequencyY(args_info.hannY_arg);
+    telemetry->Watch(rampFilter.GetPointer(), "ramp");
     }
 
   // Streaming filter
@@ -113,8 +117,11 @@ int main(int argc, char * argv[])
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( streamer->GetOutput() );
   writer->UpdateOutputInformation();
+  telemetry->Watch(writer.GetPointer(), "writer");
 
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
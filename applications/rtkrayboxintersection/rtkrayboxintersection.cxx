@@ -28,6 +28,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkrayboxintersection, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -43,7 +44,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Create a stack of empty projection images
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
@@ -69,6 +72,7 @@ int main(int argc, char * argv[])
   rbi->SetInput( constantImageSource->GetOutput() );
   rbi->SetBoxFromImage( reader->GetOutput() );
   rbi->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(rbi.GetPointer(), "ray box intersection", rtk::Telemetry::RAYS);
   rbi->Update();
 
   // Write
@@ -76,9 +80,12 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( rbi->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
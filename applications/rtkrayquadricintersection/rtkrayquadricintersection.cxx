@@ -28,6 +28,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkrayquadricintersection, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -43,7 +44,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Create a stack of empty projection images
   typedef rtk::ConstantImageSource< OutputImageType > ConstantImageSourceType;
@@ -73,6 +76,7 @@ int main(int argc, char * argv[])
   if(args_info.parameters_given>9) rbi->GetRQIFunctor()->SetJ(args_info.parameters_arg[9]);
   rbi->SetDensity(args_info.mult_arg);
   rbi->SetGeometry( geometryReader->GetOutputObject() );
+  telemetry->Watch(rbi.GetPointer(), "ray quadric intersection", rtk::Telemetry::RAYS);
   rbi->Update();
 
   // Write
@@ -80,9 +84,12 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( rbi->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   if(args_info.verbose_flag)
     std::cout << "Projecting and writing... " << std::flush;
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -33,6 +33,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtksart, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -60,6 +61,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->GenerateOutputInformation() );
 
   // Geometry
@@ -71,7 +73,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Create input: either an existing volume read from a file or a blank image
   itk::ImageSource< OutputImageType >::Pointer inputFilter;
@@ -143,6 +147,9 @@ int main(int argc, char * argv[])
   sart->SetNumberOfIterations( args_info.niterations_arg );
   sart->SetLambda( args_info.lambda_arg );
   sart->SetBackProjectionFilter( bp );
+  telemetry->Watch(inputFilter.GetPointer(), "input volume");
+  telemetry->Watch(sart.GetPointer(), "sart");
+  sart->WatchSubfilters(telemetry);
 
   itk::TimeProbe readerProbe;
   if(args_info.time_flag)
@@ -157,6 +164,8 @@ int main(int argc, char * argv[])
   {
     readerProbe.Stop();
     std::cout << "It took...  " << readerProbe.GetMean() << ' ' << readerProbe.GetUnit() << std::endl;
+    sart->PrintTiming(std::cout);
+    rtk::ImageBufferPool::GetInstance()->PrintStatistics(std::cout);
   }
 
   // Write
@@ -164,7 +173,10 @@ int main(int argc, char * argv[])
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( sart->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() );
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
@@ -24,32 +24,41 @@
 int main(int argc, char * argv[])
 {
   GGO(rtksimulatedgeometry, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // RTK geometry object
   typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
   GeometryType::Pointer geometry = GeometryType::New();
 
+  // Projection parameters
+  const unsigned int nProj = (args_info.nproj_arg>0)?args_info.nproj_arg:0;
+  std::vector<double> angles(nProj);
+  for(unsigned int noProj=0; noProj<nProj; noProj++)
+    angles[noProj] = args_info.first_angle_arg + noProj * args_info.arc_arg / args_info.nproj_arg;
+
   // Projection matrices
-  for(int noProj=0; noProj<args_info.nproj_arg; noProj++)
-    {
-    double angle = args_info.first_angle_arg + noProj * args_info.arc_arg / args_info.nproj_arg;
-    geometry->AddProjection(args_info.sid_arg,
-                            args_info.sdd_arg,
-                            angle,
-                            args_info.proj_iso_x_arg,
-                            args_info.proj_iso_y_arg,
-                            args_info.out_angle_arg,
-                            args_info.in_angle_arg,
-                            args_info.source_x_arg,
-                            args_info.source_y_arg);
-    }
+  telemetry->StartStage("geometry");
+  geometry->AddProjections(std::vector<double>(nProj, args_info.sid_arg),
+                           std::vector<double>(nProj, args_info.sdd_arg),
+                           angles,
+                           std::vector<double>(nProj, args_info.proj_iso_x_arg),
+                           std::vector<double>(nProj, args_info.proj_iso_y_arg),
+                           std::vector<double>(nProj, args_info.out_angle_arg),
+                           std::vector<double>(nProj, args_info.in_angle_arg),
+                           std::vector<double>(nProj, args_info.source_x_arg),
+                           std::vector<double>(nProj, args_info.source_y_arg) );
+  telemetry->StopStage();
 
   // Write
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.output_arg);
   xmlWriter->SetObject(&(*geometry) );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
+
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
 
   return EXIT_SUCCESS;
 }
@@ -28,6 +28,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtksubselect, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // Generate file names
   itk::RegularExpressionSeriesFileNames::Pointer names = itk::RegularExpressionSeriesFileNames::New();
@@ -51,7 +52,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Output RTK geometry object
   typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
@@ -104,7 +107,9 @@ int main(int argc, char * argv[])
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.out_geometry_arg);
   xmlWriter->SetObject( &(*outputGeometry) );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -119,16 +124,20 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( outputProjectionsNames );
+  telemetry->Watch(reader.GetPointer(), "reader");
 
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.out_proj_arg );
   writer->SetInput( reader->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->UpdateOutputInformation() )
   writer->SetNumberOfStreamDivisions( 1 + reader->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() / (1024*1024*4) );
 
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
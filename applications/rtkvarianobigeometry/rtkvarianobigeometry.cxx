@@ -27,6 +27,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkvarianobigeometry, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // Generate file names of projections
   itk::RegularExpressionSeriesFileNames::Pointer names = itk::RegularExpressionSeriesFileNames::New();
@@ -40,14 +41,20 @@ int main(int argc, char * argv[])
   reader = rtk::VarianObiGeometryReader::New();
   reader->SetXMLFileName(args_info.xml_file_arg);
   reader->SetProjectionsFileNames(names->GetFileNames());
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->UpdateOutputData() );
+  telemetry->StopStage();
 
   // Write
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.output_arg);
   xmlWriter->SetObject( reader->GetGeometry() );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
+
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
 
   return EXIT_SUCCESS;
 }
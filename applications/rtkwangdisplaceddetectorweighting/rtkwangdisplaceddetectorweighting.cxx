@@ -29,6 +29,7 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkwangdisplaceddetectorweighting, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -52,6 +53,7 @@ int main(int argc, char * argv[])
   typedef rtk::ProjectionsReader< OutputImageType > ReaderType;
   ReaderType::Pointer reader = ReaderType::New();
   reader->SetFileNames( names->GetFileNames() );
+  telemetry->Watch(reader.GetPointer(), "reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->GenerateOutputInformation() )
 
   // Geometry
@@ -63,7 +65,9 @@ int main(int argc, char * argv[])
   rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geometryReader;
   geometryReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
   geometryReader->SetFilename(args_info.geometry_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( geometryReader->GenerateOutputInformation() )
+  telemetry->StopStage();
 
   // Displaced detector weighting
   typedef rtk::DisplacedDetectorImageFilter< OutputImageType > DDFType;
@@ -72,14 +76,18 @@ int main(int argc, char * argv[])
   ddf->SetGeometry( geometryReader->GetOutputObject() );
   if(args_info.minOffset_given && args_info.maxOffset_given)
     ddf->SetOffsets( args_info.minOffset_arg, args_info.maxOffset_arg );
+  telemetry->Watch(ddf.GetPointer(), "displaced detector weighting");
 
   // Write
   typedef itk::ImageFileWriter<  OutputImageType > WriterType;
   WriterType::Pointer writer = WriterType::New();
   writer->SetFileName( args_info.output_arg );
   writer->SetInput( ddf->GetOutput() );
+  telemetry->Watch(writer.GetPointer(), "writer");
   writer->SetNumberOfStreamDivisions( args_info.divisions_arg );
   TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
 
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
+
   return EXIT_SUCCESS;
 }
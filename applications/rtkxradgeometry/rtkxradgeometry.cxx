@@ -24,18 +24,25 @@
 int main(int argc, char * argv[])
 {
   GGO(rtkxradgeometry, args_info);
+  rtk::Telemetry::Pointer telemetry = rtk::CreateTelemetryFromGgo(args_info);
 
   // Create geometry reader
   rtk::XRadGeometryReader::Pointer reader = rtk::XRadGeometryReader::New();
   reader->SetImageFileName(args_info.input_arg);
+  telemetry->StartStage("geometry reader");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->UpdateOutputData() );
+  telemetry->StopStage();
 
   // Write
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
     rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
   xmlWriter->SetFilename(args_info.output_arg);
   xmlWriter->SetObject( reader->GetGeometry() );
+  telemetry->StartStage("geometry writer");
   TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  telemetry->StopStage();
+
+  rtk::WriteTelemetryFromGgo(telemetry.GetPointer(), args_info);
 
   return EXIT_SUCCESS;
 }
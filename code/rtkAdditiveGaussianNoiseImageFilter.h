@@ -35,99 +35,11 @@
 #define __rtkAdditiveGaussianNoiseImageFilter_h
 
 #include <itkImageToImageFilter.h>
-#include "itkNormalVariateGenerator.h"
-#include "itkUnaryFunctorImageFilter.h"
 
-namespace rtk
-{
+#include "rtkPhilox.h"
 
-/** \class NormalVariateNoiseFunctor
-*
-* \brief Pixel functor that adds Gaussian noise.
-*
-* \author Gavin Baker: gavinb at cs_mu_oz_au
-*/
-template < class TPixel >
-class NormalVariateNoiseFunctor
+namespace rtk
 {
-public:
-
-  NormalVariateNoiseFunctor()
-  {
-    m_Mean = 0.0;
-    m_StandardDeviation = 1.0;
-
-    m_Generator = itk::Statistics::NormalVariateGenerator::New();
-
-    this->SetSeed( 42 );
-  }
-
-  float GetMean() const
-  {
-    return m_Mean;
-  }
-
-  void SetMean( float mean )
-  {
-    m_Mean = mean;
-  }
-
-  float GetStandardDeviation() const
-  {
-    return m_StandardDeviation;
-  }
-
-  void SetStandardDeviation( float stddev )
-  {
-    m_StandardDeviation = stddev;
-  }
-
-  void SetSeed( unsigned long seed )
-  {
-    m_Generator->Initialize( seed );
-  }
-  
-  void SetOutputMinimum( TPixel min ) {
-    m_OutputMinimum = min;
-  }
-
-  void SetOutputMaximum( TPixel max ) {
-    m_OutputMaximum = max;
-  }
-
-  TPixel GetOutputMinimum() const {
-    return m_OutputMinimum;
-  }
-
-  TPixel GetOutputMaximum() const {
-    return m_OutputMaximum;
-  }
-
-  TPixel operator()( TPixel input )
-  {
-    // Get the minimum and maximum output values
-    static const float min = static_cast<float>( m_OutputMinimum );
-    static const float max = static_cast<float>( m_OutputMaximum );
-
-    // Compute the output
-    float output = static_cast<float>( input ) +
-      m_Mean + m_StandardDeviation * m_Generator->GetVariate();
-
-    // Clamp the output value in valid range
-    output = ( output < min ? min : output );
-    output = ( output > max ? max : output );
-
-    return static_cast< TPixel > ( output );
-  }
-
-private:
-  TPixel                                           m_OutputMinimum;
-  TPixel                                           m_OutputMaximum;
-  float                                            m_Mean;
-  float                                            m_StandardDeviation;
-  itk::Statistics::NormalVariateGenerator::Pointer m_Generator;
-};
-
 
 /** \class AdditiveGaussianNoiseImageFilter
  * \brief Adds Gaussian noise to the input image
@@ -143,7 +55,27 @@ private:
  * where G() is the Gaussian generator and d is the seed.  A particular seed
  * can be specified in order to perform repeatable tests.
  *
- * \test rtkrampfiltertest.cxx
+ * Alternatively, if the number of incident photons \f$I_0\f$ is strictly
+ * positive, the input is considered as a stack of line integrals and
+ * the photon noise of the detector is simulated. The number of detected
+ * photons \f$N\f$ follows a Poisson distribution of mean
+ * \f$I_0\exp(-v_{in})\f$ and
+ *
+ * \f[
+ *     v_{out} = \log(I_0) - \log(\max(N, 1))
+ * \f]
+ *
+ * The random numbers are drawn with the counter-based generator Philox4x32
+ * keyed on the seed, with the index of the pixel in the largest possible
+ * region as counter. The output therefore only depends on the seed and the
+ * input, not on the number of threads or on the requested region, and the
+ * filter is multithreaded. The Gaussian variates are computed with the
+ * Box-Muller transform, four pixels sharing one draw of the generator. The
+ * Poisson variates are computed with the multiplication method for means
+ * below 10 and the transformed rejection method with squeeze of
+ * [Hormann, Insurance Math Econom, 1993] otherwise.
+ *
+ * \test rtkrampfiltertest.cxx, rtkmediantest.cxx, rtknoisetest.cxx
  *
  * \author Gavin Baker: gavinb at cs_mu_oz_au
  *
@@ -182,95 +114,46 @@ public:
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       TInputImage::ImageDimension);
 
-  // virtual void GenerateOutputInformation();
-
-  virtual void GenerateData();
-
   // Accessor & Mutator methods
 
   /**
    *    Specifies the average noise added to the image per pixel.
    *    The default is 0.
    */
-  void SetMean( float mean )
-  {
-    m_NoiseFilter->GetFunctor().SetMean( mean );
-    this->Modified();
-  }
-
-  /**
-   *    Returns the average noise added to the image per pixel.
-   *    The default is 0.
-   */
-  float GetMean() const
-  {
-    return m_NoiseFilter->GetFunctor().GetMean();
-  }
+  itkSetMacro(Mean, float);
+  itkGetConstMacro(Mean, float);
 
   /**
    *    Specifies the standard deviation of the noise added to the image.
    *    The default is 1.
    */
-  void SetStandardDeviation( float stddev )
-  {
-    m_NoiseFilter->GetFunctor().SetStandardDeviation( stddev );
-    this->Modified();
-  }
+  itkSetMacro(StandardDeviation, float);
+  itkGetConstMacro(StandardDeviation, float);
 
   /**
-   *    Returns the standard deviation of the noise added to the image.
-   *    The default is 1.
+   *    Specifies the seed of the random generator.  The same seed
+   *    will produce the same output, whatever the number of threads,
+   *    which can be used to reproduce results.  For a higher dose of
+   *    entropy, initialise with the current system time (in ms).
    */
-  float GetStandardDeviation() const
-  {
-    return m_NoiseFilter->GetFunctor().GetStandardDeviation();
-  }
+  itkSetMacro(Seed, unsigned long);
+  itkGetConstMacro(Seed, unsigned long);
 
   /**
-   *    Specifies the seed for the normal variate generator.  The same seed
-   *    will produce the same pseduo-random sequence, which can be used to
-   *    reproduce results.  For a higher dose of entropy, initialise with
-   *    the current system time (in ms).
+   *    Number of incident photons per pixel. If strictly positive, Poisson
+   *    noise of the detected photons is simulated instead of the additive
+   *    Gaussian noise. The default is 0.
    */
-  void SetSeed( unsigned long seed )
-  {
-    m_NoiseFilter->GetFunctor().SetSeed( seed );
-    this->Modified();
-  }
-
-  /** Set the minimum output value. */
-  void SetOutputMinimum( InputImagePixelType min )
-  {
-    if( min == m_NoiseFilter->GetFunctor().GetOutputMinimum() )
-      {
-      return;
-      }
-    m_NoiseFilter->GetFunctor().SetOutputMinimum( min );
-    this->Modified();
-  }
+  itkSetMacro(NumberOfIncidentPhotons, double);
+  itkGetConstMacro(NumberOfIncidentPhotons, double);
 
-  /** Get the minimum output value. */
-  InputImagePixelType GetOutputMinimum( )
-  {
-    return m_NoiseFilter->GetFunctor().GetOutputMinimum();
-  }
+  /** Set / Get the minimum output value. */
+  itkSetMacro(OutputMinimum, InputImagePixelType);
+  itkGetConstMacro(OutputMinimum, InputImagePixelType);
 
-  /** Set the maximum output value. */
-  void SetOutputMaximum( InputImagePixelType max )
-  {
-    if( max == m_NoiseFilter->GetFunctor().GetOutputMaximum() ) 
-      {
-      return;
-      }
-    m_NoiseFilter->GetFunctor().SetOutputMaximum( max );
-    this->Modified();
-  }
-
-  /** Get the maximum output value. */
-  InputImagePixelType GetOutputMaximum( )
-  {
-    return m_NoiseFilter->GetFunctor().GetOutputMaximum();
-  }
+  /** Set / Get the maximum output value. */
+  itkSetMacro(OutputMaximum, InputImagePixelType);
+  itkGetConstMacro(OutputMaximum, InputImagePixelType);
 
 protected:
 
@@ -278,20 +161,22 @@ protected:
 
   virtual void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
+  virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
+
+  /** Poisson variate of mean lambda drawn from stream */
+  static double GetPoissonVariate(const double lambda, Philox4x32Stream &stream);
+
 private:
 
   AdditiveGaussianNoiseImageFilter(const Self&);  // intentionally not implemented
   void operator=(const Self&);      // intentionally not implemented
 
-public:
-
-  typedef itk::UnaryFunctorImageFilter< InputImageType, InputImageType,
-                                       NormalVariateNoiseFunctor< typename InputImageType::PixelType > >
-                                       NoiseFilterType;
-
-private:
-
-  typename NoiseFilterType::Pointer m_NoiseFilter;
+  float               m_Mean;
+  float               m_StandardDeviation;
+  unsigned long       m_Seed;
+  double              m_NumberOfIncidentPhotons;
+  InputImagePixelType m_OutputMinimum;
+  InputImagePixelType m_OutputMaximum;
 };
 
 } /* end namespace rtk */
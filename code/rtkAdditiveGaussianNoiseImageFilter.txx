@@ -39,35 +39,150 @@ PURPOSE. See the above copyright notices for more information.
 
 #include "rtkAdditiveGaussianNoiseImageFilter.h"
 
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <vnl/vnl_math.h>
+#include <vnl/vnl_gamma.h>
+
 namespace rtk
 {
 
 template <class TInputImage>
 AdditiveGaussianNoiseImageFilter<TInputImage>
-::AdditiveGaussianNoiseImageFilter()
+::AdditiveGaussianNoiseImageFilter():
+  m_Mean(0.),
+  m_StandardDeviation(1.),
+  m_Seed(42),
+  m_NumberOfIncidentPhotons(0.)
 {
-  m_NoiseFilter = NoiseFilterType::New();
-  m_NoiseFilter->GetFunctor().SetOutputMinimum( itk::NumericTraits< InputPixelType >::min() );
-  m_NoiseFilter->GetFunctor().SetOutputMaximum( itk::NumericTraits< InputPixelType >::max() );
+  m_OutputMinimum = itk::NumericTraits< InputPixelType >::min();
+  m_OutputMaximum = itk::NumericTraits< InputPixelType >::max();
 }
 
-
 template <class TInputImage>
 void
 AdditiveGaussianNoiseImageFilter<TInputImage>
-::GenerateData()
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
 {
-  this->AllocateOutputs();
-
-  // Set the global max number of threads to 1
-  // NOTE: This is required because there is a bug with this filter,
-  // it appears the NormalVariateGenerate is single threaded only.
-  m_NoiseFilter->SetNumberOfThreads(1);
+  const InputImageType *input = this->GetInput();
+  InputImageType *output = this->GetOutput();
+
+  // Seed of 64 bits at most
+  const uint64_t seed = m_Seed;
+  const uint32_t key[2] = { uint32_t(seed), uint32_t(seed >> 32) };
+
+  const double min = static_cast<double>( m_OutputMinimum );
+  const double max = static_cast<double>( m_OutputMaximum );
+  const double logI0 = (m_NumberOfIncidentPhotons>0.)?vcl_log(m_NumberOfIncidentPhotons):0.;
+
+  // The counter of the random generator is the index of the pixel in the
+  // largest possible region
+  const InputImageRegionType largest = output->GetLargestPossibleRegion();
+
+  // Process row by row
+  OutputImageRegionType rows = outputRegionForThread;
+  rows.SetSize(0, 1);
+  itk::ImageRegionConstIteratorWithIndex<InputImageType> it(output, rows);
+  const unsigned int rowLength = outputRegionForThread.GetSize(0);
+  for(; !it.IsAtEnd(); ++it)
+    {
+    const typename InputImageType::IndexType index = it.GetIndex();
+    uint64_t pixel = 0;
+    uint64_t stride = 1;
+    for(unsigned int i=0; i<InputImageDimension; i++)
+      {
+      pixel += (index[i] - largest.GetIndex(i)) * stride;
+      stride *= largest.GetSize(i);
+      }
+    const InputPixelType *in = input->GetBufferPointer() + input->ComputeOffset(index);
+    InputPixelType *out = output->GetBufferPointer() + output->ComputeOffset(index);
+
+    if(m_NumberOfIncidentPhotons>0.)
+      {
+      for(unsigned int i=0; i<rowLength; i++, pixel++)
+        {
+        Philox4x32Stream stream(key, pixel, 1);
+        const double lambda = m_NumberOfIncidentPhotons * vcl_exp( -static_cast<double>(in[i]) );
+        const double n = vnl_math_max(GetPoissonVariate(lambda, stream), 1.);
+        double v = logI0 - vcl_log(n);
+        v = vnl_math_min(vnl_math_max(v, min), max);
+        out[i] = static_cast<InputPixelType>(v);
+        }
+      }
+    else
+      {
+      // Box-Muller on two pairs of uniform variates gives four Gaussian
+      // variates which are used for four consecutive pixels
+      uint64_t block = pixel >> 2;
+      double normal[4];
+      bool blockValid = false;
+      for(unsigned int i=0; i<rowLength; i++, pixel++)
+        {
+        if(!blockValid || (pixel>>2) != block)
+          {
+          block = pixel >> 2;
+          const uint32_t counter[4] = { uint32_t(block), uint32_t(block >> 32), 0, 0 };
+          uint32_t bits[4];
+          Philox4x32::Generate(counter, key, bits);
+          for(unsigned int j=0; j<4; j+=2)
+            {
+            const double r = vcl_sqrt( -2. * vcl_log( Philox4x32::ToUniform(bits[j]) ) );
+            const double theta = 2. * vnl_math::pi * Philox4x32::ToUniform(bits[j+1]);
+            normal[j] = r * vcl_cos(theta);
+            normal[j+1] = r * vcl_sin(theta);
+            }
+          blockValid = true;
+          }
+        double v = static_cast<double>(in[i]) + m_Mean + m_StandardDeviation * normal[pixel&3];
+        v = vnl_math_min(vnl_math_max(v, min), max);
+        out[i] = static_cast<InputPixelType>(v);
+        }
+      }
+    }
+}
 
-  // Setup grafted pipeline for composite filter
-  m_NoiseFilter->SetInput( this->GetInput() );
-  m_NoiseFilter->Update();
-  this->GraftOutput( m_NoiseFilter->GetOutput() );
+template <class TInputImage>
+double
+AdditiveGaussianNoiseImageFilter<TInputImage>
+::GetPoissonVariate(const double lambda, Philox4x32Stream &stream)
+{
+  if(lambda <= 0.)
+    return 0.;
+
+  if(lambda < 10.)
+    {
+    // Multiplication of uniform variates until exp(-lambda) is reached
+    const double expMinusLambda = vcl_exp(-lambda);
+    double k = 0.;
+    double p = stream.GetUniform();
+    while(p > expMinusLambda)
+      {
+      p *= stream.GetUniform();
+      k++;
+      }
+    return k;
+    }
+
+  // Transformed rejection with squeeze (PTRS)
+  const double sqrtLambda = vcl_sqrt(lambda);
+  const double logLambda = vcl_log(lambda);
+  const double b = 0.931 + 2.53 * sqrtLambda;
+  const double a = -0.059 + 0.02483 * b;
+  const double invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+  const double vr = 0.9277 - 3.6224 / (b - 2.);
+  while(true)
+    {
+    const double u = stream.GetUniform() - 0.5;
+    const double v = stream.GetUniform();
+    const double us = 0.5 - vcl_abs(u);
+    const double k = vcl_floor( (2. * a / us + b) * u + lambda + 0.43 );
+    if(us >= 0.07 && v <= vr)
+      return k;
+    if(k < 0. || (us < 0.013 && v > us))
+      continue;
+    if( vcl_log(v) + vcl_log(invAlpha) - vcl_log(a / (us * us) + b) <=
+        -lambda + k * logLambda - vnl_log_gamma(k + 1.) )
+      return k;
+    }
 }
 
 template <class TInputImage>
@@ -80,6 +195,8 @@ itk::Indent indent) const
   << indent << "AdditiveGaussianNoiseImageFilter"
   << "\n Mean: " << this->GetMean()
   << "\n StandardDeviation: " << this->GetStandardDeviation()
+  << "\n Seed: " << this->GetSeed()
+  << "\n NumberOfIncidentPhotons: " << this->GetNumberOfIncidentPhotons()
   << std::endl;
 }
 
@@ -21,16 +21,6 @@
 
 #include <itkImageToImageFilter.h>
 #include <itkRecursiveGaussianImageFilter.h>
-#if ITK_VERSION_MAJOR <= 3
-#  include <itkMultiplyByConstantImageFilter.h>
-#else
-#  include <itkMultiplyImageFilter.h>
-#endif
-#include <itkThresholdImageFilter.h>
-#include <itkSumProjectionImageFilter.h>
-#include <itkConvolutionImageFilter.h>
-#include <itkSubtractImageFilter.h>
-#include <itkPermuteAxesImageFilter.h>
 
 namespace rtk
 {
@@ -43,6 +33,13 @@ namespace rtk
  * is the cranio-caudal position. More information is available in
  * [Zijp, ICCR, 2004], [Sonke, Med Phys, 2005] and [Rit, IJROBP, 2012].
  *
+ * Each projection is processed independently in a single pass: the first
+ * order Gaussian derivative along the cranio-caudal direction is computed
+ * line by line, negated, clamped to non-positive values and summed along the
+ * rows of the projection. The unsharp mask is then applied to the summed line
+ * with a running-sum moving average. No intermediate image is allocated and
+ * the output can be streamed along the time direction.
+ *
  * \test rtkamsterdamshroudtest.cxx
  *
  * \author Simon Rit
@@ -60,6 +57,7 @@ public:
   typedef itk::ImageToImageFilter<TInputImage, TOutputImage>    Superclass;
   typedef itk::SmartPointer<Self>                               Pointer;
   typedef itk::SmartPointer<const Self>                         ConstPointer;
+  typedef typename TOutputImage::RegionType                     OutputImageRegionType;
 
   /** ImageDimension constants */
   itkStaticConstMacro(InputImageDimension, unsigned int,
@@ -73,7 +71,7 @@ public:
   itkNewMacro(Self);
 
   /** Size parameter of the unsharp mask. This is the number of pixels along the
-   * time direction (X) along which it averages. The unsharp mask allows after
+   * X direction of the shroud along which it averages. The unsharp mask allows after
    * computation of the shroud to enhance fast varying motions, e.g., breathing,
    * and remove slow varying motions, e.g., rotation around the table. The default
    * value is 17 pixels. */
@@ -88,36 +86,41 @@ protected:
 
   void GenerateOutputInformation();
   void GenerateInputRequestedRegion();
-  void UpdateUnsharpMaskKernel();
 
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to other filters. */
-  void GenerateData();
+  /** The shroud of a projection is computed from the whole projection */
+  virtual void EnlargeOutputRequestedRegion(itk::DataObject *itkNotUsed(output));
+
+  virtual void BeforeThreadedGenerateData();
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId);
 
 private:
   AmsterdamShroudImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);             //purposely not implemented
 
-  typedef itk::RecursiveGaussianImageFilter< TInputImage, TInputImage >          DerivativeType;
-#if ITK_VERSION_MAJOR <= 3
-  typedef itk::MultiplyByConstantImageFilter< TInputImage, double, TInputImage > NegativeType;
-#else
-  typedef itk::MultiplyImageFilter< TInputImage, TInputImage, TInputImage >      NegativeType;
-#endif
-  typedef itk::ThresholdImageFilter< TInputImage >                               ThresholdType;
-  typedef itk::SumProjectionImageFilter< TInputImage, TOutputImage >             SumType;
-  typedef itk::ConvolutionImageFilter< TOutputImage, TOutputImage >              ConvolutionType;
-  typedef itk::SubtractImageFilter< TOutputImage, TOutputImage >                 SubtractType;
-  typedef itk::PermuteAxesImageFilter< TOutputImage >                            PermuteType;
-
-  typename DerivativeType::Pointer  m_DerivativeFilter;
-  typename NegativeType::Pointer    m_NegativeFilter;
-  typename ThresholdType::Pointer   m_ThresholdFilter;
-  typename SumType::Pointer         m_SumFilter;
-  typename ConvolutionType::Pointer m_ConvolutionFilter;
-  typename SubtractType::Pointer    m_SubtractFilter;
-  typename PermuteType::Pointer     m_PermuteFilter;
-  unsigned int                      m_UnsharpMaskSize;
+  /** Gives access to the filtering of a single line by the recursive Gaussian
+   * filter which is otherwise only used internally by itk::RecursiveGaussianImageFilter. */
+  class DerivativeType : public itk::RecursiveGaussianImageFilter<TInputImage, TInputImage>
+  {
+  public:
+    typedef DerivativeType                                           Self;
+    typedef itk::RecursiveGaussianImageFilter<TInputImage, TInputImage> Superclass;
+    typedef itk::SmartPointer<Self>                                  Pointer;
+    typedef typename Superclass::RealType                            RealType;
+
+    itkNewMacro(Self);
+
+    void SetUpForSpacing(double spacing) { this->SetUp(spacing); }
+    void FilterLine(RealType *outs, const RealType *data, RealType *scratch, unsigned int ln)
+      {
+      this->FilterDataArray(outs, data, scratch, ln);
+      }
+  protected:
+    DerivativeType(){}
+    ~DerivativeType(){}
+  };
+
+  typename DerivativeType::Pointer m_DerivativeFilter;
+  unsigned int                     m_UnsharpMaskSize;
 }; // end of class
 
 } // end namespace rtk
@@ -19,7 +19,9 @@
 #ifndef __rtkAmsterdamShroudImageFilter_txx
 #define __rtkAmsterdamShroudImageFilter_txx
 
-#include <itkImageFileWriter.h>
+#include <vector>
+#include <algorithm>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 namespace rtk
 {
@@ -30,42 +32,9 @@ AmsterdamShroudImageFilter<TInputImage>
   m_UnsharpMaskSize(17)
 {
   m_DerivativeFilter = DerivativeType::New();
-  m_NegativeFilter = NegativeType::New();
-  m_ThresholdFilter = ThresholdType::New();
-  m_SumFilter = SumType::New();
-  m_ConvolutionFilter = ConvolutionType::New();
-  m_SubtractFilter = SubtractType::New();
-  m_PermuteFilter = PermuteType::New();
-
-  m_NegativeFilter->SetInput( m_DerivativeFilter->GetOutput() );
-  m_ThresholdFilter->SetInput( m_NegativeFilter->GetOutput() );
-  m_SumFilter->SetInput( m_ThresholdFilter->GetOutput() );
-  m_ConvolutionFilter->SetInput( m_SumFilter->GetOutput() );
-  m_SubtractFilter->SetInput1( m_SumFilter->GetOutput() );
-  m_SubtractFilter->SetInput2( m_ConvolutionFilter->GetOutput() );
-  m_PermuteFilter->SetInput( m_SubtractFilter->GetOutput() );
-
   m_DerivativeFilter->SetOrder(DerivativeType::FirstOrder);
   m_DerivativeFilter->SetDirection(1);
   m_DerivativeFilter->SetSigma(4);
-
-  m_NegativeFilter->SetConstant(-1.0);
-  m_NegativeFilter->InPlaceOn();
-
-  m_ThresholdFilter->SetUpper(0.0);
-  m_ThresholdFilter->SetOutsideValue(0.0);
-  m_ThresholdFilter->InPlaceOn();
-
-  m_SumFilter->SetProjectionDimension(0);
-
-  // The permute filter is used to allow streaming because ITK splits the output image in the last direction
-  typename PermuteType::PermuteOrderArrayType order;
-  order[0] = 1;
-  order[1] = 0;
-  m_PermuteFilter->SetOrder(order);
-
-  // Create default kernel
-  UpdateUnsharpMaskKernel();
 }
 
 template <class TInputImage>
@@ -82,9 +51,26 @@ AmsterdamShroudImageFilter<TInputImage>
     return;
     }
 
-  m_DerivativeFilter->SetInput( this->GetInput() );
-  m_PermuteFilter->UpdateOutputInformation();
-  outputPtr->SetLargestPossibleRegion( m_PermuteFilter->GetOutput()->GetLargestPossibleRegion() );
+  // The shroud drops the first dimension of the input. Its X-axis is the
+  // second dimension of the projections and its Y-axis the projection number.
+  const typename TInputImage::RegionType inRegion = inputPtr->GetLargestPossibleRegion();
+  typename TOutputImage::RegionType outRegion;
+  typename TOutputImage::SpacingType outSpacing;
+  typename TOutputImage::PointType outOrigin;
+  typename TOutputImage::DirectionType outDirection;
+  for(unsigned int i=0; i<OutputImageDimension; i++)
+    {
+    outRegion.SetIndex(i, inRegion.GetIndex(i+1));
+    outRegion.SetSize(i, inRegion.GetSize(i+1));
+    outSpacing[i] = inputPtr->GetSpacing()[i+1];
+    outOrigin[i] = inputPtr->GetOrigin()[i+1];
+    for(unsigned int j=0; j<OutputImageDimension; j++)
+      outDirection[i][j] = inputPtr->GetDirection()[i+1][j+1];
+    }
+  outputPtr->SetLargestPossibleRegion( outRegion );
+  outputPtr->SetSpacing( outSpacing );
+  outputPtr->SetOrigin( outOrigin );
+  outputPtr->SetDirection( outDirection );
 }
 
 template <class TInputImage>
@@ -98,48 +84,110 @@ AmsterdamShroudImageFilter<TInputImage>
     {
     return;
     }
-  m_DerivativeFilter->SetInput( this->GetInput() );
-  m_PermuteFilter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion() );
+
+  // Whole projections are required for the requested projection numbers
+  typename TInputImage::RegionType reqRegion = inputPtr->GetLargestPossibleRegion();
+  const typename TOutputImage::RegionType &outReqRegion = this->GetOutput()->GetRequestedRegion();
+  reqRegion.SetIndex(InputImageDimension-1, outReqRegion.GetIndex(OutputImageDimension-1));
+  reqRegion.SetSize(InputImageDimension-1, outReqRegion.GetSize(OutputImageDimension-1));
+  inputPtr->SetRequestedRegion( reqRegion );
+}
+
+template <class TInputImage>
+void
+AmsterdamShroudImageFilter<TInputImage>
+::EnlargeOutputRequestedRegion(itk::DataObject *itkNotUsed(output))
+{
+  typename TOutputImage::RegionType reqRegion = this->GetOutput()->GetRequestedRegion();
+  const typename TOutputImage::RegionType &largest = this->GetOutput()->GetLargestPossibleRegion();
+  for(unsigned int i=0; i<OutputImageDimension-1; i++)
+    {
+    reqRegion.SetIndex(i, largest.GetIndex(i));
+    reqRegion.SetSize(i, largest.GetSize(i));
+    }
+  this->GetOutput()->SetRequestedRegion( reqRegion );
 }
 
 template<class TInputImage>
 void
 AmsterdamShroudImageFilter<TInputImage>
-::GenerateData()
+::BeforeThreadedGenerateData()
 {
-  unsigned int kernelWidth;
-#if ITK_VERSION_MAJOR <= 3
-  kernelWidth = m_ConvolutionFilter->GetImageKernelInput()->GetLargestPossibleRegion().GetSize()[1];
-#else
-  kernelWidth = m_ConvolutionFilter->GetKernelImage()->GetLargestPossibleRegion().GetSize()[1];
-#endif
-  if(kernelWidth != m_UnsharpMaskSize)
-    UpdateUnsharpMaskKernel();
-  m_PermuteFilter->Update();
-  this->GraftOutput( m_PermuteFilter->GetOutput() );
+  if(m_UnsharpMaskSize == 0)
+    itkExceptionMacro(<< "The unsharp mask size must be strictly positive.");
+  if(this->GetInput()->GetRequestedRegion().GetSize(1) < 4)
+    itkExceptionMacro(<< "The number of pixels along direction 1 is less than 4. "
+                      << "This filter requires a minimum of four pixels along the derivative direction.");
+
+  // Recursive Gaussian coefficients, shared read-only by all threads
+  m_DerivativeFilter->SetUpForSpacing( this->GetInput()->GetSpacing()[1] );
 }
 
 template<class TInputImage>
 void
 AmsterdamShroudImageFilter<TInputImage>
-::UpdateUnsharpMaskKernel()
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
 {
-  // Unsharp mask: difference between image and moving average
-  // m_ConvolutionFilter computes the moving average
-  typename TOutputImage::Pointer kernel = TOutputImage::New();
-  typename TOutputImage::RegionType region;
-  region.SetIndex(0, 0);
-  region.SetIndex(1, (int)m_UnsharpMaskSize/-2);
-  region.SetSize(0, 1);
-  region.SetSize(1, m_UnsharpMaskSize);
-  kernel->SetRegions(region);
-  kernel->Allocate();
-  kernel->FillBuffer(1./m_UnsharpMaskSize);
-  #if ITK_VERSION_MAJOR <= 3
-  m_ConvolutionFilter->SetImageKernelInput( kernel );
-  #else
-  m_ConvolutionFilter->SetKernelImage( kernel );
-  #endif
+  typedef typename DerivativeType::RealType     RealType;
+  typedef typename TInputImage::PixelType       InputPixelType;
+
+  const TInputImage *input = this->GetInput();
+  TOutputImage *output = this->GetOutput();
+  const unsigned int nx = input->GetRequestedRegion().GetSize(0);
+  const unsigned int ny = input->GetRequestedRegion().GetSize(1);
+  const typename TInputImage::OffsetValueType yStride = input->GetOffsetTable()[1];
+
+  // Line buffers of the thread. The sum is the shroud line of a projection
+  // before the unsharp mask.
+  std::vector<RealType> inps(ny), outs(ny), scratch(ny);
+  std::vector<double> sum(ny);
+
+  // Unsharp mask window [y+lo, y+hi] with zero flux Neumann boundaries
+  const int lo = -int(m_UnsharpMaskSize/2);
+  const int hi = lo + int(m_UnsharpMaskSize) - 1;
+  const int last = int(ny) - 1;
+  const double invSize = 1./m_UnsharpMaskSize;
+
+  // Iterate over the first pixel of each projection
+  typename TInputImage::RegionType projRegion = input->GetRequestedRegion();
+  projRegion.SetIndex(InputImageDimension-1, outputRegionForThread.GetIndex(OutputImageDimension-1));
+  projRegion.SetSize(InputImageDimension-1, outputRegionForThread.GetSize(OutputImageDimension-1));
+  for(unsigned int i=0; i<InputImageDimension-1; i++)
+    projRegion.SetSize(i, 1);
+  typedef itk::ImageRegionConstIteratorWithIndex<TInputImage> InputIteratorType;
+  InputIteratorType itProj(input, projRegion);
+  for(; !itProj.IsAtEnd(); ++itProj)
+    {
+    const InputPixelType *proj = input->GetBufferPointer() + input->ComputeOffset(itProj.GetIndex());
+
+    // Derivative, negation, clamping and summation along the rows
+    std::fill(sum.begin(), sum.end(), 0.);
+    for(unsigned int x=0; x<nx; x++)
+      {
+      for(unsigned int y=0; y<ny; y++)
+        inps[y] = proj[x + y*yStride];
+      m_DerivativeFilter->FilterLine(&outs[0], &inps[0], &scratch[0], ny);
+      for(unsigned int y=0; y<ny; y++)
+        {
+        const InputPixelType negDerivative = -static_cast<InputPixelType>(outs[y]);
+        sum[y] += vnl_math_min(negDerivative, InputPixelType(0));
+        }
+      }
+
+    // Unsharp mask with a running sum
+    typename TOutputImage::IndexType outIdx;
+    outIdx[0] = output->GetRequestedRegion().GetIndex(0);
+    outIdx[1] = itProj.GetIndex()[InputImageDimension-1];
+    double *shroud = output->GetBufferPointer() + output->ComputeOffset(outIdx);
+    double window = 0.;
+    for(int k=lo; k<=hi; k++)
+      window += sum[vnl_math_min(vnl_math_max(k, 0), last)];
+    for(int y=0; y<int(ny); y++)
+      {
+      shroud[y] = sum[y] - window * invSize;
+      window += sum[vnl_math_min(y+hi+1, last)] - sum[vnl_math_max(y+lo, 0)];
+      }
+    }
 }
 
 } // end namespace rtk
@@ -24,6 +24,8 @@
 #include <itkInPlaceImageFilter.h>
 #include <itkConceptChecking.h>
 #include "rtkProjectionGeometry.h"
+#include "rtkFieldOfViewSpanTable.h"
+#include "rtkWorkStealingScheduler.h"
 
 namespace rtk
 {
@@ -36,6 +38,19 @@ namespace rtk
  * is voxel-based, meaning that the center of each voxel is projected in the
  * projection images to determine the interpolation location.
  *
+ * The volume is split in TilesPerThread tiles per thread which are processed
+ * by a rtk::WorkStealingScheduler. The projections are then extracted once
+ * by GenerateData for all tiles instead of once per thread. When threads are
+ * pinned on several NUMA nodes and the replication of read-only data is
+ * enabled (see rtk::ThreadAffinity), the projections are extracted once per
+ * node by threads of this node and each thread reads the copy of its node.
+ *
+ * This copy of the stack doubles the peak memory of the projections, or more
+ * with per node copies. If it exceeds ProjectionsCacheMaximumBytes, the
+ * static split of itk::ImageSource is used instead: each thread then extracts
+ * one projection at a time, which bounds the memory but loses the balancing
+ * of the tiles.
+ *
  * \test rtkfovtest.cxx
  *
  * \author Simon Rit
@@ -44,7 +59,8 @@ namespace rtk
  */
 template <class TInputImage, class TOutputImage>
 class BackProjectionImageFilter :
-  public itk::InPlaceImageFilter<TInputImage,TOutputImage>
+  public itk::InPlaceImageFilter<TInputImage,TOutputImage>,
+  protected WorkStealingScheduler::TileProcessor
 {
 public:
   /** Standard class typedefs. */
@@ -75,9 +91,28 @@ public:
   itkGetMacro(Transpose, bool);
   itkSetMacro(Transpose, bool);
 
+  /** Get / Set an optional table of the voxels in the field of view, see
+   * rtk::FieldOfViewImageFilter::ComputeSpanTable. Voxels outside the span of
+   * their row are not backprojected and keep their input value. It is only
+   * used by the CPU backprojectors. */
+  itkGetObjectMacro(FieldOfViewSpanTable, FieldOfViewSpanTable);
+  itkSetObjectMacro(FieldOfViewSpanTable, FieldOfViewSpanTable);
+
+  /** Get / Set the number of tiles per thread, 8 by default. 0 restores the
+   * static split of itk::ImageSource, without the copy of the projections. */
+  itkGetMacro(TilesPerThread, unsigned int);
+  itkSetMacro(TilesPerThread, unsigned int);
+
+  /** Get / Set the maximum size in bytes of the copies of the projections
+   * used with tiles, 1 GiB by default. Above, the static split is used. */
+  itkGetMacro(ProjectionsCacheMaximumBytes, size_t);
+  itkSetMacro(ProjectionsCacheMaximumBytes, size_t);
+
 protected:
-  BackProjectionImageFilter() : m_Geometry(NULL), m_Transpose(false) {
+  BackProjectionImageFilter() : m_Geometry(NULL), m_Transpose(false), m_TilesPerThread(8),
+    m_ProjectionsCacheMaximumBytes(size_t(1)<<30) {
     this->SetNumberOfRequiredInputs(2); this->SetInPlace( true );
+    m_Scheduler = WorkStealingScheduler::New();
   };
   virtual ~BackProjectionImageFilter() {
   }
@@ -85,6 +120,17 @@ protected:
   /** Apply changes to the input image requested region. */
   virtual void GenerateInputRequestedRegion();
 
+  /** Same as itk::ImageSource::GenerateData with a work stealing scheduler
+   * of the tiles if TilesPerThread is not 0 and the copies of the projections
+   * fit in ProjectionsCacheMaximumBytes. */
+  virtual void GenerateData();
+
+  /** Extracts the projections of the replica of the node of each thread. */
+  static ITK_THREAD_RETURN_TYPE ExtractProjectionsCallback(void *arg);
+
+  /** Calls ThreadedGenerateData on a tile. */
+  virtual void ProcessTile(const unsigned int tile, const ThreadIdType threadId);
+
   virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
 
   /** The two inputs should not be in the same space so there is nothing
@@ -112,6 +158,19 @@ private:
   /** Flip projection flag: infludences GetProjection and
     GetIndexToIndexProjectionMatrix for optimization */
   bool m_Transpose;
+
+  /** Optional field of view */
+  FieldOfViewSpanTable::Pointer m_FieldOfViewSpanTable;
+
+  /** Tiles of the output requested region and their scheduler */
+  unsigned int                        m_TilesPerThread;
+  std::vector<OutputImageRegionType>  m_Tiles;
+  WorkStealingScheduler::Pointer      m_Scheduler;
+
+  /** Projections extracted by GenerateData for all tiles, one replica per
+   * NUMA node, and their maximum size */
+  size_t                                             m_ProjectionsCacheMaximumBytes;
+  std::vector< std::vector<ProjectionImagePointer> > m_ProjectionsCache;
 };
 
 } // end namespace rtk
@@ -21,6 +21,7 @@
 
 #include "rtkHomogeneousMatrix.h"
 #include "rtkMacro.h"
+#include "rtkThreadAffinity.h"
 
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIteratorWithIndex.h>
@@ -135,6 +136,96 @@ BackProjectionImageFilter<TInputImage,TOutputImage>
     }
 }
 
+template <class TInputImage, class TOutputImage>
+void
+BackProjectionImageFilter<TInputImage,TOutputImage>
+::GenerateData()
+{
+  // The tiles share copies of the projections, the static split is used if
+  // they do not fit in the allowed memory
+  const unsigned int nReplicas = ThreadAffinity::GetNumberOfReplicas();
+  const double cacheBytes = double(nReplicas) * sizeof(InputPixelType) *
+                            this->GetInput(1)->GetBufferedRegion().GetNumberOfPixels();
+  if(!m_TilesPerThread || cacheBytes > m_ProjectionsCacheMaximumBytes)
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+
+  // Extract each projection once, after BeforeThreadedGenerateData which may
+  // set the transpose flag
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int nProj = this->GetInput(1)->GetBufferedRegion().GetSize(Dimension-1);
+  const unsigned int iFirstProj = this->GetInput(1)->GetBufferedRegion().GetIndex(Dimension-1);
+  std::vector< std::vector<ProjectionImagePointer> > projections(nReplicas, std::vector<ProjectionImagePointer>(nProj));
+  if(nReplicas==1)
+    {
+    for(unsigned int iProj=0; iProj<nProj; iProj++)
+      projections[0][iProj] = this->template GetProjection< ProjectionImageType >(iFirstProj+iProj);
+    }
+  else
+    {
+    // The pages of each replica are first touched by the threads of its node
+    std::pair<Self *, std::vector< std::vector<ProjectionImagePointer> > *> data(this, &projections);
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+    threader->SetSingleMethod(ExtractProjectionsCallback, &data);
+    threader->SingleMethodExecute();
+    }
+  m_ProjectionsCache.swap(projections);
+
+  m_Tiles = WorkStealingScheduler::SplitRegion(this->GetOutput()->GetRequestedRegion(),
+                                               m_TilesPerThread * this->GetNumberOfThreads() );
+  m_Scheduler->Execute(this, m_Tiles.size(), this->GetNumberOfThreads() );
+  m_Tiles.clear();
+  m_ProjectionsCache.clear();
+
+  this->AfterThreadedGenerateData();
+}
+
+template <class TInputImage, class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+BackProjectionImageFilter<TInputImage,TOutputImage>
+::ExtractProjectionsCallback(void *arg)
+{
+  typedef std::pair<Self *, std::vector< std::vector<ProjectionImagePointer> > *> DataType;
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(arg);
+  DataType *data = (DataType *)(info->UserData);
+  const ThreadIdType threadId = info->ThreadID;
+  const ThreadIdType nThreads = info->NumberOfThreads;
+  ThreadAffinity::ScopedPinning pinning(threadId, nThreads);
+
+  // Rank of the thread among the threads of its node which share the
+  // extraction of the replica of the node
+  const int node = ThreadAffinity::GetNodeOfThread(threadId, nThreads);
+  unsigned int rank = 0, nThreadsOfNode = 0;
+  for(ThreadIdType t=0; t<nThreads; t++)
+    if(ThreadAffinity::GetNodeOfThread(t, nThreads) == node)
+      {
+      if(t<threadId)
+        rank++;
+      nThreadsOfNode++;
+      }
+
+  std::vector<ProjectionImagePointer> &replica = (*data->second)[node];
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int iFirstProj = data->first->GetInput(1)->GetBufferedRegion().GetIndex(Dimension-1);
+  for(unsigned int iProj=rank; iProj<replica.size(); iProj+=nThreadsOfNode)
+    replica[iProj] = data->first->template GetProjection< ProjectionImageType >(iFirstProj+iProj);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BackProjectionImageFilter<TInputImage,TOutputImage>
+::ProcessTile(const unsigned int tile, const ThreadIdType threadId)
+{
+  this->ThreadedGenerateData(m_Tiles[tile], threadId);
+}
+
 /**
  * GenerateData performs the accumulation
  */
@@ -161,6 +252,9 @@ BackProjectionImageFilter<TInputImage,TOutputImage>
   // Continuous index at which we interpolate
   itk::ContinuousIndex<double, Dimension-1> pointProj;
 
+  // Optional field of view of 3D volumes
+  const FieldOfViewSpanTable *fov = (Dimension==3)?m_FieldOfViewSpanTable.GetPointer():NULL;
+
   // Go over each projection
   for(unsigned int iProj=iFirstProj; iProj<iFirstProj+nProj; iProj++)
     {
@@ -175,6 +269,16 @@ BackProjectionImageFilter<TInputImage,TOutputImage>
     itOut.GoToBegin();
     while(!itIn.IsAtEnd() )
       {
+      // Skip voxels outside the field of view
+      if( fov && !fov->IsInside(itOut.GetIndex()[0], itOut.GetIndex()[1], itOut.GetIndex()[Dimension-1]) )
+        {
+        if (iProj==iFirstProj)
+          itOut.Set( itIn.Get() );
+        ++itIn;
+        ++itOut;
+        continue;
+        }
+
       // Compute projection index
       for(unsigned int i=0; i<Dimension-1; i++)
         {
@@ -217,6 +321,18 @@ BackProjectionImageFilter<TInputImage,TOutputImage>
 
   const int iProjBuff = stack->GetBufferedRegion().GetIndex(ProjectionImageType::ImageDimension);
 
+  // Projection already extracted by GenerateData, in the replica of the node
+  // of the calling thread
+  if( !m_ProjectionsCache.empty() )
+    {
+    unsigned int replica = 0;
+    if(m_ProjectionsCache.size()>1)
+      replica = std::min(ThreadAffinity::GetCurrentNode(), (unsigned int)m_ProjectionsCache.size()-1);
+    TProjectionImage *cached = dynamic_cast< TProjectionImage * >( m_ProjectionsCache[replica][iProj-iProjBuff].GetPointer() );
+    if(cached)
+      return cached;
+    }
+
   typename TProjectionImage::Pointer projection = TProjectionImage::New();
   typename TProjectionImage::RegionType region;
   typename TProjectionImage::SpacingType spacing;
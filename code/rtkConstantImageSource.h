@@ -24,6 +24,8 @@
 #include <itkImageSource.h>
 #include <itkNumericTraits.h>
 
+#include "rtkWorkStealingScheduler.h"
+
 namespace rtk
 {
 
@@ -34,12 +36,19 @@ namespace rtk
  * useful to allow streaming of large images with a constant source, e.g., a
  * tomography reconstructed with a filtered backprojection algorithm.
  *
+ * The output is filled in TilesPerThread tiles per thread with the same
+ * partition as the backprojectors (see rtk::WorkStealingScheduler) and by
+ * threads pinned in the same way (see rtk::ThreadAffinity). The memory pages
+ * of each tile are therefore first touched, and allocated, on the NUMA node
+ * of the thread which will backproject in it if the two filters use the same
+ * number of threads and of tiles per thread.
+ *
  * \test rtkRaycastInterpolatorForwardProjectionTest.cxx,
  * rtkprojectgeometricphantomtest.cxx, rtkfdktest.cxx, rtksarttest.cxx,
  * rtkrampfiltertest.cxx, rtkamsterdamshroudtest.cxx,
  * rtkdrawgeometricphantomtest.cxx, rtkmotioncompensatedfdktest.cxx,
  * rtkfovtest.cxx, rtkforwardprojectiontest.cxx, rtkdisplaceddetectortest.cxx,
- * rtkshortscantest.cxx
+ * rtkshortscantest.cxx, rtkworkstealingtest.cxx
  *
  * \author Simon Rit
  *
@@ -104,11 +113,24 @@ public:
   itkSetMacro(Constant, OutputImagePixelType);
   itkGetConstMacro(Constant, OutputImagePixelType);
 
+  /** Get / Set the number of tiles per thread, 8 by default as in
+   * rtk::BackProjectionImageFilter. 0 restores the static split of
+   * itk::ImageSource. */
+  itkGetMacro(TilesPerThread, unsigned int);
+  itkSetMacro(TilesPerThread, unsigned int);
+
 protected:
   ConstantImageSource();
   ~ConstantImageSource();
   void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
+  /** Same as itk::ImageSource::GenerateData with the tiles of the
+   * backprojectors if TilesPerThread is not 0. */
+  virtual void GenerateData();
+
+  /** Fills the tiles of the blocks of a thread. */
+  static ITK_THREAD_RETURN_TYPE FillTilesCallback(void *arg);
+
   virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
 
   virtual void GenerateOutputInformation();
@@ -123,6 +145,9 @@ private:
   DirectionType  m_Direction;
 
   typename TOutputImage::PixelType m_Constant;
+
+  unsigned int                       m_TilesPerThread;
+  std::vector<OutputImageRegionType> m_Tiles;
 };
 
 } // end namespace rtk
@@ -40,6 +40,7 @@ ConstantImageSource<TOutputImage>
     }
 
   m_Constant = 0.;
+  m_TilesPerThread = 8;
 }
 
 template <class TOutputImage>
@@ -110,6 +111,7 @@ ConstantImageSource<TOutputImage>
     os << m_Size[i] << ", ";
     }
   os << m_Size[i] << "]" << std::endl;
+  os << indent << "TilesPerThread: " << m_TilesPerThread << std::endl;
 }
 
 //----------------------------------------------------------------------------
@@ -134,6 +136,56 @@ ConstantImageSource<TOutputImage>
   output->SetDirection(m_Direction);
 }
 
+//----------------------------------------------------------------------------
+template <typename TOutputImage>
+void
+ConstantImageSource<TOutputImage>
+::GenerateData()
+{
+  if(!m_TilesPerThread)
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+
+  m_Tiles = WorkStealingScheduler::SplitRegion(this->GetOutput()->GetRequestedRegion(),
+                                               m_TilesPerThread * this->GetNumberOfThreads() );
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( WorkStealingScheduler::GetNumberOfBlocks(m_Tiles.size(), this->GetNumberOfThreads()) );
+  threader->SetSingleMethod(FillTilesCallback, this);
+  threader->SingleMethodExecute();
+  m_Tiles.clear();
+
+  this->AfterThreadedGenerateData();
+}
+
+//----------------------------------------------------------------------------
+template <typename TOutputImage>
+ITK_THREAD_RETURN_TYPE
+ConstantImageSource<TOutputImage>
+::FillTilesCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(arg);
+  Self *self = (Self *)(info->UserData);
+  const unsigned int nBlocks = WorkStealingScheduler::GetNumberOfBlocks(self->m_Tiles.size(),
+                                                                        self->GetNumberOfThreads());
+
+  // The threader may use fewer threads than blocks, each thread then fills
+  // several blocks
+  for(unsigned int block=info->ThreadID; block<nBlocks; block+=info->NumberOfThreads)
+    {
+    ThreadAffinity::ScopedPinning pinning(block, nBlocks);
+    unsigned int begin, end;
+    WorkStealingScheduler::GetBlock(block, nBlocks, self->m_Tiles.size(), begin, end);
+    for(unsigned int tile=begin; tile<end; tile++)
+      self->ThreadedGenerateData(self->m_Tiles[tile], info->ThreadID);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 //----------------------------------------------------------------------------
 template <typename TOutputImage>
 void 
@@ -63,11 +63,11 @@ rtk::CudaFFTRampImageFilter
   if(inputDimension.y==1 && inputDimension.z>1) // Troubles cuda 3.2 and 4.0
     std::swap(inputDimension.y, inputDimension.z);
 
-  // Get FFT ramp kernel. Must be itk::Image because GetFFTRampKernel is not
-  // compatible with itk::CudaImage + ITK 3.20.
+  // Get FFT ramp kernel, recomputed only if required. Must be itk::Image
+  // because GetFFTRampKernel is not compatible with itk::CudaImage + ITK 3.20.
   FFTOutputCPUImagePointer fftK;
   FFTOutputImageType::SizeType s = paddedImage->GetLargestPossibleRegion().GetSize();
-  fftK = this->GetFFTRampKernel<FFTInputCPUImageType, FFTOutputCPUImageType>(s[0], s[1]);
+  fftK = this->UpdateFFTRampKernel<FFTInputCPUImageType, FFTOutputCPUImageType>(s[0], s[1]);
 
   // Create the itk::CudaImage holding the kernel
   FFTOutputImagePointer fftKCUDA = FFTOutputImageType::New();
@@ -76,6 +76,19 @@ public:
   itkGetMacro(Frame, unsigned int);
   itkSetMacro(Frame, unsigned int);
 
+  /** Compute the two frames of the input 4D DVF and their weights which are
+   * linearly combined to obtain the 3D DVF of a given frame number. This
+   * allows users, e.g., FDKWarpBackProjectionImageFilter, to interpolate the
+   * input 4D DVF on the fly instead of updating the filter for each frame.
+   * FDKWarpBackProjectionImageFilter detects this optional method with
+   * HasComputeFrameInterpolation, deformations without it are still updated
+   * frame by frame. The output information of the input must be up to date. */
+  virtual void ComputeFrameInterpolation(const unsigned int frame,
+                                         unsigned int &frameInf,
+                                         unsigned int &frameSup,
+                                         double &weightInf,
+                                         double &weightSup);
+
 protected:
   CyclicDeformationImageFilter(): m_Frame(0) {}
   virtual ~CyclicDeformationImageFilter() {}
@@ -62,28 +62,40 @@ template <class TOutputImage>
 void
 CyclicDeformationImageFilter<TOutputImage>
 ::BeforeThreadedGenerateData()
+{
+  ComputeFrameInterpolation(this->GetFrame(), m_FrameInf, m_FrameSup, m_WeightInf, m_WeightSup);
+}
+
+template <class TOutputImage>
+void
+CyclicDeformationImageFilter<TOutputImage>
+::ComputeFrameInterpolation(const unsigned int frame,
+                            unsigned int &frameInf,
+                            unsigned int &frameSup,
+                            double &weightInf,
+                            double &weightSup)
 {
   unsigned int nframe = this->GetInput()->GetLargestPossibleRegion().GetSize(OutputImageType::ImageDimension);
-  if( this->GetFrame() > m_Signal.size() )
+  if( frame >= m_Signal.size() )
     itkGenericExceptionMacro(<< "Frame number #"
-                             << this->GetFrame()
+                             << frame
                              << " is larger than phase signal which has size "
                              << m_SignalFilename);
 
-  double sigValue = m_Signal[this->GetFrame()];
+  double sigValue = m_Signal[frame];
   if( sigValue<0. || sigValue >=1. )
     itkGenericExceptionMacro(<< "Signal value #"
-                             << this->GetFrame()
+                             << frame
                              << " is " << sigValue
                              << " which is not in [0,1)");
 
   sigValue *= nframe;
-  m_FrameInf = itk::Math::Floor<unsigned int, double>(sigValue);
-  m_FrameSup = itk::Math::Floor<unsigned int, double>(sigValue + 1.);
-  m_WeightInf = m_FrameSup - sigValue;
-  m_WeightSup = sigValue - m_FrameInf;
-  m_FrameInf = m_FrameInf % nframe;
-  m_FrameSup = m_FrameSup % nframe;
+  frameInf = itk::Math::Floor<unsigned int, double>(sigValue);
+  frameSup = itk::Math::Floor<unsigned int, double>(sigValue + 1.);
+  weightInf = frameSup - sigValue;
+  weightSup = sigValue - frameInf;
+  frameInf = frameInf % nframe;
+  frameSup = frameSup % nframe;
 }
 
 template <class TOutputImage>
@@ -19,7 +19,9 @@
 #ifndef __rtkDPExtractShroudSignalImageFilter_h
 #define __rtkDPExtractShroudSignalImageFilter_h
 
+#include <vector>
 #include <itkImageToImageFilter.h>
+#include <itkMultiThreader.h>
 
 namespace rtk
 {
@@ -27,6 +29,18 @@ namespace rtk
    * \brief Extract the signal corresponding to the breathing motion
    * (1D) from a shroud image (2D).
    *
+   * The signal is the path through the shroud rows which maximizes the sum of
+   * the shroud values, the position in a row being allowed to move by at most
+   * Amplitude from one row to the next. It is found by dynamic programming: a
+   * forward pass accumulates the best score of each position row after row
+   * and stores a back-pointer per position, and the signal is obtained by
+   * following the back-pointers from the best position of the last row.
+   *
+   * The forward pass only depends on the previous row. It can therefore be
+   * run online, e.g., during an inline acquisition, by calling StartOnline
+   * once and AddShroudRow for each new projection. GetOnlineSignal returns at
+   * any time the signal of the rows added so far.
+   *
    * \test rtkamsterdamshroudtest.cxx
    *
    * \author Vivien Delmon
@@ -65,6 +79,21 @@ public:
   itkGetMacro(Amplitude, double);
   itkSetMacro(Amplitude, double);
 
+  /** Reset the online dynamic programming for shroud rows of shroudWidth
+   * pixels with the given spacing along the row. The current Amplitude is
+   * used until the next call. */
+  void StartOnline(unsigned int shroudWidth, double spacing);
+
+  /** Add the next row of the shroud (shroudWidth pixels) to the online
+   * dynamic programming. */
+  void AddShroudRow(const TInputPixel *row);
+
+  /** Number of shroud rows added since the last StartOnline. */
+  unsigned int GetNumberOfShroudRows() const { return m_NumberOfRows; }
+
+  /** Signal of the rows added since the last StartOnline, one value per row. */
+  void GetOnlineSignal(std::vector<TOutputPixel> &signal) const;
+
 protected:
   DPExtractShroudSignalImageFilter();
   ~DPExtractShroudSignalImageFilter(){}
@@ -77,8 +106,24 @@ private:
   DPExtractShroudSignalImageFilter(const Self&);  //purposely not implemented
   void operator=(const Self&);                  //purposely not implemented
 
+  /** Update of the scores and back-pointers of the columns [begin, end) of
+   * the current row. */
+  void ForwardRow(const double *row, unsigned int begin, unsigned int end);
+  static ITK_THREAD_RETURN_TYPE ForwardRowCallback(void *arg);
+
   double    m_Amplitude;
 
+  /** Online dynamic programming state */
+  unsigned int        m_Width;
+  int                 m_AmplitudeInVoxel;
+  double              m_Spacing;
+  unsigned int        m_NumberOfRows;
+  std::vector<double> m_Row;
+  std::vector<double> m_Score;
+  std::vector<double> m_NewScore;
+  std::vector<int>    m_From;
+  std::vector<short>  m_BackPointers;
+
 }; // end of class
 
 } // end of namespace rtk
@@ -19,7 +19,7 @@
 #ifndef __rtkDPExtractShroudSignalImageFilter_txx
 #define __rtkDPExtractShroudSignalImageFilter_txx
 
-#include <itkArray.h>
+#include <algorithm>
 
 namespace rtk
 {
@@ -27,7 +27,11 @@ namespace rtk
 template<class TInputPixel, class TOutputPixel>
 DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
 ::DPExtractShroudSignalImageFilter() :
-  m_Amplitude(0.)
+  m_Amplitude(0.),
+  m_Width(0),
+  m_AmplitudeInVoxel(0),
+  m_Spacing(1.),
+  m_NumberOfRows(0)
 {
 }
 
@@ -92,72 +96,151 @@ DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
 {
   this->AllocateOutputs();
 
-  typename TInputImage::ConstPointer input = this->GetInput();
-  typename TInputImage::RegionType::IndexType inputIdx = input->GetLargestPossibleRegion().GetIndex();
-  typename TInputImage::RegionType::SizeType  inputSize = input->GetLargestPossibleRegion().GetSize();
+  const TInputImage *input = this->GetInput();
+  const typename TInputImage::RegionType region = input->GetLargestPossibleRegion();
 
-  typename itk::Image<int, InputImageDimension>::Pointer from = itk::Image<int, InputImageDimension>::New();
-  from->CopyInformation(input);
-  from->SetRegions(input->GetLargestPossibleRegion());
-  from->Allocate();
-  int amplitudeInVoxel = m_Amplitude / input->GetSpacing()[0];
+  StartOnline(region.GetSize()[0], input->GetSpacing()[0]);
+  typename TInputImage::IndexType idx = region.GetIndex();
+  for(unsigned int i=0; i<region.GetSize()[1]; i++, idx[1]++)
+    AddShroudRow( input->GetBufferPointer() + input->ComputeOffset(idx) );
 
-  itk::Array<double>* prev = new itk::Array<double>(inputSize[0]);
-  itk::Array<double>* curr = new itk::Array<double>(inputSize[0]);
+  std::vector<TOutputPixel> signal;
+  GetOnlineSignal(signal);
+  std::copy(signal.begin(), signal.end(), this->GetOutput()->GetBufferPointer());
+}
 
-  typename TInputImage::RegionType::IndexType idx = inputIdx;
-  for (unsigned i = 0; i < inputSize[0]; ++i)
-  {
-    (*prev)[i] = (*input)[idx];
-    idx[0]++;
-  }
+template<class TInputPixel, class TOutputPixel>
+void
+DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
+::StartOnline(unsigned int shroudWidth, double spacing)
+{
+  m_AmplitudeInVoxel = m_Amplitude / spacing;
+  if(m_AmplitudeInVoxel > itk::NumericTraits<short>::max())
+    itkExceptionMacro(<< "Amplitude of " << m_AmplitudeInVoxel << " pixels is too large.");
+
+  m_Width = shroudWidth;
+  m_Spacing = spacing;
+  m_NumberOfRows = 0;
+  m_Row.resize(m_Width);
+  m_Score.resize(m_Width);
+  m_NewScore.resize(m_Width);
+  m_From.resize(m_Width);
+  m_BackPointers.clear();
+}
 
-  for (unsigned i = 1; i < inputSize[1]; ++i)
-  {
-    (*curr).Fill(0.0);
-    idx[0] = inputIdx[0];
-    for (unsigned j = 0; j < inputSize[0]; ++j)
+template<class TInputPixel, class TOutputPixel>
+void
+DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
+::AddShroudRow(const TInputPixel *row)
+{
+  if(m_Width == 0)
+    itkExceptionMacro(<< "StartOnline must be called before AddShroudRow.");
+
+  if(m_NumberOfRows == 0)
+    {
+    std::copy(row, row+m_Width, m_Score.begin());
+    m_NumberOfRows++;
+    return;
+    }
+
+  std::copy(row, row+m_Width, m_Row.begin());
+
+  // Split the columns between threads when the row is worth it
+  const double work = double(m_Width) * (2*m_AmplitudeInVoxel+1);
+  const unsigned int nThreads = vnl_math_min((unsigned int)this->GetNumberOfThreads(),
+                                             (unsigned int)(work/65536.) + 1);
+  if(nThreads > 1)
     {
-      for (int r = -amplitudeInVoxel; r <= amplitudeInVoxel; ++r)
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    threader->SetNumberOfThreads(nThreads);
+    threader->SetSingleMethod(ForwardRowCallback, this);
+    threader->SingleMethodExecute();
+    }
+  else
+    ForwardRow(&m_Row[0], 0, m_Width);
+
+  std::swap(m_Score, m_NewScore);
+  m_BackPointers.insert(m_BackPointers.end(), m_From.begin(), m_From.end());
+  m_NumberOfRows++;
+}
+
+template<class TInputPixel, class TOutputPixel>
+ITK_THREAD_RETURN_TYPE
+DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
+::ForwardRowCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(arg);
+  Self *self = (Self *)(info->UserData);
+  const unsigned int n = self->m_Width;
+  const unsigned int begin = (unsigned long)n *  info->ThreadID    / info->NumberOfThreads;
+  const unsigned int end   = (unsigned long)n * (info->ThreadID+1) / info->NumberOfThreads;
+  self->ForwardRow(&(self->m_Row[0]), begin, end);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<class TInputPixel, class TOutputPixel>
+void
+DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
+::ForwardRow(const double *row, unsigned int begin, unsigned int end)
+{
+  const int w = m_Width;
+  const double *prev = &m_Score[0];
+  double *curr = &m_NewScore[0];
+  int *from = &m_From[0];
+
+  // A position keeps a null score and does not move if no path to it has a
+  // positive score
+  for(unsigned int t=begin; t<end; t++)
+    {
+    curr[t] = 0.;
+    from[t] = 0;
+    }
+
+  // Each position t comes from a column t+d with |d|<=amplitude. The offsets
+  // are explored by increasing d so that ties are resolved towards the
+  // leftmost column. The band is handled by the bounds of the inner loop,
+  // which is written without branch so that it vectorizes.
+  for(int d=-m_AmplitudeInVoxel; d<=m_AmplitudeInVoxel; d++)
+    {
+    const int tb = vnl_math_max(int(begin), -d);
+    const int te = vnl_math_min(int(end), w-d);
+    const double *prevd = prev + d;
+    for(int t=tb; t<te; t++)
       {
-        typename TInputImage::RegionType::IndexType idx_to = idx;
-        idx_to[0] += r;
-        idx_to[1]++;
-        if (input->GetLargestPossibleRegion().IsInside(idx_to) && (*input)[idx_to] + (*prev)[j] > (*curr)[j + r])
-        {
-          (*curr)[j + r] = (*input)[idx_to] + (*prev)[j];
-          (*from)[idx_to] = -r;
-        }
+      const double candidate = row[t] + prevd[t];
+      const double best = curr[t];
+      const int better = candidate > best;
+      curr[t] = vnl_math_max(candidate, best);
+      from[t] += better * (d - from[t]);
       }
-      idx[0]++;
     }
-    idx[1]++;
-    std::swap(prev, curr);
-  }
+}
 
-  unsigned max = 0;
-  for (unsigned j = 1; j < inputSize[0]; ++j)
-    if ((*prev)[j] > (*prev)[max])
-      max = j;
+template<class TInputPixel, class TOutputPixel>
+void
+DPExtractShroudSignalImageFilter<TInputPixel, TOutputPixel>
+::GetOnlineSignal(std::vector<TOutputPixel> &signal) const
+{
+  signal.resize(m_NumberOfRows);
+  if(m_NumberOfRows == 0)
+    return;
 
-  idx[0] = inputIdx[0] + max;
+  // Best position of the last row
+  unsigned int pos = 0;
+  for(unsigned int j=1; j<m_Width; j++)
+    if(m_Score[j] > m_Score[pos])
+      pos = j;
 
-  typename Superclass::OutputImagePointer output = this->GetOutput();
-  output->Allocate();
-  typename TOutputImage::RegionType::IndexType outputIdx;
+  // Backtracking
   TOutputPixel value = 0;
-  outputIdx[0] = idx[1];
-  (*output)[outputIdx] = value;
-  while (idx[1] != inputIdx[1])
-  {
-    outputIdx[0]--;
-    value -= (*from)[idx] * input->GetSpacing()[0];
-    (*output)[outputIdx] = value;
-    idx[0] += (*from)[idx];
-    idx[1]--;
-  }
-  delete prev;
-  delete curr;
+  signal[m_NumberOfRows-1] = value;
+  for(unsigned int i=m_NumberOfRows-1; i>0; i--)
+    {
+    const int d = m_BackPointers[(i-1)*m_Width+pos];
+    value -= d * m_Spacing;
+    signal[i-1] = value;
+    pos += d;
+    }
 }
 
 } // end of namespace rtk
@@ -18,6 +18,11 @@
 
 #include "rtkDbf.h"
 
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <itksys/SystemTools.hxx>
+
 namespace rtk
 {
 
@@ -29,22 +34,53 @@ DbfField::DbfField(std::string name, char type, unsigned char length, short recO
 {
 }
 
-DbfFile::DbfFile(std::string fileName)
+DbfFieldView::DbfFieldView(const char *data, size_t length) :
+  m_Data(data),
+  m_Length(length)
 {
-  m_Stream.open(fileName.c_str(), std::ios_base::in | std::ios_base::binary);
-  if(!m_Stream.is_open() )
-    return;
+  // Remove begin/end spaces
+  while(m_Length && m_Data[m_Length-1] == ' ')
+    m_Length--;
+  while(m_Length && m_Data[0] == ' ')
+    {
+    m_Data++;
+    m_Length--;
+    }
+}
 
-  // Ignore version and date
-  m_Stream.seekg(4);
+double DbfFieldView::ToDouble() const
+{
+  // Field lengths are stored on one byte
+  char buffer[256];
+  memcpy(buffer, m_Data, m_Length);
+  buffer[m_Length] = '\0';
+  return atof(buffer);
+}
 
-  // Read number of records, header size, record size
-  m_Stream.read( (char*)&m_NumRecords, sizeof(m_NumRecords) );
-  m_Stream.read( (char*)&m_HeaderSize, sizeof(m_HeaderSize) );
-  m_Stream.read( (char*)&m_RecordSize, sizeof(m_RecordSize) );
+DbfFile::DbfFile(std::string fileName) :
+  m_File(fileName),
+  m_IsOpen(false),
+  m_NumRecords(0),
+  m_RecordSize(0),
+  m_HeaderSize(0),
+  m_Record(NULL),
+  m_NextRecord(0)
+{
+  if(!m_File.is_open() || m_File.GetSize() < 32)
+    return;
 
-  // Record allocation
-  m_Record = new char[m_RecordSize];
+  // Ignore version and date, read number of records, header size, record size
+  const char *p = m_File.GetPointer();
+  memcpy(&m_NumRecords, p+4, sizeof(m_NumRecords) );
+  memcpy(&m_HeaderSize, p+8, sizeof(m_HeaderSize) );
+  memcpy(&m_RecordSize, p+10, sizeof(m_RecordSize) );
+  if(m_HeaderSize < 33 || m_HeaderSize > m_File.GetSize() || m_RecordSize == 0)
+    return;
+
+  // Ignore records which are announced but not in the file
+  const size_t numRecordsInFile = (m_File.GetSize() - m_HeaderSize) / m_RecordSize;
+  if(m_NumRecords > numRecordsInFile)
+    m_NumRecords = numRecordsInFile;
 
   // The number of fields depends on the header size (32 are the blocks
   // describing the global part and each field, 1 is the terminator length)
@@ -54,67 +90,244 @@ DbfFile::DbfFile(std::string fileName)
   short fldRecOffset = 1;
   for(unsigned int i=0; i<numFields; i++) {
 
-    // Go to beginning of current field structure description
-    m_Stream.seekg(32 * (1 + i) );
+    // Beginning of current field structure description
+    const char *fldDesc = p + 32 * (1 + i);
 
     // Field names
-    char fldName[11];
-    m_Stream.read(fldName, 11);
+    char fldName[12];
+    memcpy(fldName, fldDesc, 11);
+    fldName[11] = '\0';
 
     // Field types
-    char fldType;
-    m_Stream.read( (char*)&fldType, sizeof(fldType) );
+    char fldType = fldDesc[11];
 
-    // Skip displacement of field in record?
-    m_Stream.seekg(4, std::ios_base::cur);
-
-    // Field length
-    unsigned char fldLength;
-    m_Stream.read( (char*)&fldLength, sizeof(fldLength) );
+    // Skip displacement of field in record? Field length
+    unsigned char fldLength = fldDesc[16];
 
     // Add field and go to next
     m_Fields.push_back(DbfField(fldName, fldType, fldLength, fldRecOffset) );
     m_MapFieldNameIndex[m_Fields.back().GetName()] = i;
+    m_FieldOffsets.push_back(fldRecOffset);
+    m_FieldLengths.push_back(fldLength);
 
     fldRecOffset += fldLength;
     }
+  if(fldRecOffset > m_RecordSize)
+    return;
 
-  // Seek to first record
-  m_Stream.seekg(m_HeaderSize);
+  m_IsOpen = true;
 }
 
 DbfFile::~DbfFile()
 {
-  delete [] m_Record;
 }
 
 bool DbfFile::ReadNextRecord()
 {
-  do
+  if(!m_IsOpen)
+    return false;
+  while(m_NextRecord < m_NumRecords)
     {
-    m_Stream.read(m_Record, m_RecordSize);
+    const char *record = GetRecordPointer(m_NextRecord++);
+    if(record[0] != 0x2A)
+      {
+      m_Record = record;
+      return true;
+      }
     }
-  while(m_Stream.gcount() == m_RecordSize && m_Record[0] == 0x2A);
-  return m_Stream.gcount() == m_RecordSize;
+  m_Record = NULL;
+  return false;
+}
+
+bool DbfFile::GoToRecord(unsigned int recNum)
+{
+  if(!m_IsOpen || recNum >= m_NumRecords)
+    return false;
+  m_NextRecord = recNum + 1;
+  m_Record = GetRecordPointer(recNum);
+  if(m_Record[0] == 0x2A)
+    {
+    m_Record = NULL;
+    return false;
+    }
+  return true;
+}
+
+int DbfFile::GetFieldIndex(const std::string &fldName) const
+{
+  std::map<std::string, unsigned int>::const_iterator it = m_MapFieldNameIndex.find(fldName);
+  if(it == m_MapFieldNameIndex.end() )
+    return -1;
+  return it->second;
 }
 
 std::string DbfFile::GetFieldAsString(std::string fldName){
-  DbfField &  field = m_Fields[ m_MapFieldNameIndex[fldName] ];
-  std::string result( m_Record + field.GetRecOffset(), field.GetLength() );
+  const int fldIndex = GetFieldIndex(fldName);
+  if(fldIndex < 0 || m_Record == NULL)
+    return std::string();
+  return GetFieldView(fldIndex).ToString();
+}
+
+DbfIndex::DbfIndex(DbfFile &dbf, const std::string &fldName, const std::string &sidecarFileName) :
+  m_IsValid(false),
+  m_Sidecar(NULL),
+  m_Entries(NULL),
+  m_NumEntries(0),
+  m_KeyLength(0)
+{
+  const int fldIndex = dbf.GetFieldIndex(fldName);
+  if(!dbf.is_open() || fldIndex < 0)
+    return;
+  m_KeyLength = dbf.GetField(fldIndex).GetLength();
+
+  // Signature of the dbf file and of the indexed field at the beginning of
+  // the sidecar file. The index is reused only if it is identical.
+  std::ostringstream header;
+  header << "RTKDBFINDEX 1 "
+         << itksys::SystemTools::FileLength(dbf.GetFileName().c_str() ) << ' '
+         << itksys::SystemTools::ModifiedTime(dbf.GetFileName().c_str() ) << ' '
+         << dbf.GetNumberOfRecords() << ' '
+         << fldName << ' '
+         << dbf.GetField(fldIndex).GetRecOffset() << ' '
+         << m_KeyLength << '\n';
+
+  if(sidecarFileName != "" && LoadSidecar(sidecarFileName, header.str() ) )
+    {
+    m_IsValid = true;
+    return;
+    }
+
+  Build(dbf, fldIndex);
+  m_IsValid = true;
+  if(sidecarFileName != "")
+    SaveSidecar(sidecarFileName, header.str() );
+}
+
+DbfIndex::~DbfIndex()
+{
+  delete m_Sidecar;
+}
 
-  // Revome begin/end spaces
-  std::string::size_type pos = result.find_last_not_of(' ');
+bool DbfIndex::LoadSidecar(const std::string &sidecarFileName, const std::string &header)
+{
+  if(!itksys::SystemTools::FileExists(sidecarFileName.c_str(), true) )
+    return false;
 
-  if(pos != std::string::npos) {
-    result.erase(pos + 1);
-    pos = result.find_first_not_of(' ');
-    if(pos != std::string::npos)
-      result.erase(0, pos);
+  MemoryMappedFile *sidecar = new MemoryMappedFile(sidecarFileName);
+  if(!sidecar->is_open() ||
+     sidecar->GetSize() < header.size() ||
+     memcmp(sidecar->GetPointer(), header.data(), header.size() ) != 0 ||
+     (sidecar->GetSize() - header.size() ) % GetEntrySize() != 0)
+    {
+    delete sidecar;
+    return false;
+    }
+
+  m_Sidecar = sidecar;
+  m_Entries = sidecar->GetPointer() + header.size();
+  m_NumEntries = (sidecar->GetSize() - header.size() ) / GetEntrySize();
+  return true;
+}
+
+/** Comparison of the keys of two entries, ties being broken by their order
+ * of insertion, i.e. the record number. */
+class DbfIndexEntryCompare
+{
+public:
+  DbfIndexEntryCompare(const char *entries, size_t entrySize, size_t keyLength):
+    m_Entries(entries), m_EntrySize(entrySize), m_KeyLength(keyLength) {}
+  bool operator()(unsigned int a, unsigned int b) const
+    {
+    return memcmp(m_Entries + a * m_EntrySize, m_Entries + b * m_EntrySize, m_KeyLength) < 0;
+    }
+private:
+  const char *m_Entries;
+  size_t      m_EntrySize;
+  size_t      m_KeyLength;
+};
+
+void DbfIndex::Build(DbfFile &dbf, unsigned int fldIndex)
+{
+  // Unsorted entries with the trimmed values padded with spaces
+  std::vector<char> unsorted;
+  unsorted.reserve(dbf.GetNumberOfRecords() * GetEntrySize() );
+  m_NumEntries = 0;
+  for(unsigned int recNum=0; recNum<dbf.GetNumberOfRecords(); recNum++)
+    {
+    if(dbf.IsRecordDeleted(recNum) )
+      continue;
+    const DbfFieldView value = dbf.GetFieldView(recNum, fldIndex);
+    unsorted.insert(unsorted.end(), value.GetPointer(), value.GetPointer() + value.GetLength() );
+    unsorted.insert(unsorted.end(), m_KeyLength - value.GetLength(), ' ');
+    const unsigned int rec = recNum;
+    unsorted.insert(unsorted.end(), (const char *)&rec, (const char *)&rec + 4);
+    m_NumEntries++;
+    }
+  if(!m_NumEntries)
+    {
+    m_Entries = NULL;
+    return;
     }
-  else
-    result.erase(result.begin(), result.end() );
 
-  return result;
+  // Sort entries by key, stable to keep the record numbers in increasing order
+  std::vector<unsigned int> order(m_NumEntries);
+  for(unsigned int i=0; i<m_NumEntries; i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   DbfIndexEntryCompare(&(unsorted[0]), GetEntrySize(), m_KeyLength) );
+
+  m_Buffer.resize(m_NumEntries * GetEntrySize() );
+  for(unsigned int i=0; i<m_NumEntries; i++)
+    memcpy(&(m_Buffer[i * GetEntrySize()]), &(unsorted[order[i] * GetEntrySize()]), GetEntrySize() );
+  m_Entries = &(m_Buffer[0]);
+}
+
+void DbfIndex::SaveSidecar(const std::string &sidecarFileName, const std::string &header)
+{
+  // The sidecar is only a cache: failing to write it is not an error
+  std::ofstream sidecar(sidecarFileName.c_str(), std::ios_base::out | std::ios_base::binary);
+  if(!sidecar.is_open() )
+    return;
+  sidecar.write(header.data(), header.size() );
+  if(m_NumEntries)
+    sidecar.write(m_Entries, m_NumEntries * GetEntrySize() );
+  sidecar.close();
+  if(sidecar.fail() )
+    itksys::SystemTools::RemoveFile(sidecarFileName.c_str() );
+}
+
+void DbfIndex::Find(const std::string &value, std::vector<unsigned int> &records) const
+{
+  records.clear();
+
+  // Key as stored in the entries
+  const DbfFieldView trimmed(value.data(), value.size() );
+  if(trimmed.GetLength() > m_KeyLength)
+    return;
+  std::string key(trimmed.GetPointer(), trimmed.GetLength() );
+  key.resize(m_KeyLength, ' ');
+
+  // Binary search of the first entry not lower than the key
+  size_t first = 0;
+  size_t count = m_NumEntries;
+  while(count > 0)
+    {
+    const size_t step = count / 2;
+    if(memcmp(GetEntry(first + step), key.data(), m_KeyLength) < 0)
+      {
+      first += step + 1;
+      count -= step + 1;
+      }
+    else
+      count = step;
+    }
+
+  for(size_t i=first; i<m_NumEntries && memcmp(GetEntry(i), key.data(), m_KeyLength) == 0; i++)
+    {
+    unsigned int rec;
+    memcpy(&rec, GetEntry(i) + m_KeyLength, 4);
+    records.push_back(rec);
+    }
 }
 
 }
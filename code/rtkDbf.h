@@ -20,11 +20,13 @@
 #define __rtkDbf_h
 
 #include <string>
-#include <fstream>
 #include <vector>
 #include <map>
+#include <string.h>
 #include <stdlib.h>
 
+#include "rtkMemoryMappedFile.h"
+
 namespace rtk
 {
 
@@ -53,11 +55,42 @@ private:
   short       m_RecOffset;
 };
 
+/** \class DbfFieldView
+ *
+ * Zero-copy view on the value of a field in the current record of a dbf
+ * file, with begin/end spaces removed. It is only valid as long as the
+ * DbfFile exists.
+ */
+class DbfFieldView
+{
+public:
+  DbfFieldView(): m_Data(NULL), m_Length(0) {}
+  DbfFieldView(const char *data, size_t length);
+
+  const char *GetPointer() const { return m_Data; }
+  size_t      GetLength() const  { return m_Length; }
+
+  bool operator==(const std::string &s) const
+    {
+    return s.size() == m_Length && memcmp(s.data(), m_Data, m_Length) == 0;
+    }
+  bool operator!=(const std::string &s) const { return !(*this == s); }
+
+  std::string ToString() const { return std::string(m_Data, m_Length); }
+  double      ToDouble() const;
+
+private:
+  const char *m_Data;
+  size_t      m_Length;
+};
+
 /** \class DbfFile
  * 
  * Light dbase file (.dbf) file reader. It assumes little-endianness
  * (least significant byte first). The format describet on this page:
  * http://www.dbf2002.com/dbf-file-format.html
+ * The file is memory mapped and records are accessed in place, either
+ * sequentially with ReadNextRecord or randomly with GoToRecord.
  */
 class DbfFile
 {
@@ -66,24 +99,64 @@ public:
   DbfFile(std::string fileName);
   ~DbfFile();
 
-  /** Return open status of file stream */
-  bool is_open() { return m_Stream.is_open(); }
+  /** Return open status of file */
+  bool is_open() { return m_IsOpen; }
+
+  /** Name of the dbf file */
+  const std::string &GetFileName() const { return m_File.GetFileName(); }
 
-  /** Number of records contained in the tabe */
-  size_t GetNumberOfRecords()      { return m_Fields.size(); }
+  /** Number of records contained in the table, including deleted records */
+  size_t GetNumberOfRecords()      { return m_NumRecords; }
 
   /** Read in memory the next record. Return true if successful and false
     oftherwise. */
   bool ReadNextRecord();
 
+  /** Go to record number recNum. Return false if it does not exist or if it
+   * has been deleted. The next call to ReadNextRecord goes to recNum+1. */
+  bool GoToRecord(unsigned int recNum);
+
+  /** Go back before the first record, the next call to ReadNextRecord reads
+   * the first record which has not been deleted. */
+  void Rewind() { m_NextRecord = 0; m_Record = NULL; }
+
+  /** Index of the field named fldName, -1 if there is no such field. The
+   * index should be computed once and then used to access field values. */
+  int GetFieldIndex(const std::string &fldName) const;
+
+  /** Field description */
+  DbfField &GetField(unsigned int fldIndex) { return m_Fields[fldIndex]; }
+
+  /** Zero-copy access to field value of field number fldIndex */
+  DbfFieldView GetFieldView(unsigned int fldIndex) const
+    {
+    return DbfFieldView(m_Record + m_FieldOffsets[fldIndex], m_FieldLengths[fldIndex]);
+    }
+
+  /** Deletion status and zero-copy access to field value of field number
+   * fldIndex of record recNum, which must exist. The current record is not
+   * changed. */
+  bool IsRecordDeleted(unsigned int recNum) const { return GetRecordPointer(recNum)[0] == 0x2A; }
+  DbfFieldView GetFieldView(unsigned int recNum, unsigned int fldIndex) const
+    {
+    return DbfFieldView(GetRecordPointer(recNum) + m_FieldOffsets[fldIndex], m_FieldLengths[fldIndex]);
+    }
+
   /** Access to field value of field named fldName */
   std::string GetFieldAsString(std::string fldName);
 
   double GetFieldAsDouble(std::string fldName) { return atof(GetFieldAsString(fldName).c_str() ); }
 
 private:
-  /** File stream. AFter constructor, positionned to next record to read. */
-  std::ifstream m_Stream;
+  /** Pointer to record recNum */
+  const char *GetRecordPointer(unsigned int recNum) const
+    {
+    return m_File.GetPointer() + m_HeaderSize + (size_t)recNum * m_RecordSize;
+    }
+
+  /** Memory mapped file and status of the header parsing */
+  MemoryMappedFile m_File;
+  bool             m_IsOpen;
 
   /** Global properties of a dbf file */
   unsigned int m_NumRecords;
@@ -93,12 +166,67 @@ private:
   /** Set of fields described in the header */
   std::vector<DbfField> m_Fields;
 
+  /** Offsets and lengths of the fields, copied from m_Fields for fast access */
+  std::vector<unsigned short> m_FieldOffsets;
+  std::vector<unsigned short> m_FieldLengths;
+
   /** Map between field names and field index */
   std::map<std::string, unsigned int> m_MapFieldNameIndex;
 
-  /** Current record in memory */
-  char *m_Record;
+  /** Current record in memory and number of the next record to read */
+  const char * m_Record;
+  unsigned int m_NextRecord;
+};
+
+/** \class DbfIndex
+ *
+ * Index of the records of a dbf file on the value of one of its fields.
+ * The index is a table of (value, record number) entries sorted by value so
+ * that the records matching a value are found in O(log(n)+k) instead of
+ * scanning the whole table. The index can be persistent: if a sidecar file
+ * name is given, the index is memory mapped from this file when it is up to
+ * date with the dbf file (same size, modification time and structure), or
+ * built and saved to it otherwise. Deleted records are not indexed. Building
+ * the index does not change the current record of the dbf file.
+ */
+class DbfIndex
+{
+public:
+  /** Constructor loads or builds the index of field fldName of dbf. */
+  DbfIndex(DbfFile &dbf, const std::string &fldName, const std::string &sidecarFileName="");
+  ~DbfIndex();
+
+  /** Return true if the index could be loaded or built */
+  bool is_valid() const { return m_IsValid; }
+
+  /** True if the index has been loaded from the sidecar file */
+  bool IsLoadedFromSidecar() const { return m_Sidecar != NULL; }
+
+  /** Get the record numbers of the records whose field equals value (begin
+   * and end spaces being ignored), in increasing order. */
+  void Find(const std::string &value, std::vector<unsigned int> &records) const;
+
+private:
+  DbfIndex(const DbfIndex&);      //purposely not implemented
+  void operator=(const DbfIndex&); //purposely not implemented
+
+  bool LoadSidecar(const std::string &sidecarFileName, const std::string &header);
+  void Build(DbfFile &dbf, unsigned int fldIndex);
+  void SaveSidecar(const std::string &sidecarFileName, const std::string &header);
+
+  /** Entry number i is m_KeyLength bytes of key, padded with spaces, followed
+   * by the record number as a 32 bits integer. */
+  size_t GetEntrySize() const { return m_KeyLength + 4; }
+  const char *GetEntry(size_t i) const { return m_Entries + i * GetEntrySize(); }
+
+  bool              m_IsValid;
+  MemoryMappedFile *m_Sidecar;
+  std::vector<char> m_Buffer;
+  const char *      m_Entries;
+  size_t            m_NumEntries;
+  unsigned int      m_KeyLength;
 };
+
 }
 
 #endif
@@ -20,10 +20,8 @@
 #define __rtkDrawCylinderImageFilter_txx
 
 #include <iostream>
-#include <itkImageRegionConstIterator.h>
-#include <itkImageRegionIterator.h>
-
 #include "rtkHomogeneousMatrix.h"
+#include "rtkQuadricScanlineFunction.h"
 
 namespace rtk
 {
@@ -44,49 +42,17 @@ void DrawCylinderImageFilter<TInputImage, TOutputImage>::ThreadedGenerateData(co
 {
   //Getting phantom parameters
   EQPFunctionType::Pointer sqpFunctor = EQPFunctionType::New();
-  FigureType Cylinder;
-
-  Cylinder.semiprincipalaxis[0] = m_Axis[0];
-  Cylinder.semiprincipalaxis[1] = m_Axis[1];
-  Cylinder.semiprincipalaxis[2] = m_Axis[2];
-  Cylinder.center[0] = m_Center[0];
-  Cylinder.center[1] = m_Center[1];
-  Cylinder.center[2] = m_Center[2];
-  Cylinder.angle = m_Angle;
-  Cylinder.density = m_Density;
-
-  typename TOutputImage::PointType point;
-  const    TInputImage *           input = this->GetInput();
-
-  typename itk::ImageRegionConstIterator<TInputImage> itIn( input, outputRegionForThread);
-  typename itk::ImageRegionIterator<TOutputImage> itOut(this->GetOutput(), outputRegionForThread);
-
   //Set type of Figure
   sqpFunctor->SetFigure("Cylinder");
   //Translate from regular expression to quadric
-  sqpFunctor->Translate(Cylinder.semiprincipalaxis);
+  sqpFunctor->Translate(m_Axis);
   //Apply rotation and translation if necessary
-  sqpFunctor->Rotate(Cylinder.angle, Cylinder.center);
-
-  while( !itOut.IsAtEnd() )
-  {
-    this->GetInput()->TransformIndexToPhysicalPoint(itOut.GetIndex(), point);
+  sqpFunctor->Rotate(m_Angle, m_Center);
+  QuadricScanlineFunction quadric;
+  quadric.SetQuadric(sqpFunctor);
 
-    double QuadricEllip = sqpFunctor->GetA()*point[0]*point[0]   +
-                          sqpFunctor->GetB()*point[1]*point[1]   +
-                          sqpFunctor->GetC()*point[2]*point[2]   +
-                          sqpFunctor->GetD()*point[0]*point[1]   +
-                          sqpFunctor->GetE()*point[0]*point[2]   +
-                          sqpFunctor->GetF()*point[1]*point[2]   +
-                          sqpFunctor->GetG()*point[0] + sqpFunctor->GetH()*point[1] +
-                          sqpFunctor->GetI()*point[2] + sqpFunctor->GetJ();
-    if(QuadricEllip<0)
-      itOut.Set(Cylinder.density + itIn.Get());
-    else
-      itOut.Set(0.);
-    ++itIn;
-    ++itOut;
-  }
+  QuadricScanlineFunction::DrawRegion(this->GetInput(), this->GetOutput(), outputRegionForThread,
+                                      &quadric, &m_Density, 1, true);
 }
 
 }// end namespace rtk
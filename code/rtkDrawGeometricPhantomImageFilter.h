@@ -24,6 +24,7 @@
 #include "rtkThreeDCircularProjectionGeometry.h"
 #include "rtkConvertEllipsoidToQuadricParametersFunction.h"
 #include "rtkGeometricPhantomFileReader.h"
+#include "rtkQuadricScanlineFunction.h"
 
 #include <vector>
 
@@ -35,6 +36,9 @@ namespace rtk
  *
  * The filter draws a list of quadric shapes which parameters are passed by a
  * file. See rtkGeometricPhantomFileReader.h for the file format.
+ * All shapes are drawn in a single pass over the volume: for each row, the
+ * quadric of each shape is solved analytically and only the span of the row
+ * which is inside the shape is filled with its density.
  *
  * \test rtkdrawgeometricphantomtest.cxx
  *
@@ -75,13 +79,19 @@ protected:
   DrawGeometricPhantomImageFilter() {}
   virtual ~DrawGeometricPhantomImageFilter() {};
 
-  virtual void GenerateData();
+  /** Reads the config file and converts the shapes to quadrics. */
+  virtual void BeforeThreadedGenerateData();
+
+  virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
 
 private:
   DrawGeometricPhantomImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);            //purposely not implemented
   StringType m_ConfigFile;
 
+  std::vector< QuadricScanlineFunction > m_Quadrics;
+  std::vector< double >                  m_Densities;
+
 };
 
 } // end namespace rtk
@@ -20,18 +20,13 @@
 #define __rtkDrawGeometricPhantomImageFilter_txx
 
 #include <iostream>
-#include "rtkDrawEllipsoidImageFilter.h"
-#include "rtkDrawCylinderImageFilter.h"
-#include "rtkDrawConeImageFilter.h"
-#include "itkAddImageFilter.h"
-
 #include "rtkHomogeneousMatrix.h"
 
 namespace rtk
 {
 
 template <class TInputImage, class TOutputImage>
-void DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
+void DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
 {
   VectorOfVectorType figParam;
   //Getting phantom parameters
@@ -41,11 +36,10 @@ void DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
   VectorType semiprincipalaxis;
   VectorType center;
 
-  //Add Image Filter used to concatenate the different figures obtained on each iteration
-  typedef itk::AddImageFilter <TOutputImage, TOutputImage, TOutputImage> AddImageFilterType;
-  typename AddImageFilterType::Pointer addFilter = AddImageFilterType::New();
-
+  EQPFunctionType::Pointer sqpFunctor = EQPFunctionType::New();
   unsigned int NumberOfFig = figParam.size();
+  m_Quadrics.resize(NumberOfFig);
+  m_Densities.resize(NumberOfFig);
   for(unsigned int i=0; i<NumberOfFig; i++)
   {
     //Set figures parameters
@@ -60,85 +54,43 @@ void DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::GenerateData()
     switch ((int)figParam[i][0])
     {
       case 0:
-      {
-        // Create figure object (3D ellipsoid).
-        typedef rtk::DrawEllipsoidImageFilter<TInputImage, TOutputImage> DEType;
-        typename DEType::Pointer de = DEType::New();
-        de->SetInput( this->GetInput() );
-        de->SetAxis(semiprincipalaxis);
-        de->SetCenter(center);
-        de->SetAngle(figParam[i][7]);
-        de->SetDensity(figParam[i][8]);
-        de->Update();
-        addFilter->SetInput1(de->GetOutput());
-        if(!i)
-          addFilter->SetInput2(this->GetInput());
-        else
-          addFilter->SetInput2(this->GetOutput());
+        // 3D ellipsoid
+        sqpFunctor->SetFigure("Ellipsoid");
         break;
-      }
       case 1:
-      {
-        // Create figure object (3D cylinder).
-        typedef rtk::DrawCylinderImageFilter<TInputImage, TOutputImage> DCType;
-        typename DCType::Pointer dc = DCType::New();
-        dc->SetInput( this->GetInput() );
-        dc->SetAxis(semiprincipalaxis);
-        dc->SetCenter(center);
-        dc->SetAngle(figParam[i][7]);
-        dc->SetDensity(figParam[i][8]);
-        dc->Update();
-        addFilter->SetInput1(dc->GetOutput());
-        if(!i)
-          addFilter->SetInput2(this->GetInput());
-        else
-          addFilter->SetInput2(this->GetOutput());
+        // 3D cylinder
+        sqpFunctor->SetFigure("Cylinder");
         break;
-      }
       case 2:
-      {
-        // Create figure object (3D cone).
-        typedef rtk::DrawConeImageFilter<TInputImage, TOutputImage> DCOType;
-        typename DCOType::Pointer dco = DCOType::New();
-        dco->SetInput( this->GetInput() );
-        dco->SetAxis(semiprincipalaxis);
-        dco->SetCenter(center);
-        dco->SetAngle(figParam[i][7]);
-        dco->SetDensity(figParam[i][8]);
-        dco->Update();
-        addFilter->SetInput1(dco->GetOutput());
-        if(!i)
-          addFilter->SetInput2(this->GetInput());
-        else
-          addFilter->SetInput2(this->GetOutput());
+        // 3D cone
+        sqpFunctor->SetFigure("Cone");
         break;
-      }
       case 3:
-      {
-        // Create figure object (3D box).
-        typedef rtk::DrawEllipsoidImageFilter<TInputImage, TOutputImage> DBType;
-        typename DBType::Pointer db = DBType::New();
-        db->SetInput( this->GetInput() );
-        db->SetAxis(semiprincipalaxis);
-        db->SetCenter(center);
-        db->SetAngle(figParam[i][7]);
-        db->SetDensity(figParam[i][8]);
-        db->Update();
-        addFilter->SetInput1(db->GetOutput());
-        if(!i)
-          addFilter->SetInput2(this->GetInput());
-        else
-          addFilter->SetInput2(this->GetOutput());
+        // 3D box, drawn as an ellipsoid
+        sqpFunctor->SetFigure("Ellipsoid");
         break;
-      }
+      default:
+        itkExceptionMacro(<< "Unknown figure type " << figParam[i][0]
+                          << " in " << m_ConfigFile);
     }
-
-    addFilter->Update();
-    this->GraftOutput( addFilter->GetOutput() );
-
+    sqpFunctor->Translate(semiprincipalaxis);
+    sqpFunctor->Rotate(figParam[i][7], center);
+    m_Quadrics[i].SetQuadric(sqpFunctor);
+    m_Densities[i] = figParam[i][8];
   }
 }
 
+template <class TInputImage, class TOutputImage>
+void DrawGeometricPhantomImageFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                                                                                      ThreadIdType itkNotUsed(threadId) )
+{
+  const unsigned int nFig = m_Quadrics.size();
+  QuadricScanlineFunction::DrawRegion(this->GetInput(), this->GetOutput(), outputRegionForThread,
+                                      (nFig)?&(m_Quadrics[0]):NULL,
+                                      (nFig)?&(m_Densities[0]):NULL,
+                                      nFig, false);
+}
+
 }// end namespace rtk
 
 #endif
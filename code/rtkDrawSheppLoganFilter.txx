@@ -20,10 +20,8 @@
 #define __rtkDrawSheppLoganFilter_txx
 
 #include <iostream>
-#include <itkImageRegionConstIterator.h>
-#include <itkImageRegionIterator.h>
-
 #include "rtkHomogeneousMatrix.h"
+#include "rtkQuadricScanlineFunction.h"
 
 #include "rtkMacro.h"
 
@@ -138,42 +136,25 @@ void DrawSheppLoganFilter<TInputImage, TOutputImage>::ThreadedGenerateData(const
   shepplogan[9].attenuation = -0.02;
 
 
-  typename TOutputImage::PointType point;
-  const    TInputImage *           input = this->GetInput();
-
+  // Quadric of each ellipsoid
+  std::vector< QuadricScanlineFunction > quadrics(NumberOfFig);
+  std::vector< double > densities(NumberOfFig);
   for(unsigned int i=0; i<NumberOfFig; i++)
-  {
-    typename itk::ImageRegionConstIterator<TInputImage> itIn( input, outputRegionForThread);
-    typename itk::ImageRegionIterator<TOutputImage> itOut(this->GetOutput(), outputRegionForThread);
-
+    {
     //Set type of Figure
     sqpFunctor->SetFigure("Ellipsoid");
     //Translate from regular expression to quadric
     sqpFunctor->Translate(shepplogan[i].semiprincipalaxis);
     //Applies rotation and translation if necessary
     sqpFunctor->Rotate(shepplogan[i].angle, shepplogan[i].center);
-    while( !itOut.IsAtEnd() )
-      {
-      this->GetInput()->TransformIndexToPhysicalPoint(itOut.GetIndex(), point);
-
-      double QuadricEllip = sqpFunctor->GetA()*point[0]*point[0]   +
-                   sqpFunctor->GetB()*point[1]*point[1]   +
-                   sqpFunctor->GetC()*point[2]*point[2]   +
-                   sqpFunctor->GetD()*point[0]*point[1]   +
-                   sqpFunctor->GetE()*point[0]*point[2]   +
-                   sqpFunctor->GetF()*point[1]*point[2]   +
-                   sqpFunctor->GetG()*point[0] + sqpFunctor->GetH()*point[1] +
-                   sqpFunctor->GetI()*point[2] + sqpFunctor->GetJ();
-      if(QuadricEllip<0){
-        itOut.Set(shepplogan[i].attenuation + itIn.Get());
-      }
-      else if (i==0)
-        itOut.Set(0.);
-      ++itIn;
-      ++itOut;
-      }
-    input = this->GetOutput();
-  }
+    quadrics[i].SetQuadric(sqpFunctor);
+    densities[i] = shepplogan[i].attenuation;
+    }
+
+  // The first ellipsoid sets the voxels outside the phantom to 0, the other
+  // ones are added only where they are
+  QuadricScanlineFunction::DrawRegion(this->GetInput(), this->GetOutput(), outputRegionForThread,
+                                      &(quadrics[0]), &(densities[0]), NumberOfFig, true);
 }
 
 }// end namespace rtk
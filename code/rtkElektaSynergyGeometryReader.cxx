@@ -25,7 +25,9 @@ rtk::ElektaSynergyGeometryReader
   m_Geometry(NULL),
   m_DicomUID(""),
   m_ImageDbfFileName("IMAGE.DBF"),
-  m_FrameDbfFileName("FRAME.DBF")
+  m_FrameDbfFileName("FRAME.DBF"),
+  m_ImageDbfIndexFileName(""),
+  m_FrameDbfIndexFileName("")
 {
 }
 
@@ -39,12 +41,32 @@ rtk::ElektaSynergyGeometryReader
     itkGenericExceptionMacro( << "Couldn't open " 
                               << m_ImageDbfFileName);
 
-  // Search for correct record
-  bool bReadOk;
-  do {
-    bReadOk = dbImage.ReadNextRecord();
+  const int uidIndex = dbImage.GetFieldIndex("DICOM_UID");
+  const int dbidIndex = dbImage.GetFieldIndex("DBID");
+  if(uidIndex<0 || dbidIndex<0)
+    itkGenericExceptionMacro( << "Missing field DICOM_UID or DBID in table "
+                              << m_ImageDbfFileName );
+
+  // Search for correct record, with the index if required
+  bool bReadOk = false;
+  if(m_ImageDbfIndexFileName != "")
+    {
+    rtk::DbfIndex index(dbImage, "DICOM_UID", m_ImageDbfIndexFileName);
+    std::vector<unsigned int> records;
+    index.Find(m_DicomUID, records);
+    bReadOk = !records.empty() && dbImage.GoToRecord(records[0]) &&
+              dbImage.GetFieldView(uidIndex) == m_DicomUID;
+    }
+
+  // Scan the table if there is no index or if its record could not be read
+  if(!bReadOk)
+    {
+    dbImage.Rewind();
+    do {
+      bReadOk = dbImage.ReadNextRecord();
+      }
+    while(bReadOk && dbImage.GetFieldView(uidIndex) != m_DicomUID);
     }
-  while(bReadOk && std::string(m_DicomUID) != dbImage.GetFieldAsString("DICOM_UID") );
 
   // Error message if not found
   if(!bReadOk)
@@ -55,7 +77,7 @@ rtk::ElektaSynergyGeometryReader
                               << m_ImageDbfFileName );
     }
 
-  return dbImage.GetFieldAsString("DBID");
+  return dbImage.GetFieldView(dbidIndex).ToString();
 }
 
 void
@@ -71,14 +93,52 @@ rtk::ElektaSynergyGeometryReader
     itkGenericExceptionMacro( << "Couldn't open " 
                               << m_FrameDbfFileName);
 
+  const int imaIndex = dbFrame.GetFieldIndex("IMA_DBID");
+  const int angIndex = dbFrame.GetFieldIndex("PROJ_ANG");
+  const int uIndex = dbFrame.GetFieldIndex("U_CENTRE");
+  const int vIndex = dbFrame.GetFieldIndex("V_CENTRE");
+  if(imaIndex<0 || angIndex<0 || uIndex<0 || vIndex<0)
+    itkGenericExceptionMacro( << "Missing field IMA_DBID, PROJ_ANG, U_CENTRE or V_CENTRE in table "
+                              << m_FrameDbfFileName );
+
+  const size_t nInitial = projAngle.size();
+  if(m_FrameDbfIndexFileName != "")
+    {
+    // Only visit the records of the acquisition
+    rtk::DbfIndex index(dbFrame, "IMA_DBID", m_FrameDbfIndexFileName);
+    std::vector<unsigned int> records;
+    index.Find(imageID, records);
+    bool bIndexOk = true;
+    for(unsigned int i=0; bIndexOk && i<records.size(); i++)
+      {
+      bIndexOk = dbFrame.GoToRecord(records[i]) && dbFrame.GetFieldView(imaIndex) == imageID;
+      if(bIndexOk)
+        {
+        projAngle.push_back(dbFrame.GetFieldView(angIndex).ToDouble() );
+        projFlexX.push_back(dbFrame.GetFieldView(uIndex).ToDouble() );
+        projFlexY.push_back(dbFrame.GetFieldView(vIndex).ToDouble() );
+        }
+      }
+    if(bIndexOk)
+      return;
+
+    // A record of the index could not be read, discard the index
+    itkWarningMacro( << "Index " << m_FrameDbfIndexFileName << " does not match "
+                     << m_FrameDbfFileName << ", the table is scanned instead" );
+    projAngle.resize(nInitial);
+    projFlexX.resize(nInitial);
+    projFlexY.resize(nInitial);
+    dbFrame.Rewind();
+    }
+
   // Go through the database, select correct records and get data
   while( dbFrame.ReadNextRecord() )
     {
-    if(dbFrame.GetFieldAsString("IMA_DBID") == imageID)
+    if(dbFrame.GetFieldView(imaIndex) == imageID)
       {
-      projAngle.push_back(dbFrame.GetFieldAsDouble("PROJ_ANG") );
-      projFlexX.push_back(dbFrame.GetFieldAsDouble("U_CENTRE") );
-      projFlexY.push_back(dbFrame.GetFieldAsDouble("V_CENTRE") );
+      projAngle.push_back(dbFrame.GetFieldView(angIndex).ToDouble() );
+      projFlexX.push_back(dbFrame.GetFieldView(uIndex).ToDouble() );
+      projFlexY.push_back(dbFrame.GetFieldView(vIndex).ToDouble() );
       }
     }
 }
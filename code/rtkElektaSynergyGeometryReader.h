@@ -71,6 +71,15 @@ public:
   itkGetMacro(FrameDbfFileName, std::string);
   itkSetMacro(FrameDbfFileName, std::string);
 
+  /** Set the paths to optional persistent indices of IMAGE.DBF on DICOM_UID
+   * and of FRAME.DBF on IMA_DBID. If set, the records of the acquisition
+   * are found with the index instead of scanning the table. The index file
+   * is created, or recreated if the table has changed, at the first use. */
+  itkGetMacro(ImageDbfIndexFileName, std::string);
+  itkSetMacro(ImageDbfIndexFileName, std::string);
+  itkGetMacro(FrameDbfIndexFileName, std::string);
+  itkSetMacro(FrameDbfIndexFileName, std::string);
+
 protected:
   ElektaSynergyGeometryReader();
 
@@ -92,6 +101,8 @@ private:
   std::string           m_DicomUID;
   std::string           m_ImageDbfFileName;
   std::string           m_FrameDbfFileName;  
+  std::string           m_ImageDbfIndexFileName;
+  std::string           m_FrameDbfIndexFileName;
 };
 
 }
@@ -68,6 +68,9 @@ protected:
   virtual ~ElektaSynergyLookupTableImageFilter() {
   }
 
+  /** Fill the lookup table shared by all instances. */
+  static void BuildLookupTable(LookupTableType *lut);
+
 private:
   ElektaSynergyLookupTableImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);              //purposely not implemented
@@ -111,6 +114,11 @@ public:
   /** Runtime information support. */
   itkTypeMacro(ElektaSynergyRawLookupTableImageFilter, LookupTableImageFilter);
 
+  /** Fill the lookup table shared by all instances. Public so that the table
+   * can be shared with readers which apply it while decoding, see
+   * ProjectionsReader. */
+  static void BuildLookupTable(LookupTableType *lut);
+
 protected:
   ElektaSynergyRawLookupTableImageFilter();
   virtual ~ElektaSynergyRawLookupTableImageFilter() {
@@ -165,6 +173,9 @@ protected:
   virtual ~ElektaSynergyLogLookupTableImageFilter() {
   }
 
+  /** Fill the lookup table shared by all instances. */
+  static void BuildLookupTable(LookupTableType *lut);
+
 private:
   ElektaSynergyLogLookupTableImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);                         //purposely not implemented
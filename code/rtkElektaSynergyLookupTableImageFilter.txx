@@ -26,13 +26,15 @@ template <class TOutputImage>
 ElektaSynergyLookupTableImageFilter<TOutputImage>
 ::ElektaSynergyLookupTableImageFilter()
 {
-  // Create the lut
-  typename LookupTableType::Pointer lut = LookupTableType::New();
-  typename LookupTableType::SizeType size;
-  size[0] = itk::NumericTraits<InputImagePixelType>::max() -
-            itk::NumericTraits<InputImagePixelType>::min() + 1;
-  lut->SetRegions( size );
-  lut->Allocate();
+  this->SetLookupTable( Superclass::GetOrCreateSharedLookupTable("ElektaSynergy", BuildLookupTable) );
+}
+
+template <class TOutputImage>
+void
+ElektaSynergyLookupTableImageFilter<TOutputImage>
+::BuildLookupTable(LookupTableType *lut)
+{
+  const typename LookupTableType::SizeType size = lut->GetBufferedRegion().GetSize();
 
   // Iterate and set lut
   OutputImagePixelType logRef;
@@ -53,22 +55,21 @@ ElektaSynergyLookupTableImageFilter<TOutputImage>
   //Last value takes value of pixel #1
   --it;
   it.Set( logRef - log( OutputImagePixelType(size[0]-1) ) );
-
-  // Set the lut to member and functor
-  this->SetLookupTable(lut);
 }
 
 template <unsigned int VImageDimension>
 ElektaSynergyRawLookupTableImageFilter<VImageDimension>
 ::ElektaSynergyRawLookupTableImageFilter()
 {
-  // Create the lut
-  typename LookupTableType::Pointer lut = LookupTableType::New();
-  typename LookupTableType::SizeType size;
-  size[0] = itk::NumericTraits<InputImagePixelType>::max() -
-            itk::NumericTraits<InputImagePixelType>::min() + 1;
-  lut->SetRegions( size );
-  lut->Allocate();
+  this->SetLookupTable( Superclass::GetOrCreateSharedLookupTable("ElektaSynergyRaw", BuildLookupTable) );
+}
+
+template <unsigned int VImageDimension>
+void
+ElektaSynergyRawLookupTableImageFilter<VImageDimension>
+::BuildLookupTable(LookupTableType *lut)
+{
+  const typename LookupTableType::SizeType size = lut->GetBufferedRegion().GetSize();
 
   // Iterate and set lut
   itk::ImageRegionIteratorWithIndex<LookupTableType> it( lut, lut->GetBufferedRegion() );
@@ -87,22 +88,21 @@ ElektaSynergyRawLookupTableImageFilter<VImageDimension>
   //Last value takes value of pixel #1
   --it;
   it.Set( OutputImagePixelType(size[0]-1) );
-
-  // Set the lut to member and functor
-  this->SetLookupTable(lut);
 }
 
 template <class TOutputImage>
 ElektaSynergyLogLookupTableImageFilter<TOutputImage>
 ::ElektaSynergyLogLookupTableImageFilter()
 {
-  // Create the lut
-  typename LookupTableType::Pointer lut = LookupTableType::New();
-  typename LookupTableType::SizeType size;
-  size[0] = itk::NumericTraits<InputImagePixelType>::max() -
-            itk::NumericTraits<InputImagePixelType>::min() + 1;
-  lut->SetRegions( size );
-  lut->Allocate();
+  this->SetLookupTable( Superclass::GetOrCreateSharedLookupTable("ElektaSynergyLog", BuildLookupTable) );
+}
+
+template <class TOutputImage>
+void
+ElektaSynergyLogLookupTableImageFilter<TOutputImage>
+::BuildLookupTable(LookupTableType *lut)
+{
+  const typename LookupTableType::SizeType size = lut->GetBufferedRegion().GetSize();
 
   // Iterate and set lut
   OutputImagePixelType                       logRef = log(OutputImagePixelType(size[0]) );
@@ -114,9 +114,6 @@ ElektaSynergyLogLookupTableImageFilter<TOutputImage>
     it.Set( logRef - log( OutputImagePixelType(it.GetIndex()[0]) ) );
     ++it;
     }
-
-  // Set the lut to member and functor
-  this->SetLookupTable(lut);
 }
 
 }
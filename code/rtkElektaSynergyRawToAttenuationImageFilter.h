@@ -36,6 +36,9 @@ namespace rtk
  * attenuation images usable in standard reconstruction algorithms,*
  * e.g. Feldkamp algorithm.
  *
+ * The first lookup table is pixel-wise and can be applied while decoding the
+ * files, see ProjectionsReader. ApplyRawLookupTable must then be set to false.
+ *
  * \test rtkelektatest.cxx
  *
  * \author Simon Rit
@@ -63,6 +66,11 @@ public:
   /** Runtime information support. */
   itkTypeMacro(ElektaSynergyRawToAttenuationImageFilter, itk::ImageToImageFilter);
 
+  /** Get / Set whether the raw lookup table must be applied by this filter
+   * (default) or has already been applied to the input. */
+  itkGetMacro(ApplyRawLookupTable, bool);
+  itkSetMacro(ApplyRawLookupTable, bool);
+
 protected:
   ElektaSynergyRawToAttenuationImageFilter();
   ~ElektaSynergyRawToAttenuationImageFilter(){
@@ -91,6 +99,8 @@ private:
   typename LogLookupTableFilterType::Pointer m_LogLookupTableFilter;
   typename CropFilterType::Pointer           m_CropFilter;
   typename ScatterFilterType::Pointer        m_ScatterFilter;
+
+  bool m_ApplyRawLookupTable;
 }; // end of class
 
 } // end namespace rtk
@@ -41,7 +41,8 @@ ElektaSynergyRawToAttenuationImageFilter<TInputImage, TOutputImage>
 
 template <class TInputImage, class TOutputImage>
 ElektaSynergyRawToAttenuationImageFilter<TInputImage, TOutputImage>
-::ElektaSynergyRawToAttenuationImageFilter()
+::ElektaSynergyRawToAttenuationImageFilter():
+  m_ApplyRawLookupTable(true)
 {
   m_CropFilter = CropFilterType::New();
   m_RawLookupTableFilter = RawLookupTableFilterType::New();
@@ -66,6 +67,10 @@ ElektaSynergyRawToAttenuationImageFilter<TInputImage, TOutputImage>
 ::GenerateOutputInformation()
 {
   m_CropFilter->SetInput(this->GetInput() );
+  if(m_ApplyRawLookupTable)
+    m_ScatterFilter->SetInput( m_RawLookupTableFilter->GetOutput() );
+  else
+    m_ScatterFilter->SetInput( m_CropFilter->GetOutput() );
   m_LogLookupTableFilter->UpdateOutputInformation();
   this->GetOutput()->SetOrigin( m_LogLookupTableFilter->GetOutput()->GetOrigin() );
   this->GetOutput()->SetSpacing( m_LogLookupTableFilter->GetOutput()->GetSpacing() );
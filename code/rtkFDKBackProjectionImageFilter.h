@@ -31,6 +31,10 @@ namespace rtk
  * [Feldkamp, Davis, Kress, 1984] algorithm for filtered backprojection
  * reconstruction of cone-beam CT images with a circular source trajectory.
  *
+ * If a field of view span table is set (see
+ * BackProjectionImageFilter::SetFieldOfViewSpanTable), the rows of the
+ * volume are only backprojected over their span.
+ *
  * \author Simon Rit
  *
  * \ingroup Projector
@@ -20,7 +20,8 @@
 #define __rtkFDKBackProjectionImageFilter_txx
 
 #include <itkImageRegionIteratorWithIndex.h>
-#include <itkLinearInterpolateImageFunction.h>
+
+#include "rtkFDKBackProjectionKernel.h"
 
 #define BILINEAR_BACKPROJECTION
 
@@ -48,10 +49,6 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
   const unsigned int nProj = this->GetInput(1)->GetLargestPossibleRegion().GetSize(Dimension-1);
   const unsigned int iFirstProj = this->GetInput(1)->GetLargestPossibleRegion().GetIndex(Dimension-1);
 
-  // Create interpolator, could be any interpolation
-  typedef itk::LinearInterpolateImageFunction< ProjectionImageType, double > InterpolatorType;
-  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
-
   // Iterators on volume input and output
   typedef itk::ImageRegionConstIterator<TInputImage> InputRegionIterator;
   InputRegionIterator itIn(this->GetInput(), outputRegionForThread);
@@ -77,8 +74,15 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
   itk::ContinuousIndex<double, Dimension> rotCenterIndex;
   this->GetInput(0)->TransformPhysicalPointToContinuousIndex(rotCenterPoint, rotCenterIndex);
 
-  // Continuous index at which we interpolate
-  itk::ContinuousIndex<double, Dimension-1> pointProj;
+  // Pointer in memory to index (0,0,0) which does not necessarily exist
+  typedef FDKBackProjectionKernel<typename TOutputImage::PixelType, typename ProjectionImageType::PixelType> KernelType;
+  typename TOutputImage::SizeType vBufferSize = this->GetOutput()->GetBufferedRegion().GetSize();
+  typename TOutputImage::IndexType vBufferIndex = this->GetOutput()->GetBufferedRegion().GetIndex();
+  typename TOutputImage::PixelType *pVolZeroPointer = this->GetOutput()->GetBufferPointer();
+  pVolZeroPointer -= vBufferIndex[0] + vBufferSize[0] * (vBufferIndex[1] + vBufferSize[1] * vBufferIndex[2]);
+
+  // Optional field of view
+  const FieldOfViewSpanTable *fov = this->GetFieldOfViewSpanTable();
 
   // Go over each projection
   for(unsigned int iProj=iFirstProj; iProj<iFirstProj+nProj; iProj++)
@@ -86,7 +90,7 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
     // Extract the current slice
     ProjectionImagePointer projection;
     projection = this->template GetProjection< ProjectionImageType >(iProj);
-    interpolator->SetInputImage(projection);
+    typename ProjectionImageType::IndexType pIndex = projection->GetBufferedRegion().GetIndex();
 
     // Index to index matrix normalized to have a correct backprojection weight
     // (1 at the isocenter)
@@ -108,33 +112,30 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
       continue;
       }
 
-    // Go over each voxel
-    itOut.GoToBegin();
-    while(!itOut.IsAtEnd() )
+    // General case with the raw-pointer kernel, the projection index of the
+    // buffered region being folded into the matrix
+    typename KernelType::MatrixType kernelMatrix;
+    for(unsigned int j=0; j<4; j++)
       {
-      // Compute projection index
-      for(unsigned int i=0; i<Dimension-1; i++)
-        {
-        pointProj[i] = matrix[i][Dimension];
-        for(unsigned int j=0; j<Dimension; j++)
-          pointProj[i] += matrix[i][j] * itOut.GetIndex()[j];
-        }
-
-      // Apply perspective
-      double perspFactor = matrix[Dimension-1][Dimension];
-      for(unsigned int j=0; j<Dimension; j++)
-        perspFactor += matrix[Dimension-1][j] * itOut.GetIndex()[j];
-      perspFactor = 1/perspFactor;
-      for(unsigned int i=0; i<Dimension-1; i++)
-        pointProj[i] = pointProj[i]*perspFactor;
-
-      // Interpolate if in projection
-      if( interpolator->IsInsideBuffer(pointProj) )
+      kernelMatrix[0][j] = matrix[0][j] - pIndex[0] * matrix[2][j];
+      kernelMatrix[1][j] = matrix[1][j] - pIndex[1] * matrix[2][j];
+      kernelMatrix[2][j] = matrix[2][j];
+      }
+    const int pSize[2] = { (int)projection->GetBufferedRegion().GetSize(0),
+                           (int)projection->GetBufferedRegion().GetSize(1) };
+    for(int k=outputRegionForThread.GetIndex(2); k<outputRegionForThread.GetIndex(2)+(int)outputRegionForThread.GetSize(2); k++)
+      {
+      for(int j=outputRegionForThread.GetIndex(1); j<outputRegionForThread.GetIndex(1)+(int)outputRegionForThread.GetSize(1); j++)
         {
-        itOut.Set( itOut.Get() + perspFactor*perspFactor*interpolator->EvaluateAtContinuousIndex(pointProj) );
+        // Only the span of the row in the field of view is backprojected
+        int i = outputRegionForThread.GetIndex(0);
+        int iEnd = outputRegionForThread.GetIndex(0) + (int)outputRegionForThread.GetSize(0);
+        if(fov)
+          fov->ClipRow(j, k, i, iEnd);
+        if(i<iEnd)
+          KernelType::BackProjectRow(pVolZeroPointer + i + vBufferSize[0] * (j + k * vBufferSize[1]),
+                                     i, iEnd, j, k, kernelMatrix, projection->GetBufferPointer(), pSize);
         }
-
-      ++itOut;
       }
     }
 }
@@ -161,11 +162,21 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
   int    ui, vi;
   double du;
 
+  // Optional field of view
+  const FieldOfViewSpanTable *fov = this->GetFieldOfViewSpanTable();
+
   for(int k=region.GetIndex(2); k<region.GetIndex(2)+(int)region.GetSize(2); k++)
     {
     for(int j=region.GetIndex(1); j<region.GetIndex(1)+(int)region.GetSize(1); j++)
       {
+      // Only the span of the row in the field of view is backprojected
       int i = region.GetIndex(0);
+      int iEnd = region.GetIndex(0) + (int)region.GetSize(0);
+      if(fov)
+        fov->ClipRow(j, k, i, iEnd);
+      if(i>=iEnd)
+        continue;
+
       u = matrix[0][0] * i + matrix[0][1] * j + matrix[0][2] * k + matrix[0][3];
       v =                    matrix[1][1] * j + matrix[1][2] * k + matrix[1][3];
       w =                    matrix[2][1] * j + matrix[2][2] * k + matrix[2][3];
@@ -194,7 +205,7 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
         pVol = pVolZeroPointer + i + vBufferSize[0] * (j + k * vBufferSize[1] );
 
         // Innermost loop
-        for(; i<(region.GetIndex(0) + (int)region.GetSize(0)); i++, u += du, pVol++)
+        for(; i<iEnd; i++, u += du, pVol++)
           {
 #ifdef BILINEAR_BACKPROJECTION
           ui = vnl_math_floor(u);
@@ -240,6 +251,9 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
   int    ui, vi;
   double du;
 
+  // Optional field of view
+  const FieldOfViewSpanTable *fov = this->GetFieldOfViewSpanTable();
+
   for(int k=region.GetIndex(2); k<region.GetIndex(2)+(int)region.GetSize(2); k++)
     {
     for(int i=region.GetIndex(0); i<region.GetIndex(0)+(int)region.GetSize(0); i++)
@@ -268,6 +282,8 @@ FDKBackProjectionImageFilter<TInputImage,TOutputImage>
         pVol = pVolZeroPointer + i + vBufferSize[0] * (j + k * vBufferSize[1] );
         for(; j<(region.GetIndex(1) + (int)region.GetSize(1)); j++, pVol += vBufferSize[0], u += du)
           {
+          if(fov && !fov->IsInside(i, j, k))
+            continue;
 #ifdef BILINEAR_BACKPROJECTION
           ui = vnl_math_floor(u);
           if(ui>=0 && ui<(int)pSize[0]-1)
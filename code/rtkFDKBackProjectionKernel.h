@@ -0,0 +1,118 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkFDKBackProjectionKernel_h
+#define __rtkFDKBackProjectionKernel_h
+
+#include <vnl/vnl_math.h>
+
+namespace rtk
+{
+
+/** \class FDKBackProjectionKernel
+ * \brief Raw-pointer kernel of the FDK backprojection.
+ *
+ * Backprojects one projection into a row or a slab of a volume stored in
+ * memory with x first, then y and z. The 3x4 matrix maps the voxel index
+ * (i,j,k,1) to the homogeneous projection index (u*w,v*w,w). Each voxel
+ * receives the bilinear interpolation of the projection at (u,v) weighted by
+ * 1/w^2. As with itk::LinearInterpolateImageFunction::IsInsideBuffer, voxels
+ * are backprojected if (u,v) is in [-0.5,size-0.5[, the neighbors outside
+ * the projection being clamped to its border, and are not modified
+ * otherwise.
+ *
+ * The kernel does not depend on ITK images so that it can be used outside
+ * pipelines, e.g., by the RabbitCT plugin. It is the general case of
+ * FDKBackProjectionImageFilter and BackProjectVoxel is also used by
+ * FDKWarpBackProjectionImageFilter for warped voxels.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Projector
+ */
+template <class TVolumePixel, class TProjectionPixel>
+class FDKBackProjectionKernel
+{
+public:
+  typedef double MatrixType[3][4];
+
+  /** Backproject the projection at (up,vp) into the voxel pVol, if (up,vp)
+   * is in the projection, with the weight invw^2. The projection has
+   * size[0] x size[1] pixels. */
+  static inline void BackProjectVoxel(TVolumePixel *pVol, const double up, const double vp, const double invw,
+                                      const TProjectionPixel *projection, const int size[2])
+    {
+    if(up<-0.5 || up>=size[0]-0.5 || vp<-0.5 || vp>=size[1]-0.5)
+      return;
+    const int ui = vnl_math_floor(up);
+    const int vi = vnl_math_floor(vp);
+    const double u1 = up-ui;
+    const double u2 = 1.0-u1;
+    const double v1 = vp-vi;
+    const double v2 = 1.0-v1;
+    if(ui>=0 && ui<size[0]-1 && vi>=0 && vi<size[1]-1)
+      {
+      const TProjectionPixel *pProj = projection + ui + vi * size[0];
+      *pVol += invw * invw * (v2 * (u2 * pProj[0]       + u1 * pProj[1]) +
+                              v1 * (u2 * pProj[size[0]] + u1 * pProj[size[0]+1]) );
+      }
+    else
+      {
+      // Half pixel border, neighbors clamped to the projection
+      const int u0c = vnl_math_max(ui, 0);
+      const int u1c = vnl_math_min(ui+1, size[0]-1);
+      const TProjectionPixel *pRow0 = projection + vnl_math_max(vi, 0) * size[0];
+      const TProjectionPixel *pRow1 = projection + vnl_math_min(vi+1, size[1]-1) * size[0];
+      *pVol += invw * invw * (v2 * (u2 * pRow0[u0c] + u1 * pRow0[u1c]) +
+                              v1 * (u2 * pRow1[u0c] + u1 * pRow1[u1c]) );
+      }
+    }
+
+  /** Backproject into the voxels [iBegin, iEnd) of row (j,k). pVol points to
+   * voxel (iBegin,j,k) and the projection has size[0] x size[1] pixels. */
+  static inline void BackProjectRow(TVolumePixel *pVol, const int iBegin, const int iEnd, const int j, const int k,
+                                    const MatrixType &matrix, const TProjectionPixel *projection,
+                                    const int size[2])
+    {
+    double u = matrix[0][0] * iBegin + matrix[0][1] * j + matrix[0][2] * k + matrix[0][3];
+    double v = matrix[1][0] * iBegin + matrix[1][1] * j + matrix[1][2] * k + matrix[1][3];
+    double w = matrix[2][0] * iBegin + matrix[2][1] * j + matrix[2][2] * k + matrix[2][3];
+    for(int i=iBegin; i<iEnd; i++, pVol++, u+=matrix[0][0], v+=matrix[1][0], w+=matrix[2][0])
+      {
+      // Apply perspective
+      const double invw = 1./w;
+      BackProjectVoxel(pVol, u * invw, v * invw, invw, projection, size);
+      }
+    }
+
+  /** Backproject into the slices [kBegin, kEnd) of a volume of size[0] x
+   * size[1] x size[2] voxels pointed by volume. */
+  static void BackProjectSlab(TVolumePixel *volume, const int volumeSize[3], const int kBegin, const int kEnd,
+                              const MatrixType &matrix, const TProjectionPixel *projection,
+                              const int projectionSize[2])
+    {
+    for(int k=kBegin; k<kEnd; k++)
+      for(int j=0; j<volumeSize[1]; j++)
+        BackProjectRow(volume + volumeSize[0] * (j + k * volumeSize[1]), 0, volumeSize[0], j, k,
+                       matrix, projection, projectionSize);
+    }
+};
+
+} // end namespace rtk
+
+#endif
@@ -23,6 +23,8 @@
 #include "rtkFFTRampImageFilter.h"
 #include "rtkFDKBackProjectionImageFilter.h"
 #include "rtkConfiguration.h"
+#include "rtkTelemetry.h"
+#include "rtkImageBufferPool.h"
 
 #include <itkExtractImageFilter.h>
 #include <itkTimeProbe.h>
@@ -42,6 +44,15 @@ namespace rtk
  * controlled with ProjectionSubsetSize) via the use of itk::ExtractImageFilter
  * to extract sub-stacks.
  *
+ * The stack of projections may have another pixel type than the volume, e.g.
+ * rtk::Half to halve the memory of a large stack, see SetProjectionStack.
+ * Each sub-stack is converted to the output pixel type when it is extracted
+ * so all computations are done in the output precision.
+ *
+ * The outputs of the extraction, weighting and ramp filters are allocated
+ * from the shared rtk::ImageBufferPool and recycled from one sub-stack to
+ * the next.
+ *
  * \test rtkfdktest.cxx, rtkrampfiltertest.cxx, rtkmotioncompensatedfdktest.cxx,
  * rtkdisplaceddetectortest.cxx, rtkshortscantest.cxx
  *
@@ -49,7 +60,10 @@ namespace rtk
  *
  * \ingroup ReconstructionAlgorithm
  */
-template<class TInputImage, class TOutputImage=TInputImage, class TFFTPrecision=double>
+template<class TInputImage,
+         class TOutputImage=TInputImage,
+         class TFFTPrecision=double,
+         class TProjectionImage=TInputImage>
 class ITK_EXPORT FDKConeBeamReconstructionFilter :
   public itk::InPlaceImageFilter<TInputImage, TOutputImage>
 {
@@ -61,12 +75,13 @@ public:
   typedef itk::SmartPointer<const Self>                      ConstPointer;
 
   /** Some convenient typedefs. */
-  typedef TInputImage  InputImageType;
-  typedef TOutputImage OutputImageType;
+  typedef TInputImage      InputImageType;
+  typedef TOutputImage     OutputImageType;
+  typedef TProjectionImage ProjectionImageType;
 
   /** Typedefs of each subfilter of this composite filter */
-  typedef itk::ExtractImageFilter<InputImageType, OutputImageType>                 ExtractFilterType;
-  typedef rtk::FDKWeightProjectionFilter<InputImageType, OutputImageType>          WeightFilterType;
+  typedef itk::ExtractImageFilter<ProjectionImageType, OutputImageType>            ExtractFilterType;
+  typedef rtk::FDKWeightProjectionFilter<OutputImageType, OutputImageType>         WeightFilterType;
   typedef rtk::FFTRampImageFilter<OutputImageType, OutputImageType, TFFTPrecision> RampFilterType;
   typedef rtk::FDKBackProjectionImageFilter<OutputImageType, OutputImageType>      BackProjectionFilterType;
   typedef typename BackProjectionFilterType::Pointer                               BackProjectionFilterPointer;
@@ -77,6 +92,17 @@ public:
   /** Runtime information support. */
   itkTypeMacro(FDKConeBeamReconstructionFilter, itk::ImageToImageFilter);
 
+  /** Set / Get the stack of projections, i.e., the second input. Use these
+   * instead of SetInput(1, ...) when ProjectionImageType is not InputImageType. */
+  void SetProjectionStack(const ProjectionImageType *projections)
+    {
+    this->SetNthInput(1, const_cast<ProjectionImageType *>(projections) );
+    }
+  const ProjectionImageType * GetProjectionStack() const
+    {
+    return static_cast<const ProjectionImageType *>( this->itk::ProcessObject::GetInput(1) );
+    }
+
   /** Get / Set the object pointer to projection geometry */
   virtual ThreeDCircularProjectionGeometry::Pointer GetGeometry();
   virtual void SetGeometry(const ThreeDCircularProjectionGeometry::Pointer _arg);
@@ -89,6 +115,10 @@ public:
 
   void PrintTiming(std::ostream& os) const;
 
+  /** Record each execution of the subfilters with telemetry. This must be
+   * called after SetBackProjectionFilter. */
+  void WatchSubfilters(Telemetry *telemetry);
+
   /** Get / Set the number of cone-beam projection images processed
       simultaneously. Default is 4. */
   itkGetMacro(ProjectionSubsetSize, unsigned int);
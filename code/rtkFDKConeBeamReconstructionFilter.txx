@@ -22,8 +22,8 @@
 namespace rtk
 {
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::FDKConeBeamReconstructionFilter():
   m_ProjectionSubsetSize(16)
 {
@@ -35,6 +35,11 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   m_RampFilter = RampFilterType::New();
   this->SetBackProjectionFilter( BackProjectionFilterType::New() );
 
+  // The outputs of the mini-pipeline have the same size for each subset
+  ImageBufferPool::GetInstance()->Watch( m_ExtractFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_WeightFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_RampFilter.GetPointer() );
+
   //Permanent internal connections
   m_WeightFilter->SetInput( m_ExtractFilter->GetOutput() );
   m_RampFilter->SetInput( m_WeightFilter->GetOutput() );
@@ -56,9 +61,9 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
 #endif
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::GenerateInputRequestedRegion()
 {
   typename Superclass::InputImagePointer inputPtr =
@@ -69,14 +74,14 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   //SR: is this useful?
   m_BackProjectionFilter->SetInput ( 0, this->GetInput(0) );
   m_BackProjectionFilter->SetInPlace( this->GetInPlace() );
-  m_ExtractFilter->SetInput( this->GetInput(1) );
+  m_ExtractFilter->SetInput( this->GetProjectionStack() );
   m_BackProjectionFilter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion() );
   m_BackProjectionFilter->GetOutput()->PropagateRequestedRegion();
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::GenerateOutputInformation()
 {
   const unsigned int Dimension = this->InputImageDimension;
@@ -84,7 +89,7 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   // We only set the first sub-stack at that point, the rest will be
   // requested in the GenerateData function
   typename ExtractFilterType::InputImageRegionType projRegion;
-  projRegion = this->GetInput(1)->GetLargestPossibleRegion();
+  projRegion = this->GetProjectionStack()->GetLargestPossibleRegion();
   unsigned int firstStackSize = std::min(m_ProjectionSubsetSize, (unsigned int)projRegion.GetSize(Dimension-1) );
   projRegion.SetSize(Dimension-1, firstStackSize);
   m_ExtractFilter->SetExtractionRegion(projRegion);
@@ -92,7 +97,7 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   // Run composite filter update
   m_BackProjectionFilter->SetInput ( 0, this->GetInput(0) );
   m_BackProjectionFilter->SetInPlace( this->GetInPlace() );
-  m_ExtractFilter->SetInput( this->GetInput(1) );
+  m_ExtractFilter->SetInput( this->GetProjectionStack() );
   m_BackProjectionFilter->UpdateOutputInformation();
 
   // Update output information
@@ -102,16 +107,16 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   this->GetOutput()->SetLargestPossibleRegion( m_BackProjectionFilter->GetOutput()->GetLargestPossibleRegion() );
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::GenerateData()
 {
   const unsigned int Dimension = this->InputImageDimension;
 
   // The backprojection works on a small stack of projections, not the full stack
   typename ExtractFilterType::InputImageRegionType subsetRegion;
-  subsetRegion = this->GetInput(1)->GetLargestPossibleRegion();
+  subsetRegion = this->GetProjectionStack()->GetLargestPossibleRegion();
   unsigned int nProj = subsetRegion.GetSize( Dimension-1 );
 
   for(unsigned int i=0; i<nProj; i+=m_ProjectionSubsetSize)
@@ -150,17 +155,17 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
   this->GenerateOutputInformation();
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 ThreeDCircularProjectionGeometry::Pointer
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::GetGeometry()
 {
   return this->m_WeightFilter->GetGeometry();
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::SetGeometry(const ThreeDCircularProjectionGeometry::Pointer _arg)
 {
   itkDebugMacro("setting GeometryPointer to " << _arg);
@@ -172,9 +177,20 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
     }
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
+void
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
+::WatchSubfilters(Telemetry *telemetry)
+{
+  telemetry->Watch(m_ExtractFilter.GetPointer(), "extract");
+  telemetry->Watch(m_WeightFilter.GetPointer(), "weighting");
+  telemetry->Watch(m_RampFilter.GetPointer(), "ramp");
+  telemetry->Watch(m_BackProjectionFilter.GetPointer(), "backprojection", Telemetry::VOXEL_UPDATES);
+}
+
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::PrintTiming(std::ostream& os) const
 {
   os << "FDKConeBeamReconstructionFilter timing:" << std::endl;
@@ -186,9 +202,9 @@ FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
      << ' ' << m_BackProjectionProbe.GetUnit() << std::endl;
 }
 
-template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TInputImage, class TOutputImage, class TFFTPrecision, class TProjectionImage>
 void
-FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision>
+FDKConeBeamReconstructionFilter<TInputImage, TOutputImage, TFFTPrecision, TProjectionImage>
 ::SetBackProjectionFilter (const BackProjectionFilterPointer _arg)
 {
   itkDebugMacro("setting BackProjectionFilter to " << _arg);
@@ -22,21 +22,62 @@
 #include "rtkFDKBackProjectionImageFilter.h"
 
 #include <itkBarrier.h>
+#include <vector>
 
 namespace rtk
 {
 
+/** \class HasComputeFrameInterpolation
+ * \brief Value is true if the deformation type T, or one of its
+ * superclasses, has a member named ComputeFrameInterpolation.
+ *
+ * The name is looked up in a class derived from T and from a class with a
+ * member of the same name: the lookup is ambiguous, i.e., the substitution
+ * fails, if and only if T has the member.
+ */
+template <class T>
+class HasComputeFrameInterpolation
+{
+  struct Fallback { int ComputeFrameInterpolation; };
+  struct Derived : T, Fallback {};
+  template <class U, U> struct Check;
+  typedef char Yes;
+  typedef char No[2];
+  template <class U> static No & Test(Check<int Fallback::*, &U::ComputeFrameInterpolation> *);
+  template <class U> static Yes & Test(...);
+public:
+  static const bool Value = sizeof(Test<Derived>(0)) == sizeof(Yes);
+};
+
 /** \class FDKWarpBackProjectionImageFilter
  * \brief CPU version of the warp backprojection of motion-compensated FDK.
  *
  * The deformation is described by the TDeformation template parameter. This
- * type must implement the function SetFrame and returns a 3D deformation
- * vector field. FDKWarpBackProjectionImageFilter loops over the projections,
- * sets the frame number, updates the deformation and compose the resulting
- * deformation with the projection matrix. One thus obtain a warped
- * backprojection that is used in motion-compensated cone-beam CT
- * reconstruction. This has been described in [Rit et al, TMI, 2009] and
- * [Rit et al, Med Phys, 2009].
+ * type must implement the function SetFrame and return a 3D deformation
+ * vector field (DVF). Each voxel is warped with the trilinear interpolation
+ * of the DVF and the warped point is projected with the projection matrix.
+ * One thus obtain a warped backprojection that is used in motion-compensated
+ * cone-beam CT reconstruction. This has been described in [Rit et al, TMI,
+ * 2009] and [Rit et al, Med Phys, 2009].
+ *
+ * If TDeformation also implements ComputeFrameInterpolation, e.g.,
+ * CyclicDeformationImageFilter, it must take a 4D DVF as input and
+ * ComputeFrameInterpolation must give, for each projection, the two frames
+ * of the 4D DVF and their weights (see
+ * CyclicDeformationImageFilter::ComputeFrameInterpolation). The 4D DVF is
+ * then updated once before the backprojection and shared read-only by all
+ * threads, which never wait for each other. The 3D DVF of each projection is
+ * never computed: the two frames are combined on the fly for each voxel. The
+ * DVF may be stored on a coarser grid than the volume, e.g. every 4th voxel:
+ * the corners of the DVF cell traversed by a row are cached.
+ *
+ * Otherwise, the filter loops over the projections, sets the frame number
+ * and updates the deformation, the threads waiting for each other before
+ * and after each update. The volume is then split statically between the
+ * threads, without the tiles of BackProjectionImageFilter.
+ *
+ * In both cases, the projections are interpolated with the bounds of
+ * FDKBackProjectionKernel.
  *
  * \test rtkmotioncompensatedfdktest.cxx
  *
@@ -57,8 +98,13 @@ public:
   typedef typename TInputImage::PixelType                        InputPixelType;
   typedef typename TOutputImage::RegionType                      OutputImageRegionType;
 
-  typedef TDeformation                      DeformationType;
-  typedef typename DeformationType::Pointer DeformationPointer;
+  typedef TDeformation                                       DeformationType;
+  typedef typename DeformationType::Pointer                  DeformationPointer;
+  typedef typename DeformationType::OutputImageType          DVFImageType;
+  typedef typename DVFImageType::PixelType                   DVFPixelType;
+  typedef itk::Image<DVFPixelType,
+                     DVFImageType::ImageDimension+1>         DVFInputImageType;
+  typedef typename DVFInputImageType::ConstPointer           DVFInputImageConstPointer;
 
   typedef rtk::ProjectionGeometry<TOutputImage::ImageDimension>     GeometryType;
   typedef typename GeometryType::Pointer                            GeometryPointer;
@@ -80,6 +126,10 @@ protected:
   FDKWarpBackProjectionImageFilter() {};
   virtual ~FDKWarpBackProjectionImageFilter() {};
 
+  /** The tiles of the superclass are only used if the threads do not wait
+   * for each other, i.e., with ComputeFrameInterpolation. */
+  virtual void GenerateData();
+
   virtual void BeforeThreadedGenerateData();
 
   virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
@@ -88,8 +138,42 @@ private:
   FDKWarpBackProjectionImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);                   //purposely not implemented
 
-  DeformationPointer    m_Deformation;
-  itk::Barrier::Pointer m_Barrier;
+  /** Implementations for a TDeformation with and without
+   * ComputeFrameInterpolation */
+  template <bool> struct DeformationTag {};
+  typedef DeformationTag< HasComputeFrameInterpolation<TDeformation>::Value > CurrentDeformationTag;
+
+  /** DVF of a projection, weighted sum of two 3D buffers */
+  struct ProjectionDVF
+    {
+    const DVFPixelType *inf;
+    const DVFPixelType *sup;
+    double              wInf;
+    double              wSup;
+    int                 size[3];
+    int                 stride[3];
+    /** Volume index to continuous index in the DVF buffers */
+    itk::Matrix<double, TOutputImage::ImageDimension+1, TOutputImage::ImageDimension+1> matrix;
+    };
+
+  void PrepareDeformation(DeformationTag<true>);
+  void PrepareDeformation(DeformationTag<false>);
+  void GetProjectionDVF(const unsigned int iProj, const ThreadIdType threadId, ProjectionDVF &dvf, DeformationTag<true>);
+  void GetProjectionDVF(const unsigned int iProj, const ThreadIdType threadId, ProjectionDVF &dvf, DeformationTag<false>);
+
+  /** Set the grid members of dvf from the spatial dimensions of image */
+  template <class TDVFImage>
+  void SetProjectionDVFGrid(const TDVFImage *image, ProjectionDVF &dvf);
+
+  DeformationPointer        m_Deformation;
+  DVFInputImageConstPointer m_DVF;
+  itk::Barrier::Pointer     m_Barrier;
+
+  /** Frames of the 4D DVF and weights for each projection */
+  std::vector<unsigned int> m_FrameInf;
+  std::vector<unsigned int> m_FrameSup;
+  std::vector<double>       m_WeightInf;
+  std::vector<double>       m_WeightSup;
 };
 
 } // end namespace rtk
@@ -19,25 +19,143 @@
 #ifndef __rtkFDKWarpBackProjectionImageFilter_txx
 #define __rtkFDKWarpBackProjectionImageFilter_txx
 
-#include <itkImageRegionIteratorWithIndex.h>
-#include <itkLinearInterpolateImageFunction.h>
+#include <itkImageRegionIterator.h>
 
-#define BILINEAR_BACKPROJECTION
+#include "rtkHomogeneousMatrix.h"
+#include "rtkFDKBackProjectionKernel.h"
 
 namespace rtk
 {
 
+template <class TInputImage, class TOutputImage, class TDeformation>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::GenerateData()
+{
+  if( HasComputeFrameInterpolation<TDeformation>::Value )
+    Superclass::GenerateData();
+  else
+    itk::InPlaceImageFilter<TInputImage, TOutputImage>::GenerateData();
+}
+
 template <class TInputImage, class TOutputImage, class TDeformation>
 void
 FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
 ::BeforeThreadedGenerateData()
 {
   this->SetTranspose(true);
+  PrepareDeformation( CurrentDeformationTag() );
+}
+
+template <class TInputImage, class TOutputImage, class TDeformation>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::PrepareDeformation(DeformationTag<true>)
+{
+  // Update the 4D DVF once, it is then shared read-only by all threads
+  typename DVFInputImageType::Pointer dvf = const_cast< DVFInputImageType * >( m_Deformation->GetInput() );
+  if( dvf.GetPointer() == NULL )
+    itkGenericExceptionMacro(<< "The deformation has no input 4D vector field");
+  dvf->Update();
+  m_DVF = dvf;
+  m_Deformation->UpdateOutputInformation();
+
+  // Frames and weights of each projection
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int nProj = this->GetInput(1)->GetLargestPossibleRegion().GetSize(Dimension-1);
+  const unsigned int iFirstProj = this->GetInput(1)->GetLargestPossibleRegion().GetIndex(Dimension-1);
+  m_FrameInf.resize(nProj);
+  m_FrameSup.resize(nProj);
+  m_WeightInf.resize(nProj);
+  m_WeightSup.resize(nProj);
+  for(unsigned int iProj=0; iProj<nProj; iProj++)
+    m_Deformation->ComputeFrameInterpolation(iProj+iFirstProj,
+                                             m_FrameInf[iProj], m_FrameSup[iProj],
+                                             m_WeightInf[iProj], m_WeightSup[iProj]);
+}
+
+template <class TInputImage, class TOutputImage, class TDeformation>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::PrepareDeformation(DeformationTag<false>)
+{
   typename TOutputImage::RegionType splitRegion;
   m_Barrier = itk::Barrier::New();
   m_Barrier->Initialize( this->SplitRequestedRegion(0, this->GetNumberOfThreads(), splitRegion) );
 }
 
+template <class TInputImage, class TOutputImage, class TDeformation>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::GetProjectionDVF(const unsigned int iProj, const ThreadIdType itkNotUsed(threadId),
+                   ProjectionDVF &dvf, DeformationTag<true>)
+{
+  // Frames of the 4D DVF combined for this projection
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const unsigned int iFirstProj = this->GetInput(1)->GetLargestPossibleRegion().GetIndex(Dimension-1);
+  const typename DVFInputImageType::RegionType dvfRegion = m_DVF->GetBufferedRegion();
+  SetProjectionDVFGrid(m_DVF.GetPointer(), dvf);
+  const int frameStride = dvf.stride[2] * dvf.size[2];
+  dvf.inf = m_DVF->GetBufferPointer() + (m_FrameInf[iProj-iFirstProj] - dvfRegion.GetIndex(Dimension)) * frameStride;
+  dvf.sup = m_DVF->GetBufferPointer() + (m_FrameSup[iProj-iFirstProj] - dvfRegion.GetIndex(Dimension)) * frameStride;
+  dvf.wInf = m_WeightInf[iProj-iFirstProj];
+  dvf.wSup = m_WeightSup[iProj-iFirstProj];
+}
+
+template <class TInputImage, class TOutputImage, class TDeformation>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::GetProjectionDVF(const unsigned int iProj, const ThreadIdType threadId,
+                   ProjectionDVF &dvf, DeformationTag<false>)
+{
+  // Set the deformation
+  m_Barrier->Wait();
+  if(threadId==0)
+    {
+    m_Deformation->SetFrame(iProj);
+    m_Deformation->Update();
+    }
+  m_Barrier->Wait();
+
+  SetProjectionDVFGrid(m_Deformation->GetOutput(), dvf);
+  dvf.inf = m_Deformation->GetOutput()->GetBufferPointer();
+  dvf.sup = dvf.inf;
+  dvf.wInf = 1.;
+  dvf.wSup = 0.;
+}
+
+template <class TInputImage, class TOutputImage, class TDeformation>
+template <class TDVFImage>
+void
+FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
+::SetProjectionDVFGrid(const TDVFImage *image, ProjectionDVF &dvf)
+{
+  // Volume index to continuous index in the spatial dimensions of the DVF
+  const unsigned int Dimension = TOutputImage::ImageDimension;
+  const unsigned int DVFDimension = TDVFImage::ImageDimension;
+  itk::Matrix<double, DVFDimension+1, DVFDimension+1> matrixDVFIndexToPhys =
+    GetIndexToPhysicalPointMatrix< TDVFImage >( image );
+  dvf.matrix.SetIdentity();
+  for(unsigned int i=0; i<Dimension; i++)
+    {
+    dvf.matrix[i][Dimension] = matrixDVFIndexToPhys[i][DVFDimension];
+    for(unsigned int j=0; j<Dimension; j++)
+      dvf.matrix[i][j] = matrixDVFIndexToPhys[i][j];
+    }
+  dvf.matrix = itk::Matrix<double, Dimension+1, Dimension+1>( dvf.matrix.GetInverse() );
+  dvf.matrix = itk::Matrix<double, Dimension+1, Dimension+1>( dvf.matrix.GetVnlMatrix() *
+               GetIndexToPhysicalPointMatrix< TOutputImage >( this->GetOutput() ).GetVnlMatrix() );
+
+  // Buffer
+  const typename TDVFImage::RegionType region = image->GetBufferedRegion();
+  for(unsigned int i=0; i<Dimension; i++)
+    {
+    dvf.matrix[i][Dimension] -= region.GetIndex(i);
+    dvf.size[i] = region.GetSize(i);
+    dvf.stride[i] = (i==0)?1:dvf.stride[i-1]*dvf.size[i-1];
+    }
+}
+
 /**
  * GenerateData performs the accumulation
  */
@@ -50,14 +168,10 @@ FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
   const unsigned int nProj = this->GetInput(1)->GetLargestPossibleRegion().GetSize(Dimension-1);
   const unsigned int iFirstProj = this->GetInput(1)->GetLargestPossibleRegion().GetIndex(Dimension-1);
 
-  // Create interpolator, could be any interpolation
-  typedef itk::LinearInterpolateImageFunction< ProjectionImageType, double > InterpolatorType;
-  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
-
   // Iterators on volume input and output
   typedef itk::ImageRegionConstIterator<TInputImage> InputRegionIterator;
   InputRegionIterator itIn(this->GetInput(), outputRegionForThread);
-  typedef itk::ImageRegionIteratorWithIndex<TOutputImage> OutputRegionIterator;
+  typedef itk::ImageRegionIterator<TOutputImage> OutputRegionIterator;
   OutputRegionIterator itOut(this->GetOutput(), outputRegionForThread);
 
   // Initialize output region with input region in case the filter is not in
@@ -77,33 +191,33 @@ FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
   typename TInputImage::PointType rotCenterPoint;
   rotCenterPoint.Fill(0.0);
 
-  // Continuous index at which we interpolate
-  itk::ContinuousIndex<double, Dimension-1> pointProj;
-
-  // Warped point and interpolator for vector field
-  typename TOutputImage::PointType point;
-  typedef itk::LinearInterpolateImageFunction< typename TDeformation::OutputImageType, double > WarpInterpolatorType;
-  typename WarpInterpolatorType::Pointer warpInterpolator = WarpInterpolatorType::New();
-
+  // Volume index to physical point
+  itk::Matrix<double, Dimension+1, Dimension+1> matrixVolIndexToPhys =
+    GetIndexToPhysicalPointMatrix< TOutputImage >( this->GetOutput() );
   itk::Matrix<double, Dimension+1, Dimension+1> matrixVol =
     GetPhysicalPointToIndexMatrix< TOutputImage >( this->GetOutput() );
 
+  // Output volume buffer
+  typename TOutputImage::SizeType vBufferSize = this->GetOutput()->GetBufferedRegion().GetSize();
+  typename TOutputImage::IndexType vBufferIndex = this->GetOutput()->GetBufferedRegion().GetIndex();
+  typename TOutputImage::PixelType *pVolZeroPointer = this->GetOutput()->GetBufferPointer();
+  pVolZeroPointer -= vBufferIndex[0] + vBufferSize[0] * (vBufferIndex[1] + vBufferSize[1] * vBufferIndex[2]);
+
+  const OutputImageRegionType &region = outputRegionForThread;
+  typedef FDKBackProjectionKernel<typename TOutputImage::PixelType, InputPixelType> KernelType;
+
   // Go over each projection
   for(unsigned int iProj=iFirstProj; iProj<iFirstProj+nProj; iProj++)
     {
-    // Set the deformation
-    m_Barrier->Wait();
-    if(threadId==0)
-      {
-      m_Deformation->SetFrame(iProj);
-      m_Deformation->Update();
-      }
-    m_Barrier->Wait();
-    warpInterpolator->SetInputImage(m_Deformation->GetOutput());
+    // DVF of this projection
+    ProjectionDVF dvf;
+    GetProjectionDVF(iProj, threadId, dvf, CurrentDeformationTag());
 
     // Extract the current slice
     ProjectionImagePointer projection = this->template GetProjection< ProjectionImageType >(iProj);
-    interpolator->SetInputImage(projection);
+    typename ProjectionImageType::IndexType pIndex = projection->GetBufferedRegion().GetIndex();
+    const int pSize[2] = { (int)projection->GetBufferedRegion().GetSize(0),
+                           (int)projection->GetBufferedRegion().GetSize(1) };
 
     // Index to index matrix normalized to have a correct backprojection weight
     // (1 at the isocenter)
@@ -113,39 +227,94 @@ FDKWarpBackProjectionImageFilter<TInputImage,TOutputImage,TDeformation>
       perspFactor += matrix[Dimension-1][j] * rotCenterPoint[j];
     matrix /= perspFactor;
 
-    // Go over each voxel
-    itOut.GoToBegin();
-    while(!itOut.IsAtEnd() )
+    for(int k=region.GetIndex(2); k<region.GetIndex(2)+(int)region.GetSize(2); k++)
       {
-      // Warp
-      this->GetOutput()->TransformIndexToPhysicalPoint(itOut.GetIndex(), point);
-      if(warpInterpolator->IsInsideBuffer(point))
-        point = point + warpInterpolator->Evaluate(point);
-
-      // Compute projection index
-      for(unsigned int i=0; i<Dimension-1; i++)
+      for(int j=region.GetIndex(1); j<region.GetIndex(1)+(int)region.GetSize(1); j++)
         {
-        pointProj[i] = matrix[i][Dimension];
-        for(unsigned int j=0; j<Dimension; j++)
-          pointProj[i] += matrix[i][j] * point[j];
-        }
-
-      // Apply perspective
-      double perspFactor = matrix[Dimension-1][Dimension];
-      for(unsigned int j=0; j<Dimension; j++)
-        perspFactor += matrix[Dimension-1][j] * point[j];
-      perspFactor = 1/perspFactor;
-      for(unsigned int i=0; i<Dimension-1; i++)
-        pointProj[i] = pointProj[i]*perspFactor;
-
-      // Interpolate if in projection
-      if( interpolator->IsInsideBuffer(pointProj) )
-        {
-        itOut.Set( itOut.Get() + perspFactor*perspFactor*interpolator->EvaluateAtContinuousIndex(pointProj) );
-        }
+        // Physical point and DVF continuous index of the first voxel of the
+        // row, then stepped incrementally along the row
+        const int i0 = region.GetIndex(0);
+        double point[3], dvfIndex[3];
+        for(unsigned int d=0; d<Dimension; d++)
+          {
+          point[d] = matrixVolIndexToPhys[d][0] * i0 +
+                     matrixVolIndexToPhys[d][1] * j +
+                     matrixVolIndexToPhys[d][2] * k +
+                     matrixVolIndexToPhys[d][3];
+          dvfIndex[d] = dvf.matrix[d][0] * i0 + dvf.matrix[d][1] * j + dvf.matrix[d][2] * k + dvf.matrix[d][3];
+          }
 
-      ++itOut;
-      }
+        // Cached DVF cell
+        int    cell[3] = {itk::NumericTraits<int>::min(), 0, 0};
+        double corners[8][3];
+
+        typename TOutputImage::PixelType *pVol = pVolZeroPointer + i0 + vBufferSize[0] * (j + k * vBufferSize[1] );
+        for(int i=i0; i<i0+(int)region.GetSize(0); i++, pVol++)
+          {
+          // Warp with the trilinear interpolation of the DVF, the neighbors
+          // are clamped to the buffer like in itk::LinearInterpolateImageFunction.
+          // The DVF is typically much coarser than the volume so the corners of
+          // the current DVF cell, combined between the two frames, are cached
+          // and only fetched again when the row enters a new cell.
+          double warped[3] = {point[0], point[1], point[2]};
+          if(dvfIndex[0]>=-0.5 && dvfIndex[0]<dvf.size[0]-0.5 &&
+             dvfIndex[1]>=-0.5 && dvfIndex[1]<dvf.size[1]-0.5 &&
+             dvfIndex[2]>=-0.5 && dvfIndex[2]<dvf.size[2]-0.5)
+            {
+            int    base[3];
+            double f[3];
+            for(unsigned int d=0; d<Dimension; d++)
+              {
+              base[d] = vnl_math_floor(dvfIndex[d]);
+              f[d] = dvfIndex[d] - base[d];
+              }
+            if(base[0]!=cell[0] || base[1]!=cell[1] || base[2]!=cell[2])
+              {
+              int offset[3][2];
+              for(unsigned int d=0; d<Dimension; d++)
+                {
+                cell[d] = base[d];
+                offset[d][0] = vnl_math_max(base[d], 0) * dvf.stride[d];
+                offset[d][1] = vnl_math_min(base[d]+1, dvf.size[d]-1) * dvf.stride[d];
+                }
+              for(unsigned int c=0; c<8; c++)
+                {
+                const int o = offset[0][c&1] + offset[1][(c>>1)&1] + offset[2][(c>>2)&1];
+                for(unsigned int d=0; d<Dimension; d++)
+                  corners[c][d] = dvf.wInf * dvf.inf[o][d] + dvf.wSup * dvf.sup[o][d];
+                }
+              }
+            for(unsigned int d=0; d<Dimension; d++)
+              {
+              const double c00 = corners[0][d] + f[0] * (corners[1][d] - corners[0][d]);
+              const double c10 = corners[2][d] + f[0] * (corners[3][d] - corners[2][d]);
+              const double c01 = corners[4][d] + f[0] * (corners[5][d] - corners[4][d]);
+              const double c11 = corners[6][d] + f[0] * (corners[7][d] - corners[6][d]);
+              const double c0 = c00 + f[1] * (c10 - c00);
+              const double c1 = c01 + f[1] * (c11 - c01);
+              warped[d] += c0 + f[2] * (c1 - c0);
+              }
+            }
+          for(unsigned int d=0; d<Dimension; d++)
+            {
+            point[d] += matrixVolIndexToPhys[d][0];
+            dvfIndex[d] += dvf.matrix[d][0];
+            }
+
+          // Compute projection index with perspective
+          double w = matrix[2][0] * warped[0] + matrix[2][1] * warped[1] + matrix[2][2] * warped[2] + matrix[2][3];
+          w = 1/w;
+          const double u = (matrix[0][0] * warped[0] + matrix[0][1] * warped[1] +
+                            matrix[0][2] * warped[2] + matrix[0][3]) * w - pIndex[0];
+          const double v = (matrix[1][0] * warped[0] + matrix[1][1] * warped[1] +
+                            matrix[1][2] * warped[2] + matrix[1][3]) * w - pIndex[1];
+
+          // Bilinear interpolation if in projection, with the bounds of the
+          // general FDK kernel
+          KernelType::BackProjectVoxel(pVol, u, v, w, projection->GetBufferPointer(), pSize);
+          } //i
+        } //j
+      } //k
     }
 }
 
@@ -22,6 +22,8 @@
 #include <itkImageToImageFilter.h>
 #include <itkConceptChecking.h>
 #include "rtkConfiguration.h"
+#include "rtkWorkStealingScheduler.h"
+#include "rtkImageBufferPool.h"
 
 namespace rtk
 {
@@ -32,6 +34,14 @@ namespace rtk
  * The filter code is based on FFTConvolutionImageFilter by Gaetan Lehmann
  * (see http://hdl.handle.net/10380/3154)
  *
+ * The projections are split in TilesPerThread tiles per thread, i.e.,
+ * projections or blocks of rows if the Hann window along Y is not used,
+ * which are filtered by a rtk::WorkStealingScheduler. The padded images,
+ * the kernels and the FFTs of each tile are allocated from the shared
+ * rtk::ImageBufferPool. The kernel is computed once for all tiles before
+ * the threads are spawned and reused by the next updates while the filter
+ * and the spacing and the size of the input do not change.
+ *
  * \test rtkrampfiltertest.cxx
  *
  * \author Simon Rit
@@ -41,7 +51,8 @@ namespace rtk
 
 template<class TInputImage, class TOutputImage=TInputImage, class TFFTPrecision=double>
 class ITK_EXPORT FFTRampImageFilter :
-  public itk::ImageToImageFilter<TInputImage, TOutputImage>
+  public itk::ImageToImageFilter<TInputImage, TOutputImage>,
+  protected WorkStealingScheduler::TileProcessor
 {
 public:
   /** Standard class typedefs. */
@@ -123,6 +134,16 @@ public:
   itkGetConstMacro(HannCutFrequencyY, double);
   itkSetMacro(HannCutFrequencyY, double);
 
+  /** Get / Set the number of tiles per thread, 8 by default. 0 restores the
+   * static split of itk::ImageSource. */
+  itkGetConstMacro(TilesPerThread, unsigned int);
+  itkSetMacro(TilesPerThread, unsigned int);
+
+  /** Get the ramp kernel in Fourier space used by the last update. It is
+   * reused by the next updates until the filter, the spacing of the input or
+   * the size of the padded input change. */
+  const itk::DataObject * GetRampKernel() const { return m_FFTRampKernel.GetPointer(); }
+
 protected:
   FFTRampImageFilter();
   ~FFTRampImageFilter(){}
@@ -135,6 +156,13 @@ protected:
 
   virtual void ThreadedGenerateData( const RegionType& outputRegionForThread, ThreadIdType threadId );
 
+  /** Same as itk::ImageSource::GenerateData with a work stealing scheduler
+   * of the tiles if TilesPerThread is not 0. */
+  virtual void GenerateData();
+
+  /** Calls ThreadedGenerateData on a tile. */
+  virtual void ProcessTile(const unsigned int tile, const ThreadIdType threadId);
+
   /** Pad the inputRegion region of the input image and returns a pointer to the new padded image.
     * Padding includes a correction for truncation [Ohnesorge, Med Phys, 2000].
     * centralRegion is the region of the returned image which corresponds to inputRegion.
@@ -143,6 +171,9 @@ protected:
   template<class TFFTInputImage, class TFFTOutputImage>
   typename TFFTInputImage::Pointer PadInputImageRegion(const RegionType &inputRegion);
 
+  /** Size of the padded image of the inputRegion region of the input image. */
+  SizeType GetPaddedSize(const RegionType &inputRegion) const;
+
   void PrintSelf(std::ostream& os, itk::Indent indent) const;
 
   bool IsPrime( int n ) const;
@@ -155,6 +186,14 @@ protected:
   template<class TFFTInputImage, class TFFTOutputImage>
   typename TFFTOutputImage::Pointer GetFFTRampKernel(const int width, const int height);
 
+  /** Returns the kernel of the last call if the filter and the input spacing
+   * have not been modified since and if the size is the same. Otherwise,
+   * the kernel is recomputed with GetFFTRampKernel. The function is not
+   * thread safe, it is called before the threads are spawned which then
+   * only read the kernel. */
+  template<class TFFTInputImage, class TFFTOutputImage>
+  typename TFFTOutputImage::Pointer UpdateFFTRampKernel(const int width, const int height);
+
   /** Pre compute weights for truncation correction in a lookup table. The index
     * is the distance to the original image border.
     * Careful: the function is not thread safe but it does nothing if the weights have
@@ -188,6 +227,21 @@ private:
   double m_HannCutFrequencyY;
 
   int m_BackupNumberOfThreads;
+
+  /** Tiles of the output requested region and their scheduler */
+  unsigned int                   m_TilesPerThread;
+  std::vector<RegionType>        m_Tiles;
+  WorkStealingScheduler::Pointer m_Scheduler;
+
+  /** Pool of the padded images, kernels and FFTs of each tile */
+  ImageBufferPool::Pointer       m_BufferPool;
+
+  /** Ramp kernel of the last update and the parameters of its computation */
+  itk::DataObject::Pointer       m_FFTRampKernel;
+  unsigned long                  m_FFTRampKernelMTime;
+  double                         m_FFTRampKernelSpacing;
+  int                            m_FFTRampKernelWidth;
+  int                            m_FFTRampKernelHeight;
 }; // end of class
 
 } // end namespace rtk
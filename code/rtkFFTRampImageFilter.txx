@@ -44,8 +44,11 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
 ::FFTRampImageFilter() :
   m_TruncationCorrection(0.), m_GreatestPrimeFactor(2), m_HannCutFrequency(0.),
   m_CosineCutFrequency(0.),m_HammingFrequency(0.), m_HannCutFrequencyY(0.),
-  m_BackupNumberOfThreads(1)
+  m_BackupNumberOfThreads(1), m_TilesPerThread(8), m_FFTRampKernelMTime(0),
+  m_FFTRampKernelSpacing(0.), m_FFTRampKernelWidth(0), m_FFTRampKernelHeight(0)
 {
+  m_Scheduler = WorkStealingScheduler::New();
+  m_BufferPool = ImageBufferPool::GetInstance();
 #if defined(USE_FFTWD)
   if(typeid(TFFTPrecision).name() == typeid(double).name() )
     m_GreatestPrimeFactor = 13;
@@ -96,7 +99,18 @@ void
 FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
 ::BeforeThreadedGenerateData()
 {
+  typedef typename itk::Image<TFFTPrecision,
+                              TInputImage::ImageDimension > FFTInputImageType;
+  typedef typename itk::Image<std::complex<TFFTPrecision>,
+                              TInputImage::ImageDimension > FFTOutputImageType;
+
   UpdateTruncationMirrorWeights();
+
+  // The kernel only depends on the padded size of the input requested region
+  // along X, and along Y for the Hann window in that direction, which is the
+  // same for all the regions of ThreadedGenerateData.
+  SizeType s = GetPaddedSize( this->GetInput()->GetRequestedRegion() );
+  this->UpdateFFTRampKernel<FFTInputImageType, FFTOutputImageType>(s[0], s[1]);
   if(this->GetOutput()->GetRequestedRegion().GetSize()[2] == 1 &&
      this->GetHannCutFrequencyY() != 0.)
     {
@@ -115,6 +129,40 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   this->SetNumberOfThreads(m_BackupNumberOfThreads);
 }
 
+template<class TInputImage, class TOutputImage, class TFFTPrecision>
+void
+FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
+::GenerateData()
+{
+  if(!m_TilesPerThread)
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+
+  // Entire projections are filtered if the Hann window along Y is used and
+  // rows otherwise since the ramp filter is 1D
+  const unsigned int lowestSplitDimension = (m_HannCutFrequencyY>0.)?2:1;
+  m_Tiles = WorkStealingScheduler::SplitRegion(this->GetOutput()->GetRequestedRegion(),
+                                               m_TilesPerThread * this->GetNumberOfThreads(),
+                                               lowestSplitDimension);
+  m_Scheduler->Execute(this, m_Tiles.size(), this->GetNumberOfThreads() );
+  m_Tiles.clear();
+
+  this->AfterThreadedGenerateData();
+}
+
+template<class TInputImage, class TOutputImage, class TFFTPrecision>
+void
+FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
+::ProcessTile(const unsigned int tile, const ThreadIdType threadId)
+{
+  this->ThreadedGenerateData(m_Tiles[tile], threadId);
+}
+
 template<class TInputImage, class TOutputImage, class TFFTPrecision>
 void
 FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
@@ -125,14 +173,17 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   typedef typename FFTInputImageType::Pointer               FFTInputImagePointer;
   typedef typename itk::Image<std::complex<TFFTPrecision>,
                               TInputImage::ImageDimension > FFTOutputImageType;
-  typedef typename FFTOutputImageType::Pointer              FFTOutputImagePointer;
 
-  // Pad image region enlarged along X
+  // Pad image region enlarged along X, and along Y for the Hann window in
+  // that direction. Otherwise, rows are filtered independently.
   RegionType enlargedRegionX = outputRegionForThread;
   enlargedRegionX.SetIndex(0, this->GetInput()->GetRequestedRegion().GetIndex(0) );
   enlargedRegionX.SetSize(0, this->GetInput()->GetRequestedRegion().GetSize(0) );
-  enlargedRegionX.SetIndex(1, this->GetInput()->GetRequestedRegion().GetIndex(1) );
-  enlargedRegionX.SetSize(1, this->GetInput()->GetRequestedRegion().GetSize(1) );
+  if(m_HannCutFrequencyY>0.)
+    {
+    enlargedRegionX.SetIndex(1, this->GetInput()->GetRequestedRegion().GetIndex(1) );
+    enlargedRegionX.SetSize(1, this->GetInput()->GetRequestedRegion().GetSize(1) );
+    }
   FFTInputImagePointer paddedImage;
   paddedImage = PadInputImageRegion<FFTInputImageType, FFTOutputImageType>(enlargedRegionX);
 
@@ -143,15 +194,13 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   typedef itk::RealToHalfHermitianForwardFFTImageFilter< FFTInputImageType > FFTType;
 #endif
   typename FFTType::Pointer fftI = FFTType::New();
+  m_BufferPool->Watch( fftI.GetPointer() );
   fftI->SetInput( paddedImage );
   fftI->SetNumberOfThreads( m_BackupNumberOfThreads );
   fftI->Update();
 
-  // Get FFT ramp kernel
-  typename FFTOutputImageType::SizeType s;
-  s = paddedImage->GetLargestPossibleRegion().GetSize();
-  FFTOutputImagePointer fftK;
-  fftK = this->GetFFTRampKernel<FFTInputImageType, FFTOutputImageType>(s[0], s[1]);
+  // FFT ramp kernel computed in BeforeThreadedGenerateData
+  const FFTOutputImageType *fftK = static_cast<const FFTOutputImageType *>( m_FFTRampKernel.GetPointer() );
 
   //Multiply line-by-line
   itk::ImageRegionIterator<typename FFTType::OutputImageType> itI(fftI->GetOutput(),
@@ -174,6 +223,7 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   typedef itk::HalfHermitianToRealInverseFFTImageFilter< typename FFTType::OutputImageType > IFFTType;
 #endif
   typename IFFTType::Pointer ifft = IFFTType::New();
+  m_BufferPool->Watch( ifft.GetPointer() );
   ifft->SetInput( fftI->GetOutput() );
 #if ITK_VERSION_MAJOR <= 3
   ifft->SetActualXDimensionIsOdd( paddedImage->GetLargestPossibleRegion().GetSize(0) % 2 );
@@ -203,26 +253,16 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   UpdateTruncationMirrorWeights();
 
   RegionType paddedRegion = inputRegion;
+  paddedRegion.SetSize( GetPaddedSize(inputRegion) );
 
-  // Set x padding
-  typename SizeType::SizeValueType xPaddedSize = 2*inputRegion.GetSize(0);
-  while( GreatestPrimeFactor( xPaddedSize ) > m_GreatestPrimeFactor )
-    xPaddedSize++;
-  paddedRegion.SetSize(0, xPaddedSize);
-  long zeroext = ( (long)xPaddedSize - (long)inputRegion.GetSize(0) ) / 2;
+  // Center the x padding
+  long zeroext = ( (long)paddedRegion.GetSize(0) - (long)inputRegion.GetSize(0) ) / 2;
   paddedRegion.SetIndex(0, inputRegion.GetIndex(0) - zeroext);
 
-  // Set y padding
-  typename SizeType::SizeValueType yPaddedSize = inputRegion.GetSize(1);
-  while( GreatestPrimeFactor( yPaddedSize ) > m_GreatestPrimeFactor )
-    yPaddedSize++;
-  paddedRegion.SetSize(1, yPaddedSize);
-  paddedRegion.SetIndex(1, inputRegion.GetIndex(1) );
-
   // Create padded image (spacing and origin do not matter)
   typename TFFTInputImage::Pointer paddedImage = TFFTInputImage::New();
   paddedImage->SetRegions(paddedRegion);
-  paddedImage->Allocate();
+  m_BufferPool->Allocate( paddedImage.GetPointer() );
   paddedImage->FillBuffer(0);
 
   const long next = vnl_math_min(zeroext, (long)this->GetTruncationCorrectionExtent() );
@@ -275,6 +315,25 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   return paddedImage;
 }
 
+template<class TInputImage, class TOutputImage, class TFFTPrecision>
+typename FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>::SizeType
+FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
+::GetPaddedSize(const RegionType &inputRegion) const
+{
+  SizeType paddedSize = inputRegion.GetSize();
+
+  // Set x padding
+  paddedSize[0] = 2*inputRegion.GetSize(0);
+  while( GreatestPrimeFactor( paddedSize[0] ) > m_GreatestPrimeFactor )
+    paddedSize[0]++;
+
+  // Set y padding
+  while( GreatestPrimeFactor( paddedSize[1] ) > m_GreatestPrimeFactor )
+    paddedSize[1]++;
+
+  return paddedSize;
+}
+
 template<class TInputImage, class TOutputImage, class TFFTPrecision>
 void
 FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
@@ -324,7 +383,7 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   size[0] = width;
   typename TFFTInputImage::Pointer kernel = TFFTInputImage::New();
   kernel->SetRegions( size );
-  kernel->Allocate();
+  m_BufferPool->Allocate( kernel.GetPointer() );
   kernel->FillBuffer(0.);
 
   // Compute kernel in space domain (see Kak & Slaney, chapter 3 equation 61
@@ -349,6 +408,7 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   typedef itk::RealToHalfHermitianForwardFFTImageFilter< TFFTInputImage, TFFTOutputImage > FFTType;
 #endif
   typename FFTType::Pointer fftK = FFTType::New();
+  m_BufferPool->Watch( fftK.GetPointer() );
   fftK->SetInput( kernel );
   fftK->SetNumberOfThreads( 1 );
   fftK->Update();
@@ -432,7 +492,7 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
 
     result = TFFTOutputImage::New();
     result->SetRegions( size );
-    result->Allocate();
+    m_BufferPool->Allocate( result.GetPointer() );
     result->FillBuffer(0.);
 
     IteratorType itTwoDK(result, result->GetLargestPossibleRegion() );
@@ -460,6 +520,33 @@ FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
   return result;
 }
 
+template<class TInputImage, class TOutputImage, class TFFTPrecision>
+template<class TFFTInputImage, class TFFTOutputImage>
+typename TFFTOutputImage::Pointer
+FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
+::UpdateFFTRampKernel(const int width, const int height)
+{
+  const double spacing = this->GetInput()->GetSpacing()[0];
+  TFFTOutputImage *kernel = dynamic_cast<TFFTOutputImage *>( m_FFTRampKernel.GetPointer() );
+  if( kernel == NULL ||
+      m_FFTRampKernelMTime != this->GetMTime() ||
+      m_FFTRampKernelSpacing != spacing ||
+      m_FFTRampKernelWidth != width ||
+      m_FFTRampKernelHeight != height )
+    {
+    typename TFFTOutputImage::Pointer newKernel;
+    newKernel = this->GetFFTRampKernel<TFFTInputImage, TFFTOutputImage>(width, height);
+    newKernel->DisconnectPipeline();
+    m_FFTRampKernel = newKernel.GetPointer();
+    m_FFTRampKernelMTime = this->GetMTime();
+    m_FFTRampKernelSpacing = spacing;
+    m_FFTRampKernelWidth = width;
+    m_FFTRampKernelHeight = height;
+    kernel = newKernel.GetPointer();
+    }
+  return kernel;
+}
+
 template<class TInputImage, class TOutputImage, class TFFTPrecision>
 void
 FFTRampImageFilter<TInputImage, TOutputImage, TFFTPrecision>
@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkFastLog_h
+#define __rtkFastLog_h
+
+#include <cstring>
+
+namespace rtk
+{
+
+/** \brief Natural logarithm of a positive single precision number.
+ *
+ * The number is split in a mantissa m in [sqrt(2)/2, sqrt(2)) and an exponent
+ * e, and log(m) is approximated with the minimax polynomial of the Cephes
+ * logf function. The function has no branch, no table and no call, so that
+ * loops over contiguous buffers calling it are vectorized by the compiler
+ * (SSE, AVX2 or AVX-512 depending on the target flags).
+ *
+ * For positive normal inputs, the absolute error is below 1e-7 when x is in
+ * [0.5,2] and the relative error is below 1e-7 elsewhere, i.e., the result
+ * is within a couple of float ulps of the exact value. Zero, negative,
+ * denormal, infinite and NaN inputs are not handled and must be filtered by
+ * the caller.
+ *
+ * \test rtkfastlogtest.cxx
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+inline float FastLog(const float x)
+{
+  // Split x in mantissa in [0.5,1) and exponent. All tests are done on the
+  // integer representation: floating point comparisons may trap and prevent
+  // the vectorization of the calling loop.
+  int bits;
+  std::memcpy(&bits, &x, sizeof(float));
+  const int mantissa = bits & 0x007fffff;
+  const int exponent = ( (bits >> 23) & 0xff ) - 126;
+
+  // Move the mantissa to [sqrt(2)/2, sqrt(2)) and center it on 0
+  const int small = (mantissa < 0x3504f3); // mantissa < sqrt(2)/2
+  const float e = float(exponent - small);
+  bits = mantissa | ( (0x7e + small) << 23 );
+  float m;
+  std::memcpy(&m, &bits, sizeof(float));
+  m -= 1.f;
+
+  // Polynomial approximation of log(1+m)
+  const float z = m * m;
+  float y =      7.0376836292e-2f;
+  y = y * m + -1.1514610310e-1f;
+  y = y * m +  1.1676998740e-1f;
+  y = y * m + -1.2420140846e-1f;
+  y = y * m +  1.4249322787e-1f;
+  y = y * m + -1.6668057665e-1f;
+  y = y * m +  2.0000714765e-1f;
+  y = y * m + -2.4999993993e-1f;
+  y = y * m +  3.3333331174e-1f;
+  y *= m * z;
+
+  // Add exponent contribution with log(2) split in two parts for accuracy
+  y += -2.12194440e-4f * e;
+  y += -0.5f * z;
+  return m + y + 0.693359375f * e;
+}
+
+/** \brief Computes out[i] = -log(scale*in[i]) on a row of n pixels, 0 if
+ * in[i] is not positive.
+ *
+ * This is the kernel shared by the raw to attenuation filters which convert
+ * intensities to line integrals, scale being the inverse of the unattenuated
+ * intensity. The scaling is done before the logarithm so that the result is
+ * accurate close to 0, i.e., for low attenuation. The loop is written to be
+ * vectorized by the compiler, see FastLog.
+ */
+template <class TInput, class TOutput>
+inline void NegativeLogRow(const TInput *in, TOutput *out, const unsigned int n, const float scale)
+{
+  for(unsigned int i=0; i<n; i++)
+    {
+    // Positivity test on the integer representation, see FastLog
+    const float v = float(in[i]) * scale;
+    int bits;
+    std::memcpy(&bits, &v, sizeof(float));
+    const int positive = (bits > 0);
+    const int mask = -positive;
+    bits = (bits & mask) | (0x3f800000 & ~mask); // 1.f if not positive
+    float a;
+    std::memcpy(&a, &bits, sizeof(float));
+    out[i] = TOutput( -float(positive) * FastLog(a) );
+    }
+}
+
+} // end namespace rtk
+
+#endif
@@ -22,6 +22,7 @@
 #include <itkInPlaceImageFilter.h>
 
 #include "rtkThreeDCircularProjectionGeometry.h"
+#include "rtkFieldOfViewSpanTable.h"
 #include "rtkConfiguration.h"
 
 namespace rtk
@@ -36,6 +37,12 @@ namespace rtk
  * InPlaneAngle. The rest is accounted for but the fov is assumed to be
  * cylindrical.
  *
+ * The field of view of each row of the volume along the first dimension is
+ * computed analytically as a span of voxels (see rtk::FieldOfViewSpanTable)
+ * and only the voxels inside the span are tested. The same span table can be
+ * computed with ComputeSpanTable and passed to the backprojectors to skip
+ * the voxels outside the field of view.
+ *
  * \test rtkfovtest.cxx, rtkfdktest.cxx, rtkmotioncompensatedfdktest.cxx
  *
  * \author Marc Vila
@@ -86,12 +93,31 @@ public:
   itkGetMacro(DisplacedDetector, bool);
   itkSetMacro(DisplacedDetector, bool);
 
+  /** Computes the span table of the field of view for the voxels of the
+   * largest possible region of volume. Geometry and ProjectionsStack must be
+   * set. A null pointer is returned if the direction of volume is not the
+   * identity since rows along the first dimension are not along x then. */
+  FieldOfViewSpanTable::Pointer ComputeSpanTable(const itk::ImageBase<TInputImage::ImageDimension> *volume);
+
 protected:
   FieldOfViewImageFilter();
   virtual ~FieldOfViewImageFilter() {};
 
   virtual void BeforeThreadedGenerateData();
 
+  /** Computes the radius and the hat parameters of the field of view from the
+   * geometry and the projections stack. */
+  void ComputeFieldOfView();
+
+  /** Is physical point (x,y,z) in the field of view? */
+  inline bool IsInsideFieldOfView(const double x, const double y, const double z) const
+    {
+    const double radius = vcl_sqrt(x*x + z*z);
+    return ( radius <= m_Radius &&
+             radius*m_HatTangentInf >= m_HatHeightInf - y &&
+             radius*m_HatTangentSup <= m_HatHeightSup - y );
+    }
+
   /** Generates a FOV mask which is applied to the reconstruction
    * A call to this function will assume modification of the function.*/
   virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId );
@@ -109,6 +135,9 @@ private:
   double                  m_HatHeightInf;
   double                  m_HatHeightSup;
   bool                    m_DisplacedDetector;
+
+  /** Span table of the output when its direction is the identity */
+  FieldOfViewSpanTable::Pointer m_SpanTable;
 };
 
 } // end namespace rtk
@@ -21,6 +21,7 @@
 
 #include <itkImageRegionConstIterator.h>
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 namespace rtk
 {
@@ -37,6 +38,15 @@ FieldOfViewImageFilter<TInputImage, TOutputImage>
 template <class TInputImage, class TOutputImage>
 void FieldOfViewImageFilter<TInputImage, TOutputImage>
 ::BeforeThreadedGenerateData()
+{
+  m_SpanTable = ComputeSpanTable( this->GetOutput() );
+  if( m_SpanTable.GetPointer() == NULL )
+    ComputeFieldOfView();
+}
+
+template <class TInputImage, class TOutputImage>
+void FieldOfViewImageFilter<TInputImage, TOutputImage>
+::ComputeFieldOfView()
 {
   // Compute projection stack indices of corners
   m_ProjectionsStack->UpdateOutputInformation();
@@ -112,65 +122,160 @@ void FieldOfViewImageFilter<TInputImage, TOutputImage>
     }
 }
 
+template <class TInputImage, class TOutputImage>
+FieldOfViewSpanTable::Pointer
+FieldOfViewImageFilter<TInputImage, TOutputImage>
+::ComputeSpanTable(const itk::ImageBase<TInputImage::ImageDimension> *volume)
+{
+  typename TInputImage::DirectionType d = volume->GetDirection();
+  if( TInputImage::ImageDimension != 3 ||
+      d[0][0]!=1. || d[0][1]!=0. || d[0][2]!=0. ||
+      d[1][0]!=0. || d[1][1]!=1. || d[1][2]!=0. ||
+      d[2][0]!=0. || d[2][1]!=0. || d[2][2]!=1.)
+    return NULL;
+
+  if(m_Geometry.GetPointer() == NULL || m_ProjectionsStack.GetPointer() == NULL)
+    itkExceptionMacro(<< "Geometry and ProjectionsStack must be set to compute the field of view.");
+  ComputeFieldOfView();
+
+  const typename TInputImage::RegionType region = volume->GetLargestPossibleRegion();
+  FieldOfViewSpanTable::RegionType spanRegion;
+  for(unsigned int i=0; i<3; i++)
+    {
+    spanRegion.SetIndex(i, region.GetIndex(i));
+    spanRegion.SetSize(i, region.GetSize(i));
+    }
+  FieldOfViewSpanTable::Pointer table = FieldOfViewSpanTable::New();
+  table->SetRegion(spanRegion);
+
+  // Physical coordinates of the first voxel and increments
+  typename TInputImage::IndexType index = region.GetIndex();
+  typename TInputImage::PointType pointBase, pointIncrement;
+  volume->TransformIndexToPhysicalPoint( index, pointBase );
+  for(unsigned int i=0; i<3; i++)
+    index[i]++;
+  volume->TransformIndexToPhysicalPoint( index, pointIncrement );
+  for(unsigned int i=0; i<3; i++)
+    pointIncrement[i] -= pointBase[i];
+
+  const int xBegin = region.GetIndex(0);
+  const int xEnd = xBegin + (int)region.GetSize(0);
+  for(unsigned int k=0; k<region.GetSize(2); k++)
+    {
+    const double z = pointBase[2] + k * pointIncrement[2];
+    for(unsigned int j=0; j<region.GetSize(1); j++)
+      {
+      const double y = pointBase[1] + j * pointIncrement[1];
+      const int jj = region.GetIndex(1) + j;
+      const int kk = region.GetIndex(2) + k;
+
+      // Interval [rmin, rmax] of radii in the field of view for this height
+      // from the three conditions of IsInsideFieldOfView
+      bool empty = false;
+      double rmin = 0.;
+      double rmax = m_Radius;
+      const double cInf = m_HatHeightInf - y;
+      if(m_HatTangentInf<0.)
+        rmax = vnl_math_min(rmax, cInf/m_HatTangentInf);
+      else if(m_HatTangentInf>0.)
+        rmin = vnl_math_max(rmin, cInf/m_HatTangentInf);
+      else if(cInf>0.)
+        empty = true;
+      const double cSup = m_HatHeightSup - y;
+      if(m_HatTangentSup>0.)
+        rmax = vnl_math_min(rmax, cSup/m_HatTangentSup);
+      else if(m_HatTangentSup<0.)
+        rmin = vnl_math_max(rmin, cSup/m_HatTangentSup);
+      else if(cSup<0.)
+        empty = true;
+      if(empty || rmax<rmin || rmax*rmax<z*z)
+        {
+        table->SetSpan(jj, kk, xBegin, xBegin);
+        continue;
+        }
+
+      // Analytic span of |x|<=sqrt(rmax^2-z^2), refined with the exact test
+      // to be robust to rounding. An inner bound rmin, if any, is not a
+      // bound of the span.
+      const double halfWidth = vcl_sqrt(rmax*rmax - z*z);
+      const double i1 = (-halfWidth - pointBase[0]) / pointIncrement[0];
+      const double i2 = ( halfWidth - pointBase[0]) / pointIncrement[0];
+      const double iMin = vnl_math_max(vnl_math_min(i1, i2), -1.);
+      const double iMax = vnl_math_min(vnl_math_max(i1, i2), double(region.GetSize(0)));
+      int start = xBegin + vnl_math_max(0, (int)vcl_ceil(iMin));
+      int end = xBegin + vnl_math_min((int)region.GetSize(0), (int)vcl_floor(iMax)+1);
+      end = vnl_math_max(start, end);
+#define FOV_INSIDE(i) IsInsideFieldOfView(pointBase[0]+((i)-xBegin)*pointIncrement[0], y, z)
+      while(start<end && !FOV_INSIDE(start))
+        start++;
+      while(start>xBegin && FOV_INSIDE(start-1))
+        start--;
+      while(end>start && !FOV_INSIDE(end-1))
+        end--;
+      while(end<xEnd && FOV_INSIDE(end))
+        end++;
+#undef FOV_INSIDE
+      table->SetSpan(jj, kk, start, end);
+      }
+    }
+  return table;
+}
+
 template <class TInputImage, class TOutputImage>
 void FieldOfViewImageFilter<TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                        ThreadIdType itkNotUsed(threadId) )
 {
-  typename TInputImage::DirectionType d = this->GetInput()->GetDirection();
-  if( d[0][0]==1. && d[0][1]==0. && d[0][2]==0. &&
-      d[1][0]==0. && d[1][1]==1. && d[1][2]==0. &&
-      d[2][0]==0. && d[2][1]==0. && d[2][2]==1.)
-
+  if( m_SpanTable.GetPointer() != NULL )
     {
     // Prepare point increment (TransformIndexToPhysicalPoint too slow)
     typename TInputImage::PointType pointBase, pointIncrement;
-    typename TInputImage::IndexType index = outputRegionForThread.GetIndex();
+    typename TInputImage::IndexType index = this->GetOutput()->GetLargestPossibleRegion().GetIndex();
     this->GetInput()->TransformIndexToPhysicalPoint( index, pointBase );
     for(unsigned int i=0; i<TInputImage::GetImageDimension(); i++)
       index[i]++;
     this->GetInput()->TransformIndexToPhysicalPoint( index, pointIncrement );
     for(unsigned int i=0; i<TInputImage::GetImageDimension(); i++)
       pointIncrement[i] -= pointBase[i];
-  
-    // Iterators
-    typedef itk::ImageRegionConstIterator<TInputImage> InputConstIterator;
-    InputConstIterator itIn(this->GetInput(0), outputRegionForThread);
-    itIn.GoToBegin();
-    typedef itk::ImageRegionIterator<TOutputImage> OutputIterator;
-    OutputIterator itOut(this->GetOutput(), outputRegionForThread);
-    itOut.GoToBegin();
-  
-    // Go over output, compute weights and avoid redundant computation
-    typename TInputImage::PointType point = pointBase;
-    for(unsigned int k=0; k<outputRegionForThread.GetSize(2); k++)
+
+    // The span only bounds the field of view if there is no inner radius,
+    // i.e., if the hat does not exclude the center
+    const bool testInsideSpan = (m_HatTangentInf>0. || m_HatTangentSup<0.);
+    const int xBegin = this->GetOutput()->GetLargestPossibleRegion().GetIndex(0);
+
+    // Go over output rows, only the span of the row is in the field of view
+    OutputImageRegionType rowRegion = outputRegionForThread;
+    rowRegion.SetSize(0, 1);
+    typedef itk::ImageRegionConstIteratorWithIndex<TOutputImage> RowIterator;
+    RowIterator itRow(this->GetOutput(), rowRegion);
+    for(; !itRow.IsAtEnd(); ++itRow)
       {
-      double zsquare = point[2]*point[2];
-      point[1] = pointBase[1];
-      for(unsigned int j=0; j<outputRegionForThread.GetSize(1); j++)
+      const typename TOutputImage::IndexType idx = itRow.GetIndex();
+      const int rowBegin = idx[0];
+      const int rowEnd = rowBegin + outputRegionForThread.GetSize(0);
+      int spanBegin = rowBegin;
+      int spanEnd = rowEnd;
+      m_SpanTable->ClipRow(idx[1], idx[2], spanBegin, spanEnd);
+
+      const typename TInputImage::PixelType *pIn = this->GetInput()->GetBufferPointer() +
+                                                   this->GetInput()->ComputeOffset(idx) - rowBegin;
+      typename TOutputImage::PixelType *pOut = this->GetOutput()->GetBufferPointer() +
+                                               this->GetOutput()->ComputeOffset(idx) - rowBegin;
+      for(int i=rowBegin; i<spanBegin; i++)
+        pOut[i] = 0.;
+      for(int i=spanEnd; i<rowEnd; i++)
+        pOut[i] = 0.;
+      const double y = pointBase[1] + (idx[1]-this->GetOutput()->GetLargestPossibleRegion().GetIndex(1)) * pointIncrement[1];
+      const double z = pointBase[2] + (idx[2]-this->GetOutput()->GetLargestPossibleRegion().GetIndex(2)) * pointIncrement[2];
+      for(int i=spanBegin; i<spanEnd; i++)
         {
-        point[0] = pointBase[0];
-        for(unsigned int i=0; i<outputRegionForThread.GetSize(0); i++)
-          {
-          double radius = vcl_sqrt(point[0]*point[0] + zsquare);
-          if ( radius <= m_Radius &&
-               radius*m_HatTangentInf >= m_HatHeightInf - point[1] &&
-               radius*m_HatTangentSup <= m_HatHeightSup - point[1])
-            {
-            if(m_Mask)
-              itOut.Set(1.0);
-            else
-              itOut.Set(itIn.Get());
-            }
-          else
-            itOut.Set(0.);
-          ++itIn;
-          ++itOut;
-          point[0] += pointIncrement[0];
-          }
-        point[1] += pointIncrement[1];
+        if(testInsideSpan && !IsInsideFieldOfView(pointBase[0]+(i-xBegin)*pointIncrement[0], y, z))
+          pOut[i] = 0.;
+        else if(m_Mask)
+          pOut[i] = 1.;
+        else
+          pOut[i] = pIn[i];
         }
-      point[2] += pointIncrement[2];
       }
     }
   else
@@ -0,0 +1,51 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkFieldOfViewSpanTable.h"
+
+namespace rtk
+{
+
+void
+FieldOfViewSpanTable
+::SetRegion(const RegionType &region)
+{
+  m_Region = region;
+  m_Spans.resize(2 * region.GetSize(1) * region.GetSize(2));
+  for(size_t i=0; i<m_Spans.size(); i+=2)
+    {
+    m_Spans[i]   = region.GetIndex(0);
+    m_Spans[i+1] = region.GetIndex(0) + region.GetSize(0);
+    }
+  this->Modified();
+}
+
+void
+FieldOfViewSpanTable
+::SetSpan(const int j, const int k, const int xStart, const int xEnd)
+{
+  const int jj = j - (int)m_Region.GetIndex(1);
+  const int kk = k - (int)m_Region.GetIndex(2);
+  if(jj<0 || jj>=(int)m_Region.GetSize(1) || kk<0 || kk>=(int)m_Region.GetSize(2))
+    itkExceptionMacro(<< "Row (" << j << ',' << k << ") is outside the region of the span table.");
+  int *span = &(m_Spans[2*(jj + kk * m_Region.GetSize(1))]);
+  span[0] = xStart;
+  span[1] = xEnd;
+}
+
+} // end namespace rtk
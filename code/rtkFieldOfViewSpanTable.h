@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkFieldOfViewSpanTable_h
+#define __rtkFieldOfViewSpanTable_h
+
+#include <vector>
+#include <algorithm>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkImageRegion.h>
+
+namespace rtk
+{
+
+/** \class FieldOfViewSpanTable
+ * \brief Voxels of a volume inside the field of view, row by row.
+ *
+ * For each row of a 3D volume along the first dimension, i.e., each (j,k)
+ * pair of indices, the table stores the span [xStart, xEnd) of indices along
+ * the first dimension which contains the voxels inside the field of view.
+ * Voxels outside the span may be skipped, e.g., by backprojectors. The span
+ * of a row is empty if xStart>=xEnd. Rows outside the region of the table
+ * are assumed to be entirely inside the field of view.
+ *
+ * The table is computed by rtk::FieldOfViewImageFilter::ComputeSpanTable.
+ *
+ * \author Simon Rit
+ */
+class FieldOfViewSpanTable : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef FieldOfViewSpanTable          Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  typedef itk::ImageRegion<3>           RegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FieldOfViewSpanTable, itk::Object);
+
+  /** Set the region of the volume covered by the table. All spans are reset
+   * to the full rows of the region. */
+  void SetRegion(const RegionType &region);
+  const RegionType &GetRegion() const { return m_Region; }
+
+  /** Set the span of row (j,k) in absolute indices. */
+  void SetSpan(const int j, const int k, const int xStart, const int xEnd);
+
+  /** Clip the range [begin, end) of indices along the first dimension of row
+   * (j,k) to its span. */
+  inline void ClipRow(const int j, const int k, int &begin, int &end) const
+    {
+    const int jj = j - (int)m_Region.GetIndex(1);
+    const int kk = k - (int)m_Region.GetIndex(2);
+    if(jj<0 || jj>=(int)m_Region.GetSize(1) || kk<0 || kk>=(int)m_Region.GetSize(2))
+      return;
+    const int *span = &(m_Spans[2*(jj + kk * m_Region.GetSize(1))]);
+    begin = std::max(begin, span[0]);
+    end = std::max(begin, std::min(end, span[1]));
+    }
+
+  /** Is voxel index inside the span of its row? */
+  inline bool IsInside(const int i, const int j, const int k) const
+    {
+    int begin = i;
+    int end = i+1;
+    ClipRow(j, k, begin, end);
+    return begin<end;
+    }
+
+protected:
+  FieldOfViewSpanTable() {}
+  virtual ~FieldOfViewSpanTable() {}
+
+private:
+  FieldOfViewSpanTable(const Self&); //purposely not implemented
+  void operator=(const Self&);       //purposely not implemented
+
+  RegionType       m_Region;
+  std::vector<int> m_Spans;
+};
+
+} // end namespace rtk
+
+#endif
@@ -21,6 +21,7 @@
 
 #include <itkInPlaceImageFilter.h>
 #include "rtkThreeDCircularProjectionGeometry.h"
+#include "rtkWorkStealingScheduler.h"
 
 namespace rtk
 {
@@ -28,13 +29,19 @@ namespace rtk
 /** \class ForwardProjectionImageFilter
  * \brief Base class for forward projection, i.e. accumulation along x-ray lines.
  *
+ * The projections are split in TilesPerThread tiles per thread, i.e.,
+ * projections or blocks of rows, which are processed by a
+ * rtk::WorkStealingScheduler since the rays of different tiles may have
+ * very different lengths.
+ *
  * \author Simon Rit
  *
  * \ingroup Projector
  */
 template <class TInputImage, class TOutputImage>
 class ForwardProjectionImageFilter :
-  public itk::InPlaceImageFilter<TInputImage,TOutputImage>
+  public itk::InPlaceImageFilter<TInputImage,TOutputImage>,
+  protected WorkStealingScheduler::TileProcessor
 {
 public:
   /** Standard class typedefs. */
@@ -45,6 +52,7 @@ public:
 
   typedef rtk::ThreeDCircularProjectionGeometry             GeometryType;
   typedef typename GeometryType::Pointer                    GeometryPointer;
+  typedef typename TOutputImage::RegionType                 OutputImageRegionType;
 
   /** Run-time type information (and related methods). */
   itkTypeMacro(ForwardProjectionImageFilter, itk::InPlaceImageFilter);
@@ -53,9 +61,15 @@ public:
   itkGetMacro(Geometry, GeometryPointer);
   itkSetMacro(Geometry, GeometryPointer);
 
+  /** Get / Set the number of tiles per thread, 8 by default. 0 restores the
+   * static split of itk::ImageSource. */
+  itkGetMacro(TilesPerThread, unsigned int);
+  itkSetMacro(TilesPerThread, unsigned int);
+
 protected:
-  ForwardProjectionImageFilter() : m_Geometry(NULL) {
+  ForwardProjectionImageFilter() : m_Geometry(NULL), m_TilesPerThread(8) {
     this->SetNumberOfRequiredInputs(2); this->SetInPlace( true );
+    m_Scheduler = WorkStealingScheduler::New();
   };
 
   virtual ~ForwardProjectionImageFilter() {
@@ -64,6 +78,13 @@ protected:
   /** Apply changes to the input image requested region. */
   virtual void GenerateInputRequestedRegion();
 
+  /** Same as itk::ImageSource::GenerateData with a work stealing scheduler
+   * of the tiles if TilesPerThread is not 0. */
+  virtual void GenerateData();
+
+  /** Calls ThreadedGenerateData on a tile. */
+  virtual void ProcessTile(const unsigned int tile, const ThreadIdType threadId);
+
   /** The two inputs should not be in the same space so there is nothing
    * to verify. */
   virtual void VerifyInputInformation() {}
@@ -74,6 +95,11 @@ private:
 
   /** RTK geometry object */
   GeometryPointer m_Geometry;
+
+  /** Tiles of the output requested region and their scheduler */
+  unsigned int                       m_TilesPerThread;
+  std::vector<OutputImageRegionType> m_Tiles;
+  WorkStealingScheduler::Pointer     m_Scheduler;
 };
 
 } // end namespace rtk
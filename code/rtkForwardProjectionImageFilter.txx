@@ -51,6 +51,34 @@ ForwardProjectionImageFilter<TInputImage,TOutputImage>
   inputPtr1->SetRequestedRegion( reqRegion );
 }
 
+template <class TInputImage, class  TOutputImage>
+void
+ForwardProjectionImageFilter<TInputImage,TOutputImage>
+::GenerateData()
+{
+  if(!m_TilesPerThread)
+    {
+    Superclass::GenerateData();
+    return;
+    }
+
+  this->AllocateOutputs();
+  this->BeforeThreadedGenerateData();
+  m_Tiles = WorkStealingScheduler::SplitRegion(this->GetOutput()->GetRequestedRegion(),
+                                               m_TilesPerThread * this->GetNumberOfThreads() );
+  m_Scheduler->Execute(this, m_Tiles.size(), this->GetNumberOfThreads() );
+  m_Tiles.clear();
+  this->AfterThreadedGenerateData();
+}
+
+template <class TInputImage, class  TOutputImage>
+void
+ForwardProjectionImageFilter<TInputImage,TOutputImage>
+::ProcessTile(const unsigned int tile, const ThreadIdType threadId)
+{
+  this->ThreadedGenerateData(m_Tiles[tile], threadId);
+}
+
 } // end namespace rtk
 
 #endif
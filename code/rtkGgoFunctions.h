@@ -24,6 +24,8 @@
 
 #include "rtkMacro.h"
 #include "rtkConstantImageSource.h"
+#include "rtkTelemetry.h"
+#include "rtkThreadAffinity.h"
 
 namespace rtk
 {
@@ -82,6 +84,58 @@ SetConstantImageSourceFromGgo(typename TConstantImageSourceType::Pointer source,
   source->UpdateOutputInformation();
 }
 
+/** \brief Create a telemetry object from gengetopt specifications.
+ *
+ * The telemetry is enabled only if the option timing-json is given so that
+ * watching filters has no effect otherwise. The required option in the ggo
+ * struct is:
+ *     - timing-json: file name of the JSON / Chrome trace output
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+template< class TArgsInfo >
+Telemetry::Pointer
+CreateTelemetryFromGgo(const TArgsInfo &args_info)
+{
+  Telemetry::Pointer telemetry = Telemetry::New();
+  telemetry->SetEnabled( args_info.timing_json_given );
+  return telemetry;
+}
+
+/** \brief Write the telemetry in the file given by the timing-json option
+ * of the gengetopt struct, if any.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+template< class TArgsInfo >
+void
+WriteTelemetryFromGgo(const Telemetry *telemetry, const TArgsInfo &args_info)
+{
+  if(args_info.timing_json_given)
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( telemetry->WriteJSON( std::string(args_info.timing_json_arg) ) )
+}
+
+/** \brief Set the pinning policy of rtk::ThreadAffinity from gengetopt
+ * specifications. The required options in the ggo struct are:
+ *     - pin: "none", "spread" or "compact"
+ *     - replicate: flag for per node copies of read-only data
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+template< class TArgsInfo >
+void
+SetThreadAffinityFromGgo(const TArgsInfo &args_info)
+{
+  ThreadAffinity::SetPolicy( ThreadAffinity::GetPolicyFromName(args_info.pin_arg) );
+  ThreadAffinity::SetReplicateReadOnlyData( args_info.replicate_flag );
+}
+
 }
 
 #endif // __rtkGgoFunctions_h
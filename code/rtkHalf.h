@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkHalf_h
+#define __rtkHalf_h
+
+#include <cstring>
+#include <cstddef>
+#include <itkNumericTraits.h>
+
+#if defined (_MSC_VER) && (_MSC_VER < 1600)
+typedef unsigned short uint16_t;
+typedef unsigned int   uint32_t;
+#else
+#include <stdint.h>
+#endif
+
+namespace rtk
+{
+
+/** \brief Conversions between single precision floats and IEEE 754 half
+ * precision floats stored as uint16_t.
+ *
+ * The conversions are written without branches, selecting between the
+ * normal, subnormal and special cases with integer masks, so that the row
+ * versions below are vectorized by the compiler. Conversion to half rounds
+ * to nearest even, overflows to infinity and keeps NaNs. Subnormal halves are
+ * handled in both directions.
+ *
+ * \author Simon Rit
+ */
+inline float HalfToFloat(const uint16_t h)
+{
+  const uint32_t shiftedExp = 0x7c00 << 13;
+  const uint32_t em = (uint32_t(h) & 0x7fff) << 13;
+  const uint32_t exp = shiftedExp & em;
+  const uint32_t isInfNan = -uint32_t(exp == shiftedExp);
+  const uint32_t isSubnormal = -uint32_t(exp == 0);
+
+  // Normal numbers and Inf/NaN only need an exponent adjustment
+  const uint32_t normal = em + ((127 - 15) << 23) + (isInfNan & ((128 - 16) << 23));
+
+  // Zero and subnormal numbers are renormalized by the FPU
+  float sub;
+  const uint32_t subBits = em + ((127 - 15 + 1) << 23);
+  std::memcpy(&sub, &subBits, sizeof(float));
+  sub -= 6.103515625e-05f; // 2^-14
+  uint32_t subnormal;
+  std::memcpy(&subnormal, &sub, sizeof(float));
+
+  const uint32_t u = (normal & ~isSubnormal) | (subnormal & isSubnormal) |
+                     ((uint32_t(h) & 0x8000) << 16);
+  float f;
+  std::memcpy(&f, &u, sizeof(float));
+  return f;
+}
+
+inline uint16_t FloatToHalf(const float x)
+{
+  const uint32_t f32infty = 255 << 23;
+  const uint32_t f16max = (127 + 16) << 23;
+  const uint32_t denormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+  uint32_t u;
+  std::memcpy(&u, &x, sizeof(float));
+  const uint32_t sign = u & 0x80000000u;
+  u ^= sign;
+
+  // Overflow to Inf, NaN stays NaN
+  const uint32_t isOverflow = -uint32_t(u >= f16max);
+  const uint32_t infNan = 0x7c00 | (-uint32_t(u > f32infty) & 0x200);
+
+  // Subnormal or zero: the FPU rounds when adding 0.5 in the subnormal scale
+  const uint32_t isSubnormal = -uint32_t(u < (113 << 23));
+  float f, magic;
+  std::memcpy(&f, &u, sizeof(float));
+  std::memcpy(&magic, &denormMagic, sizeof(float));
+  f += magic;
+  uint32_t subnormal;
+  std::memcpy(&subnormal, &f, sizeof(float));
+  subnormal -= denormMagic;
+
+  // Normal, round to nearest even
+  const uint32_t normal = (u + ((15 - 127) << 23) + 0xfff + ((u >> 13) & 1)) >> 13;
+
+  const uint32_t o = (isOverflow & infNan) |
+                     (~isOverflow & ((isSubnormal & subnormal) | (~isSubnormal & normal)));
+  return uint16_t(o | (sign >> 16));
+}
+
+/** \class Half
+ * \brief Half precision pixel type.
+ *
+ * Storage type for images which do not need single precision, e.g. stacks
+ * of projections of a 16 bits detector, to halve their memory footprint.
+ * There is no half precision arithmetic: a Half is implicitly converted to
+ * and from float and all computations are done in single precision.
+ *
+ * \author Simon Rit
+ */
+class Half
+{
+public:
+  Half(): m_Bits(0) {}
+  Half(const float f): m_Bits( FloatToHalf(f) ) {}
+  operator float() const { return HalfToFloat(m_Bits); }
+
+  /** Access to the IEEE 754 binary16 representation */
+  static Half FromBits(const uint16_t bits) { Half h; h.m_Bits = bits; return h; }
+  uint16_t GetBits() const { return m_Bits; }
+
+private:
+  uint16_t m_Bits;
+};
+
+/** Converts a row of n halves to floats. */
+inline void HalfToFloatRow(const uint16_t *in, float *out, const size_t n)
+{
+  for(size_t i=0; i<n; i++)
+    out[i] = HalfToFloat(in[i]);
+}
+
+/** Converts a row of n floats to halves. */
+inline void FloatToHalfRow(const float *in, uint16_t *out, const size_t n)
+{
+  for(size_t i=0; i<n; i++)
+    out[i] = FloatToHalf(in[i]);
+}
+
+/** Converts rows of Half pixels. Half has the size and the layout of its
+ * binary16 representation. */
+inline void HalfToFloatRow(const Half *in, float *out, const size_t n)
+{
+  HalfToFloatRow(reinterpret_cast<const uint16_t *>(in), out, n);
+}
+
+inline void FloatToHalfRow(const float *in, Half *out, const size_t n)
+{
+  FloatToHalfRow(in, reinterpret_cast<uint16_t *>(out), n);
+}
+
+} // end namespace rtk
+
+namespace itk
+{
+
+/** \brief Numeric traits of rtk::Half which borrows the traits of float
+ * for all computations. */
+template <>
+class NumericTraits<rtk::Half> : public NumericTraits<float>
+{
+public:
+  typedef rtk::Half  ValueType;
+  typedef float      PrintType;
+  typedef rtk::Half  AbsType;
+  typedef float      AccumulateType;
+  typedef float      FloatType;
+  typedef float      RealType;
+  typedef float      ScalarRealType;
+  typedef rtk::Half  MeasurementVectorType;
+
+  static rtk::Half min() { return rtk::Half::FromBits(0x0400); }
+  static rtk::Half max() { return rtk::Half::FromBits(0x7bff); }
+  static rtk::Half min(rtk::Half) { return min(); }
+  static rtk::Half max(rtk::Half) { return max(); }
+  static rtk::Half NonpositiveMin() { return rtk::Half::FromBits(0xfbff); }
+  static rtk::Half ZeroValue() { return rtk::Half::FromBits(0x0000); }
+  static rtk::Half OneValue() { return rtk::Half::FromBits(0x3c00); }
+  static rtk::Half ZeroValue(const rtk::Half &) { return ZeroValue(); }
+  static rtk::Half OneValue(const rtk::Half &) { return OneValue(); }
+  static unsigned int GetLength(const rtk::Half &) { return 1; }
+  static unsigned int GetLength() { return 1; }
+};
+
+} // end namespace itk
+
+#endif
@@ -114,7 +114,7 @@ void rtk::HisImageIO::Read(void * buffer)
   if ( file.fail() )
     itkGenericExceptionMacro(<< "Could not open file (for reading): " << m_FileName);
 
-  file.seekg(m_HeaderSize+HEADER_INFO_SIZE, std::ios::beg);
+  file.seekg(GetRawDataOffset(), std::ios::beg);
   if ( file.fail() )
     itkExceptionMacro(<<"File seek failed (His Read)");
 
@@ -127,6 +127,18 @@ void rtk::HisImageIO::Read(void * buffer)
                       << file.rdstate() );
 }
 
+//--------------------------------------------------------------------
+std::string rtk::HisImageIO::GetRawFileName() const
+{
+  return m_FileName;
+}
+
+//--------------------------------------------------------------------
+size_t rtk::HisImageIO::GetRawDataOffset() const
+{
+  return m_HeaderSize+HEADER_INFO_SIZE;
+}
+
 //--------------------------------------------------------------------
 bool rtk::HisImageIO::CanWriteFile( const char* itkNotUsed(FileNameToWrite) )
 {
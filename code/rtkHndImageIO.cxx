@@ -18,88 +18,106 @@
 
 // std include
 #include <stdio.h>
+#include <string.h>
 
 #include "rtkHndImageIO.h"
 #include <itkMetaDataObject.h>
 
 //--------------------------------------------------------------------
-// Read Image Information
-void rtk::HndImageIO::ReadImageInformation()
+// Copy one field of the packed on-disk header and move to the next one
+template <class TField>
+static inline void ReadHeaderField(const char *&p, TField &field)
 {
-  Hnd_header hnd;
-  FILE *     fp;
+  memcpy(&field, p, sizeof(TField));
+  p += sizeof(TField);
+}
 
-  fp = fopen (m_FileName.c_str(), "rb");
+//--------------------------------------------------------------------
+// Read the fixed size header of an hnd file
+void rtk::HndImageIO::ReadHeader(const std::string &fileName, Hnd_header &hnd)
+{
+  FILE *fp = fopen (fileName.c_str(), "rb");
   if (fp == NULL)
-    itkGenericExceptionMacro(<< "Could not open file (for reading): " << m_FileName);
-
-  size_t nelements = 0;
-  nelements += fread ( (void *) hnd.sFileType, sizeof(char), 32, fp);
-  nelements += fread ( (void *) &hnd.FileLength, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) hnd.sChecksumSpec, sizeof(char), 4, fp);
-  nelements += fread ( (void *) &hnd.nCheckSum, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) hnd.sCreationDate, sizeof(char), 8, fp);
-  nelements += fread ( (void *) hnd.sCreationTime, sizeof(char), 8, fp);
-  nelements += fread ( (void *) hnd.sPatientID, sizeof(char), 16, fp);
-  nelements += fread ( (void *) &hnd.nPatientSer, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) hnd.sSeriesID, sizeof(char), 16, fp);
-  nelements += fread ( (void *) &hnd.nSeriesSer, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) hnd.sSliceID, sizeof(char), 16, fp);
-  nelements += fread ( (void *) &hnd.nSliceSer, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) &hnd.SizeX, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) &hnd.SizeY, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) &hnd.dSliceZPos, sizeof(double), 1, fp);
-  nelements += fread ( (void *) hnd.sModality, sizeof(char), 16, fp);
-  nelements += fread ( (void *) &hnd.nWindow, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) &hnd.nLevel, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) &hnd.nPixelOffset, sizeof(uint32_t), 1, fp);
-  nelements += fread ( (void *) hnd.sImageType, sizeof(char), 4, fp);
-  nelements += fread ( (void *) &hnd.dGantryRtn, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dSAD, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dSFD, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCollX1, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCollX2, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCollY1, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCollY2, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCollRtn, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dFieldX, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dFieldY, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dBladeX1, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dBladeX2, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dBladeY1, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dBladeY2, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUPosLng, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUPosLat, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUPosVrt, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUPosRtn, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dPatientSupportAngle, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dTableTopEccentricAngle, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCouchVrt, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCouchLng, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCouchLat, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUResolutionX, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dIDUResolutionY, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dImageResolutionX, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dImageResolutionY, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dEnergy, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dDoseRate, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dXRayKV, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dXRayMA, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dMetersetExposure, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dAcqAdjustment, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCTProjectionAngle, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dCTNormChamber, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dGatingTimeTag, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dGating4DInfoX, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dGating4DInfoY, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dGating4DInfoZ, sizeof(double), 1, fp);
-  nelements += fread ( (void *) &hnd.dGating4DInfoTime, sizeof(double), 1, fp);
-
-  if(nelements != /*char*/120 + /*uint32_t*/10 +  /*double*/41)
-    itkGenericExceptionMacro(<< "Could not read header data in " << m_FileName);
+    itkGenericExceptionMacro(<< "Could not open file (for reading): " << fileName);
 
+  // The header is packed on disk whereas the struct may be padded: it is read
+  // at once and then unpacked field by field.
+  char buffer[HeaderSize];
+  const size_t nbytes = fread (buffer, sizeof(char), HeaderSize, fp);
   if(fclose (fp) != 0)
-    itkGenericExceptionMacro(<< "Could not close file: " << m_FileName);
+    itkGenericExceptionMacro(<< "Could not close file: " << fileName);
+  if(nbytes != HeaderSize)
+    itkGenericExceptionMacro(<< "Could not read header data in " << fileName);
+
+  const char *p = buffer;
+  ReadHeaderField(p, hnd.sFileType);
+  ReadHeaderField(p, hnd.FileLength);
+  ReadHeaderField(p, hnd.sChecksumSpec);
+  ReadHeaderField(p, hnd.nCheckSum);
+  ReadHeaderField(p, hnd.sCreationDate);
+  ReadHeaderField(p, hnd.sCreationTime);
+  ReadHeaderField(p, hnd.sPatientID);
+  ReadHeaderField(p, hnd.nPatientSer);
+  ReadHeaderField(p, hnd.sSeriesID);
+  ReadHeaderField(p, hnd.nSeriesSer);
+  ReadHeaderField(p, hnd.sSliceID);
+  ReadHeaderField(p, hnd.nSliceSer);
+  ReadHeaderField(p, hnd.SizeX);
+  ReadHeaderField(p, hnd.SizeY);
+  ReadHeaderField(p, hnd.dSliceZPos);
+  ReadHeaderField(p, hnd.sModality);
+  ReadHeaderField(p, hnd.nWindow);
+  ReadHeaderField(p, hnd.nLevel);
+  ReadHeaderField(p, hnd.nPixelOffset);
+  ReadHeaderField(p, hnd.sImageType);
+  ReadHeaderField(p, hnd.dGantryRtn);
+  ReadHeaderField(p, hnd.dSAD);
+  ReadHeaderField(p, hnd.dSFD);
+  ReadHeaderField(p, hnd.dCollX1);
+  ReadHeaderField(p, hnd.dCollX2);
+  ReadHeaderField(p, hnd.dCollY1);
+  ReadHeaderField(p, hnd.dCollY2);
+  ReadHeaderField(p, hnd.dCollRtn);
+  ReadHeaderField(p, hnd.dFieldX);
+  ReadHeaderField(p, hnd.dFieldY);
+  ReadHeaderField(p, hnd.dBladeX1);
+  ReadHeaderField(p, hnd.dBladeX2);
+  ReadHeaderField(p, hnd.dBladeY1);
+  ReadHeaderField(p, hnd.dBladeY2);
+  ReadHeaderField(p, hnd.dIDUPosLng);
+  ReadHeaderField(p, hnd.dIDUPosLat);
+  ReadHeaderField(p, hnd.dIDUPosVrt);
+  ReadHeaderField(p, hnd.dIDUPosRtn);
+  ReadHeaderField(p, hnd.dPatientSupportAngle);
+  ReadHeaderField(p, hnd.dTableTopEccentricAngle);
+  ReadHeaderField(p, hnd.dCouchVrt);
+  ReadHeaderField(p, hnd.dCouchLng);
+  ReadHeaderField(p, hnd.dCouchLat);
+  ReadHeaderField(p, hnd.dIDUResolutionX);
+  ReadHeaderField(p, hnd.dIDUResolutionY);
+  ReadHeaderField(p, hnd.dImageResolutionX);
+  ReadHeaderField(p, hnd.dImageResolutionY);
+  ReadHeaderField(p, hnd.dEnergy);
+  ReadHeaderField(p, hnd.dDoseRate);
+  ReadHeaderField(p, hnd.dXRayKV);
+  ReadHeaderField(p, hnd.dXRayMA);
+  ReadHeaderField(p, hnd.dMetersetExposure);
+  ReadHeaderField(p, hnd.dAcqAdjustment);
+  ReadHeaderField(p, hnd.dCTProjectionAngle);
+  ReadHeaderField(p, hnd.dCTNormChamber);
+  ReadHeaderField(p, hnd.dGatingTimeTag);
+  ReadHeaderField(p, hnd.dGating4DInfoX);
+  ReadHeaderField(p, hnd.dGating4DInfoY);
+  ReadHeaderField(p, hnd.dGating4DInfoZ);
+  ReadHeaderField(p, hnd.dGating4DInfoTime);
+}
+
+//--------------------------------------------------------------------
+// Read Image Information
+void rtk::HndImageIO::ReadImageInformation()
+{
+  Hnd_header hnd;
+  ReadHeader(m_FileName, hnd);
 
   /* Convert hnd to ITK image information */
   SetNumberOfDimensions(2);
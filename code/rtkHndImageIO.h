@@ -112,6 +112,10 @@ public:
     double dGating4DInfoTime;
     } Hnd_header;
 
+  /** Size in bytes of the packed header at the beginning of hnd files:
+   * 120 chars, 10 uint32 and 41 doubles. */
+  itkStaticConstMacro(HeaderSize, unsigned int, 120 + 10*4 + 41*8);
+
   HndImageIO() : Superclass() {}
 
   /** Method for creation through the object factory. */
@@ -127,6 +131,12 @@ public:
 
   virtual void Read(void * buffer);
 
+  /** Read the header of an hnd file only, without going through the reader
+   * and the factory mechanism. This is the fast path to collect per
+   * projection information, e.g., the gantry angle, of a whole acquisition.
+   * The function is thread safe and throws an exception on failure. */
+  static void ReadHeader(const std::string &fileName, Hnd_header &hnd);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
   virtual void WriteImageInformation(bool /*keepOfStream*/) { }
 
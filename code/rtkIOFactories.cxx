@@ -34,6 +34,9 @@
 // Xrad small animal scanner
 #include "rtkXRadImageIOFactory.h"
 
+// Preprocessed projections written by rtkprojections
+#include "rtkProjectionsCacheImageIOFactory.h"
+
 namespace rtk
 {
 
@@ -44,6 +47,7 @@ void RegisterIOFactories()
   rtk::ImagXImageIOFactory::RegisterOneFactory();
   rtk::EdfImageIOFactory::RegisterOneFactory();
   rtk::XRadImageIOFactory::RegisterOneFactory();
+  rtk::ProjectionsCacheImageIOFactory::RegisterOneFactory();
 #if ITK_VERSION_MAJOR <= 3
   itk::ImageIOFactory::RegisterBuiltInFactories();
 #endif
@@ -61,6 +61,9 @@ protected:
   virtual ~ImagXLookupTableImageFilter() {
   }
 
+  /** Fill the lookup table shared by all instances. */
+  static void BuildLookupTable(LookupTableType *lut);
+
 private:
   ImagXLookupTableImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);              //purposely not implemented
@@ -72,12 +75,14 @@ private:
 template <class TInputImage, class TOutputImage>
 rtk::ImagXLookupTableImageFilter<TInputImage, TOutputImage>::ImagXLookupTableImageFilter()
 {
-  // Create the lut
-  typename LookupTableType::Pointer lut = LookupTableType::New();
-  typename LookupTableType::SizeType size;
-  size[0] = itk::NumericTraits<InputImagePixelType>::max()-itk::NumericTraits<InputImagePixelType>::min()+1;
-  lut->SetRegions( size );
-  lut->Allocate();
+  this->SetLookupTable( Superclass::GetOrCreateSharedLookupTable("ImagX", BuildLookupTable) );
+}
+
+template <class TInputImage, class TOutputImage>
+void
+rtk::ImagXLookupTableImageFilter<TInputImage, TOutputImage>::BuildLookupTable(LookupTableType *lut)
+{
+  const typename LookupTableType::SizeType size = lut->GetBufferedRegion().GetSize();
 
   OutputImagePixelType logRef = log(OutputImagePixelType(size[0]) );
 
@@ -89,9 +94,6 @@ rtk::ImagXLookupTableImageFilter<TInputImage, TOutputImage>::ImagXLookupTableIma
     it.Set( logRef - log(it.GetIndex()[0]+1.) );
     ++it;
     }
-
-  // Set the lut to member and functor
-  this->SetLookupTable(lut);
 }
 
 #endif
@@ -19,11 +19,11 @@
 #ifndef __rtkImagXRawToAttenuationImageFilter_h
 #define __rtkImagXRawToAttenuationImageFilter_h
 
+#include <vector>
 #include <itkImageToImageFilter.h>
-#include <itkCropImageFilter.h>
+#include <itkMultiThreader.h>
 
 #include "rtkImagXLookupTableImageFilter.h"
-#include "rtkBoellaardScatterCorrectionImageFilter.h"
 
 namespace rtk
 {
@@ -31,6 +31,15 @@ namespace rtk
 /** \class ImagXRawToAttenuationImageFilter
  * \brief Convert raw ImagX data to attenuation images
  *
+ * The conversion crops a border of 4 pixels, removes a constant scatter
+ * estimate per projection as BoellaardScatterCorrectionImageFilter and applies
+ * the ImagX lookup table. The three steps are fused: the statistics of each
+ * projection (air mean and minimum) are computed in a first threaded pass
+ * over the cropped region of the input, without copy, and the correction and
+ * the lookup table are applied in a second threaded pass which writes the
+ * output directly. Both passes split projections in several pieces if there
+ * are fewer projections than threads.
+ *
  * \author Simon Rit
  *
  * \ingroup ImageToImageFilter
@@ -51,11 +60,27 @@ public:
   typedef TInputImage  InputImageType;
   typedef TOutputImage OutputImageType;
 
+  typedef typename TInputImage::PixelType                     InputPixelType;
+  typedef typename TOutputImage::PixelType                    OutputPixelType;
+  typedef typename TOutputImage::RegionType                   OutputImageRegionType;
+  typedef ImagXLookupTableImageFilter<TInputImage, TOutputImage> LookupTableFilterType;
+  typedef typename LookupTableFilterType::LookupTableType     LookupTableType;
+
   /** Standard New method. */
   itkNewMacro(Self);
 
   /** Runtime information support. */
   itkTypeMacro(ImagXRawToAttenuationImageFilter, itk::ImageToImageFilter);
+
+  /** Get / Set the parameters of the scatter correction, see
+   * BoellaardScatterCorrectionImageFilter. */
+  itkGetMacro(AirThreshold, double);
+  itkSetMacro(AirThreshold, double);
+  itkGetMacro(ScatterToPrimaryRatio, double);
+  itkSetMacro(ScatterToPrimaryRatio, double);
+  itkGetMacro(NonNegativityConstraintThreshold, double);
+  itkSetMacro(NonNegativityConstraintThreshold, double);
+
 protected:
   ImagXRawToAttenuationImageFilter();
   ~ImagXRawToAttenuationImageFilter(){
@@ -66,22 +91,40 @@ protected:
 
   void GenerateOutputInformation();
 
-  /** Single-threaded version of GenerateData.  This filter delegates
-   * to other filters. */
-  void GenerateData();
+  /** Requires full projection images to estimate scatter */
+  virtual void EnlargeOutputRequestedRegion(itk::DataObject *itkNotUsed(output));
+
+  /** Computes the scatter correction of each requested projection */
+  virtual void BeforeThreadedGenerateData();
+
+  /** Applies the scatter correction and the lookup table */
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId);
 
 private:
   //purposely not implemented
   ImagXRawToAttenuationImageFilter(const Self&);
   void operator=(const Self&);
 
-  typedef itk::CropImageFilter<InputImageType, InputImageType>                       CropFilterType;
-  typedef rtk::BoellaardScatterCorrectionImageFilter<InputImageType, InputImageType> ScatterFilterType;
-  typedef rtk::ImagXLookupTableImageFilter<InputImageType, OutputImageType>          LookupTableFilterType;
-
-  typename LookupTableFilterType::Pointer m_LookupTableFilter;
-  typename CropFilterType::Pointer        m_CropFilter;
-  typename ScatterFilterType::Pointer     m_ScatterFilter;
+  /** Statistics of a piece of projection */
+  struct ProjectionStatistics
+    {
+    double         AirSum;
+    InputPixelType Minimum;
+    };
+
+  static ITK_THREAD_RETURN_TYPE ComputeStatisticsCallback(void *arg);
+  void ComputeStatistics(unsigned int piece, ProjectionStatistics &stats);
+
+  typename LookupTableType::Pointer m_LookupTable;
+  double                            m_AirThreshold;
+  double                            m_ScatterToPrimaryRatio;
+  double                            m_NonNegativityConstraintThreshold;
+
+  /** Pieces of the statistics pass and resulting correction per projection */
+  typename TInputImage::RegionType   m_StatisticsRegion;
+  unsigned int                       m_NumberOfPiecesPerProjection;
+  std::vector<ProjectionStatistics>  m_Statistics;
+  std::vector<double>                m_Corrections;
 }; // end of class
 
 } // end namespace rtk
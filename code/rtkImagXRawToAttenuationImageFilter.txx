@@ -19,11 +19,41 @@
 #ifndef __rtkImagXRawToAttenuationImageFilter_txx
 #define __rtkImagXRawToAttenuationImageFilter_txx
 
-#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 
 namespace rtk
 {
 
+template <class TInputImage, class TOutputImage>
+ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
+::ImagXRawToAttenuationImageFilter():
+  m_AirThreshold(32000),
+  m_ScatterToPrimaryRatio(0.),
+  m_NonNegativityConstraintThreshold(20),
+  m_NumberOfPiecesPerProjection(1)
+{
+  // The lut is shared by all ImagX filters with the same pixel types
+  m_LookupTable = LookupTableFilterType::New()->GetLookupTable();
+}
+
+template<class TInputImage, class TOutputImage>
+void
+ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  // Crop a border of 4 pixels. The index is shifted, the origin is kept as in
+  // itk::CropImageFilter.
+  typename TOutputImage::RegionType region = this->GetInput()->GetLargestPossibleRegion();
+  for(unsigned int i=0; i<2; i++)
+    {
+    region.SetIndex(i, region.GetIndex(i) + 4);
+    region.SetSize(i, region.GetSize(i) - 8);
+    }
+  this->GetOutput()->SetLargestPossibleRegion( region );
+}
+
 template<class TInputImage, class TOutputImage>
 void
 ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
@@ -34,51 +64,167 @@ ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
   if ( !inputPtr )
     return;
 
-  m_CropFilter->SetInput(inputPtr); //SR: this is most likely useless
-  m_LookupTableFilter->GetOutput()->SetRequestedRegion(this->GetOutput()->GetRequestedRegion() );
-  m_LookupTableFilter->GetOutput()->PropagateRequestedRegion();
+  // The output is a subregion of the input with the same indices
+  inputPtr->SetRequestedRegion( this->GetOutput()->GetRequestedRegion() );
 }
 
 template <class TInputImage, class TOutputImage>
+void
 ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
-::ImagXRawToAttenuationImageFilter()
+::EnlargeOutputRequestedRegion(itk::DataObject *itkNotUsed(output))
 {
-  m_CropFilter = CropFilterType::New();
-  m_ScatterFilter = ScatterFilterType::New();
-  m_LookupTableFilter = LookupTableFilterType::New();
-
-  //Permanent internal connections
-  m_ScatterFilter->SetInput( m_CropFilter->GetOutput() );
-  m_LookupTableFilter->SetInput( m_ScatterFilter->GetOutput() );
-
-  //Default filter parameters
-  typename CropFilterType::SizeType border = m_CropFilter->GetLowerBoundaryCropSize();
-  border[0] = 4;
-  border[1] = 4;
-  m_CropFilter->SetBoundaryCropSize(border);
+  typename TOutputImage::RegionType orr = this->GetOutput()->GetRequestedRegion();
+  const typename TOutputImage::RegionType &lpr = this->GetOutput()->GetLargestPossibleRegion();
+  for(unsigned int i=0; i<TOutputImage::ImageDimension-1; i++)
+    {
+    orr.SetIndex( i, lpr.GetIndex(i) );
+    orr.SetSize( i, lpr.GetSize(i) );
+    }
+  this->GetOutput()->SetRequestedRegion( orr );
 }
 
 template<class TInputImage, class TOutputImage>
 void
 ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
-::GenerateOutputInformation()
+::BeforeThreadedGenerateData()
+{
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  m_StatisticsRegion = this->GetOutput()->GetRequestedRegion();
+  const unsigned int nproj = m_StatisticsRegion.GetSize(Dimension-1);
+  const unsigned int nthreads = this->GetNumberOfThreads();
+
+  // Each projection is split along its rows in several pieces if there are
+  // fewer projections than threads
+  m_NumberOfPiecesPerProjection = 1;
+  if(Dimension > 2 && nproj < nthreads)
+    m_NumberOfPiecesPerProjection = vnl_math_min( (nthreads+nproj-1) / nproj,
+                                                  (unsigned int)m_StatisticsRegion.GetSize(1) );
+  m_Statistics.resize(nproj * m_NumberOfPiecesPerProjection);
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( vnl_math_min(nthreads, (unsigned int)m_Statistics.size()) );
+  threader->SetSingleMethod(ComputeStatisticsCallback, this);
+  threader->SingleMethodExecute();
+
+  // Same correction as BoellaardScatterCorrectionImageFilter
+  double npixelPerSlice = 1.;
+  for(unsigned int i=0; i<Dimension-1; i++)
+    npixelPerSlice *= m_StatisticsRegion.GetSize(i);
+  m_Corrections.resize(nproj);
+  for(unsigned int p=0; p<nproj; p++)
+    {
+    double averageBehindPatient = 0.;
+    double smallestValue = itk::NumericTraits<double>::max();
+    for(unsigned int i=0; i<m_NumberOfPiecesPerProjection; i++)
+      {
+      const ProjectionStatistics &stats = m_Statistics[p*m_NumberOfPiecesPerProjection+i];
+      averageBehindPatient += stats.AirSum;
+      smallestValue = vnl_math_min(smallestValue, (double)stats.Minimum);
+      }
+    averageBehindPatient /= npixelPerSlice;
+
+    // Compute constant correction
+    double correction = averageBehindPatient * m_ScatterToPrimaryRatio;
+
+    // Apply non-negativity constraint
+    if(smallestValue-correction<m_NonNegativityConstraintThreshold)
+      correction = smallestValue - m_NonNegativityConstraintThreshold;
+
+    m_Corrections[p] = correction;
+    }
+}
+
+template<class TInputImage, class TOutputImage>
+ITK_THREAD_RETURN_TYPE
+ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
+::ComputeStatisticsCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(arg);
+  Self *self = (Self *)(info->UserData);
+  for(unsigned int piece=info->ThreadID; piece<self->m_Statistics.size(); piece+=info->NumberOfThreads)
+    self->ComputeStatistics(piece, self->m_Statistics[piece]);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<class TInputImage, class TOutputImage>
+void
+ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
+::ComputeStatistics(unsigned int piece, ProjectionStatistics &stats)
 {
-  m_CropFilter->SetInput(this->GetInput() );
-  m_LookupTableFilter->UpdateOutputInformation();
-  this->GetOutput()->SetOrigin( m_LookupTableFilter->GetOutput()->GetOrigin() );
-  this->GetOutput()->SetSpacing( m_LookupTableFilter->GetOutput()->GetSpacing() );
-  this->GetOutput()->SetDirection( m_LookupTableFilter->GetOutput()->GetDirection() );
-  this->GetOutput()->SetLargestPossibleRegion( m_LookupTableFilter->GetOutput()->GetLargestPossibleRegion() );
+  typedef typename itk::NumericTraits<InputPixelType>::AccumulateType RowSumType;
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const TInputImage *input = this->GetInput();
+
+  // Region of the piece
+  typename TInputImage::RegionType region = m_StatisticsRegion;
+  const unsigned int proj = piece / m_NumberOfPiecesPerProjection;
+  const unsigned int subPiece = piece % m_NumberOfPiecesPerProjection;
+  region.SetIndex(Dimension-1, region.GetIndex(Dimension-1) + proj);
+  region.SetSize(Dimension-1, 1);
+  if(Dimension > 2)
+    {
+    const unsigned int nrows = region.GetSize(1);
+    const unsigned int begin = (unsigned long)nrows *  subPiece    / m_NumberOfPiecesPerProjection;
+    const unsigned int end   = (unsigned long)nrows * (subPiece+1) / m_NumberOfPiecesPerProjection;
+    region.SetIndex(1, region.GetIndex(1) + begin);
+    region.SetSize(1, end - begin);
+    }
+  const unsigned int nx = region.GetSize(0);
+
+  // Air threshold in the pixel type, i.e., the smallest pixel value which is
+  // greater than or equal to m_AirThreshold
+  const bool noAir = m_AirThreshold > (double)itk::NumericTraits<InputPixelType>::max();
+  double airThresholdDouble = vnl_math_max(m_AirThreshold, (double)itk::NumericTraits<InputPixelType>::NonpositiveMin());
+  if(itk::NumericTraits<InputPixelType>::is_integer)
+    airThresholdDouble = vcl_ceil(airThresholdDouble);
+  const InputPixelType airThreshold = (noAir)?itk::NumericTraits<InputPixelType>::max():(InputPixelType)airThresholdDouble;
+
+  // Iterate over the first pixel of each row of the piece. The row loops are
+  // written without branch so that the reductions vectorize.
+  stats.AirSum = 0.;
+  stats.Minimum = itk::NumericTraits<InputPixelType>::max();
+  region.SetSize(0, 1);
+  itk::ImageRegionConstIteratorWithIndex<TInputImage> itRow(input, region);
+  for(; !itRow.IsAtEnd(); ++itRow)
+    {
+    const InputPixelType *in = input->GetBufferPointer() + input->ComputeOffset(itRow.GetIndex());
+    InputPixelType rowMin = stats.Minimum;
+    RowSumType rowSum = itk::NumericTraits<RowSumType>::Zero;
+    for(unsigned int x=0; x<nx; x++)
+      {
+      rowMin = vnl_math_min(rowMin, in[x]);
+      rowSum += RowSumType(in[x] >= airThreshold) * RowSumType(in[x]);
+      }
+    stats.Minimum = rowMin;
+    if(!noAir)
+      stats.AirSum += rowSum;
+    }
 }
 
 template<class TInputImage, class TOutputImage>
 void
 ImagXRawToAttenuationImageFilter<TInputImage, TOutputImage>
-::GenerateData()
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
 {
-  m_CropFilter->SetInput(this->GetInput() );
-  m_LookupTableFilter->Update();
-  this->GraftOutput( m_LookupTableFilter->GetOutput() );
+  const unsigned int Dimension = TInputImage::ImageDimension;
+  const TInputImage *input = this->GetInput();
+  TOutputImage *output = this->GetOutput();
+  const OutputPixelType *lut = m_LookupTable->GetBufferPointer();
+  const unsigned int nx = outputRegionForThread.GetSize(0);
+
+  // Iterate over the first pixel of each row
+  OutputImageRegionType rowRegion = outputRegionForThread;
+  rowRegion.SetSize(0, 1);
+  itk::ImageRegionConstIteratorWithIndex<TOutputImage> itRow(output, rowRegion);
+  for(; !itRow.IsAtEnd(); ++itRow)
+    {
+    const typename TOutputImage::IndexType idx = itRow.GetIndex();
+    const double correction = m_Corrections[idx[Dimension-1] - m_StatisticsRegion.GetIndex(Dimension-1)];
+    const InputPixelType *in = input->GetBufferPointer() + input->ComputeOffset(idx);
+    OutputPixelType *out = output->GetBufferPointer() + output->ComputeOffset(idx);
+    for(unsigned int x=0; x<nx; x++)
+      out[x] = lut[ InputPixelType(in[x] - correction) ];
+    }
 }
 
 } // end namespace rtk
@@ -0,0 +1,246 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkImageBufferPool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#if defined(_WIN32) || defined(WIN32)
+#  include <malloc.h>
+#endif
+
+namespace rtk
+{
+
+ImageBufferPool::Pointer
+ImageBufferPool
+::GetInstance()
+{
+  static Pointer instance = Self::New();
+  return instance;
+}
+
+ImageBufferPool
+::ImageBufferPool():
+  m_MaximumCachedBytes(size_t(1)<<30)
+{
+  m_Statistics.BytesInUse = 0;
+  m_Statistics.BytesCached = 0;
+  ResetStatistics();
+}
+
+ImageBufferPool
+::~ImageBufferPool()
+{
+  Trim();
+}
+
+size_t
+ImageBufferPool
+::GetBlockSize(const size_t bytes)
+{
+  return std::max(size_t(1), (bytes + Alignment - 1) / Alignment) * Alignment;
+}
+
+void *
+ImageBufferPool
+::AllocateBlock(const size_t bytes)
+{
+  void *buffer = NULL;
+#if defined(_WIN32) || defined(WIN32)
+  buffer = _aligned_malloc(bytes, Alignment);
+#else
+  if(posix_memalign(&buffer, Alignment, bytes) != 0)
+    buffer = NULL;
+#endif
+  if(buffer == NULL)
+    itkExceptionMacro(<< "Failed to allocate " << bytes << " bytes");
+  return buffer;
+}
+
+void
+ImageBufferPool
+::FreeBlock(void *buffer)
+{
+#if defined(_WIN32) || defined(WIN32)
+  _aligned_free(buffer);
+#else
+  free(buffer);
+#endif
+}
+
+void *
+ImageBufferPool
+::Acquire(const size_t bytes)
+{
+  const size_t blockSize = GetBlockSize(bytes);
+  void *buffer = NULL;
+  m_Mutex.Lock();
+  m_Statistics.Requests++;
+  BuffersType::iterator it = m_Buffers.find(blockSize);
+  if(it != m_Buffers.end())
+    {
+    buffer = it->second;
+    m_Buffers.erase(it);
+    m_Statistics.Reuses++;
+    m_Statistics.BytesCached -= blockSize;
+    }
+  else
+    m_Statistics.Allocations++;
+  m_Statistics.BytesInUse += blockSize;
+  m_Statistics.PeakBytesInUse = std::max(m_Statistics.PeakBytesInUse, m_Statistics.BytesInUse);
+  m_Mutex.Unlock();
+
+  // New buffers are allocated outside of the lock
+  if(buffer == NULL)
+    {
+    try
+      {
+      buffer = AllocateBlock(blockSize);
+      }
+    catch(...)
+      {
+      m_Mutex.Lock();
+      m_Statistics.BytesInUse -= blockSize;
+      m_Mutex.Unlock();
+      throw;
+      }
+    }
+  return buffer;
+}
+
+void
+ImageBufferPool
+::Release(void *buffer, const size_t bytes)
+{
+  if(buffer == NULL)
+    return;
+  const size_t blockSize = GetBlockSize(bytes);
+  bool cached = false;
+  m_Mutex.Lock();
+  m_Statistics.BytesInUse -= blockSize;
+  if(m_Statistics.BytesCached + blockSize <= m_MaximumCachedBytes)
+    {
+    m_Buffers.insert( std::make_pair(blockSize, buffer) );
+    m_Statistics.BytesCached += blockSize;
+    cached = true;
+    }
+  else
+    m_Statistics.Frees++;
+  m_Mutex.Unlock();
+
+  if(!cached)
+    FreeBlock(buffer);
+}
+
+void
+ImageBufferPool
+::Trim()
+{
+  BuffersType buffers;
+  m_Mutex.Lock();
+  buffers.swap(m_Buffers);
+  m_Statistics.Frees += buffers.size();
+  m_Statistics.BytesCached = 0;
+  m_Mutex.Unlock();
+
+  for(BuffersType::iterator it=buffers.begin(); it!=buffers.end(); ++it)
+    FreeBlock(it->second);
+}
+
+void
+ImageBufferPool
+::SetMaximumCachedBytes(const size_t bytes)
+{
+  if(bytes == m_MaximumCachedBytes)
+    return;
+
+  // Free the largest buffers beyond the new maximum
+  std::vector<void *> buffers;
+  m_Mutex.Lock();
+  m_MaximumCachedBytes = bytes;
+  while(m_Statistics.BytesCached > m_MaximumCachedBytes)
+    {
+    BuffersType::iterator it = --m_Buffers.end();
+    buffers.push_back(it->second);
+    m_Statistics.BytesCached -= it->first;
+    m_Statistics.Frees++;
+    m_Buffers.erase(it);
+    }
+  m_Mutex.Unlock();
+
+  for(unsigned int i=0; i<buffers.size(); i++)
+    FreeBlock(buffers[i]);
+  this->Modified();
+}
+
+ImageBufferPool::Statistics
+ImageBufferPool
+::GetStatistics() const
+{
+  m_Mutex.Lock();
+  Statistics statistics = m_Statistics;
+  m_Mutex.Unlock();
+  return statistics;
+}
+
+void
+ImageBufferPool
+::ResetStatistics()
+{
+  // The bytes in use and cached describe the current state, they are kept
+  m_Mutex.Lock();
+  m_Statistics.Requests = 0;
+  m_Statistics.Reuses = 0;
+  m_Statistics.Allocations = 0;
+  m_Statistics.Frees = 0;
+  m_Statistics.PeakBytesInUse = m_Statistics.BytesInUse;
+  m_Mutex.Unlock();
+}
+
+void
+ImageBufferPool
+::PrintStatistics(std::ostream &os) const
+{
+  const Statistics s = GetStatistics();
+  os << "ImageBufferPool statistics:" << std::endl;
+  os << "  Requests: " << s.Requests << " (" << s.Reuses << " reuses, "
+     << s.Allocations << " allocations)" << std::endl;
+  os << "  Buffers freed: " << s.Frees << std::endl;
+  os << "  Bytes in use: " << s.BytesInUse << " (peak " << s.PeakBytesInUse << ')' << std::endl;
+  os << "  Bytes cached: " << s.BytesCached << std::endl;
+}
+
+void
+ImageBufferPool
+::PrintSelf(std::ostream &os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  const Statistics s = GetStatistics();
+  os << indent << "MaximumCachedBytes: " << m_MaximumCachedBytes << std::endl;
+  os << indent << "Requests: " << s.Requests << std::endl;
+  os << indent << "Reuses: " << s.Reuses << std::endl;
+  os << indent << "Allocations: " << s.Allocations << std::endl;
+  os << indent << "Frees: " << s.Frees << std::endl;
+  os << indent << "BytesInUse: " << s.BytesInUse << std::endl;
+  os << indent << "PeakBytesInUse: " << s.PeakBytesInUse << std::endl;
+  os << indent << "BytesCached: " << s.BytesCached << std::endl;
+}
+
+} // end namespace rtk
@@ -0,0 +1,235 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkImageBufferPool_h
+#define __rtkImageBufferPool_h
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkCommand.h>
+#include <itkImageSource.h>
+#include <itkImportImageContainer.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <map>
+#include <ostream>
+
+namespace rtk
+{
+
+/** \class ImageBufferPool
+ * \brief Recycles the pixel buffers of images which are repeatedly allocated.
+ *
+ * The mini-pipelines of the reconstruction filters, e.g.,
+ * rtk::FDKConeBeamReconstructionFilter and
+ * rtk::SARTConeBeamReconstructionFilter, update their subfilters once per
+ * subset of projections. Each update frees the output buffers of the
+ * previous one and allocates buffers of the same size. The pool keeps the
+ * released buffers, keyed by their size, and hands them out again instead
+ * of going through malloc and the page faults of new pages. All buffers are
+ * aligned on Alignment bytes for SIMD instructions.
+ *
+ * Images get a pooled buffer with Allocate, instead of itk::Image::Allocate,
+ * or through Watch which pools the output of a filter at each of its
+ * executions. The buffer returns to the pool when the last image which
+ * shares it is destroyed or reinitialized, e.g., when the filter executes
+ * again. At most MaximumCachedBytes are kept unused in the pool, Trim frees
+ * all of them.
+ *
+ * GetInstance returns the pool shared by RTK filters. The pool is thread
+ * safe.
+ *
+ * \test rtkbufferpooltest.cxx
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+class ITK_EXPORT ImageBufferPool : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferPool               Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferPool, itk::Object);
+
+  /** Alignment in bytes of all buffers, the size of a cache line */
+  itkStaticConstMacro(Alignment, size_t, 64);
+
+  /** Pool shared by RTK filters */
+  static Pointer GetInstance();
+
+  /** Usage of the pool since its creation or the last ResetStatistics */
+  struct Statistics
+    {
+    unsigned long Requests;    // Number of Acquire
+    unsigned long Reuses;      // Requests served with a buffer of the pool
+    unsigned long Allocations; // Requests served with a new buffer
+    unsigned long Frees;       // Buffers returned to the system
+    size_t        BytesInUse;
+    size_t        PeakBytesInUse;
+    size_t        BytesCached;
+    };
+
+  /** Get a buffer of at least bytes bytes aligned on Alignment */
+  void *Acquire(const size_t bytes);
+
+  /** Give back a buffer obtained with Acquire with the same size */
+  void Release(void *buffer, const size_t bytes);
+
+  /** Free all unused buffers */
+  void Trim();
+
+  /** Get / Set the maximum number of bytes of the unused buffers kept in the
+   * pool, 1 GiB by default. Buffers released beyond are freed. */
+  itkGetConstMacro(MaximumCachedBytes, size_t);
+  void SetMaximumCachedBytes(const size_t bytes);
+
+  Statistics GetStatistics() const;
+  void ResetStatistics();
+  void PrintStatistics(std::ostream &os) const;
+
+  /** Allocate the buffered region of image with a pooled buffer. This
+   * replaces itk::Image::Allocate and the pixels are not initialized. */
+  template <class TImage>
+  void Allocate(TImage *image);
+
+  /** Give a pooled buffer to the output of filter before each of its
+   * executions. The filter must allocate its requested region, as
+   * itk::ImageSource::AllocateOutputs, for the buffer to be used. Each
+   * filter must be watched once. */
+  template <class TOutputImage>
+  void Watch(itk::ImageSource<TOutputImage> *filter);
+
+protected:
+  ImageBufferPool();
+  virtual ~ImageBufferPool();
+  virtual void PrintSelf(std::ostream &os, itk::Indent indent) const;
+
+  /** Size actually allocated for a request of bytes bytes */
+  static size_t GetBlockSize(const size_t bytes);
+
+  /** Aligned allocation from and to the system */
+  void *AllocateBlock(const size_t bytes);
+  static void FreeBlock(void *buffer);
+
+  /** Observer of the StartEvent of a watched filter */
+  template <class TOutputImage>
+  class AllocationCommand : public itk::Command
+  {
+  public:
+    typedef AllocationCommand       Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkNewMacro(Self);
+
+    void SetPool(ImageBufferPool *pool) { m_Pool = pool; }
+
+    virtual void Execute(itk::Object *caller, const itk::EventObject &event);
+    virtual void Execute(const itk::Object *, const itk::EventObject &) {}
+
+  protected:
+    AllocationCommand() {}
+
+  private:
+    ImageBufferPool::Pointer m_Pool;
+  };
+
+private:
+  ImageBufferPool(const Self&);  //purposely not implemented
+  void operator=(const Self&);   //purposely not implemented
+
+  typedef std::multimap<size_t, void *> BuffersType;
+
+  mutable itk::SimpleFastMutexLock m_Mutex;
+  BuffersType                      m_Buffers;
+  size_t                           m_MaximumCachedBytes;
+  Statistics                       m_Statistics;
+};
+
+/** \class PooledImageContainer
+ * \brief Pixel container of an itk::Image whose buffer belongs to an
+ * rtk::ImageBufferPool.
+ *
+ * The buffer is imported in the container, which does not manage it, and
+ * it is released to the pool by the destructor.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+template <class TElementIdentifier, class TElement>
+class ITK_EXPORT PooledImageContainer :
+  public itk::ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  /** Standard class typedefs. */
+  typedef PooledImageContainer                                   Self;
+  typedef itk::ImportImageContainer<TElementIdentifier, TElement> Superclass;
+  typedef itk::SmartPointer<Self>                                Pointer;
+  typedef itk::SmartPointer<const Self>                          ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PooledImageContainer, itk::ImportImageContainer);
+
+  /** Import a buffer of size elements of pool */
+  void SetPoolBuffer(ImageBufferPool *pool, const TElementIdentifier size)
+    {
+    ReleasePoolBuffer();
+    m_Bytes = size * sizeof(TElement);
+    m_Buffer = pool->Acquire(m_Bytes);
+    m_Pool = pool;
+    this->SetImportPointer(static_cast<TElement *>(m_Buffer), size, false);
+    }
+
+protected:
+  PooledImageContainer() : m_Buffer(NULL), m_Bytes(0) {}
+  virtual ~PooledImageContainer() { ReleasePoolBuffer(); }
+
+  void ReleasePoolBuffer()
+    {
+    if(m_Buffer)
+      m_Pool->Release(m_Buffer, m_Bytes);
+    m_Buffer = NULL;
+    }
+
+private:
+  PooledImageContainer(const Self&); //purposely not implemented
+  void operator=(const Self&);       //purposely not implemented
+
+  ImageBufferPool::Pointer m_Pool;
+  void                    *m_Buffer;
+  size_t                   m_Bytes;
+};
+
+} // end namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "rtkImageBufferPool.txx"
+#endif
+
+#endif
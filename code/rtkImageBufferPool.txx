@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkImageBufferPool_txx
+#define __rtkImageBufferPool_txx
+
+namespace rtk
+{
+
+template <class TImage>
+void
+ImageBufferPool
+::Allocate(TImage *image)
+{
+  typedef typename TImage::PixelContainer PixelContainerType;
+  typedef PooledImageContainer<typename PixelContainerType::ElementIdentifier,
+                               typename PixelContainerType::Element> PooledContainerType;
+  typename PooledContainerType::Pointer container = PooledContainerType::New();
+  container->SetPoolBuffer(this, image->GetBufferedRegion().GetNumberOfPixels());
+  image->SetPixelContainer(container);
+
+  // Computes the offset table, the container is large enough
+  image->Allocate();
+}
+
+template <class TOutputImage>
+void
+ImageBufferPool
+::Watch(itk::ImageSource<TOutputImage> *filter)
+{
+  if(filter==NULL)
+    return;
+  typename AllocationCommand<TOutputImage>::Pointer command = AllocationCommand<TOutputImage>::New();
+  command->SetPool(this);
+  filter->AddObserver(itk::StartEvent(), command);
+}
+
+template <class TOutputImage>
+void
+ImageBufferPool::AllocationCommand<TOutputImage>
+::Execute(itk::Object *caller, const itk::EventObject &event)
+{
+  if( !itk::StartEvent().CheckEvent(&event) )
+    return;
+
+  // The previous buffer of the output has been released when the output was
+  // prepared for new data. The buffered region is set by the filter, the
+  // allocation then reuses the imported buffer.
+  itk::ImageSource<TOutputImage> *filter = dynamic_cast<itk::ImageSource<TOutputImage> *>(caller);
+  if(filter==NULL)
+    return;
+  TOutputImage *output = filter->GetOutput();
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef PooledImageContainer<typename PixelContainerType::ElementIdentifier,
+                               typename PixelContainerType::Element> PooledContainerType;
+  const size_t size = output->GetRequestedRegion().GetNumberOfPixels();
+  if(size==0)
+    return;
+  typename PooledContainerType::Pointer container = PooledContainerType::New();
+  container->SetPoolBuffer(m_Pool, size);
+  output->SetPixelContainer(container);
+}
+
+} // end namespace rtk
+
+#endif
@@ -20,6 +20,10 @@
 #define __rtkLookupTableImageFilter_h
 
 #include <itkUnaryFunctorImageFilter.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include <map>
+#include <string>
 
 namespace rtk
 {
@@ -44,11 +48,11 @@ public:
   typedef itk::Image<TOutput,1>                LookupTableType;
   typedef typename LookupTableType::PixelType* LookupTableDataPointerType;
 
-  LUT() {};
+  LUT():m_LookupTableDataPointer(NULL) {};
   ~LUT() {};
 
   /** Get/Set the lookup table. */
-  LookupTableDataPointerType GetLookupTableDataPointer() {
+  LookupTableDataPointerType GetLookupTableDataPointer() const {
     return m_LookupTableDataPointer;
   }
   void SetLookupTableDataPointer(LookupTableDataPointerType lut) {
@@ -56,10 +60,10 @@ public:
   }
 
   bool operator!=( const LUT & lut ) const {
-    return m_LookupTableDataPointer != lut->GetLookupTableDataPointer;
+    return m_LookupTableDataPointer != lut.GetLookupTableDataPointer();
   }
   bool operator==( const LUT & lut ) const {
-    return m_LookupTableDataPointer == lut->GetLookupTableDataPointer;
+    return m_LookupTableDataPointer == lut.GetLookupTableDataPointer();
   }
 
   inline TOutput operator()( const TInput & val ) const {
@@ -74,7 +78,14 @@ private:
 /** \class LookupTableImageFilter
  * \brief Converts integer values of an input image using lookup table.
  *
- * The lookup table is passed via a functor of type Functor::LUT
+ * The lookup table is passed via a functor of type Functor::LUT. The same
+ * functor can be used elsewhere, e.g., in the decoding loop of
+ * MemoryMappedProjectionsReader, to avoid an intermediate image.
+ *
+ * Lookup tables which only depend on the format and its parameters should be
+ * built once per process and shared between filters. Subclasses with a fixed
+ * table pass a key and a function filling the table to
+ * GetOrCreateSharedLookupTable() in their constructor.
  *
  * \author Simon Rit
  *
@@ -119,11 +130,40 @@ public:
   /** Get lookup table. */
   itkGetObjectMacro(LookupTable, LookupTableType);
 
+  /** Get the process-wide lookup table registered under key, NULL if none. */
+  static LookupTableType * GetSharedLookupTable(const std::string &key);
+
+  /** Register a process-wide lookup table under key. If another table has
+   * already been registered with the same key, it is kept and returned. */
+  static LookupTableType * SetSharedLookupTable(const std::string &key, LookupTableType *lut);
+
+  /** Function filling a lookup table allocated over the range of the input
+   * pixel type. */
+  typedef void (*LookupTableBuilderType)(LookupTableType *lut);
+
+  /** Get the process-wide lookup table registered under key. If there is
+   * none, a table is allocated over the range of the input pixel type, filled
+   * by builder and registered. */
+  static LookupTableType * GetOrCreateSharedLookupTable(const std::string &key, LookupTableBuilderType builder);
+
 protected:
   LookupTableImageFilter() {}
   virtual ~LookupTableImageFilter() {}
+
+  typedef typename TInputImage::PixelType    InputPixelType;
+  typedef typename TOutputImage::PixelType   OutputPixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  /** Apply the lookup table row by row with raw pointers instead of the
+   * per-pixel functor call of the superclass. */
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId);
+
   typename LookupTableType::Pointer m_LookupTable;
 
+  typedef std::map< std::string, typename LookupTableType::Pointer > SharedLookupTablesType;
+  static SharedLookupTablesType & GetSharedLookupTables();
+  static itk::SimpleFastMutexLock & GetSharedLookupTablesLock();
+
 private:
   LookupTableImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
@@ -132,4 +172,8 @@ private:
 
 } // end namespace rtk
 
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "rtkLookupTableImageFilter.txx"
+#endif
+
 #endif
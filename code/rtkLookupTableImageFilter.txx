@@ -0,0 +1,120 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkLookupTableImageFilter_txx
+#define __rtkLookupTableImageFilter_txx
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkNumericTraits.h>
+
+namespace rtk
+{
+
+template <class TInputImage, class TOutputImage>
+typename LookupTableImageFilter<TInputImage, TOutputImage>::SharedLookupTablesType &
+LookupTableImageFilter<TInputImage, TOutputImage>
+::GetSharedLookupTables()
+{
+  static SharedLookupTablesType tables;
+  return tables;
+}
+
+template <class TInputImage, class TOutputImage>
+itk::SimpleFastMutexLock &
+LookupTableImageFilter<TInputImage, TOutputImage>
+::GetSharedLookupTablesLock()
+{
+  static itk::SimpleFastMutexLock lock;
+  return lock;
+}
+
+template <class TInputImage, class TOutputImage>
+typename LookupTableImageFilter<TInputImage, TOutputImage>::LookupTableType *
+LookupTableImageFilter<TInputImage, TOutputImage>
+::GetSharedLookupTable(const std::string &key)
+{
+  LookupTableType *lut = NULL;
+  GetSharedLookupTablesLock().Lock();
+  typename SharedLookupTablesType::const_iterator it = GetSharedLookupTables().find(key);
+  if( it != GetSharedLookupTables().end() )
+    lut = it->second;
+  GetSharedLookupTablesLock().Unlock();
+  return lut;
+}
+
+template <class TInputImage, class TOutputImage>
+typename LookupTableImageFilter<TInputImage, TOutputImage>::LookupTableType *
+LookupTableImageFilter<TInputImage, TOutputImage>
+::SetSharedLookupTable(const std::string &key, LookupTableType *lut)
+{
+  GetSharedLookupTablesLock().Lock();
+  typename LookupTableType::Pointer &shared = GetSharedLookupTables()[key];
+  if( shared.GetPointer() == NULL )
+    shared = lut;
+  lut = shared;
+  GetSharedLookupTablesLock().Unlock();
+  return lut;
+}
+
+template <class TInputImage, class TOutputImage>
+typename LookupTableImageFilter<TInputImage, TOutputImage>::LookupTableType *
+LookupTableImageFilter<TInputImage, TOutputImage>
+::GetOrCreateSharedLookupTable(const std::string &key, LookupTableBuilderType builder)
+{
+  LookupTableType *shared = GetSharedLookupTable(key);
+  if( shared != NULL )
+    return shared;
+
+  typename LookupTableType::Pointer lut = LookupTableType::New();
+  typename LookupTableType::SizeType size;
+  size[0] = itk::NumericTraits<InputPixelType>::max() -
+            itk::NumericTraits<InputPixelType>::min() + 1;
+  lut->SetRegions( size );
+  lut->Allocate();
+  builder( lut );
+
+  // Another thread may have registered its table in the meantime
+  return SetSharedLookupTable(key, lut);
+}
+
+template <class TInputImage, class TOutputImage>
+void
+LookupTableImageFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
+{
+  const TInputImage *input = this->GetInput();
+  TOutputImage *output = this->GetOutput();
+  const OutputPixelType *lut = m_LookupTable->GetBufferPointer();
+
+  // Iterate over the first pixel of each row
+  OutputImageRegionType rows = outputRegionForThread;
+  rows.SetSize(0, 1);
+  const unsigned int n = outputRegionForThread.GetSize(0);
+  itk::ImageRegionConstIteratorWithIndex<TOutputImage> itRows(output, rows);
+  for(itRows.GoToBegin(); !itRows.IsAtEnd(); ++itRows)
+    {
+    const InputPixelType *in  = input->GetBufferPointer() + input->ComputeOffset( itRows.GetIndex() );
+    OutputPixelType      *out = output->GetBufferPointer() + output->ComputeOffset( itRows.GetIndex() );
+    for(unsigned int i=0; i<n; i++)
+      out[i] = lut[ in[i] ];
+    }
+}
+
+} // end namespace rtk
+
+#endif
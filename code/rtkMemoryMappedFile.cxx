@@ -0,0 +1,91 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkMemoryMappedFile.h"
+
+#if defined(_WIN32) || defined(WIN32)
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+rtk::MemoryMappedFile::MemoryMappedFile(const std::string &fileName):
+  m_FileName(fileName),
+  m_Data(NULL),
+  m_Size(0)
+{
+#if defined(_WIN32) || defined(WIN32)
+  m_MappingHandle = NULL;
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if(file == INVALID_HANDLE_VALUE)
+    return;
+
+  LARGE_INTEGER size;
+  if(GetFileSizeEx(file, &size) && size.QuadPart>0)
+    {
+    m_MappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if(m_MappingHandle != NULL)
+      {
+      m_Data = static_cast<const char *>( MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0) );
+      if(m_Data == NULL)
+        {
+        CloseHandle(m_MappingHandle);
+        m_MappingHandle = NULL;
+        }
+      else
+        m_Size = static_cast<size_t>(size.QuadPart);
+      }
+    }
+  CloseHandle(file);
+#else
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if(fd<0)
+    return;
+
+  struct stat st;
+  if(fstat(fd, &st)==0 && st.st_size>0)
+    {
+    void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(data != MAP_FAILED)
+      {
+      m_Data = static_cast<const char *>(data);
+      m_Size = st.st_size;
+#  ifdef MADV_SEQUENTIAL
+      madvise(data, m_Size, MADV_SEQUENTIAL);
+#  endif
+      }
+    }
+  close(fd);
+#endif
+}
+
+rtk::MemoryMappedFile::~MemoryMappedFile()
+{
+  if(m_Data == NULL)
+    return;
+#if defined(_WIN32) || defined(WIN32)
+  UnmapViewOfFile(m_Data);
+  CloseHandle(m_MappingHandle);
+#else
+  munmap(const_cast<char *>(m_Data), m_Size);
+#endif
+}
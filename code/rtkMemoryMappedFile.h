@@ -0,0 +1,72 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkMemoryMappedFile_h
+#define __rtkMemoryMappedFile_h
+
+#include <string>
+#include <cstddef>
+
+namespace rtk
+{
+
+/** \class MemoryMappedFile
+ *
+ * Read-only mapping of a whole file in memory. The file is mapped in the
+ * constructor and unmapped in the destructor. The file descriptor is closed
+ * as soon as the mapping exists so that many files can be mapped at once,
+ * e.g. one per projection. The kernel is advised that the content is read
+ * sequentially so that read-ahead is aggressive and pages are dropped soon
+ * after use.
+ *
+ * \author Simon Rit
+ */
+class MemoryMappedFile
+{
+public:
+  /** Constructor maps the file. Check is_open() for success. */
+  MemoryMappedFile(const std::string &fileName);
+  ~MemoryMappedFile();
+
+  /** Return mapping status */
+  bool is_open() const { return m_Data != NULL; }
+
+  /** Pointer to the first byte of the file */
+  const char *GetPointer() const { return m_Data; }
+
+  /** Size of the file in bytes */
+  size_t GetSize() const { return m_Size; }
+
+  /** Name of the mapped file */
+  const std::string &GetFileName() const { return m_FileName; }
+
+private:
+  MemoryMappedFile(const MemoryMappedFile&); //purposely not implemented
+  void operator=(const MemoryMappedFile&);   //purposely not implemented
+
+  std::string m_FileName;
+  const char *m_Data;
+  size_t      m_Size;
+#if defined(_WIN32) || defined(WIN32)
+  void       *m_MappingHandle;
+#endif
+};
+
+} // end namespace rtk
+
+#endif
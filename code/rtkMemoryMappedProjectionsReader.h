@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkMemoryMappedProjectionsReader_h
+#define __rtkMemoryMappedProjectionsReader_h
+
+// ITK
+#include <itkImageSource.h>
+#include <itkCastImageFilter.h>
+
+// Standard lib
+#include <vector>
+#include <string>
+
+#include "rtkMemoryMappedFile.h"
+
+namespace rtk
+{
+
+/** \class MemoryMappedProjectionsReader
+ *
+ * Reads a series of projection files of a fixed-layout raw format, i.e., a
+ * format where the pixel values are stored contiguously after a header, and
+ * stacks them in a single image. Each file is mapped in memory and a single
+ * pass skips the header, swaps the bytes if required, converts the raw values
+ * with TFunctor and writes the result straight into the output stack. This
+ * avoids the intermediate per-file buffer and the copy of itk::ImageSeriesReader.
+ *
+ * TImageIO must provide GetRawFileName() and GetRawDataOffset() after
+ * ReadImageInformation(), see HisImageIO, XRadImageIO and ImagXImageIO. Each
+ * raw value is first converted to TRawPixel and then passed to the functor.
+ * Files may contain one or several projections but they must all have the
+ * same size. The projections are processed in parallel. All scalar integer
+ * and floating point component types are converted, an exception is thrown
+ * for other types.
+ *
+ * \see ProjectionsReader
+ *
+ * \author Simon Rit
+ *
+ * \ingroup ImageSource
+ */
+template <class TOutputImage,
+          class TImageIO,
+          class TRawPixel=typename TOutputImage::PixelType,
+          class TFunctor=itk::Functor::Cast<TRawPixel, typename TOutputImage::PixelType> >
+class ITK_EXPORT MemoryMappedProjectionsReader : public itk::ImageSource<TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedProjectionsReader  Self;
+  typedef itk::ImageSource<TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>        Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedProjectionsReader, itk::ImageSource);
+
+  /** Some convenient typedefs. */
+  typedef TOutputImage                         OutputImageType;
+  typedef typename OutputImageType::Pointer    OutputImagePointer;
+  typedef typename OutputImageType::RegionType OutputImageRegionType;
+  typedef typename OutputImageType::PixelType  OutputImagePixelType;
+  typedef TImageIO                             ImageIOType;
+  typedef typename ImageIOType::Pointer        ImageIOPointer;
+  typedef TFunctor                             FunctorType;
+
+  typedef  std::vector<std::string> FileNamesContainer;
+
+  /** ImageDimension constant */
+  itkStaticConstMacro(OutputImageDimension, unsigned int,
+                      TOutputImage::ImageDimension);
+
+  /** Set the vector of strings that contains the file names. Files
+   * are processed in sequential order. */
+  void SetFileNames (const FileNamesContainer &name)
+    {
+    if ( m_FileNames != name)
+      {
+      m_FileNames = name;
+      this->Modified();
+      }
+    }
+  const FileNamesContainer & GetFileNames() const
+    {
+    return m_FileNames;
+    }
+
+  /** Set/Get the ImageIO used to read the headers of the files. */
+  itkSetObjectMacro(ImageIO, ImageIOType);
+  itkGetObjectMacro(ImageIO, ImageIOType);
+
+  /** Get the functor object. The functor is returned by reference. It must
+   * be modified before the filter is updated. */
+  FunctorType &       GetFunctor()       { return m_Functor; }
+  const FunctorType & GetFunctor() const { return m_Functor; }
+
+  /** Set the functor object. */
+  void SetFunctor(const FunctorType & functor)
+    {
+    m_Functor = functor;
+    this->Modified();
+    }
+
+protected:
+  MemoryMappedProjectionsReader():m_NumberOfProjectionsPerFile(1) {};
+  ~MemoryMappedProjectionsReader() { this->ReleaseMappedFiles(); }
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Read the header of the first file to set the output information. */
+  virtual void GenerateOutputInformation(void);
+
+  /** Read the headers and map the files required by the requested region. */
+  virtual void BeforeThreadedGenerateData();
+
+  /** Convert the mapped data of the projections of the thread region. */
+  virtual void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType threadId);
+
+  /** Unmap the files. */
+  virtual void AfterThreadedGenerateData();
+
+  /** Convert n raw values of type TComponent pointed by src. */
+  template<class TComponent>
+  void ConvertRaw(const char *src, OutputImagePixelType *dst, const unsigned int n, const bool swap) const;
+
+  void ReleaseMappedFiles();
+
+  /** A list of filenames to be processed. */
+  FileNamesContainer m_FileNames;
+
+private:
+  MemoryMappedProjectionsReader(const Self&); //purposely not implemented
+  void operator=(const Self&);                //purposely not implemented
+
+  ImageIOPointer m_ImageIO;
+  FunctorType    m_Functor;
+  unsigned int   m_NumberOfProjectionsPerFile;
+
+  /** Per file information, only valid between BeforeThreadedGenerateData
+   * and AfterThreadedGenerateData for the files of the requested region. */
+  std::vector<MemoryMappedFile *>                m_MappedFiles;
+  std::vector<size_t>                            m_RawDataOffsets;
+  std::vector<itk::ImageIOBase::IOComponentType> m_ComponentTypes;
+  std::vector<bool>                              m_SwapBytes;
+};
+
+} //namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "rtkMemoryMappedProjectionsReader.txx"
+#endif
+
+#endif // __rtkMemoryMappedProjectionsReader_h
@@ -0,0 +1,302 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkMemoryMappedProjectionsReader_txx
+#define __rtkMemoryMappedProjectionsReader_txx
+
+#include <itkByteSwapper.h>
+#include <algorithm>
+#include <cstring>
+
+namespace rtk
+{
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of files: " << m_FileNames.size() << std::endl;
+  os << indent << "Number of projections per file: " << m_NumberOfProjectionsPerFile << std::endl;
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::GenerateOutputInformation(void)
+{
+  if(m_FileNames.size() == 0)
+    return;
+  if(m_ImageIO.GetPointer() == NULL)
+    m_ImageIO = ImageIOType::New();
+
+  m_ImageIO->SetFileName( m_FileNames[0].c_str() );
+  m_ImageIO->ReadImageInformation();
+
+  const unsigned int nDimIO = m_ImageIO->GetNumberOfDimensions();
+  if(nDimIO > OutputImageDimension)
+    itkExceptionMacro(<< "Cannot stack " << nDimIO << "D files in a "
+                      << OutputImageDimension << "D image");
+
+  // Stacking is along the last dimension
+  const unsigned int last = OutputImageDimension-1;
+  m_NumberOfProjectionsPerFile = (nDimIO==OutputImageDimension)?m_ImageIO->GetDimensions(last):1;
+
+  typename OutputImageType::SpacingType   spacing;
+  typename OutputImageType::PointType     origin;
+  typename OutputImageType::DirectionType direction;
+  typename OutputImageType::SizeType      size;
+  spacing.Fill(1.);
+  origin.Fill(0.);
+  direction.SetIdentity();
+  size.Fill(1);
+  for(unsigned int i=0; i<nDimIO; i++)
+    {
+    spacing[i] = m_ImageIO->GetSpacing(i);
+    origin[i] = m_ImageIO->GetOrigin(i);
+    size[i] = m_ImageIO->GetDimensions(i);
+    for(unsigned int j=0; j<nDimIO; j++)
+      direction[j][i] = m_ImageIO->GetDirection(i)[j];
+    }
+  size[last] = m_NumberOfProjectionsPerFile * m_FileNames.size();
+
+  OutputImageRegionType largest;
+  largest.SetSize(size);
+
+  TOutputImage * output = this->GetOutput();
+  output->SetSpacing(spacing);
+  output->SetOrigin(origin);
+  output->SetDirection(direction);
+  output->SetLargestPossibleRegion(largest);
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::BeforeThreadedGenerateData()
+{
+  this->ReleaseMappedFiles();
+
+  const unsigned int last = OutputImageDimension-1;
+  const OutputImageRegionType region = this->GetOutput()->GetRequestedRegion();
+  const unsigned int firstFile = region.GetIndex(last) / m_NumberOfProjectionsPerFile;
+  const unsigned int lastFile = (region.GetIndex(last) + region.GetSize(last) - 1) / m_NumberOfProjectionsPerFile;
+
+  const typename OutputImageType::SizeType size = this->GetOutput()->GetLargestPossibleRegion().GetSize();
+  size_t nPixelsPerProjection = 1;
+  for(unsigned int i=0; i<last; i++)
+    nPixelsPerProjection *= size[i];
+
+  m_MappedFiles.resize(m_FileNames.size(), NULL);
+  m_RawDataOffsets.resize(m_FileNames.size(), 0);
+  m_ComponentTypes.resize(m_FileNames.size(), itk::ImageIOBase::UNKNOWNCOMPONENTTYPE);
+  m_SwapBytes.resize(m_FileNames.size(), false);
+  for(unsigned int f=firstFile; f<=lastFile; f++)
+    {
+    m_ImageIO->SetFileName( m_FileNames[f].c_str() );
+    m_ImageIO->ReadImageInformation();
+    for(unsigned int i=0; i<m_ImageIO->GetNumberOfDimensions() && i<OutputImageDimension; i++)
+      {
+      const unsigned int expected = (i==last)?m_NumberOfProjectionsPerFile:size[i];
+      if(m_ImageIO->GetDimensions(i) != expected)
+        itkExceptionMacro(<< "Size of " << m_FileNames[f]
+                          << " differs from size of " << m_FileNames[0]);
+      }
+
+    m_MappedFiles[f] = new MemoryMappedFile( m_ImageIO->GetRawFileName() );
+    if( !m_MappedFiles[f]->is_open() )
+      {
+      this->ReleaseMappedFiles();
+      itkExceptionMacro(<< "Could not map file " << m_ImageIO->GetRawFileName() );
+      }
+
+    m_RawDataOffsets[f] = m_ImageIO->GetRawDataOffset();
+    m_ComponentTypes[f] = m_ImageIO->GetComponentType();
+    // LONG and ULONG are not supported: their size on disk depends on the
+    // image IO (4 bytes for ImagX and XRad) while GetComponentSize returns
+    // sizeof(long), which is 8 bytes on LP64 systems.
+    switch(m_ComponentTypes[f])
+      {
+      case itk::ImageIOBase::UCHAR:
+      case itk::ImageIOBase::CHAR:
+      case itk::ImageIOBase::USHORT:
+      case itk::ImageIOBase::SHORT:
+      case itk::ImageIOBase::UINT:
+      case itk::ImageIOBase::INT:
+      case itk::ImageIOBase::FLOAT:
+      case itk::ImageIOBase::DOUBLE:
+        break;
+      default:
+        {
+        const std::string componentType = m_ImageIO->GetComponentTypeAsString(m_ComponentTypes[f]);
+        this->ReleaseMappedFiles();
+        itkExceptionMacro(<< "Unsupported pixel component type " << componentType
+                          << " in " << m_FileNames[f]);
+        }
+      }
+    const size_t nBytes = m_RawDataOffsets[f] +
+                          m_NumberOfProjectionsPerFile * nPixelsPerProjection * m_ImageIO->GetComponentSize();
+    if( m_MappedFiles[f]->GetSize() < nBytes )
+      {
+      const size_t fileSize = m_MappedFiles[f]->GetSize();
+      this->ReleaseMappedFiles();
+      itkExceptionMacro(<< "Read failed: Wanted " << nBytes
+                        << " bytes in " << m_ImageIO->GetRawFileName()
+                        << " but the file contains " << fileSize << " bytes.");
+      }
+
+    const bool systemIsBigEndian = itk::ByteSwapper<char>::SystemIsBigEndian();
+    m_SwapBytes[f] = ( systemIsBigEndian && m_ImageIO->GetByteOrder()==itk::ImageIOBase::LittleEndian) ||
+                     (!systemIsBigEndian && m_ImageIO->GetByteOrder()==itk::ImageIOBase::BigEndian);
+    }
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
+{
+  const unsigned int last = OutputImageDimension-1;
+  const typename OutputImageType::SizeType size = this->GetOutput()->GetLargestPossibleRegion().GetSize();
+  size_t nPixelsPerProjection = 1;
+  for(unsigned int i=0; i<last; i++)
+    nPixelsPerProjection *= size[i];
+
+  // Each projection of the region is a set of rows of contiguous pixels in
+  // both the raw file and the output buffer
+  OutputImageRegionType rows = outputRegionForThread;
+  rows.SetSize(0, 1);
+  rows.SetSize(last, 1);
+  const unsigned int nRowsPerProjection = rows.GetNumberOfPixels();
+  const unsigned int rowLength = outputRegionForThread.GetSize(0);
+
+  typename OutputImageType::IndexType index = outputRegionForThread.GetIndex();
+  for(int k = outputRegionForThread.GetIndex(last);
+          k < outputRegionForThread.GetIndex(last) + (int)outputRegionForThread.GetSize(last);
+          k++)
+    {
+    const unsigned int f = k / m_NumberOfProjectionsPerFile;
+    const char *proj = m_MappedFiles[f]->GetPointer() + m_RawDataOffsets[f];
+    const size_t projOffset = (k % m_NumberOfProjectionsPerFile) * nPixelsPerProjection;
+
+    index[last] = k;
+    for(unsigned int r=0; r<nRowsPerProjection; r++)
+      {
+      // Index of the first pixel of the row
+      unsigned int rr = r;
+      for(unsigned int i=1; i<last; i++)
+        {
+        index[i] = outputRegionForThread.GetIndex(i) + rr % outputRegionForThread.GetSize(i);
+        rr /= outputRegionForThread.GetSize(i);
+        }
+      OutputImagePixelType *dst = this->GetOutput()->GetBufferPointer() +
+                                  this->GetOutput()->ComputeOffset(index);
+      size_t pixelOffset = index[0];
+      size_t stride = 1;
+      for(unsigned int i=1; i<last; i++)
+        {
+        stride *= size[i-1];
+        pixelOffset += index[i] * stride;
+        }
+      pixelOffset += projOffset;
+
+      switch(m_ComponentTypes[f])
+        {
+        case itk::ImageIOBase::UCHAR:
+          ConvertRaw<unsigned char>(proj + pixelOffset*sizeof(unsigned char), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::CHAR:
+          ConvertRaw<char>(proj + pixelOffset*sizeof(char), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::USHORT:
+          ConvertRaw<unsigned short>(proj + pixelOffset*sizeof(unsigned short), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::SHORT:
+          ConvertRaw<short>(proj + pixelOffset*sizeof(short), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::UINT:
+          ConvertRaw<unsigned int>(proj + pixelOffset*sizeof(unsigned int), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::INT:
+          ConvertRaw<int>(proj + pixelOffset*sizeof(int), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::FLOAT:
+          ConvertRaw<float>(proj + pixelOffset*sizeof(float), dst, rowLength, m_SwapBytes[f]);
+          break;
+        case itk::ImageIOBase::DOUBLE:
+          ConvertRaw<double>(proj + pixelOffset*sizeof(double), dst, rowLength, m_SwapBytes[f]);
+          break;
+        default:
+          // Rejected by BeforeThreadedGenerateData
+          break;
+        }
+      }
+    }
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+template <class TComponent>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::ConvertRaw(const char *src, OutputImagePixelType *dst, const unsigned int n, const bool swap) const
+{
+  // The raw data are not necessarily aligned on sizeof(TComponent), hence
+  // the memcpy which the compiler turns into a plain load
+  TComponent v;
+  if(swap)
+    {
+    for(unsigned int i=0; i<n; i++, src+=sizeof(TComponent))
+      {
+      char *b = reinterpret_cast<char *>(&v);
+      std::reverse_copy(src, src+sizeof(TComponent), b);
+      dst[i] = m_Functor( static_cast<TRawPixel>(v) );
+      }
+    }
+  else
+    {
+    for(unsigned int i=0; i<n; i++, src+=sizeof(TComponent))
+      {
+      std::memcpy(&v, src, sizeof(TComponent));
+      dst[i] = m_Functor( static_cast<TRawPixel>(v) );
+      }
+    }
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::AfterThreadedGenerateData()
+{
+  this->ReleaseMappedFiles();
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage, class TImageIO, class TRawPixel, class TFunctor>
+void MemoryMappedProjectionsReader<TOutputImage, TImageIO, TRawPixel, TFunctor>
+::ReleaseMappedFiles()
+{
+  for(unsigned int f=0; f<m_MappedFiles.size(); f++)
+    delete m_MappedFiles[f];
+  m_MappedFiles.clear();
+}
+
+} //namespace rtk
+
+#endif
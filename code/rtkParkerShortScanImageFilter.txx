@@ -31,7 +31,7 @@ ParkerShortScanImageFilter<TInputImage, TOutputImage>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
 {
   // Get angular gaps and max gap
-  std::vector<double> angularGaps = m_Geometry->GetAngularGapsWithNext();
+  const std::vector<double> &angularGaps = m_Geometry->GetAngularGapsWithNext();
   int                 nProj = angularGaps.size();
   int                 maxAngularGapPos = 0;
   for(int iProj=1; iProj<nProj; iProj++)
@@ -79,8 +79,8 @@ ParkerShortScanImageFilter<TInputImage, TOutputImage>
   weights->Allocate();
   typename itk::ImageRegionIteratorWithIndex<WeightImageType> itWeights(weights, weights->GetLargestPossibleRegion() );
 
-  const std::vector<double> rotationAngles = m_Geometry->GetGantryAngles();
-  const std::multimap<double,unsigned int> sortedAngles = m_Geometry->GetSortedAngles();
+  const std::vector<double> &rotationAngles = m_Geometry->GetGantryAngles();
+  const std::multimap<double,unsigned int> &sortedAngles = m_Geometry->GetSortedAngles();
   const double detectorWidth = this->GetInput()->GetSpacing()[0] *
                                this->GetInput()->GetLargestPossibleRegion().GetSize()[0];
 
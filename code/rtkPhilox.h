@@ -0,0 +1,124 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkPhilox_h
+#define __rtkPhilox_h
+
+#if defined (_MSC_VER) && (_MSC_VER < 1600)
+typedef unsigned int       uint32_t;
+typedef unsigned __int64   uint64_t;
+#else
+#include <stdint.h>
+#endif
+
+namespace rtk
+{
+
+/** \class Philox4x32
+ * \brief Counter-based pseudo-random number generator Philox4x32-10.
+ *
+ * The generator of [Salmon et al, SC11, 2011] is a keyed bijection of a 128
+ * bits counter: the random numbers of a given counter only depend on the
+ * counter and the key. Using the key as seed and e.g. the pixel index as
+ * counter, each pixel has its own random stream which does not depend on the
+ * order in which the pixels are processed, hence on the number of threads or
+ * on the splitting of the image in regions. The generator only uses integer
+ * operations and has no state so a loop over pixels can be vectorized.
+ *
+ * \author Simon Rit
+ */
+class Philox4x32
+{
+public:
+  /** Four 32 bits random numbers of a counter and a key */
+  static inline void Generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+    {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+    for(unsigned int r=0; r<10; r++)
+      {
+      const uint64_t p0 = uint64_t(0xD2511F53u) * c0;
+      const uint64_t p1 = uint64_t(0xCD9E8D57u) * c2;
+      const uint32_t n0 = uint32_t(p1 >> 32) ^ c1 ^ k0;
+      const uint32_t n2 = uint32_t(p0 >> 32) ^ c3 ^ k1;
+      c1 = uint32_t(p1);
+      c3 = uint32_t(p0);
+      c0 = n0;
+      c2 = n2;
+      k0 += 0x9E3779B9u;
+      k1 += 0xBB67AE85u;
+      }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+    }
+
+  /** Uniform double in ]0,1] from 32 random bits. 0 is excluded so that the
+   * result can be passed to a logarithm. */
+  static inline double ToUniform(const uint32_t x)
+    {
+    return (double(x) + 1.) * (1./4294967296.);
+    }
+};
+
+/** \class Philox4x32Stream
+ * \brief Sequence of uniform random numbers of one counter of Philox4x32.
+ *
+ * The first two words of the counter identify the stream, e.g. a pixel, the
+ * third word is incremented every four numbers and the last word can be used
+ * to separate independent usages of the same key and identifier.
+ *
+ * \author Simon Rit
+ */
+class Philox4x32Stream
+{
+public:
+  Philox4x32Stream(const uint32_t key[2], const uint64_t id, const uint32_t usage=0):
+    m_Next(4)
+    {
+    m_Key[0] = key[0];
+    m_Key[1] = key[1];
+    m_Counter[0] = uint32_t(id);
+    m_Counter[1] = uint32_t(id >> 32);
+    m_Counter[2] = 0;
+    m_Counter[3] = usage;
+    }
+
+  /** Next uniform double in ]0,1] */
+  inline double GetUniform()
+    {
+    if(m_Next == 4)
+      {
+      Philox4x32::Generate(m_Counter, m_Key, m_Bits);
+      m_Counter[2]++;
+      m_Next = 0;
+      }
+    return Philox4x32::ToUniform(m_Bits[m_Next++]);
+    }
+
+private:
+  uint32_t     m_Key[2];
+  uint32_t     m_Counter[4];
+  uint32_t     m_Bits[4];
+  unsigned int m_Next;
+};
+
+} // end namespace rtk
+
+#endif
@@ -79,6 +79,12 @@ protected:
     this->Modified();
   }
 
+  /** Direct access to the projection matrices for subclasses which modify
+   * many matrices at once. They are responsible for calling Modified(). */
+  std::vector<MatrixType> &GetModifiableMatrices(){
+    return this->m_Matrices;
+  }
+
 private:
   ProjectionGeometry(const Self&); //purposely not implemented
   void operator=(const Self&);     //purposely not implemented
@@ -0,0 +1,282 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkProjectionsCacheImageIO.h"
+#include "rtkMemoryMappedFile.h"
+#include "rtkHalf.h"
+
+#include <itkMetaDataObject.h>
+#include <itksys/SystemTools.hxx>
+
+#include <fstream>
+#include <vector>
+#include <cstring>
+
+namespace
+{
+// On-disk header, stored in the first HeaderSize bytes of the file
+const size_t   HeaderSize = 256;
+const char     Magic[8] = {'R','T','K','P','R','O','J','\0'};
+const uint32_t Version = 1;
+const uint32_t ByteOrderMark = 0x01020304;
+const char    *GeometryKey = "rtkGeometryXML";
+
+struct ProjectionsCacheHeader
+{
+  char     Magic[8];
+  uint32_t Version;
+  uint32_t ByteOrderMark;
+  uint32_t HalfPrecision;
+  uint32_t NumberOfDimensions;
+  uint32_t Dimensions[3];
+  uint32_t RowPitch;
+  uint64_t DataOffset;
+  uint64_t GeometryLength;
+  double   Spacing[3];
+  double   Origin[3];
+  double   Direction[9];
+};
+}
+
+//--------------------------------------------------------------------
+rtk::ProjectionsCacheImageIO::ProjectionsCacheImageIO():
+  Superclass(),
+  m_UseHalfPrecision(false),
+  m_RowPitch(0),
+  m_DataOffset(0)
+{
+}
+
+//--------------------------------------------------------------------
+void rtk::ProjectionsCacheImageIO::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "UseHalfPrecision: " << m_UseHalfPrecision << std::endl;
+  os << indent << "RowPitch: " << m_RowPitch << std::endl;
+  os << indent << "DataOffset: " << m_DataOffset << std::endl;
+}
+
+//--------------------------------------------------------------------
+void rtk::ProjectionsCacheImageIO::ComputeLayout()
+{
+  const size_t storedComponentSize = (m_UseHalfPrecision)?sizeof(uint16_t):sizeof(float);
+  m_RowPitch = GetDimensions(0) * storedComponentSize;
+  m_RowPitch = ((m_RowPitch + RowAlignment - 1) / RowAlignment) * RowAlignment;
+  m_DataOffset = HeaderSize + m_GeometryXML.size();
+  m_DataOffset = ((m_DataOffset + DataAlignment - 1) / DataAlignment) * DataAlignment;
+}
+
+//--------------------------------------------------------------------
+// Read Image Information
+void rtk::ProjectionsCacheImageIO::ReadImageInformation()
+{
+  std::ifstream is(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if(!is.is_open())
+    itkExceptionMacro(<<"Could not open file " << m_FileName);
+
+  ProjectionsCacheHeader header;
+  is.read( (char *)&header, sizeof(header) );
+  if( is.gcount() != sizeof(header) || std::memcmp(header.Magic, Magic, sizeof(Magic)) )
+    itkExceptionMacro(<<"File " << m_FileName << " is not a projections cache");
+  if( header.Version != Version )
+    itkExceptionMacro(<<"Unsupported version " << header.Version << " of projections cache " << m_FileName);
+  if( header.ByteOrderMark != ByteOrderMark )
+    itkExceptionMacro(<<"Projections cache " << m_FileName << " was written with a different byte order");
+
+  SetNumberOfDimensions(header.NumberOfDimensions);
+  for(unsigned int i=0; i<header.NumberOfDimensions; i++)
+    {
+    SetDimensions(i, header.Dimensions[i]);
+    SetSpacing(i, header.Spacing[i]);
+    SetOrigin(i, header.Origin[i]);
+    std::vector<double> direction(header.NumberOfDimensions);
+    for(unsigned int j=0; j<header.NumberOfDimensions; j++)
+      direction[j] = header.Direction[i*3+j];
+    SetDirection(i, direction);
+    }
+  SetPixelType(itk::ImageIOBase::SCALAR);
+  SetComponentType(itk::ImageIOBase::FLOAT);
+
+  m_UseHalfPrecision = (header.HalfPrecision != 0);
+  m_RowPitch = header.RowPitch;
+  m_DataOffset = header.DataOffset;
+
+  m_GeometryXML.resize(header.GeometryLength);
+  if(header.GeometryLength)
+    {
+    is.seekg(HeaderSize);
+    is.read(&(m_GeometryXML[0]), header.GeometryLength);
+    itk::EncapsulateMetaData<std::string>(this->GetMetaDataDictionary(), GeometryKey, m_GeometryXML);
+    }
+}
+
+//--------------------------------------------------------------------
+bool rtk::ProjectionsCacheImageIO::CanReadFile(const char* FileNameToRead)
+{
+  std::ifstream is(FileNameToRead, std::ios::in | std::ios::binary);
+  if(!is.is_open())
+    return false;
+
+  char magic[sizeof(Magic)];
+  is.read(magic, sizeof(Magic));
+  return is.gcount() == sizeof(Magic) && !std::memcmp(magic, Magic, sizeof(Magic));
+}
+
+//--------------------------------------------------------------------
+// Read Image Content
+void rtk::ProjectionsCacheImageIO::Read(void * buffer)
+{
+  MemoryMappedFile file(m_FileName);
+  if(!file.is_open())
+    itkExceptionMacro(<<"Could not map file " << m_FileName);
+
+  // Only the rows of the requested region are read. The requested region is
+  // padded with dimensions of size 1 for 2D images.
+  size_t start[3] = {0, 0, 0};
+  size_t size[3] = {1, 1, 1};
+  for(unsigned int i=0; i<m_IORegion.GetImageDimension() && i<3; i++)
+    {
+    start[i] = m_IORegion.GetIndex(i);
+    size[i] = m_IORegion.GetSize(i);
+    }
+  const size_t nRows = GetNumberOfDimensions()>1 ? GetDimensions(1) : 1;
+  const size_t lastRow = (start[2]+size[2]-1)*nRows + start[1]+size[1]-1;
+  if( file.GetSize() < m_DataOffset + (lastRow+1)*m_RowPitch )
+    itkExceptionMacro(<<"Read failed: projections cache " << m_FileName << " is truncated");
+
+  float *out = static_cast<float *>(buffer);
+  for(size_t k=start[2]; k<start[2]+size[2]; k++)
+    for(size_t j=start[1]; j<start[1]+size[1]; j++, out+=size[0])
+      {
+      const char *row = file.GetPointer() + m_DataOffset + (k*nRows+j) * m_RowPitch;
+      if(m_UseHalfPrecision)
+        HalfToFloatRow(reinterpret_cast<const uint16_t *>(row) + start[0], out, size[0]);
+      else
+        std::memcpy(out, reinterpret_cast<const float *>(row) + start[0], size[0]*sizeof(float));
+      }
+}
+
+//--------------------------------------------------------------------
+// Write Image Information
+void rtk::ProjectionsCacheImageIO::WriteImageInformation()
+{
+  if(GetNumberOfDimensions()>3)
+    itkExceptionMacro(<<"Projections cache only supports up to 3D images");
+  if(GetComponentType() != itk::ImageIOBase::FLOAT || GetNumberOfComponents() != 1)
+    itkExceptionMacro(<<"Projections cache only supports scalar float images");
+
+  if(m_GeometryXML.empty())
+    itk::ExposeMetaData<std::string>(this->GetMetaDataDictionary(), GeometryKey, m_GeometryXML);
+  ComputeLayout();
+
+  ProjectionsCacheHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.Magic, Magic, sizeof(Magic));
+  header.Version = Version;
+  header.ByteOrderMark = ByteOrderMark;
+  header.HalfPrecision = m_UseHalfPrecision;
+  header.NumberOfDimensions = GetNumberOfDimensions();
+  for(unsigned int i=0; i<3; i++)
+    {
+    header.Dimensions[i] = 1;
+    header.Spacing[i] = 1.;
+    header.Direction[i*3+i] = 1.;
+    }
+  for(unsigned int i=0; i<GetNumberOfDimensions(); i++)
+    {
+    header.Dimensions[i] = GetDimensions(i);
+    header.Spacing[i] = GetSpacing(i);
+    header.Origin[i] = GetOrigin(i);
+    for(unsigned int j=0; j<GetNumberOfDimensions(); j++)
+      header.Direction[i*3+j] = GetDirection(i)[j];
+    }
+  header.RowPitch = m_RowPitch;
+  header.DataOffset = m_DataOffset;
+  header.GeometryLength = m_GeometryXML.size();
+
+  std::ofstream os(m_FileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if(!os.is_open())
+    itkExceptionMacro(<<"Could not open file " << m_FileName << " for writing");
+
+  std::vector<char> block(HeaderSize, 0);
+  std::memcpy(&(block[0]), &header, sizeof(header));
+  os.write(&(block[0]), HeaderSize);
+  os.write(m_GeometryXML.c_str(), m_GeometryXML.size());
+
+  // Allocate the whole file so that the streamed pieces can be written in
+  // place. The row padding is left to zero.
+  const size_t fileSize = m_DataOffset + header.Dimensions[1] * header.Dimensions[2] * m_RowPitch;
+  os.seekp(fileSize-1);
+  os.put('\0');
+  if(os.fail())
+    itkExceptionMacro(<<"Could not write header of " << m_FileName);
+}
+
+//--------------------------------------------------------------------
+bool rtk::ProjectionsCacheImageIO::CanWriteFile(const char* FileNameToWrite)
+{
+  return itksys::SystemTools::GetFilenameLastExtension(FileNameToWrite) == std::string(".rtkproj");
+}
+
+//--------------------------------------------------------------------
+// Write Image
+void rtk::ProjectionsCacheImageIO::Write(const void * buffer)
+{
+  // The first streamed piece creates the file
+  bool firstPiece = true;
+  for(unsigned int i=0; i<m_IORegion.GetImageDimension(); i++)
+    firstPiece &= (m_IORegion.GetIndex(i)==0);
+  if(firstPiece)
+    WriteImageInformation();
+  else
+    ComputeLayout();
+
+  std::fstream os(m_FileName.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+  if(!os.is_open())
+    itkExceptionMacro(<<"Could not open file " << m_FileName << " for writing");
+
+  size_t start[3] = {0, 0, 0};
+  size_t size[3] = {1, 1, 1};
+  for(unsigned int i=0; i<m_IORegion.GetImageDimension() && i<3; i++)
+    {
+    start[i] = m_IORegion.GetIndex(i);
+    size[i] = m_IORegion.GetSize(i);
+    }
+  const size_t nRows = GetNumberOfDimensions()>1 ? GetDimensions(1) : 1;
+
+  const float *in = static_cast<const float *>(buffer);
+  std::vector<uint16_t> halfRow(size[0]);
+  for(size_t k=start[2]; k<start[2]+size[2]; k++)
+    for(size_t j=start[1]; j<start[1]+size[1]; j++, in+=size[0])
+      {
+      const size_t rowOffset = m_DataOffset + (k*nRows+j) * m_RowPitch;
+      if(m_UseHalfPrecision)
+        {
+        FloatToHalfRow(in, &(halfRow[0]), size[0]);
+        os.seekp(rowOffset + start[0]*sizeof(uint16_t));
+        os.write((const char *)&(halfRow[0]), size[0]*sizeof(uint16_t));
+        }
+      else
+        {
+        os.seekp(rowOffset + start[0]*sizeof(float));
+        os.write((const char *)in, size[0]*sizeof(float));
+        }
+      }
+  if(os.fail())
+    itkExceptionMacro(<<"Write failed in " << m_FileName);
+}
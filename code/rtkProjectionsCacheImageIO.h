@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkProjectionsCacheImageIO_h
+#define __rtkProjectionsCacheImageIO_h
+
+#include <itkImageIOBase.h>
+#include <string>
+
+namespace rtk {
+
+/** \class ProjectionsCacheImageIO
+ * \brief Class for reading and writing preprocessed projection stacks.
+ *
+ * The projection cache is the file written by rtkprojections after the raw
+ * data have been decoded and converted to attenuation. It is meant to be
+ * mapped in memory so that subsequent reconstructions skip the decoding and
+ * only read the projections they request. The file contains:
+ * - a 256 bytes header with the image information, the storage type and the
+ * offsets of the following blocks,
+ * - the geometry XML file, if any, which is made available in the
+ * metadata dictionary under the key "rtkGeometryXML",
+ * - the attenuation values, starting at a page-aligned offset. Each row is
+ * padded to a multiple of 64 bytes so that all rows are aligned on a cache
+ * line. Values are stored in single or half precision and always read as
+ * single precision floats.
+ *
+ * Both reading and writing can be streamed. The file is stored with the byte
+ * order of the machine which wrote it and it is not swapped when read.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup IOFilters
+ */
+class ProjectionsCacheImageIO : public itk::ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef ProjectionsCacheImageIO Self;
+  typedef itk::ImageIOBase        Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ProjectionsCacheImageIO, ImageIOBase);
+
+  /** Alignment in bytes of each row and of the first pixel. */
+  itkStaticConstMacro(RowAlignment, unsigned int, 64);
+  itkStaticConstMacro(DataAlignment, unsigned int, 4096);
+
+  /** Store the values in half precision when writing. Set from the file
+   * after ReadImageInformation(). */
+  itkSetMacro(UseHalfPrecision, bool);
+  itkGetConstMacro(UseHalfPrecision, bool);
+  itkBooleanMacro(UseHalfPrecision);
+
+  /** Content of the geometry XML file embedded in the cache. When writing
+   * with an empty string, the metadata dictionary entry is used, if any. */
+  itkSetMacro(GeometryXML, std::string);
+  itkGetConstReferenceMacro(GeometryXML, std::string);
+
+  /** Byte offset of the first pixel and number of bytes between two rows.
+   * Valid after ReadImageInformation(). */
+  size_t GetDataOffset() const { return m_DataOffset; }
+  size_t GetRowPitch() const { return m_RowPitch; }
+
+  /*-------- This part of the interface deals with reading data. ------ */
+  virtual void ReadImageInformation();
+
+  virtual bool CanReadFile( const char* FileNameToRead );
+
+  virtual bool CanStreamRead() { return true; }
+
+  virtual void Read(void * buffer);
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+  virtual void WriteImageInformation();
+
+  virtual bool CanWriteFile(const char* filename);
+
+  virtual bool CanStreamWrite() { return true; }
+
+  virtual void Write(const void* buffer);
+
+protected:
+  ProjectionsCacheImageIO();
+  ~ProjectionsCacheImageIO() {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const;
+
+  /** Compute m_RowPitch and m_DataOffset from the current image information */
+  void ComputeLayout();
+
+  bool        m_UseHalfPrecision;
+  std::string m_GeometryXML;
+  size_t      m_RowPitch;
+  size_t      m_DataOffset;
+
+private:
+  ProjectionsCacheImageIO(const Self&); //purposely not implemented
+  void operator=(const Self&);          //purposely not implemented
+}; // end class ProjectionsCacheImageIO
+
+} // end namespace
+
+#endif
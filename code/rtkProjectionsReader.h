@@ -23,6 +23,9 @@
 #include <itkImageSource.h>
 #include <itkImageIOFactory.h>
 
+// RTK
+#include "rtkHalf.h"
+
 // Standard lib
 #include <vector>
 #include <string>
@@ -30,13 +33,38 @@
 namespace rtk
 {
 
+/** \brief Image type in which ProjectionsReader decodes the projections.
+ * This is the output image type except for half precision stacks which are
+ * decoded in single precision.
+ */
+template <class TOutputImage>
+struct ProjectionsReaderDecodedImage
+{
+  typedef TOutputImage Type;
+};
+
+template <unsigned int VDimension>
+struct ProjectionsReaderDecodedImage< itk::Image<Half, VDimension> >
+{
+  typedef itk::Image<float, VDimension> Type;
+};
+
 /** \class ProjectionsReader
  *
  * This is the universal projections reader of rtk (raw data converted to
  * understandable values, e.g. attenuation). Currently handles his (Elekta
  * Synergy), hnd (Varian OBI), tiff. For all other ITK file formats, it is
  * assumed that the attenuation is directly passed and there is no processing,
- * only the reading.
+ * only the reading. The fixed-layout raw formats (his, xrad, ImagX) are
+ * read with MemoryMappedProjectionsReader which maps the files and writes
+ * the raw values directly into the projection stack. The projection caches
+ * written by rtkprojections (ProjectionsCacheImageIO) are read without any
+ * conversion and only the requested region is read.
+ *
+ * The output can be an image of rtk::Half to halve the memory of the stack.
+ * The projections are then decoded in single precision a few at a time and
+ * converted to half precision, so the full stack is never stored in single
+ * precision.
  *
  * \test rtkedftest.cxx, rtkelektatest.cxx, rtkimagxtest.cxx, 
  * rtkdigisenstest.cxx, rtkxradtest.cxx, rtkvariantest.cxx
@@ -68,6 +96,9 @@ public:
 
   typedef  std::vector<std::string> FileNamesContainer;
 
+  /** Type of the image decoded by the raw data pipe */
+  typedef typename ProjectionsReaderDecodedImage<TOutputImage>::Type DecodedImageType;
+
   /** ImageDimension constant */
   itkStaticConstMacro(OutputImageDimension, unsigned int,
                       TOutputImage::ImageDimension);
@@ -91,6 +122,10 @@ public:
    * propagation of the pipeline. */
   virtual void GenerateOutputInformation(void);
 
+  /** Lookup table applied while decoding the raw data, NULL if none. It is
+   * shared with all readers and lookup table filters of the same scanner. */
+  itkGetConstObjectMacro(RawLookupTable, itk::DataObject);
+
 protected:
   ProjectionsReader():m_ImageIO(NULL) {};
   ~ProjectionsReader() {};
@@ -99,6 +134,13 @@ protected:
   /** Does the real work. */
   virtual void GenerateData();
 
+  /** Transfer the decoded projections to the output. When the decoded image
+   * type is the output type, the output of the pipe is grafted. Otherwise,
+   * the requested region is decoded piece by piece and converted. */
+  void CopyDecodedProjections(TOutputImage *decoded);
+  template <class TDecodedImage>
+  void CopyDecodedProjections(TDecodedImage *decoded);
+
   /** A list of filenames to be processed. */
   FileNamesContainer m_FileNames;
 
@@ -113,10 +155,13 @@ private:
 
   /** Conversion from raw to Projections. Is equal to m_RawDataReader
    * if no conversion. Put in a composite filter if more than one operation.*/
-  typename itk::ImageSource<TOutputImage>::Pointer m_RawToProjectionsFilter;
+  typename itk::ImageSource<DecodedImageType>::Pointer m_RawToProjectionsFilter;
 
   /** Image IO object which is stored to create the pipe only when required */
   itk::ImageIOBase::Pointer m_ImageIO;
+
+  /** Lookup table applied by m_RawDataReader, kept to reference it. */
+  itk::DataObject::Pointer m_RawLookupTable;
 };
 
 } //namespace rtk
@@ -21,10 +21,13 @@
 
 // ITK
 #include <itkImageSeriesReader.h>
+#include <itkImageFileReader.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itkConfigure.h>
 
 // RTK
 #include "rtkIOFactories.h"
+#include "rtkMemoryMappedProjectionsReader.h"
 
 // Varian Obi includes
 #include "rtkHndImageIOFactory.h"
@@ -80,6 +83,7 @@ void ProjectionsReader<TOutputImage>
   if(m_ImageIO != imageIO)
     {
     // In this block, we create a specific pipe depending on the type
+    m_RawLookupTable = NULL;
     if( !strcmp(imageIO->GetNameOfClass(), "HndImageIO") )
       {
       /////////// Varian OBI
@@ -94,7 +98,7 @@ void ProjectionsReader<TOutputImage>
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::VarianObiRawImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::VarianObiRawImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
       rawFilter->SetInput( reader->GetOutput() );
       m_RawToProjectionsFilter = rawFilter;
@@ -105,16 +109,27 @@ void ProjectionsReader<TOutputImage>
       typedef unsigned short                                     InputPixelType;
       typedef itk::Image< InputPixelType, OutputImageDimension > InputImageType;
 
-      // Reader
-      typedef itk::ImageSeriesReader< InputImageType > ReaderType;
+      // Reader which applies the raw lookup table while decoding. The table
+      // is shared with the lookup table filters and kept alive by this reader.
+      typedef rtk::ElektaSynergyRawLookupTableImageFilter<OutputImageDimension> RawLookupTableFilterType;
+      typedef rtk::MemoryMappedProjectionsReader< InputImageType,
+                                                  rtk::HisImageIO,
+                                                  InputPixelType,
+                                                  typename RawLookupTableFilterType::FunctorType > ReaderType;
       typename ReaderType::Pointer reader = ReaderType::New();
-      reader->SetImageIO( imageIO );
+      reader->SetImageIO( dynamic_cast<rtk::HisImageIO*>( imageIO.GetPointer() ) );
       reader->SetFileNames( this->GetFileNames() );
+      typename RawLookupTableFilterType::LookupTableType::Pointer lut;
+      lut = RawLookupTableFilterType::GetOrCreateSharedLookupTable("ElektaSynergyRaw",
+                                                                   RawLookupTableFilterType::BuildLookupTable);
+      m_RawLookupTable = lut;
+      reader->GetFunctor().SetLookupTableDataPointer( lut->GetBufferPointer() );
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::ElektaSynergyRawToAttenuationImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::ElektaSynergyRawToAttenuationImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
+      rawFilter->SetApplyRawLookupTable( false );
       rawFilter->SetInput( reader->GetOutput() );
       m_RawToProjectionsFilter = rawFilter;
       }
@@ -125,14 +140,14 @@ void ProjectionsReader<TOutputImage>
       typedef itk::Image< InputPixelType, OutputImageDimension > InputImageType;
 
       // Reader
-      typedef itk::ImageSeriesReader< InputImageType > ReaderType;
+      typedef rtk::MemoryMappedProjectionsReader< InputImageType, rtk::ImagXImageIO > ReaderType;
       typename ReaderType::Pointer reader = ReaderType::New();
-      reader->SetImageIO( imageIO );
+      reader->SetImageIO( dynamic_cast<rtk::ImagXImageIO*>( imageIO.GetPointer() ) );
       reader->SetFileNames( this->GetFileNames() );
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::ImagXRawToAttenuationImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::ImagXRawToAttenuationImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
       rawFilter->SetInput( reader->GetOutput() );
       m_RawToProjectionsFilter = rawFilter;
@@ -150,7 +165,7 @@ void ProjectionsReader<TOutputImage>
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::TiffLookupTableImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::TiffLookupTableImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
       rawFilter->SetInput( reader->GetOutput() );
       m_RawToProjectionsFilter = rawFilter;
@@ -169,7 +184,7 @@ void ProjectionsReader<TOutputImage>
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::EdfRawToAttenuationImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::EdfRawToAttenuationImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
       rawFilter->SetInput( reader->GetOutput() );
       rawFilter->SetFileNames( this->GetFileNames() );
@@ -182,23 +197,36 @@ void ProjectionsReader<TOutputImage>
       typedef itk::Image< InputPixelType, OutputImageDimension > InputImageType;
 
       // Reader
-      typedef itk::ImageSeriesReader< InputImageType > ReaderType;
+      typedef rtk::MemoryMappedProjectionsReader< InputImageType, rtk::XRadImageIO > ReaderType;
       typename ReaderType::Pointer reader = ReaderType::New();
-      reader->SetImageIO( imageIO );
+      reader->SetImageIO( dynamic_cast<rtk::XRadImageIO*>( imageIO.GetPointer() ) );
       reader->SetFileNames( this->GetFileNames() );
       m_RawDataReader = reader;
 
       // Convert raw to Projections
-      typedef rtk::XRadRawToAttenuationImageFilter<InputImageType, OutputImageType> RawFilterType;
+      typedef rtk::XRadRawToAttenuationImageFilter<InputImageType, DecodedImageType> RawFilterType;
       typename RawFilterType::Pointer rawFilter = RawFilterType::New();
       rawFilter->SetInput( reader->GetOutput() );
       m_RawToProjectionsFilter = rawFilter;
       }
+    else if( !strcmp(imageIO->GetNameOfClass(), "ProjectionsCacheImageIO") &&
+             this->GetFileNames().size() == 1 )
+      {
+      /////////// Projections preprocessed by rtkprojections. The cache is
+      // streamed, only the rows of the requested region are read from the
+      // mapped file.
+      typedef itk::ImageFileReader< DecodedImageType > ReaderType;
+      typename ReaderType::Pointer reader = ReaderType::New();
+      reader->SetImageIO( imageIO );
+      reader->SetFileName( this->GetFileNames()[0] );
+      m_RawDataReader = reader;
+      m_RawToProjectionsFilter = reader;
+      }
     else
       {
       ///////////// Default: whatever the format, we assume that we directly
       // read the Projections
-      typedef itk::ImageSeriesReader< OutputImageType > ReaderType;
+      typedef itk::ImageSeriesReader< DecodedImageType > ReaderType;
       typename ReaderType::Pointer reader = ReaderType::New();
       reader->SetImageIO( imageIO );
       reader->SetFileNames( this->GetFileNames() );
@@ -224,11 +252,56 @@ template <class TOutputImage>
 void ProjectionsReader<TOutputImage>
 ::GenerateData()
 {
-  TOutputImage * output = this->GetOutput();
+  this->CopyDecodedProjections( m_RawToProjectionsFilter->GetOutput() );
+}
 
-  m_RawToProjectionsFilter->GetOutput()->SetRequestedRegion( output->GetRequestedRegion() );
+//--------------------------------------------------------------------
+template <class TOutputImage>
+void ProjectionsReader<TOutputImage>
+::CopyDecodedProjections(TOutputImage *decoded)
+{
+  decoded->SetRequestedRegion( this->GetOutput()->GetRequestedRegion() );
   m_RawToProjectionsFilter->Update();
-  this->GraftOutput( m_RawToProjectionsFilter->GetOutput() );
+  this->GraftOutput( decoded );
+}
+
+//--------------------------------------------------------------------
+template <class TOutputImage>
+template <class TDecodedImage>
+void ProjectionsReader<TOutputImage>
+::CopyDecodedProjections(TDecodedImage *decoded)
+{
+  TOutputImage * output = this->GetOutput();
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->Allocate();
+
+  // Decode about 16 Mpixels at a time
+  const unsigned int last = OutputImageDimension-1;
+  const OutputImageRegionType region = output->GetRequestedRegion();
+  const unsigned int nProj = region.GetSize(last);
+  const unsigned int nPixelsPerProjection = region.GetNumberOfPixels() / vnl_math_max(nProj, 1U);
+  const unsigned int nProjPerPiece = vnl_math_max(1U, (1U<<24) / vnl_math_max(nPixelsPerProjection, 1U));
+
+  for(unsigned int k=0; k<nProj; k+=nProjPerPiece)
+    {
+    OutputImageRegionType piece = region;
+    piece.SetIndex(last, region.GetIndex(last)+k);
+    piece.SetSize(last, vnl_math_min(nProjPerPiece, nProj-k));
+    decoded->SetRequestedRegion( piece );
+    m_RawToProjectionsFilter->Update();
+
+    // Row by row conversion
+    OutputImageRegionType rows = piece;
+    rows.SetSize(0, 1);
+    itk::ImageRegionConstIteratorWithIndex<TOutputImage> it(output, rows);
+    for(; !it.IsAtEnd(); ++it)
+      FloatToHalfRow( decoded->GetBufferPointer() + decoded->ComputeOffset( it.GetIndex() ),
+                      output->GetBufferPointer() + output->ComputeOffset( it.GetIndex() ),
+                      piece.GetSize(0) );
+    }
+
+  // The last piece is not needed anymore
+  decoded->ReleaseData();
 }
 
 } //namespace rtk
@@ -0,0 +1,285 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkQuadricScanlineFunction_h
+#define __rtkQuadricScanlineFunction_h
+
+#include <algorithm>
+#include <vcl_cmath.h>
+#include <vnl/vnl_math.h>
+
+#include "rtkConvertEllipsoidToQuadricParametersFunction.h"
+
+namespace rtk
+{
+
+/** \class QuadricScanlineFunction
+ * \brief Computes the voxels of a row which are inside a quadric.
+ *
+ * The row is the line p(t) = p0 + t*d where p0 is the physical position of
+ * the first voxel of the row and d the physical step between two consecutive
+ * voxels. The quadric equation restricted to this line is a second order
+ * polynomial a*t^2+b*t+c which is solved analytically. The voxels inside the
+ * quadric, i.e. those for which the polynomial is strictly negative, are
+ * returned as at most two spans [begin, end) of voxel indices in [0, n).
+ * The ends of the spans are then checked with Evaluate at the voxel centers
+ * so that voxels on or tangent to the surface are classified exactly as a
+ * per-voxel evaluation of the quadric would, whatever the rounding of the
+ * roots.
+ *
+ * This is used by the drawing filters to fill only the relevant part of each
+ * row instead of evaluating the quadric for every voxel, see DrawRegion.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+class QuadricScanlineFunction
+{
+public:
+  QuadricScanlineFunction():
+    m_A(0.), m_B(0.), m_C(0.), m_D(0.), m_E(0.),
+    m_F(0.), m_G(0.), m_H(0.), m_I(0.), m_J(0.) {}
+  ~QuadricScanlineFunction() {}
+
+  /** Set the 10 quadric parameters from a converted ellipsoid description. */
+  void SetQuadric(ConvertEllipsoidToQuadricParametersFunction *p)
+    {
+    m_A = p->GetA(); m_B = p->GetB(); m_C = p->GetC(); m_D = p->GetD(); m_E = p->GetE();
+    m_F = p->GetF(); m_G = p->GetG(); m_H = p->GetH(); m_I = p->GetI(); m_J = p->GetJ();
+    }
+
+  /** Evaluate the quadric at a physical point. */
+  inline double Evaluate(const double p[3]) const
+    {
+    return m_A*p[0]*p[0] + m_B*p[1]*p[1] + m_C*p[2]*p[2] +
+           m_D*p[0]*p[1] + m_E*p[0]*p[2] + m_F*p[1]*p[2] +
+           m_G*p[0] + m_H*p[1] + m_I*p[2] + m_J;
+    }
+
+  /** Compute the spans of the row of n voxels starting at p0 with step d
+   * which are inside the quadric. The spans are stored in spans as
+   * [begin0, end0, begin1, end1] and the number of non empty spans is
+   * returned. */
+  inline unsigned int ComputeSpans(const double p0[3], const double d[3], const int n, int spans[4]) const
+    {
+    // Coefficients of the polynomial a*t^2+b*t+c
+    const double a = m_A*d[0]*d[0] + m_B*d[1]*d[1] + m_C*d[2]*d[2] +
+                     m_D*d[0]*d[1] + m_E*d[0]*d[2] + m_F*d[1]*d[2];
+    const double b = 2*(m_A*p0[0]*d[0] + m_B*p0[1]*d[1] + m_C*p0[2]*d[2]) +
+                     m_D*(p0[0]*d[1] + p0[1]*d[0]) +
+                     m_E*(p0[0]*d[2] + p0[2]*d[0]) +
+                     m_F*(p0[1]*d[2] + p0[2]*d[1]) +
+                     m_G*d[0] + m_H*d[1] + m_I*d[2];
+    const double c = Evaluate(p0);
+
+    unsigned int nSpans = 0;
+    if(a==0.)
+      {
+      if(b==0.)
+        {
+        if(c<0.)
+          nSpans = AddSpan(-1., n, n, spans, nSpans);
+        }
+      else if(b>0.)
+        nSpans = AddSpan(-1., -c/b, n, spans, nSpans);
+      else
+        nSpans = AddSpan(-c/b, n, n, spans, nSpans);
+      }
+    else
+      {
+      const double discriminant = b*b-4*a*c;
+      if(discriminant<=0.)
+        {
+        // No root: the sign of the polynomial is the sign of a. For a>0, the
+        // voxels around the minimum are kept for the check below in case the
+        // row is tangent to the surface.
+        if(a<0.)
+          nSpans = AddSpan(-1., n, n, spans, nSpans);
+        else
+          nSpans = AddSpan(-b/(2*a)-1., -b/(2*a)+1., n, spans, nSpans);
+        }
+      else
+        {
+        const double sqrtDiscriminant = vcl_sqrt(discriminant);
+        double t1 = (-b-sqrtDiscriminant)/(2*a);
+        double t2 = (-b+sqrtDiscriminant)/(2*a);
+        if(t1>t2)
+          std::swap(t1, t2);
+        if(a>0.)
+          nSpans = AddSpan(t1, t2, n, spans, nSpans);
+        else
+          {
+          nSpans = AddSpan(-1., t1, n, spans, nSpans);
+          nSpans = AddSpan(t2, n, n, spans, nSpans);
+          }
+        }
+      }
+    return CheckSpanEnds(p0, d, n, spans, nSpans);
+    }
+
+  /** Draw nQuadrics quadrics with their densities in the region of output,
+   * row by row. The output is first initialized with the input unless both
+   * share the same pixel container (in place filter). The densities of the
+   * voxels inside each quadric are then added to the output. If
+   * clearOutside is true, the voxels outside the first quadric are set to 0
+   * instead, which is the behavior of the single shape drawing filters.
+   * input and output must have the same geometry. */
+  template <class TInputImage, class TOutputImage>
+  static void DrawRegion(const TInputImage *input,
+                         TOutputImage *output,
+                         const typename TOutputImage::RegionType &region,
+                         const QuadricScanlineFunction *quadrics,
+                         const double *densities,
+                         const unsigned int nQuadrics,
+                         const bool clearOutside)
+    {
+    const bool inPlace = (const void *)(input->GetPixelContainer()) ==
+                         (const void *)(output->GetPixelContainer());
+
+    // Physical step between two consecutive voxels of a row
+    typename TOutputImage::IndexType index = region.GetIndex();
+    typename TOutputImage::PointType point, pointNext;
+    input->TransformIndexToPhysicalPoint(index, point);
+    index[0]++;
+    input->TransformIndexToPhysicalPoint(index, pointNext);
+    double p0[3], d[3];
+    for(unsigned int i=0; i<3; i++)
+      d[i] = pointNext[i] - point[i];
+
+    // Go over each row of the region once and composite all quadrics
+    const int n = region.GetSize(0);
+    int spans[4];
+    for(index[2]=region.GetIndex(2); index[2]<region.GetIndex(2)+(int)region.GetSize(2); index[2]++)
+      {
+      for(index[1]=region.GetIndex(1); index[1]<region.GetIndex(1)+(int)region.GetSize(1); index[1]++)
+        {
+        index[0] = region.GetIndex(0);
+        input->TransformIndexToPhysicalPoint(index, point);
+        for(unsigned int i=0; i<3; i++)
+          p0[i] = point[i];
+        typename TOutputImage::PixelType *pOut = output->GetBufferPointer() + output->ComputeOffset(index);
+        const typename TInputImage::PixelType *pIn = input->GetBufferPointer() + input->ComputeOffset(index);
+
+        unsigned int q = 0;
+        if(clearOutside && nQuadrics)
+          {
+          // Voxels outside the first quadric are set to 0
+          const unsigned int nSpans = quadrics[0].ComputeSpans(p0, d, n, spans);
+          int i = 0;
+          for(unsigned int s=0; s<nSpans; s++)
+            {
+            for(; i<spans[2*s]; i++)
+              pOut[i] = 0.;
+            for(; i<spans[2*s+1]; i++)
+              pOut[i] = densities[0] + pIn[i];
+            }
+          for(; i<n; i++)
+            pOut[i] = 0.;
+          q++;
+          }
+        else if(!inPlace)
+          {
+          for(int i=0; i<n; i++)
+            pOut[i] = pIn[i];
+          }
+
+        // Only add the density to the part of the row inside each quadric
+        for(; q<nQuadrics; q++)
+          {
+          const unsigned int nSpans = quadrics[q].ComputeSpans(p0, d, n, spans);
+          for(unsigned int s=0; s<nSpans; s++)
+            for(int i=spans[2*s]; i<spans[2*s+1]; i++)
+              pOut[i] += densities[q];
+          }
+        }
+      }
+    }
+
+private:
+  /** Evaluate the quadric at the center of voxel i of the row. */
+  inline double Evaluate(const double p0[3], const double d[3], const int i) const
+    {
+    double p[3];
+    for(unsigned int k=0; k<3; k++)
+      p[k] = p0[k] + i * d[k];
+    return Evaluate(p);
+    }
+
+  /** Move the ends of the spans until the voxels at both ends are inside and
+   * their neighbours outside the quadric. Empty spans are removed. */
+  inline unsigned int CheckSpanEnds(const double p0[3], const double d[3], const int n,
+                                    int spans[4], const unsigned int nSpans) const
+    {
+    unsigned int nNonEmpty = 0;
+    for(unsigned int s=0; s<nSpans; s++)
+      {
+      const int lo = (s)?spans[2*s-1]:0;
+      const int hi = (s+1<nSpans)?spans[2*s+2]:n;
+      int begin = spans[2*s];
+      int end = spans[2*s+1];
+      while(begin>lo && Evaluate(p0, d, begin-1)<0.)
+        begin--;
+      while(begin<end && !(Evaluate(p0, d, begin)<0.))
+        begin++;
+      while(end<hi && Evaluate(p0, d, end)<0.)
+        end++;
+      while(end>begin && !(Evaluate(p0, d, end-1)<0.))
+        end--;
+      if(begin<end)
+        {
+        spans[2*nNonEmpty]   = begin;
+        spans[2*nNonEmpty+1] = end;
+        nNonEmpty++;
+        }
+      }
+    return nNonEmpty;
+    }
+
+  /** Add the span of integer indices strictly inside ]tmin, tmax[ clipped to
+   * [0, n) if it is not empty. */
+  static inline unsigned int AddSpan(double tmin, double tmax, const int n, int spans[4], unsigned int nSpans)
+    {
+    tmin = vnl_math_min(vnl_math_max(tmin, -1.), double(n));
+    tmax = vnl_math_min(vnl_math_max(tmax, -1.), double(n));
+    const int begin = vnl_math_floor(tmin)+1;
+    const int end = vnl_math_ceil(tmax);
+    if(begin<end)
+      {
+      spans[2*nSpans]   = begin;
+      spans[2*nSpans+1] = end;
+      nSpans++;
+      }
+    return nSpans;
+    }
+
+  double m_A;
+  double m_B;
+  double m_C;
+  double m_D;
+  double m_E;
+  double m_F;
+  double m_G;
+  double m_H;
+  double m_I;
+  double m_J;
+};
+
+} // end namespace rtk
+
+#endif
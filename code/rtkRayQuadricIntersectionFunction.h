@@ -63,6 +63,20 @@ public:
   /** Evaluate the intersection points */
   bool Evaluate( const VectorType& input );
 
+  /** Evaluate the intersection points of n rays starting from the ray origin.
+   * The normalized ray directions are passed as a structure of arrays, one
+   * array per coordinate, and the distances to the intersections are written
+   * in nearest and farthest. Both distances are set to 0 for rays which do
+   * not intersect the quadric so that their difference, the intersection
+   * length, is 0. The loop has no data-dependent branch so that it can be
+   * vectorized by the compiler. */
+  void BatchEvaluate( const unsigned int n,
+                      const TCoordRep *dirx,
+                      const TCoordRep *diry,
+                      const TCoordRep *dirz,
+                      TCoordRep *nearest,
+                      TCoordRep *farthest ) const;
+
   /** Get / Set the quadric parameters. */
   itkGetMacro(A, TCoordRep);
   itkSetMacro(A, TCoordRep);
@@ -19,6 +19,8 @@
 #ifndef __rtkRayQuadricIntersectionFunction_txx
 #define __rtkRayQuadricIntersectionFunction_txx
 
+#include <vcl_cmath.h>
+
 namespace rtk
 {
 
@@ -100,6 +102,56 @@ RayQuadricIntersectionFunction<TCoordRep, VBoxDimension>
   return true;
 }
 
+template < class TCoordRep, unsigned int VBoxDimension >
+void
+RayQuadricIntersectionFunction<TCoordRep, VBoxDimension>
+::BatchEvaluate( const unsigned int n,
+                 const TCoordRep *dirx,
+                 const TCoordRep *diry,
+                 const TCoordRep *dirz,
+                 TCoordRep *nearest,
+                 TCoordRep *farthest ) const
+{
+  // All rays share the same origin, i.e., Cq is the same for all rays and Bq
+  // is a dot product between the ray direction and a constant gradient.
+  const TCoordRep *o = &(m_RayOrigin[0]);
+  const TCoordRep Cq = m_A*o[0]*o[0] + m_B*o[1]*o[1] + m_C*o[2]*o[2] +
+                       m_D*o[0]*o[1] + m_E*o[0]*o[2] + m_F*o[1]*o[2] +
+                       m_G*o[0] + m_H*o[1] + m_I*o[2] + m_J;
+  const TCoordRep gx = 2*m_A*o[0] + m_D*o[1] + m_E*o[2] + m_G;
+  const TCoordRep gy = 2*m_B*o[1] + m_D*o[0] + m_F*o[2] + m_H;
+  const TCoordRep gz = 2*m_C*o[2] + m_E*o[0] + m_F*o[1] + m_I;
+
+  const TCoordRep zero = itk::NumericTraits<TCoordRep>::ZeroValue();
+  const TCoordRep maxDistance = itk::NumericTraits<TCoordRep>::max();
+  for(unsigned int i=0; i<n; i++)
+    {
+    const TCoordRep x = dirx[i];
+    const TCoordRep y = diry[i];
+    const TCoordRep z = dirz[i];
+    const TCoordRep Aq = m_A*x*x + m_B*y*y + m_C*z*z + m_D*x*y + m_E*x*z + m_F*y*z;
+    const TCoordRep Bq = gx*x + gy*y + gz*z;
+    const TCoordRep discriminant = Bq*Bq-4*Aq*Cq;
+    const TCoordRep sqrtDiscriminant = vcl_sqrt( (discriminant<zero)?zero:discriminant );
+    const TCoordRep half = (Aq==zero)?zero:0.5/Aq;
+    TCoordRep t1 = (-Bq-sqrtDiscriminant)*half;
+    TCoordRep t2 = (-Bq+sqrtDiscriminant)*half;
+
+    // Same ordering as Evaluate, nearest in absolute value first
+    const bool swap = (t1-t2)*(t1+t2)>zero;
+    TCoordRep tn = swap?t2:t1;
+    TCoordRep tf = swap?t1:t2;
+
+    // Degenerate case of a linear equation
+    tn = (Aq==zero)?-Cq/Bq:tn;
+    tf = (Aq==zero)?maxDistance:tf;
+
+    const bool intersect = (Aq==zero) || (discriminant>=zero);
+    nearest[i]  = intersect?tn:zero;
+    farthest[i] = intersect?tf:zero;
+    }
+}
+
 } // namespace rtk
 
 #endif // __rtkRayQuadricIntersectionFunction_txx
@@ -20,7 +20,7 @@
 #define __rtkRayQuadricIntersectionImageFilter_txx
 
 #include <itkImageRegionConstIterator.h>
-#include <itkImageRegionIteratorWithIndex.h>
+#include <itkImageRegionIterator.h>
 
 #include "rtkHomogeneousMatrix.h"
 
@@ -67,11 +67,17 @@ RayQuadricIntersectionImageFilter<TInputImage,TOutputImage>
   // Iterators on input and output
   typedef itk::ImageRegionConstIterator<TInputImage> InputRegionIterator;
   InputRegionIterator itIn(this->GetInput(), outputRegionForThread);
-  typedef itk::ImageRegionIteratorWithIndex<TOutputImage> OutputRegionIterator;
+  typedef itk::ImageRegionIterator<TOutputImage> OutputRegionIterator;
   OutputRegionIterator itOut(this->GetOutput(), outputRegionForThread);
 
   const unsigned int Dimension = TInputImage::ImageDimension;
-  const unsigned int nPixelPerProj = outputRegionForThread.GetSize(0)*outputRegionForThread.GetSize(1);
+  const unsigned int nPixelPerRow = outputRegionForThread.GetSize(0);
+
+  // Structure of arrays for the ray directions and the intersection distances
+  // of one row of the projection, which are processed in one batch
+  std::vector<double> dirx(nPixelPerRow), diry(nPixelPerRow), dirz(nPixelPerRow);
+  std::vector<double> nearest(nPixelPerRow), farthest(nPixelPerRow);
+  double *dir[3] = {&(dirx[0]), &(diry[0]), &(dirz[0])};
 
   // Go over each projection
   for(unsigned int iProj=outputRegionForThread.GetIndex(2);
@@ -87,31 +93,35 @@ RayQuadricIntersectionImageFilter<TInputImage,TOutputImage>
     matrix = m_Geometry->GetProjectionCoordinatesToFixedSystemMatrix(iProj).GetVnlMatrix() *
              GetIndexToPhysicalPointMatrix( this->GetOutput() ).GetVnlMatrix();
 
-    // Go over each pixel of the projection
-    typename RQIFunctionType::VectorType direction;
-    for(unsigned int pix=0; pix<nPixelPerProj; pix++, ++itIn, ++itOut)
+    // Go over each row of the projection
+    for(int j=outputRegionForThread.GetIndex(1);
+            j<outputRegionForThread.GetIndex(1)+(int)outputRegionForThread.GetSize(1);
+            j++)
       {
-      // Compute point coordinate in volume depending on projection index
+      // Ray directions (projection position - source position), computed by
+      // stepping along the first column of the matrix
+      const int i0 = outputRegionForThread.GetIndex(0);
       for(unsigned int i=0; i<Dimension; i++)
         {
-        direction[i] = matrix[i][Dimension];
-        for(unsigned int j=0; j<Dimension; j++)
-          direction[i] += matrix[i][j] * itOut.GetIndex()[j];
-
-        // Direction (projection position - source position)
-        direction[i] -= sourcePosition[i];
+        const double start = matrix[i][0] * i0 + matrix[i][1] * j +
+                             matrix[i][2] * iProj + matrix[i][Dimension] - sourcePosition[i];
+        for(unsigned int pix=0; pix<nPixelPerRow; pix++)
+          dir[i][pix] = start + matrix[i][0] * pix;
         }
 
-      // Normalize direction
-      double invNorm = 1/direction.GetNorm();
-      for(unsigned int i=0; i<Dimension; i++)
-        direction[i] *= invNorm;
+      // Normalize directions
+      for(unsigned int pix=0; pix<nPixelPerRow; pix++)
+        {
+        const double invNorm = 1/vcl_sqrt(dirx[pix]*dirx[pix] + diry[pix]*diry[pix] + dirz[pix]*dirz[pix]);
+        dirx[pix] *= invNorm;
+        diry[pix] *= invNorm;
+        dirz[pix] *= invNorm;
+        }
 
-      // Compute ray intersection length
-      if( rqiFunctor->Evaluate(direction) )
-        itOut.Set( itIn.Get() + m_Density*(rqiFunctor->GetFarthestDistance() - rqiFunctor->GetNearestDistance() ));
-      else
-        itOut.Set( itIn.Get() );
+      // Compute ray intersection lengths of the row
+      rqiFunctor->BatchEvaluate(nPixelPerRow, dir[0], dir[1], dir[2], &(nearest[0]), &(farthest[0]));
+      for(unsigned int pix=0; pix<nPixelPerRow; pix++, ++itIn, ++itOut)
+        itOut.Set( itIn.Get() + m_Density*(farthest[pix] - nearest[pix]) );
       }
     }
 }
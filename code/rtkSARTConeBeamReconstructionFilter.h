@@ -21,6 +21,8 @@
 
 #include "rtkBackProjectionImageFilter.h"
 #include "rtkForwardProjectionImageFilter.h"
+#include "rtkTelemetry.h"
+#include "rtkImageBufferPool.h"
 
 #include <itkExtractImageFilter.h>
 #if ITK_VERSION_MAJOR <= 3
@@ -47,6 +49,10 @@ namespace rtk
  * controlled with ProjectionSubsetSize) via the use of itk::ExtractImageFilter
  * to extract sub-stacks.
  *
+ * The outputs of the subfilters which process projections are allocated
+ * from the shared rtk::ImageBufferPool and recycled from one projection to
+ * the next.
+ *
  * \test rtksarttest.cxx
  *
  * \author Simon Rit
@@ -92,6 +98,10 @@ public:
 
   void PrintTiming(std::ostream& os) const;
 
+  /** Record each execution of the subfilters with telemetry. This must be
+   * called after SetBackProjectionFilter. */
+  void WatchSubfilters(Telemetry *telemetry);
+
   /** Get / Set the number of iterations. Default is 3. */
   itkGetMacro(NumberOfIterations, unsigned int);
   itkSetMacro(NumberOfIterations, unsigned int);
@@ -139,6 +149,14 @@ private:
   /** Convergence factor according to Andersen's publications which relates
    * to the step size of the gradient descent. Default 0.3, Must be in (0,2). */
   double m_Lambda;
+
+  /** Probes to time reconstruction */
+  itk::TimeProbe m_ExtractProbe;
+  itk::TimeProbe m_ZeroMultiplyProbe;
+  itk::TimeProbe m_ForwardProjectionProbe;
+  itk::TimeProbe m_SubtractProbe;
+  itk::TimeProbe m_MultiplyProbe;
+  itk::TimeProbe m_BackProjectionProbe;
 }; // end of class
 
 } // end namespace rtk
@@ -41,7 +41,16 @@ SARTConeBeamReconstructionFilter<TInputImage, TOutputImage>
   m_ForwardProjectionFilter = JosephForwardProjectionImageFilter<TInputImage, TOutputImage>::New();
   m_SubtractFilter = SubtractFilterType::New();
   m_MultiplyFilter = MultiplyFilterType::New();
-  SetBackProjectionFilter(rtk::BackProjectionImageFilter<OutputImageType, OutputImageType>::New());  //Permanent internal connections
+  SetBackProjectionFilter(rtk::BackProjectionImageFilter<OutputImageType, OutputImageType>::New());
+
+  // The projections of the mini-pipeline have the same size for each update
+  ImageBufferPool::GetInstance()->Watch( m_ExtractFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_ZeroMultiplyFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_ForwardProjectionFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_SubtractFilter.GetPointer() );
+  ImageBufferPool::GetInstance()->Watch( m_MultiplyFilter.GetPointer() );
+
+  //Permanent internal connections
 #if ITK_VERSION_MAJOR >= 4
   m_ZeroMultiplyFilter->SetInput1( itk::NumericTraits<typename InputImageType::PixelType>::ZeroValue() );
   m_ZeroMultiplyFilter->SetInput2( m_ExtractFilter->GetOutput() );
@@ -189,12 +198,29 @@ SARTConeBeamReconstructionFilter<TInputImage, TOutputImage>
       m_BackProjectionFilter->GetOutput()->UpdateOutputInformation();
       m_BackProjectionFilter->GetOutput()->PropagateRequestedRegion();
 
+      m_ExtractProbe.Start();
       m_ExtractFilter->Update();
+      m_ExtractProbe.Stop();
+
+      m_ZeroMultiplyProbe.Start();
       m_ZeroMultiplyFilter->Update();
+      m_ZeroMultiplyProbe.Stop();
+
+      m_ForwardProjectionProbe.Start();
       m_ForwardProjectionFilter->Update();
+      m_ForwardProjectionProbe.Stop();
+
+      m_SubtractProbe.Start();
       m_SubtractFilter->Update();
+      m_SubtractProbe.Stop();
+
+      m_MultiplyProbe.Start();
       m_MultiplyFilter->Update();
+      m_MultiplyProbe.Stop();
+
+      m_BackProjectionProbe.Start();
       m_BackProjectionFilter->Update();
+      m_BackProjectionProbe.Stop();
 
       }
     }
@@ -206,6 +232,32 @@ void
 SARTConeBeamReconstructionFilter<TInputImage, TOutputImage>
 ::PrintTiming(std::ostream& os) const
 {
+  os << "SARTConeBeamReconstructionFilter timing:" << std::endl;
+  os << "  Extraction of projection sub-stacks: " << m_ExtractProbe.GetTotal()
+     << ' ' << m_ExtractProbe.GetUnit() << std::endl;
+  os << "  Multiplication by zero: " << m_ZeroMultiplyProbe.GetTotal()
+     << ' ' << m_ZeroMultiplyProbe.GetUnit() << std::endl;
+  os << "  Forward projection: " << m_ForwardProjectionProbe.GetTotal()
+     << ' ' << m_ForwardProjectionProbe.GetUnit() << std::endl;
+  os << "  Subtraction: " << m_SubtractProbe.GetTotal()
+     << ' ' << m_SubtractProbe.GetUnit() << std::endl;
+  os << "  Multiplication by lambda: " << m_MultiplyProbe.GetTotal()
+     << ' ' << m_MultiplyProbe.GetUnit() << std::endl;
+  os << "  Back projection: " << m_BackProjectionProbe.GetTotal()
+     << ' ' << m_BackProjectionProbe.GetUnit() << std::endl;
+}
+
+template<class TInputImage, class TOutputImage>
+void
+SARTConeBeamReconstructionFilter<TInputImage, TOutputImage>
+::WatchSubfilters(Telemetry *telemetry)
+{
+  telemetry->Watch(m_ExtractFilter.GetPointer(), "extract");
+  telemetry->Watch(m_ZeroMultiplyFilter.GetPointer(), "zero multiply");
+  telemetry->Watch(m_ForwardProjectionFilter.GetPointer(), "forward projection", Telemetry::RAYS);
+  telemetry->Watch(m_SubtractFilter.GetPointer(), "subtract");
+  telemetry->Watch(m_MultiplyFilter.GetPointer(), "lambda multiply");
+  telemetry->Watch(m_BackProjectionFilter.GetPointer(), "backprojection", Telemetry::VOXEL_UPDATES);
 }
 
 } // end namespace rtk
@@ -65,10 +65,10 @@ SiddonForwardProjectionImageFilter<TInputImage,
     typename Superclass::GeometryType::ThreeDHomogeneousMatrixType matrix;
     typename Superclass::GeometryType::ThreeDHomogeneousMatrixType FSM;
 
-    FSM = geometry->GetProjectionCoordinatesToFixedSystemMatrix(iProj).GetVnlMatrix();
+    FSM = geometry->GetProjectionCoordinatesToFixedSystemMatrix(iProj);
 
     matrix = volPPToIndex.GetVnlMatrix() *
-             geometry->GetProjectionCoordinatesToFixedSystemMatrix(iProj).GetVnlMatrix() *
+             FSM.GetVnlMatrix() *
              GetIndexToPhysicalPointMatrix( this->GetOutput() ).GetVnlMatrix();
 
 //  ***************************************************************************
@@ -116,9 +116,10 @@ SiddonForwardProjectionImageFilter<TInputImage,
     v2[2] = FSM[2][1];
     // Source Position
     PointType Source;
-    Source[0] = geometry->GetSourcePosition(iProj)[0];
-    Source[1] = geometry->GetSourcePosition(iProj)[1];
-    Source[2] = geometry->GetSourcePosition(iProj)[2];
+    const typename Superclass::GeometryType::HomogeneousVectorType &sourcePositionInWorld = geometry->GetSourcePosition(iProj);
+    Source[0] = sourcePositionInWorld[0];
+    Source[1] = sourcePositionInWorld[1];
+    Source[2] = sourcePositionInWorld[2];
 
     // output pixel position (WCS) due to y index
     PointType Xh;
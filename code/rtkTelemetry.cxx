@@ -0,0 +1,328 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkTelemetry.h"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <map>
+
+#if !defined(_WIN32) && !defined(WIN32)
+#  include <sys/resource.h>
+#endif
+
+namespace
+{
+/** Write a string in a JSON file with the required escape characters */
+std::string JSONString(const std::string &s)
+{
+  std::string result("\"");
+  for(std::string::const_iterator it=s.begin(); it!=s.end(); ++it)
+    {
+    if(*it=='"' || *it=='\\')
+      result += '\\';
+    result += *it;
+    }
+  return result + "\"";
+}
+
+/** Accumulated events of one stage */
+struct StageSummary
+{
+  StageSummary():count(0), wallTime(0.), cpuTime(0.), bytes(0.), work(0.), peakMemory(0.) {}
+  std::string  className;
+  unsigned int count;
+  double       wallTime;
+  double       cpuTime;
+  double       bytes;
+  double       work;
+  double       peakMemory;
+  rtk::Telemetry::WorkType workType;
+};
+
+/** Summaries in the order of the first completion of each stage */
+void Summarize(const rtk::Telemetry::EventsType &events,
+               std::vector<std::string> &stages,
+               std::map<std::string, StageSummary> &summaries)
+{
+  for(unsigned int i=0; i<events.size(); i++)
+    {
+    const rtk::Telemetry::StageEvent &e = events[i];
+    if(summaries.find(e.stage) == summaries.end())
+      stages.push_back(e.stage);
+    StageSummary &s = summaries[e.stage];
+    s.className = e.className;
+    s.workType = e.workType;
+    s.count++;
+    s.wallTime += e.wallTime;
+    s.cpuTime += e.cpuTime;
+    s.bytes += e.bytes;
+    s.work += e.work;
+    s.peakMemory = std::max(s.peakMemory, e.peakMemory);
+    }
+}
+}
+
+namespace rtk
+{
+
+Telemetry
+::Telemetry():
+  m_Enabled(true),
+  m_Depth(0)
+{
+  m_Clock = itk::RealTimeClock::New();
+  m_Origin = m_Clock->GetTimeInSeconds();
+}
+
+void
+Telemetry
+::Watch(itk::ProcessObject *filter, const std::string &stage)
+{
+  if(!m_Enabled || filter==NULL)
+    return;
+  ProcessStageCommand::Pointer command = ProcessStageCommand::New();
+  AddObservers(filter, command, stage, PIXELS);
+}
+
+void
+Telemetry
+::AddObservers(itk::ProcessObject *filter, StageCommand *command,
+               const std::string &stage, const WorkType workType)
+{
+  if(m_Watched.find(filter) != m_Watched.end())
+    return;
+  m_Watched.insert(filter);
+  command->Setup(this, stage, workType);
+  filter->AddObserver(itk::StartEvent(), command);
+  filter->AddObserver(itk::EndEvent(), command);
+}
+
+void
+Telemetry
+::StartStage(const std::string &stage)
+{
+  if(!m_Enabled)
+    return;
+  StageEvent e;
+  e.stage = stage;
+  e.className = stage;
+  e.begin = GetWallTime();
+  e.cpuTime = GetCPUTime();
+  e.depth = m_Depth++;
+  m_OpenStages.push_back(e);
+}
+
+void
+Telemetry
+::StopStage(const double bytes, const double work, const WorkType workType)
+{
+  if(!m_Enabled)
+    return;
+  if(m_OpenStages.empty())
+    itkExceptionMacro(<< "StopStage called without StartStage");
+  StageEvent e = m_OpenStages.back();
+  m_OpenStages.pop_back();
+  m_Depth = e.depth;
+  e.wallTime = GetWallTime() - e.begin;
+  e.cpuTime = GetCPUTime() - e.cpuTime;
+  e.bytes = bytes;
+  e.work = work;
+  e.workType = workType;
+  e.peakMemory = GetPeakMemory();
+  m_Events.push_back(e);
+}
+
+void
+Telemetry
+::WriteJSON(std::ostream &os) const
+{
+  os.precision(9);
+  os << "{\n"
+     << "  \"displayTimeUnit\": \"ms\",\n"
+     << "  \"traceEvents\": [";
+  for(unsigned int i=0; i<m_Events.size(); i++)
+    {
+    const StageEvent &e = m_Events[i];
+    os << ((i)?",":"") << "\n    {"
+       << "\"name\": " << JSONString(e.stage) << ", "
+       << "\"cat\": " << JSONString(e.className) << ", "
+       << "\"ph\": \"X\", "
+       << "\"ts\": " << e.begin * 1e6 << ", "
+       << "\"dur\": " << e.wallTime * 1e6 << ", "
+       << "\"pid\": 0, \"tid\": 0, "
+       << "\"args\": {"
+       << "\"cpu_time\": " << e.cpuTime << ", "
+       << "\"bytes\": " << e.bytes << ", "
+       << "\"work\": " << e.work << ", "
+       << "\"work_unit\": \"" << GetWorkUnit(e.workType) << "\", "
+       << "\"peak_memory\": " << e.peakMemory << ", "
+       << "\"depth\": " << e.depth << "}}";
+    }
+  os << "\n  ],\n"
+     << "  \"stages\": [";
+
+  std::vector<std::string> stages;
+  std::map<std::string, StageSummary> summaries;
+  Summarize(m_Events, stages, summaries);
+  for(unsigned int i=0; i<stages.size(); i++)
+    {
+    const StageSummary &s = summaries[stages[i]];
+    os << ((i)?",":"") << "\n    {"
+       << "\"name\": " << JSONString(stages[i]) << ", "
+       << "\"class\": " << JSONString(s.className) << ", "
+       << "\"count\": " << s.count << ", "
+       << "\"wall_time\": " << s.wallTime << ", "
+       << "\"cpu_time\": " << s.cpuTime << ", "
+       << "\"bytes\": " << s.bytes << ", "
+       << "\"bytes_per_second\": " << ((s.wallTime>0.)?s.bytes/s.wallTime:0.) << ", "
+       << "\"work\": " << s.work << ", "
+       << "\"work_unit\": \"" << GetWorkUnit(s.workType) << "\", "
+       << "\"work_per_second\": " << ((s.wallTime>0.)?s.work/s.wallTime:0.) << ", "
+       << "\"peak_memory\": " << s.peakMemory << "}";
+    }
+  os << "\n  ],\n"
+     << "  \"wall_time\": " << GetWallTime() << ",\n"
+     << "  \"peak_memory\": " << GetPeakMemory() << "\n"
+     << "}\n";
+}
+
+void
+Telemetry
+::WriteJSON(const std::string &fileName) const
+{
+  std::ofstream os(fileName.c_str());
+  if(!os.is_open())
+    itkExceptionMacro(<< "Could not open " << fileName << " for writing");
+  WriteJSON(os);
+}
+
+void
+Telemetry
+::PrintTiming(std::ostream &os) const
+{
+  std::vector<std::string> stages;
+  std::map<std::string, StageSummary> summaries;
+  Summarize(m_Events, stages, summaries);
+  os << "Telemetry:" << std::endl;
+  for(unsigned int i=0; i<stages.size(); i++)
+    {
+    const StageSummary &s = summaries[stages[i]];
+    os << "  " << stages[i] << ": " << s.wallTime << " s wall, "
+       << s.cpuTime << " s CPU";
+    if(s.count>1)
+      os << ", " << s.count << " executions";
+    if(s.work>0. && s.wallTime>0.)
+      os << ", " << s.work / s.wallTime << ' ' << GetWorkUnit(s.workType) << "/s";
+    os << std::endl;
+    }
+  os << "  Peak memory: " << GetPeakMemory() / (1024.*1024.) << " MB" << std::endl;
+}
+
+double
+Telemetry
+::GetPeakMemory()
+{
+#if defined(_WIN32) || defined(WIN32)
+  return 0.;
+#else
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage))
+    return 0.;
+#  if defined(__APPLE__)
+  return usage.ru_maxrss;
+#  else
+  return usage.ru_maxrss * 1024.;
+#  endif
+#endif
+}
+
+const char *
+Telemetry
+::GetWorkUnit(const WorkType workType)
+{
+  switch(workType)
+    {
+    case VOXEL_UPDATES:
+      return "voxel updates";
+    case RAYS:
+      return "rays";
+    default:
+      return "pixels";
+    }
+}
+
+double
+Telemetry
+::GetWallTime() const
+{
+  return m_Clock->GetTimeInSeconds() - m_Origin;
+}
+
+double
+Telemetry
+::GetCPUTime()
+{
+  return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+void
+Telemetry::StageCommand
+::Setup(Telemetry *telemetry, const std::string &stage, const WorkType workType)
+{
+  m_Telemetry = telemetry;
+  m_Stage = stage;
+  m_WorkType = workType;
+}
+
+void
+Telemetry::StageCommand
+::Execute(itk::Object *caller, const itk::EventObject &event)
+{
+  if(itk::StartEvent().CheckEvent(&event))
+    {
+    m_Begin = m_Telemetry->GetWallTime();
+    m_BeginCPU = GetCPUTime();
+    m_Depth = m_Telemetry->m_Depth++;
+    }
+  else if(itk::EndEvent().CheckEvent(&event))
+    {
+    StageEvent e;
+    e.stage = m_Stage;
+    e.className = caller->GetNameOfClass();
+    e.begin = m_Begin;
+    e.wallTime = m_Telemetry->GetWallTime() - m_Begin;
+    e.cpuTime = GetCPUTime() - m_BeginCPU;
+    ComputeSize(dynamic_cast<itk::ProcessObject *>(caller), e.bytes, e.work);
+    e.workType = m_WorkType;
+    e.peakMemory = GetPeakMemory();
+    e.depth = m_Depth;
+    m_Telemetry->m_Depth = m_Depth;
+    m_Telemetry->m_Events.push_back(e);
+    }
+}
+
+void
+Telemetry::StageCommand
+::Execute(const itk::Object *caller, const itk::EventObject &event)
+{
+  this->Execute(const_cast<itk::Object *>(caller), event);
+}
+
+} // end namespace rtk
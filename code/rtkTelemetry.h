@@ -0,0 +1,214 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkTelemetry_h
+#define __rtkTelemetry_h
+
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkCommand.h>
+#include <itkImageSource.h>
+#include <itkRealTimeClock.h>
+
+#include <vector>
+#include <set>
+#include <string>
+
+namespace rtk
+{
+
+/** \class Telemetry
+ * \brief Records the execution of the stages of a pipeline.
+ *
+ * Each watched process object is timed through observers of its StartEvent
+ * and EndEvent. Every execution, e.g. every stream division or every
+ * projection of SART, is recorded as an event with its wall time, the CPU
+ * time of the process, the bytes produced, the work done (pixels, voxel
+ * updates or rays) and the peak memory of the process. Code which is not a
+ * process object can be timed with StartStage / StopStage.
+ *
+ * The events are exported with WriteJSON in the JSON object format of the
+ * Chrome trace viewer (chrome://tracing) with an additional summary per
+ * stage. No observer is added when the telemetry is disabled so that the
+ * overhead is negligible.
+ *
+ * \author Simon Rit
+ *
+ * \ingroup Functions
+ */
+class ITK_EXPORT Telemetry : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef Telemetry                     Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(Telemetry, itk::Object);
+
+  /** Unit of the work of a stage which is used to compute its rate */
+  typedef enum {PIXELS=0, VOXEL_UPDATES=1, RAYS=2} WorkType;
+
+  /** One execution of a stage. Times are in seconds and memory in bytes. */
+  struct StageEvent
+    {
+    std::string  stage;
+    std::string  className;
+    double       begin;
+    double       wallTime;
+    double       cpuTime;
+    double       bytes;
+    double       work;
+    WorkType     workType;
+    double       peakMemory;
+    unsigned int depth;
+    };
+  typedef std::vector<StageEvent> EventsType;
+
+  /** Get / Set if the stages are recorded. Default is on. */
+  itkGetConstMacro(Enabled, bool);
+  itkSetMacro(Enabled, bool);
+  itkBooleanMacro(Enabled);
+
+  /** Record each execution of filter under the name stage. The bytes
+   * produced and the work are computed from the requested region of the
+   * output. For VOXEL_UPDATES, the number of projections is the size of the
+   * last dimension of the second input, e.g., for backprojection filters.
+   * A filter which is already watched is ignored. */
+  template <class TOutputImage>
+  void Watch(itk::ImageSource<TOutputImage> *filter, const std::string &stage, const WorkType workType=PIXELS);
+
+  /** Record each execution of a process object which is not an image source,
+   * e.g., a writer. Only times and memory are recorded. */
+  void Watch(itk::ProcessObject *filter, const std::string &stage);
+
+  /** Record a stage which is not a process object, e.g., reading the
+   * geometry. Stages can be nested. */
+  void StartStage(const std::string &stage);
+  void StopStage(const double bytes=0., const double work=0., const WorkType workType=PIXELS);
+
+  /** Events recorded in the order of completion */
+  const EventsType &GetEvents() const { return m_Events; }
+
+  /** Export the events in the JSON object format of the Chrome trace viewer
+   * with a summary per stage. */
+  void WriteJSON(std::ostream &os) const;
+  void WriteJSON(const std::string &fileName) const;
+
+  /** Print a summary per stage in a human readable format */
+  void PrintTiming(std::ostream &os) const;
+
+  /** Peak resident memory of the process in bytes, 0 if not available */
+  static double GetPeakMemory();
+
+  /** Name of a work unit */
+  static const char *GetWorkUnit(const WorkType workType);
+
+protected:
+  Telemetry();
+  virtual ~Telemetry() {}
+
+  /** Observer of the StartEvent and EndEvent of a process object */
+  class StageCommand : public itk::Command
+  {
+  public:
+    typedef StageCommand            Self;
+    typedef itk::SmartPointer<Self> Pointer;
+
+    void Setup(Telemetry *telemetry, const std::string &stage, const WorkType workType);
+
+    virtual void Execute(itk::Object *caller, const itk::EventObject &event);
+    virtual void Execute(const itk::Object *caller, const itk::EventObject &event);
+
+  protected:
+    StageCommand() {}
+
+    /** Compute the bytes produced and the work of the last execution */
+    virtual void ComputeSize(itk::ProcessObject *itkNotUsed(filter), double &bytes, double &work)
+      {
+      bytes = 0.;
+      work = 0.;
+      }
+
+    WorkType m_WorkType;
+
+  private:
+    Telemetry   *m_Telemetry;
+    std::string  m_Stage;
+    double       m_Begin;
+    double       m_BeginCPU;
+    unsigned int m_Depth;
+  };
+
+  template <class TOutputImage>
+  class ImageStageCommand : public StageCommand
+  {
+  public:
+    typedef ImageStageCommand       Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkNewMacro(Self);
+
+  protected:
+    virtual void ComputeSize(itk::ProcessObject *filter, double &bytes, double &work);
+  };
+
+  class ProcessStageCommand : public StageCommand
+  {
+  public:
+    typedef ProcessStageCommand     Self;
+    typedef itk::SmartPointer<Self> Pointer;
+    itkNewMacro(Self);
+  };
+
+  /** Add command as observer of filter if it is not watched yet */
+  void AddObservers(itk::ProcessObject *filter, StageCommand *command,
+                    const std::string &stage, const WorkType workType);
+
+  /** Wall time in seconds since the creation of the telemetry */
+  double GetWallTime() const;
+
+  /** CPU time of the process in seconds */
+  static double GetCPUTime();
+
+private:
+  Telemetry(const Self&);        //purposely not implemented
+  void operator=(const Self&);   //purposely not implemented
+
+  bool                             m_Enabled;
+  itk::RealTimeClock::Pointer      m_Clock;
+  double                           m_Origin;
+  EventsType                       m_Events;
+  std::set<itk::ProcessObject *>   m_Watched;
+  unsigned int                     m_Depth;
+
+  /** Stages opened with StartStage */
+  std::vector<StageEvent>          m_OpenStages;
+};
+
+} // end namespace rtk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "rtkTelemetry.txx"
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkTelemetry_txx
+#define __rtkTelemetry_txx
+
+namespace rtk
+{
+
+template <class TOutputImage>
+void
+Telemetry
+::Watch(itk::ImageSource<TOutputImage> *filter, const std::string &stage, const WorkType workType)
+{
+  if(!m_Enabled || filter==NULL)
+    return;
+  typename ImageStageCommand<TOutputImage>::Pointer command = ImageStageCommand<TOutputImage>::New();
+  AddObservers(filter, command, stage, workType);
+}
+
+template <class TOutputImage>
+void
+Telemetry::ImageStageCommand<TOutputImage>
+::ComputeSize(itk::ProcessObject *filter, double &bytes, double &work)
+{
+  const unsigned int Dimension = TOutputImage::ImageDimension;
+  const TOutputImage *output = dynamic_cast<itk::ImageSource<TOutputImage> *>(filter)->GetOutput();
+  const double pixels = output->GetRequestedRegion().GetNumberOfPixels();
+  bytes = pixels * sizeof(typename TOutputImage::PixelType);
+  work = pixels;
+
+  // Backprojection: each voxel is updated once per projection
+  if(this->m_WorkType == VOXEL_UPDATES && filter->GetInputs().size()>1)
+    {
+    const itk::ImageBase<Dimension> *projections;
+    projections = dynamic_cast<const itk::ImageBase<Dimension> *>(filter->GetInputs()[1].GetPointer());
+    if(projections)
+      work *= projections->GetRequestedRegion().GetSize(Dimension-1);
+    }
+}
+
+} // end namespace rtk
+
+#endif
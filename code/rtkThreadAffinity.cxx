@@ -0,0 +1,317 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkThreadAffinity.h"
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#  include <sched.h>
+#  include <pthread.h>
+#  include <dirent.h>
+#endif
+
+namespace rtk
+{
+
+ThreadAffinity::PolicyType ThreadAffinity::m_Policy = ThreadAffinity::NONE;
+bool ThreadAffinity::m_ReplicateReadOnlyData = false;
+
+namespace
+{
+/** Parse a sysfs cpu list, e.g., "0-3,8-11" */
+std::vector<int> ParseCPUList(const char *list)
+{
+  std::vector<int> cpus;
+  const char *p = list;
+  while(*p)
+    {
+    int first, last, n;
+    if(sscanf(p, "%d-%d%n", &first, &last, &n) == 2)
+      ;
+    else if(sscanf(p, "%d%n", &first, &n) == 1)
+      last = first;
+    else
+      break;
+    for(int c=first; c<=last; c++)
+      cpus.push_back(c);
+    p += n;
+    if(*p != ',')
+      break;
+    p++;
+    }
+  return cpus;
+}
+
+/** Allowed cores of each node read from sysfs */
+std::vector< std::vector<int> > ReadTopology()
+{
+  std::vector< std::vector<int> > topology;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    {
+    for(int c=0; c<CPU_SETSIZE; c++)
+      CPU_SET(c, &allowed);
+    }
+
+  // Nodes from sysfs, keeping only the allowed cores
+  DIR *dir = opendir("/sys/devices/system/node");
+  if(dir != NULL)
+    {
+    struct dirent *entry;
+    std::vector< std::pair<int, std::vector<int> > > nodes;
+    while( (entry = readdir(dir)) != NULL )
+      {
+      int node;
+      char tail;
+      if(sscanf(entry->d_name, "node%d%c", &node, &tail) != 1)
+        continue;
+      char path[256];
+      sprintf(path, "/sys/devices/system/node/node%d/cpulist", node);
+      FILE *file = fopen(path, "r");
+      if(file == NULL)
+        continue;
+      char list[4096];
+      if(fgets(list, sizeof(list), file) != NULL)
+        {
+        std::vector<int> cpus = ParseCPUList(list);
+        std::vector<int> allowedCpus;
+        for(unsigned int i=0; i<cpus.size(); i++)
+          if(cpus[i]<CPU_SETSIZE && CPU_ISSET(cpus[i], &allowed))
+            allowedCpus.push_back(cpus[i]);
+        if(allowedCpus.size())
+          nodes.push_back( std::make_pair(node, allowedCpus) );
+        }
+      fclose(file);
+      }
+    closedir(dir);
+    std::sort(nodes.begin(), nodes.end());
+    for(unsigned int i=0; i<nodes.size(); i++)
+      topology.push_back(nodes[i].second);
+    }
+
+  // No NUMA information, e.g., kernel without NUMA support
+  if(topology.empty())
+    {
+    topology.resize(1);
+    for(int c=0; c<CPU_SETSIZE; c++)
+      if(CPU_ISSET(c, &allowed))
+        topology[0].push_back(c);
+    }
+#else
+  topology.resize(1);
+#endif
+  return topology;
+}
+} // end anonymous namespace
+
+void
+ThreadAffinity
+::SetPolicy(const PolicyType policy)
+{
+  // The topology is read once here, before any thread needs it
+  GetTopology();
+  m_Policy = policy;
+}
+
+ThreadAffinity::PolicyType
+ThreadAffinity
+::GetPolicy()
+{
+  return m_Policy;
+}
+
+ThreadAffinity::PolicyType
+ThreadAffinity
+::GetPolicyFromName(const std::string &name)
+{
+  if(name == "spread")
+    return SPREAD;
+  if(name == "compact")
+    return COMPACT;
+  return NONE;
+}
+
+const std::vector< std::vector<int> > &
+ThreadAffinity
+::GetTopology()
+{
+  // Read at the first call, which is done by SetPolicy before any thread is
+  // started, and then constant, so no lock is needed on the per projection
+  // calls of GetCurrentNode
+  static const std::vector< std::vector<int> > topology = ReadTopology();
+  return topology;
+}
+
+unsigned int
+ThreadAffinity
+::GetNumberOfNodes()
+{
+  return GetTopology().size();
+}
+
+int
+ThreadAffinity
+::GetNodeOfThread(const ThreadIdType threadId, const ThreadIdType numberOfThreads)
+{
+  if(m_Policy == NONE)
+    return -1;
+
+  const std::vector< std::vector<int> > &topology = GetTopology();
+  const unsigned int nNodes = topology.size();
+  const unsigned int nThreads = std::max((unsigned int)numberOfThreads, 1u);
+  switch(m_Policy)
+    {
+    case SPREAD:
+      // Consecutive threads, which process consecutive blocks of tiles, on
+      // the same node
+      return (unsigned long)threadId * nNodes / nThreads;
+    case COMPACT:
+      {
+      unsigned int t = threadId;
+      unsigned int nCores = 0;
+      for(unsigned int n=0; n<nNodes; n++)
+        nCores += topology[n].size();
+      if(nCores)
+        t %= nCores;
+      for(unsigned int n=0; n<nNodes; n++)
+        {
+        if(t<topology[n].size())
+          return n;
+        t -= topology[n].size();
+        }
+      return 0;
+      }
+    default:
+      return -1;
+    }
+}
+
+int
+ThreadAffinity
+::GetCoreOfThread(const ThreadIdType threadId, const ThreadIdType numberOfThreads)
+{
+  const int node = GetNodeOfThread(threadId, numberOfThreads);
+  if(node<0)
+    return -1;
+  const std::vector<int> &cores = GetTopology()[node];
+  if(cores.empty())
+    return -1;
+
+  // Rank of the thread among the threads of its node
+  unsigned int rank = threadId;
+  if(m_Policy == SPREAD)
+    {
+    const unsigned int nNodes = GetTopology().size();
+    const unsigned int nThreads = std::max((unsigned int)numberOfThreads, 1u);
+    rank -= ((unsigned long)node * nThreads + nNodes - 1) / nNodes;
+    }
+  else
+    {
+    // Threads wrap around the cores of all nodes as in GetNodeOfThread
+    const std::vector< std::vector<int> > &topology = GetTopology();
+    unsigned int nCores = 0;
+    for(unsigned int n=0; n<topology.size(); n++)
+      nCores += topology[n].size();
+    rank %= nCores;
+    for(int n=0; n<node; n++)
+      rank -= topology[n].size();
+    }
+  return cores[rank % cores.size()];
+}
+
+unsigned int
+ThreadAffinity
+::GetCurrentNode()
+{
+#ifdef __linux__
+  const std::vector< std::vector<int> > &topology = GetTopology();
+  if(topology.size()<2)
+    return 0;
+  const int cpu = sched_getcpu();
+  for(unsigned int n=0; n<topology.size(); n++)
+    if( std::find(topology[n].begin(), topology[n].end(), cpu) != topology[n].end() )
+      return n;
+#endif
+  return 0;
+}
+
+void
+ThreadAffinity
+::SetReplicateReadOnlyData(const bool replicate)
+{
+  m_ReplicateReadOnlyData = replicate;
+}
+
+bool
+ThreadAffinity
+::GetReplicateReadOnlyData()
+{
+  return m_ReplicateReadOnlyData;
+}
+
+unsigned int
+ThreadAffinity
+::GetNumberOfReplicas()
+{
+  if(m_Policy == NONE || !m_ReplicateReadOnlyData)
+    return 1;
+  return GetNumberOfNodes();
+}
+
+ThreadAffinity::ScopedPinning
+::ScopedPinning(const ThreadIdType threadId, const ThreadIdType numberOfThreads):
+  m_Pinned(false)
+{
+#ifdef __linux__
+  const int core = GetCoreOfThread(threadId, numberOfThreads);
+  if(core<0)
+    return;
+  cpu_set_t previous;
+  if(pthread_getaffinity_np(pthread_self(), sizeof(previous), &previous) != 0)
+    return;
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(core, &mask);
+  if(pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) != 0)
+    return;
+  m_PreviousAffinity.resize(sizeof(previous));
+  memcpy(&(m_PreviousAffinity[0]), &previous, sizeof(previous));
+  m_Pinned = true;
+#else
+  (void)threadId;
+  (void)numberOfThreads;
+#endif
+}
+
+ThreadAffinity::ScopedPinning
+::~ScopedPinning()
+{
+#ifdef __linux__
+  if(!m_Pinned)
+    return;
+  cpu_set_t previous;
+  memcpy(&previous, &(m_PreviousAffinity[0]), sizeof(previous));
+  pthread_setaffinity_np(pthread_self(), sizeof(previous), &previous);
+#endif
+}
+
+} // end namespace rtk
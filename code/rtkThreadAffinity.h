@@ -0,0 +1,112 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkThreadAffinity_h
+#define __rtkThreadAffinity_h
+
+#include <string>
+#include <algorithm>
+#include <vector>
+
+#include "rtkConfiguration.h"
+
+namespace rtk
+{
+
+/** \class ThreadAffinity
+ *
+ * Process-wide pinning of the worker threads to cores, to keep the pages
+ * first touched by a thread on the NUMA node where the same thread later
+ * works on them. Thread threadId of numberOfThreads is always pinned to the
+ * same core so that rtk::ConstantImageSource and the projectors, which use
+ * the same partition of the volume in tiles (see
+ * rtk::WorkStealingScheduler), find their tiles in local memory. With the
+ * SPREAD policy, consecutive threads are grouped on the same node and the
+ * threads are evenly split between nodes. With the COMPACT policy, the cores
+ * of a node are used before those of the next node. The default policy,
+ * NONE, leaves scheduling to the operating system.
+ *
+ * The topology is read from /sys/devices/system/node and restricted to the
+ * cores allowed to the process. Pinning is only implemented on Linux, all
+ * cores are on a single node otherwise.
+ *
+ * \author Simon Rit
+ */
+class ThreadAffinity
+{
+public:
+  typedef enum {NONE=0, SPREAD, COMPACT} PolicyType;
+
+  /** Set / Get the pinning policy of all RTK filters */
+  static void SetPolicy(const PolicyType policy);
+  static PolicyType GetPolicy();
+
+  /** Policy from its lower case name, NONE if unknown */
+  static PolicyType GetPolicyFromName(const std::string &name);
+
+  /** Number of NUMA nodes with at least one allowed core */
+  static unsigned int GetNumberOfNodes();
+
+  /** Node and core of thread threadId of numberOfThreads with the current
+   * policy, -1 if the policy is NONE */
+  static int GetNodeOfThread(const ThreadIdType threadId, const ThreadIdType numberOfThreads);
+  static int GetCoreOfThread(const ThreadIdType threadId, const ThreadIdType numberOfThreads);
+
+  /** Node of the core on which the calling thread runs */
+  static unsigned int GetCurrentNode();
+
+  /** Set / Get the replication of read-only data shared by all threads,
+   * e.g., the projections of the backprojectors, on each node. Off by
+   * default since it multiplies the memory of these data by the number of
+   * nodes. */
+  static void SetReplicateReadOnlyData(const bool replicate);
+  static bool GetReplicateReadOnlyData();
+
+  /** Number of copies of read-only data shared by all threads, which is the
+   * number of nodes when threads are pinned and replication is on, 1
+   * otherwise. */
+  static unsigned int GetNumberOfReplicas();
+
+  /** \class ScopedPinning
+   * Pins the calling thread according to the policy in the constructor and
+   * restores its previous affinity in the destructor. The restoration matters
+   * for the thread of itk::MultiThreader which is the calling thread, its
+   * affinity being inherited by all threads created later. */
+  class ScopedPinning
+  {
+  public:
+    ScopedPinning(const ThreadIdType threadId, const ThreadIdType numberOfThreads);
+    ~ScopedPinning();
+  private:
+    ScopedPinning(const ScopedPinning&);  //purposely not implemented
+    void operator=(const ScopedPinning&); //purposely not implemented
+    bool                m_Pinned;
+    std::vector<char>   m_PreviousAffinity;
+  };
+
+private:
+  /** Allowed cores of each node, read once */
+  static const std::vector< std::vector<int> > &GetTopology();
+
+  static PolicyType m_Policy;
+  static bool       m_ReplicateReadOnlyData;
+};
+
+} // end namespace rtk
+
+#endif
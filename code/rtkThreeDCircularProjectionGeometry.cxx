@@ -20,7 +20,7 @@
 #include "rtkMacro.h"
 
 #include <algorithm>
-#include <itkCenteredEuler3DTransform.h>
+#include <vnl/vnl_math.h>
 
 double rtk::ThreeDCircularProjectionGeometry::ConvertAngleBetween0And360Degrees(const double a)
 {
@@ -34,6 +34,110 @@ void rtk::ThreeDCircularProjectionGeometry::AddProjection(
   const double projOffsetX, const double projOffsetY,
   const double outOfPlaneAngle, const double inPlaneAngle,
   const double sourceOffsetX, const double sourceOffsetY)
+{
+  // If the derived quantities are up to date, they are extended with the new
+  // projection instead of being recomputed for all projections at the next
+  // request so that adding projections one by one, e.g. during an inline
+  // acquisition, is amortized O(1). The check and the update are done under
+  // the lock of the cache, like in UpdateCache. Modified() is called after
+  // the lock is released because observers may access the cache.
+  m_CacheLock.Lock();
+  const unsigned long cacheMTime = m_CacheMTime;
+  const bool cacheIsUpToDate = (cacheMTime == this->GetMTime());
+
+  AppendProjection(sid, sdd, gantryAngle, projOffsetX, projOffsetY,
+                   outOfPlaneAngle, inPlaneAngle, sourceOffsetX, sourceOffsetY);
+  if(cacheIsUpToDate)
+    AppendToCache();
+  m_CacheLock.Unlock();
+
+  this->Modified();
+
+  // Mark the extended cache as current unless it has been recomputed in the
+  // meantime, e.g., by an observer
+  if(cacheIsUpToDate)
+    {
+    m_CacheLock.Lock();
+    if(m_CacheMTime == cacheMTime)
+      m_CacheMTime = this->GetMTime();
+    m_CacheLock.Unlock();
+    }
+}
+
+void rtk::ThreeDCircularProjectionGeometry::AddProjections(
+  const std::vector<double> &sids,
+  const std::vector<double> &sdds,
+  const std::vector<double> &gantryAngles,
+  const std::vector<double> &projOffsetsX,
+  const std::vector<double> &projOffsetsY,
+  const std::vector<double> &outOfPlaneAngles,
+  const std::vector<double> &inPlaneAngles,
+  const std::vector<double> &sourceOffsetsX,
+  const std::vector<double> &sourceOffsetsY)
+{
+  const size_t n = gantryAngles.size();
+  if(sids.size() != n || sdds.size() != n ||
+     projOffsetsX.size() != n || projOffsetsY.size() != n ||
+     outOfPlaneAngles.size() != n || inPlaneAngles.size() != n ||
+     sourceOffsetsX.size() != n || sourceOffsetsY.size() != n)
+    itkExceptionMacro(<< "All parameter vectors must have the same size.");
+
+  // Parameters
+  ComputeMatricesRange range;
+  range.Geometry = this;
+  range.First = m_GantryAngles.size();
+  range.End = range.First + n;
+  const size_t size = range.End;
+  m_GantryAngles.reserve(size);
+  m_OutOfPlaneAngles.reserve(size);
+  m_InPlaneAngles.reserve(size);
+  for(size_t i=0; i<n; i++)
+    {
+    m_GantryAngles.push_back( ConvertAngleBetween0And360Degrees(gantryAngles[i]) );
+    m_OutOfPlaneAngles.push_back( ConvertAngleBetween0And360Degrees(outOfPlaneAngles[i]) );
+    m_InPlaneAngles.push_back( ConvertAngleBetween0And360Degrees(inPlaneAngles[i]) );
+    }
+  m_SourceToIsocenterDistances.insert(m_SourceToIsocenterDistances.end(), sids.begin(), sids.end());
+  m_SourceOffsetsX.insert(m_SourceOffsetsX.end(), sourceOffsetsX.begin(), sourceOffsetsX.end());
+  m_SourceOffsetsY.insert(m_SourceOffsetsY.end(), sourceOffsetsY.begin(), sourceOffsetsY.end());
+  m_SourceToDetectorDistances.insert(m_SourceToDetectorDistances.end(), sdds.begin(), sdds.end());
+  m_ProjectionOffsetsX.insert(m_ProjectionOffsetsX.end(), projOffsetsX.begin(), projOffsetsX.end());
+  m_ProjectionOffsetsY.insert(m_ProjectionOffsetsY.end(), projOffsetsY.begin(), projOffsetsY.end());
+
+  // Matrices, computed in parallel for large numbers of projections
+  m_ProjectionTranslationMatrices.resize(size);
+  m_MagnificationMatrices.resize(size);
+  m_RotationMatrices.resize(size);
+  m_SourceTranslationMatrices.resize(size);
+  this->GetModifiableMatrices().resize(size);
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( vnl_math_min((unsigned int)(n/256+1),
+                                             (unsigned int)threader->GetNumberOfThreads()) );
+  threader->SetSingleMethod(ComputeMatricesCallback, &range);
+  threader->SingleMethodExecute();
+
+  this->Modified();
+}
+
+ITK_THREAD_RETURN_TYPE
+rtk::ThreeDCircularProjectionGeometry::ComputeMatricesCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const ComputeMatricesRange *range = static_cast<ComputeMatricesRange *>(info->UserData);
+
+  const unsigned int n = range->End - range->First;
+  const unsigned int begin = range->First + (n * info->ThreadID) / info->NumberOfThreads;
+  const unsigned int end = range->First + (n * (info->ThreadID+1)) / info->NumberOfThreads;
+  for(unsigned int i=begin; i<end; i++)
+    range->Geometry->ComputeMatrices(i);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void rtk::ThreeDCircularProjectionGeometry::AppendProjection(
+  const double sid, const double sdd, const double gantryAngle,
+  const double projOffsetX, const double projOffsetY,
+  const double outOfPlaneAngle, const double inPlaneAngle,
+  const double sourceOffsetX, const double sourceOffsetY)
 {
   // Detector orientation parameters
   m_GantryAngles.push_back( ConvertAngleBetween0And360Degrees(gantryAngle) );
@@ -50,21 +154,36 @@ void rtk::ThreeDCircularProjectionGeometry::AddProjection(
   m_ProjectionOffsetsX.push_back( projOffsetX );
   m_ProjectionOffsetsY.push_back( projOffsetY );
 
-  // Compute sub-matrices
-  AddProjectionTranslationMatrix( ComputeTranslationHomogeneousMatrix(sourceOffsetX-projOffsetX, sourceOffsetY-projOffsetY) );
-  AddMagnificationMatrix( ComputeProjectionMagnificationMatrix(-sdd, -sid) );
-  AddRotationMatrix( ComputeRotationHomogeneousMatrix(-outOfPlaneAngle, -gantryAngle, -inPlaneAngle) );
-  AddSourceTranslationMatrix( ComputeTranslationHomogeneousMatrix(-sourceOffsetX, -sourceOffsetY, 0.) );
+  // Sub-matrices and projection matrix
+  const unsigned int size = m_GantryAngles.size();
+  m_ProjectionTranslationMatrices.resize(size);
+  m_MagnificationMatrices.resize(size);
+  m_RotationMatrices.resize(size);
+  m_SourceTranslationMatrices.resize(size);
+  this->GetModifiableMatrices().resize(size);
+  ComputeMatrices(size-1);
+}
 
-  Superclass::MatrixType matrix;
-  matrix =
-    this->GetProjectionTranslationMatrices().back().GetVnlMatrix() *
-    this->GetMagnificationMatrices().back().GetVnlMatrix() *
-    this->GetSourceTranslationMatrices().back().GetVnlMatrix()*
-    this->GetRotationMatrices().back().GetVnlMatrix();
+void rtk::ThreeDCircularProjectionGeometry::ComputeMatrices(const unsigned int i)
+{
+  const double sid = m_SourceToIsocenterDistances[i];
+  const double sdd = m_SourceToDetectorDistances[i];
+  const double sourceOffsetX = m_SourceOffsetsX[i];
+  const double sourceOffsetY = m_SourceOffsetsY[i];
+  const double projOffsetX = m_ProjectionOffsetsX[i];
+  const double projOffsetY = m_ProjectionOffsetsY[i];
 
-  this->AddMatrix(matrix);
-  this->Modified();
+  // Compute sub-matrices
+  m_ProjectionTranslationMatrices[i] = ComputeTranslationHomogeneousMatrix(sourceOffsetX-projOffsetX, sourceOffsetY-projOffsetY);
+  m_MagnificationMatrices[i] = ComputeProjectionMagnificationMatrix(-sdd, -sid);
+  m_RotationMatrices[i] = ComputeRotationHomogeneousMatrix(-m_OutOfPlaneAngles[i], -m_GantryAngles[i], -m_InPlaneAngles[i]);
+  m_SourceTranslationMatrices[i] = ComputeTranslationHomogeneousMatrix(-sourceOffsetX, -sourceOffsetY, 0.);
+
+  this->GetModifiableMatrices()[i] =
+    m_ProjectionTranslationMatrices[i].GetVnlMatrix() *
+    m_MagnificationMatrices[i].GetVnlMatrix() *
+    m_SourceTranslationMatrices[i].GetVnlMatrix()*
+    m_RotationMatrices[i].GetVnlMatrix();
 }
 
 void rtk::ThreeDCircularProjectionGeometry::Clear()
@@ -83,98 +202,125 @@ void rtk::ThreeDCircularProjectionGeometry::Clear()
   m_MagnificationMatrices.clear();
   m_RotationMatrices.clear();
   m_SourceTranslationMatrices.clear();
+  this->GetModifiableMatrices().clear();
   this->Modified();
 }
 
 
-const std::multimap<double,unsigned int> rtk::ThreeDCircularProjectionGeometry::GetSortedAngles()
+void rtk::ThreeDCircularProjectionGeometry::UpdateCache() const
 {
-  unsigned int nProj = this->GetGantryAngles().size();
-  std::multimap<double,unsigned int> angles;
-  for(unsigned int iProj=0; iProj<nProj; iProj++)
+  // The time stamp is only read under the lock, the accessors are called per
+  // projection so the cost of the lock is negligible
+  m_CacheLock.Lock();
+  if(m_CacheMTime != this->GetMTime())
     {
-    double angle = this->GetGantryAngles()[iProj];
-    angles.insert(std::pair<double, unsigned int>(angle, iProj) );
+    const unsigned int nProj = m_GantryAngles.size();
+
+    // Source positions and projection to fixed system matrices
+    m_InverseRotationMatrices.resize(nProj);
+    m_SourcePositions.resize(nProj);
+    m_ProjectionCoordinatesToFixedSystemMatrices.resize(nProj);
+    for(unsigned int i=0; i<nProj; i++)
+      ComputeCache(i);
+
+    // Sorted angles
+    m_SortedAngles.clear();
+    for(unsigned int i=0; i<nProj; i++)
+      m_SortedAngles.insert(std::pair<double, unsigned int>(m_GantryAngles[i], i) );
+    m_SortedAnglesPermutation.clear();
+    m_SortedAnglesPermutation.reserve(nProj);
+    std::multimap<double,unsigned int>::const_iterator it;
+    for(it=m_SortedAngles.begin(); it!=m_SortedAngles.end(); it++)
+      m_SortedAnglesPermutation.push_back(it->second);
+
+    // Angular gaps
+    ComputeAngularGaps();
+
+    m_CacheMTime = this->GetMTime();
     }
-  return angles;
+  m_CacheLock.Unlock();
 }
 
-const std::vector<double> rtk::ThreeDCircularProjectionGeometry::GetAngularGapsWithNext()
+void rtk::ThreeDCircularProjectionGeometry::ComputeCache(const unsigned int i) const
 {
-  std::vector<double> angularGaps;
-  unsigned int        nProj = this->GetGantryAngles().size();
-  angularGaps.resize(nProj);
-
-  // Special management of single or empty dataset
-  const double degreesToRadians = vcl_atan(1.0) / 45.0;
-  if(nProj==1)
-    angularGaps[0] = degreesToRadians * 360;
-  if(nProj<2)
-    return angularGaps;
+  m_InverseRotationMatrices[i] = m_RotationMatrices[i].GetInverse();
 
-  // Otherwise we sort the angles in a multimap
-  std::multimap<double,unsigned int> angles = this->GetSortedAngles();
+  HomogeneousVectorType sourcePosition;
+  sourcePosition[0] = m_SourceOffsetsX[i];
+  sourcePosition[1] = m_SourceOffsetsY[i];
+  sourcePosition[2] = m_SourceToIsocenterDistances[i];
+  sourcePosition[3] = 1.;
+  m_SourcePositions[i] = m_InverseRotationMatrices[i] * sourcePosition;
 
-  // We then go over the sorted angles and deduce the angular weight
-  std::multimap<double,unsigned int>::const_iterator curr = angles.begin(), next = angles.begin();
-  next++;
+  ThreeDHomogeneousMatrixType matrix;
+  matrix.SetIdentity();
+  matrix[0][3] = m_ProjectionOffsetsX[i];
+  matrix[1][3] = m_ProjectionOffsetsY[i];
+  matrix[2][3] = m_SourceToIsocenterDistances[i]-m_SourceToDetectorDistances[i];
+  matrix[2][2] = 0.; // Force z to axis to detector distance
+  m_ProjectionCoordinatesToFixedSystemMatrices[i] = m_InverseRotationMatrices[i] * matrix;
+}
 
-  // All but the last projection
-  while(next!=angles.end() )
+void rtk::ThreeDCircularProjectionGeometry::AppendToCache() const
+{
+  const unsigned int nProj = m_GantryAngles.size();
+  const unsigned int i = nProj-1;
+
+  // Source position and projection to fixed system matrix
+  m_InverseRotationMatrices.resize(nProj);
+  m_SourcePositions.resize(nProj);
+  m_ProjectionCoordinatesToFixedSystemMatrices.resize(nProj);
+  ComputeCache(i);
+
+  // Sorted angles: the new projection goes after the projections with the
+  // same angle, which is the end for increasing angles
+  m_SortedAngles.insert(std::pair<double, unsigned int>(m_GantryAngles[i], i) );
+  unsigned int k = m_SortedAnglesPermutation.size();
+  while(k>0 && m_GantryAngles[m_SortedAnglesPermutation[k-1]] > m_GantryAngles[i])
+    k--;
+  m_SortedAnglesPermutation.insert(m_SortedAnglesPermutation.begin()+k, i);
+
+  // Angular gaps: only the neighbours of the new projection in the sorted
+  // order and the two ends, which wrap around, change. Small and parallel
+  // geometries are recomputed, see ComputeAngularGaps.
+  if(nProj<4 || m_SourceToDetectorDistances[0]==0.)
     {
-    angularGaps[curr->second] = degreesToRadians * ( next->first - curr->first );
-    curr++; next++;
+    ComputeAngularGaps();
+    return;
     }
-
-  //Last projection wraps the angle of the first one
-  angularGaps[curr->second] = 0.5 * degreesToRadians * ( angles.begin()->first + 360 - curr->first );
-
-  return angularGaps;
+  m_AngularGapsWithNext.resize(nProj);
+  m_AngularGaps.resize(nProj);
+  const unsigned int positions[6] = {(k>0)?k-1:0, k, vnl_math_min(k+1, nProj-1), 0, nProj-2, nProj-1};
+  for(unsigned int j=0; j<6; j++)
+    ComputeAngularGap(positions[j]);
 }
 
-const std::vector<double> rtk::ThreeDCircularProjectionGeometry::GetAngularGaps()
+void rtk::ThreeDCircularProjectionGeometry::ComputeAngularGaps() const
 {
-  std::vector<double> angularGaps;
-  unsigned int        nProj = this->GetGantryAngles().size();
-  angularGaps.resize(nProj);
+  const unsigned int nProj = m_GantryAngles.size();
+  m_AngularGapsWithNext.assign(nProj, 0.);
+  m_AngularGaps.assign(nProj, 0.);
 
   // Special management of single or empty dataset
   const double degreesToRadians = vcl_atan(1.0) / 45.0;
   if(nProj==1)
-    angularGaps[0] = degreesToRadians * 180;
-  if(nProj<2)
-    return angularGaps;
-
-  // Otherwise we sort the angles in a multimap
-  std::multimap<double,unsigned int> angles = this->GetSortedAngles();
-
-  // We then go over the sorted angles and deduce the angular weight
-  std::multimap<double,unsigned int>::const_iterator prev = angles.begin(),
-                                                     curr = angles.begin(),
-                                                     next = angles.begin();
-  next++;
-
-  //First projection wraps the angle of the last one
-  angularGaps[curr->second] = 0.5 * degreesToRadians * ( next->first - angles.rbegin()->first + 360 );
-  curr++; next++;
-
-  //Rest of the angles
-  while(next!=angles.end() )
     {
-    angularGaps[curr->second] = 0.5 * degreesToRadians * ( next->first - prev->first );
-    prev++; curr++; next++;
+    m_AngularGapsWithNext[0] = degreesToRadians * 360;
+    m_AngularGaps[0] = degreesToRadians * 180;
     }
+  if(nProj<2)
+    return;
 
-  //Last projection wraps the angle of the first one
-  angularGaps[curr->second] = 0.5 * degreesToRadians * ( angles.begin()->first + 360 - prev->first );
+  for(unsigned int i=0; i<nProj; i++)
+    ComputeAngularGap(i);
 
   // FIXME: Trick for the half scan in parallel geometry case
   if(m_SourceToDetectorDistances[0]==0.)
     {
-    std::vector<double>::iterator it = std::max_element(angularGaps.begin(), angularGaps.end());
+    std::vector<double>::iterator it = std::max_element(m_AngularGaps.begin(), m_AngularGaps.end());
     if(*it>itk::Math::pi_over_2)
       {
-      for(it=angularGaps.begin(); it<angularGaps.end(); it++)
+      for(it=m_AngularGaps.begin(); it<m_AngularGaps.end(); it++)
         {
         if(*it>itk::Math::pi_over_2)
           *it -= itk::Math::pi_over_2;
@@ -182,8 +328,78 @@ const std::vector<double> rtk::ThreeDCircularProjectionGeometry::GetAngularGaps(
         }
       }
     }
+}
+
+void rtk::ThreeDCircularProjectionGeometry::ComputeAngularGap(const unsigned int i) const
+{
+  const unsigned int nProj = m_GantryAngles.size();
+  const std::vector<unsigned int> &s = m_SortedAnglesPermutation;
+  const std::vector<double> &a = m_GantryAngles;
+  const double degreesToRadians = vcl_atan(1.0) / 45.0;
+
+  // Gap with next, the last projection wraps the angle of the first one
+  if(i<nProj-1)
+    m_AngularGapsWithNext[s[i]] = degreesToRadians * ( a[s[i+1]] - a[s[i]] );
+  else
+    m_AngularGapsWithNext[s[i]] = 0.5 * degreesToRadians * ( a[s[0]] + 360 - a[s[i]] );
+
+  // Half gap between previous and next, the first and the last projections
+  // wrap around
+  if(i==0)
+    m_AngularGaps[s[i]] = 0.5 * degreesToRadians * ( a[s[1]] - a[s[nProj-1]] + 360 );
+  else if(i<nProj-1)
+    m_AngularGaps[s[i]] = 0.5 * degreesToRadians * ( a[s[i+1]] - a[s[i-1]] );
+  else
+    m_AngularGaps[s[i]] = 0.5 * degreesToRadians * ( a[s[0]] + 360 - a[s[i-1]] );
+}
+
+const std::multimap<double,unsigned int> &
+rtk::ThreeDCircularProjectionGeometry::GetSortedAngles() const
+{
+  this->UpdateCache();
+  return m_SortedAngles;
+}
+
+const std::vector<unsigned int> &
+rtk::ThreeDCircularProjectionGeometry::GetSortedAnglesPermutation() const
+{
+  this->UpdateCache();
+  return m_SortedAnglesPermutation;
+}
+
+const std::vector<double> &
+rtk::ThreeDCircularProjectionGeometry::GetAngularGapsWithNext() const
+{
+  this->UpdateCache();
+  return m_AngularGapsWithNext;
+}
+
+const std::vector<double> &
+rtk::ThreeDCircularProjectionGeometry::GetAngularGaps() const
+{
+  this->UpdateCache();
+  return m_AngularGaps;
+}
+
+const std::vector<rtk::ThreeDCircularProjectionGeometry::HomogeneousVectorType> &
+rtk::ThreeDCircularProjectionGeometry::GetSourcePositions() const
+{
+  this->UpdateCache();
+  return m_SourcePositions;
+}
 
-  return angularGaps;
+const std::vector<rtk::ThreeDCircularProjectionGeometry::ThreeDHomogeneousMatrixType> &
+rtk::ThreeDCircularProjectionGeometry::GetProjectionCoordinatesToFixedSystemMatrices() const
+{
+  this->UpdateCache();
+  return m_ProjectionCoordinatesToFixedSystemMatrices;
+}
+
+const std::vector<rtk::ThreeDCircularProjectionGeometry::ThreeDHomogeneousMatrixType> &
+rtk::ThreeDCircularProjectionGeometry::GetInverseRotationMatrices() const
+{
+  this->UpdateCache();
+  return m_InverseRotationMatrices;
 }
 
 rtk::ThreeDCircularProjectionGeometry::ThreeDHomogeneousMatrixType
@@ -193,17 +409,26 @@ ComputeRotationHomogeneousMatrix(double angleX,
                                  double angleZ)
 {
   const double degreesToRadians = vcl_atan(1.0) / 45.0;
-
-  typedef itk::CenteredEuler3DTransform<double> ThreeDTransformType;
-  ThreeDTransformType::Pointer xfm = ThreeDTransformType::New();
-  xfm->SetIdentity();
-  xfm->SetRotation( angleX*degreesToRadians, angleY*degreesToRadians, angleZ*degreesToRadians );
-
+  const double cx = vcl_cos(angleX*degreesToRadians);
+  const double sx = vcl_sin(angleX*degreesToRadians);
+  const double cy = vcl_cos(angleY*degreesToRadians);
+  const double sy = vcl_sin(angleY*degreesToRadians);
+  const double cz = vcl_cos(angleZ*degreesToRadians);
+  const double sz = vcl_sin(angleZ*degreesToRadians);
+
+  // Closed form of RotationZ * RotationX * RotationY, i.e., the ZXY
+  // convention of itk::Euler3DTransform
   ThreeDHomogeneousMatrixType matrix;
   matrix.SetIdentity();
-  for(int i=0; i<3; i++)
-    for(int j=0; j<3; j++)
-      matrix[i][j] = xfm->GetMatrix()[i][j];
+  matrix[0][0] = cz*cy - sz*sx*sy;
+  matrix[0][1] = -sz*cx;
+  matrix[0][2] = cz*sy + sz*sx*cy;
+  matrix[1][0] = sz*cy + cz*sx*sy;
+  matrix[1][1] = cz*cx;
+  matrix[1][2] = sz*sy - cz*sx*cy;
+  matrix[2][0] = -cx*sy;
+  matrix[2][1] = sx;
+  matrix[2][2] = cx*cy;
 
   return matrix;
 }
@@ -247,39 +472,6 @@ ComputeProjectionMagnificationMatrix(double sdd, const double sid)
   return matrix;
 }
 
-const rtk::ThreeDCircularProjectionGeometry::HomogeneousVectorType
-rtk::ThreeDCircularProjectionGeometry::
-GetSourcePosition(const unsigned int i) const
-{
-  HomogeneousVectorType sourcePosition;
-  sourcePosition[0] = this->GetSourceOffsetsX()[i];
-  sourcePosition[1] = this->GetSourceOffsetsY()[i];
-  sourcePosition[2] = this->GetSourceToIsocenterDistances()[i];
-  sourcePosition[3] = 1.;
-
-  // Rotate
-  sourcePosition.SetVnlVector(GetRotationMatrices()[i].GetInverse() * sourcePosition.GetVnlVector());
-  return sourcePosition;
-}
-
-const rtk::ThreeDCircularProjectionGeometry::ThreeDHomogeneousMatrixType
-rtk::ThreeDCircularProjectionGeometry::
-GetProjectionCoordinatesToFixedSystemMatrix(const unsigned int i) const
-{
-  // Compute projection inverse and distance to source
-  ThreeDHomogeneousMatrixType matrix;
-  matrix.SetIdentity();
-  matrix[0][3] = this->GetProjectionOffsetsX()[i];
-  matrix[1][3] = this->GetProjectionOffsetsY()[i];
-  matrix[2][3] = this->GetSourceToIsocenterDistances()[i]-this->GetSourceToDetectorDistances()[i];
-  matrix[2][2] = 0.; // Force z to axis to detector distance
-
-  // Rotate
-  matrix = this->GetRotationMatrices()[i].GetInverse() * matrix.GetVnlMatrix();
-  return matrix;
-}
-
-
 double
 rtk::ThreeDCircularProjectionGeometry::
 ToUntiltedCoordinate(const unsigned int noProj,
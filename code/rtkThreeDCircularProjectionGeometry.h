@@ -22,6 +22,10 @@
 #include "rtkWin32Header.h"
 #include "rtkProjectionGeometry.h"
 
+#include <map>
+#include <itkSimpleFastMutexLock.h>
+#include <itkMultiThreader.h>
+
 namespace rtk
 {
 /** \class ThreeDCircularProjectionGeometry
@@ -39,6 +43,15 @@ namespace rtk
  * 
  * If SDD equals 0., then one is dealing with a parallel geometry.
  *
+ * Quantities derived from the parameters (source positions, projection to
+ * fixed system matrices, sorted angles and angular gaps) are computed once
+ * for all projections the first time one of them is requested and kept until
+ * the next modification of the object. The corresponding accessors are
+ * therefore cheap and can be called per projection in threaded code. The
+ * references they return are invalidated by the next modification of the
+ * object, e.g., AddProjection, which must not be called while other threads
+ * use the geometry.
+ *
  * \author Simon Rit
  *
  * \ingroup ProjectionGeometry
@@ -62,12 +75,29 @@ public:
   /** Add projection to geometry. One projection is defined with the rotation
    * angle in degrees and the in-plane translation of the detector in physical
    * units (e.g. mm). The rotation axis is assumed to be (0,1,0).
+   * If the derived quantities are up to date, they are updated for the new
+   * projection only.
    */
   void AddProjection(const double sid, const double sdd, const double gantryAngle,
                      const double projOffsetX=0., const double projOffsetY=0.,
                      const double outOfPlaneAngle=0., const double inPlaneAngle=0.,
                      const double sourceOffsetX=0., const double sourceOffsetY=0.);
 
+  /** Add many projections at once. The vectors contain the parameters of
+   * AddProjection for each projection and must have the same size. This is
+   * equivalent to calling AddProjection for each projection but memory is
+   * allocated once, the matrices are computed in parallel and the object is
+   * modified once. */
+  void AddProjections(const std::vector<double> &sids,
+                      const std::vector<double> &sdds,
+                      const std::vector<double> &gantryAngles,
+                      const std::vector<double> &projOffsetsX,
+                      const std::vector<double> &projOffsetsY,
+                      const std::vector<double> &outOfPlaneAngles,
+                      const std::vector<double> &inPlaneAngles,
+                      const std::vector<double> &sourceOffsetsX,
+                      const std::vector<double> &sourceOffsetsY);
+
   /** Empty the geometry object. */
   void Clear();
 
@@ -101,14 +131,17 @@ public:
   }
 
   /** Get a multimap containing all sorted angles and corresponding index. */
-  const std::multimap<double,unsigned int> GetSortedAngles();
+  const std::multimap<double,unsigned int> &GetSortedAngles() const;
+
+  /** Get the projection indices sorted by increasing gantry angle. */
+  const std::vector<unsigned int> &GetSortedAnglesPermutation() const;
 
   /** Get for each projection the angular gaps with next projection. */
-  const std::vector<double> GetAngularGapsWithNext();
+  const std::vector<double> &GetAngularGapsWithNext() const;
 
   /** Get for each projection half the angular distance between the previous
    *  and the next projection. */
-  const std::vector<double> GetAngularGaps();
+  const std::vector<double> &GetAngularGaps() const;
 
   /** Compute rotation matrix in homogeneous coordinates from 3 angles in
    * degrees. The convention is the default in itk, i.e. ZXY of Euler angles.*/
@@ -148,14 +181,24 @@ public:
 
   /** Get the source position for the ith projection in the fixed reference
    * system and in homogeneous coordinates. */
-  const HomogeneousVectorType GetSourcePosition(const unsigned int i) const;
+  const HomogeneousVectorType &GetSourcePosition(const unsigned int i) const {
+    return this->GetSourcePositions()[i];
+  }
+  const std::vector<HomogeneousVectorType> &GetSourcePositions() const;
 
   /** Compute the ith matrix to convert projection coordinates to coordinates
    * in the fixed coordinate system. Note that the matrix is square but the
    * third element of the projection coordinates is ignored because projection
    * coordinates are 2D. This is meant to manipulate more easily stack of
    * projection images. */
-  const ThreeDHomogeneousMatrixType GetProjectionCoordinatesToFixedSystemMatrix(const unsigned int i) const;
+  const ThreeDHomogeneousMatrixType &GetProjectionCoordinatesToFixedSystemMatrix(const unsigned int i) const {
+    return this->GetProjectionCoordinatesToFixedSystemMatrices()[i];
+  }
+  const std::vector<ThreeDHomogeneousMatrixType> &GetProjectionCoordinatesToFixedSystemMatrices() const;
+
+  /** Get the inverse of the rotation matrices, i.e., the rotation from the
+   * rotating to the fixed coordinate system. */
+  const std::vector<ThreeDHomogeneousMatrixType> &GetInverseRotationMatrices() const;
 
   /** This function wraps an angle value between 0 and 360 degrees. */
   static double ConvertAngleBetween0And360Degrees(const double a);
@@ -169,25 +212,48 @@ public:
                               const double tiltedCoord) const;
 
 protected:
-  ThreeDCircularProjectionGeometry() {};
+  ThreeDCircularProjectionGeometry():m_CacheMTime(0) {};
   virtual ~ThreeDCircularProjectionGeometry() {};
 
-  virtual void AddProjectionTranslationMatrix(const TwoDHomogeneousMatrixType &m){
-    this->m_ProjectionTranslationMatrices.push_back(m);
-    this->Modified();
-  }
-  virtual void AddRotationMatrix(const ThreeDHomogeneousMatrixType &m){
-    this->m_RotationMatrices.push_back(m);
-    this->Modified();
-  }
-  virtual void AddSourceTranslationMatrix(const ThreeDHomogeneousMatrixType &m){
-    this->m_SourceTranslationMatrices.push_back(m);
-    this->Modified();
-  }
-  virtual void AddMagnificationMatrix(const Superclass::MatrixType &m){
-    this->m_MagnificationMatrices.push_back(m);
-    this->Modified();
-  }
+  /** Recompute all derived quantities if the object has been modified since
+   * the last computation. Thread safe, the check is done under m_CacheLock. */
+  void UpdateCache() const;
+
+  /** Compute the derived quantities of projection i. */
+  void ComputeCache(const unsigned int i) const;
+
+  /** Update the derived quantities after the addition of one projection. */
+  void AppendToCache() const;
+
+  /** Compute the angular gaps from the sorted angles. Called by UpdateCache(). */
+  void ComputeAngularGaps() const;
+
+  /** Compute the angular gaps of the projection at position i in the sorted
+   * angles, at least 2 projections. */
+  void ComputeAngularGap(const unsigned int i) const;
+
+  /** Compute the sub-matrices and the projection matrix of projection i from
+   * its parameters. */
+  void ComputeMatrices(const unsigned int i);
+
+  /** Range of projections passed to ComputeMatricesCallback. */
+  struct ComputeMatricesRange
+    {
+    Self *       Geometry;
+    unsigned int First;
+    unsigned int End;
+    };
+
+  /** Thread callback computing the matrices of the projections of the
+   * ComputeMatricesRange passed as user data. */
+  static ITK_THREAD_RETURN_TYPE ComputeMatricesCallback(void *arg);
+
+  /** Add the parameters and the matrices of one projection without
+   * modifying the object. */
+  void AppendProjection(const double sid, const double sdd, const double gantryAngle,
+                        const double projOffsetX, const double projOffsetY,
+                        const double outOfPlaneAngle, const double inPlaneAngle,
+                        const double sourceOffsetX, const double sourceOffsetY);
 
   /** Circular geometry parameters per projection (angles in degrees between 0
     and 360). */
@@ -206,6 +272,17 @@ protected:
   std::vector<ThreeDHomogeneousMatrixType>       m_RotationMatrices;
   std::vector<ThreeDHomogeneousMatrixType>       m_SourceTranslationMatrices;
 
+  /** Quantities derived from the parameters above, see UpdateCache(). */
+  mutable std::vector<ThreeDHomogeneousMatrixType> m_InverseRotationMatrices;
+  mutable std::vector<HomogeneousVectorType>       m_SourcePositions;
+  mutable std::vector<ThreeDHomogeneousMatrixType> m_ProjectionCoordinatesToFixedSystemMatrices;
+  mutable std::multimap<double,unsigned int>       m_SortedAngles;
+  mutable std::vector<unsigned int>                m_SortedAnglesPermutation;
+  mutable std::vector<double>                      m_AngularGapsWithNext;
+  mutable std::vector<double>                      m_AngularGaps;
+  mutable unsigned long                            m_CacheMTime;
+  mutable itk::SimpleFastMutexLock                 m_CacheLock;
+
 private:
   ThreeDCircularProjectionGeometry(const Self&); //purposely not implemented
   void operator=(const Self&);                   //purposely not implemented
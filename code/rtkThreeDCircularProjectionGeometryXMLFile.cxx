@@ -20,12 +20,16 @@
 #define _rtkThreeDCircularProjectionGeometryXMLFile_cxx
 
 #include "rtkThreeDCircularProjectionGeometryXMLFile.h"
+#include "rtkMemoryMappedFile.h"
 
 #include <itksys/SystemTools.hxx>
 #include <itkMetaDataObject.h>
 #include <itkIOCommon.h>
+#include <itkByteSwapper.h>
 
 #include <iomanip>
+#include <algorithm>
+#include <cctype>
 
 namespace rtk
 {
@@ -43,9 +47,249 @@ ThreeDCircularProjectionGeometryXMLFileReader():
   m_SourceToDetectorDistance(0.),
   m_ProjectionOffsetX(0.),
   m_ProjectionOffsetY(0.),
-  m_Version(0)
+  m_Version(0),
+  m_BinarySidecar(false),
+  m_LoadedFromSidecar(false)
 {
   this->m_OutputObject = &(*m_Geometry);
+
+  m_Tags["inplaneangle"]              = IN_PLANE_ANGLE;
+  m_Tags["gantryangle"]               = GANTRY_ANGLE;
+  m_Tags["angle"]                     = GANTRY_ANGLE; // Backward compatibility
+  m_Tags["outofplaneangle"]           = OUT_OF_PLANE_ANGLE;
+  m_Tags["sourcetoisocenterdistance"] = SOURCE_TO_ISOCENTER_DISTANCE;
+  m_Tags["sourceoffsetx"]             = SOURCE_OFFSET_X;
+  m_Tags["sourceoffsety"]             = SOURCE_OFFSET_Y;
+  m_Tags["sourcetodetectordistance"]  = SOURCE_TO_DETECTOR_DISTANCE;
+  m_Tags["projectionoffsetx"]         = PROJECTION_OFFSET_X;
+  m_Tags["projectionoffsety"]         = PROJECTION_OFFSET_Y;
+  m_Tags["matrix"]                    = MATRIX;
+  m_Tags["projection"]                = PROJECTION;
+}
+
+/** Size of the text header of binary geometry files */
+static const unsigned int BinaryHeaderSize = 64;
+
+/** Throw an exception if the matrix read in a file and the matrix computed
+ * from the parameters are not consistent. */
+static void
+CheckGeometryMatrix(const rtk::ThreeDCircularProjectionGeometry::MatrixType &read,
+                    const rtk::ThreeDCircularProjectionGeometry::MatrixType &computed)
+{
+  for(unsigned int i=0; i<read.RowDimensions; i++)
+    for(unsigned int j=0; j<read.ColumnDimensions; j++)
+      {
+      // Tolerance can not be vcl_numeric_limits<double>::epsilon(), too strict
+      // 0.001 is a random choice to catch "large" inconsistencies
+      if( fabs(read[i][j]-computed[i][j]) > 0.001 )
+        {
+        itkGenericExceptionMacro(<< "Matrix and parameters are not consistent."
+                                 << std::endl << "Read matrix from geometry file: "
+                                 << std::endl << read
+                                 << std::endl << "Computed matrix from parameters:"
+                                 << std::endl << computed);
+        }
+      }
+}
+
+/** 32 bits FNV-1a hash of the content of a file, 0 if it can not be read */
+static unsigned int
+GetFileHash(const std::string &fileName)
+{
+  rtk::MemoryMappedFile file(fileName);
+  if(!file.is_open() )
+    return 0;
+  unsigned int hash = 2166136261u;
+  const unsigned char *p = reinterpret_cast<const unsigned char *>(file.GetPointer() );
+  for(size_t i=0; i<file.GetSize(); i++)
+    {
+    hash ^= p[i];
+    hash *= 16777619u;
+    }
+  return hash;
+}
+
+/** Header of a binary geometry file, possibly the sidecar of xmlFileName.
+ * The sidecar is identified by the size, the modification time and the hash
+ * of the content of the XML file. */
+static std::string
+GetBinaryHeader(size_t nProj, const std::string &xmlFileName)
+{
+  std::ostringstream header;
+  header << "RTKGEO 2 "
+         << rtk::ThreeDCircularProjectionGeometryXMLFileReader::CurrentVersion << ' '
+         << nProj << ' ';
+  if(xmlFileName == "")
+    header << "0 0 0";
+  else
+    header << itksys::SystemTools::FileLength(xmlFileName.c_str() ) << ' '
+           << itksys::SystemTools::ModifiedTime(xmlFileName.c_str() ) << ' '
+           << std::hex << GetFileHash(xmlFileName);
+  std::string result = header.str();
+  result.resize(BinaryHeaderSize-1, ' ');
+  result += '\n';
+  return result;
+}
+
+bool
+ThreeDCircularProjectionGeometryXMLFileReader::
+IsBinaryFileName(const std::string &fileName)
+{
+  return itksys::SystemTools::Strucmp(itksys::SystemTools::GetFilenameLastExtension(fileName).c_str(),
+                                      ".rtkgeo") == 0;
+}
+
+bool
+ThreeDCircularProjectionGeometryXMLFileReader::
+ReadBinaryFile(const std::string &fileName,
+               GeometryType *geometry,
+               const std::string &xmlFileName)
+{
+  MemoryMappedFile file(fileName);
+  if(!file.is_open() || file.GetSize() < BinaryHeaderSize)
+    return false;
+
+  // Check header and size
+  const std::string header(file.GetPointer(), BinaryHeaderSize);
+  std::istringstream iss(header);
+  std::string magic;
+  size_t nProj = 0;
+  iss >> magic >> magic >> magic >> nProj;
+  if(iss.fail() ||
+     header != GetBinaryHeader(nProj, xmlFileName) ||
+     file.GetSize() != BinaryHeaderSize + nProj * 21 * sizeof(double) )
+    return false;
+  if(!nProj)
+    return true;
+
+  // The data are aligned after the header in the mapped file and stored in
+  // little-endian byte order
+  std::vector<double> data(reinterpret_cast<const double *>(file.GetPointer() + BinaryHeaderSize),
+                           reinterpret_cast<const double *>(file.GetPointer() + file.GetSize() ) );
+  itk::ByteSwapper<double>::SwapRangeFromSystemToLittleEndian(&(data[0]), data.size() );
+  const double *p = &(data[0]);
+  const size_t first = geometry->GetGantryAngles().size();
+  geometry->AddProjections(std::vector<double>(p,         p+nProj),
+                           std::vector<double>(p+nProj,   p+2*nProj),
+                           std::vector<double>(p+2*nProj, p+3*nProj),
+                           std::vector<double>(p+3*nProj, p+4*nProj),
+                           std::vector<double>(p+4*nProj, p+5*nProj),
+                           std::vector<double>(p+5*nProj, p+6*nProj),
+                           std::vector<double>(p+6*nProj, p+7*nProj),
+                           std::vector<double>(p+7*nProj, p+8*nProj),
+                           std::vector<double>(p+8*nProj, p+9*nProj) );
+
+  p += 9*nProj;
+  for(size_t i=0; i<nProj; i++, p+=12)
+    {
+    GeometryType::MatrixType matrix;
+    std::copy(p, p+12, matrix.GetVnlMatrix().data_block() );
+    CheckGeometryMatrix(matrix, geometry->GetMatrices()[first+i]);
+    }
+  return true;
+}
+
+bool
+ThreeDCircularProjectionGeometryXMLFileReader::
+WriteBinaryFile(const std::string &fileName,
+                GeometryType *geometry,
+                const std::string &xmlFileName)
+{
+  std::ofstream output(fileName.c_str(), std::ios_base::out | std::ios_base::binary);
+  if(!output.is_open() )
+    return false;
+
+  const size_t nProj = geometry->GetGantryAngles().size();
+  const std::string header = GetBinaryHeader(nProj, xmlFileName);
+  output.write(header.data(), header.size() );
+
+  const std::vector<double> *parameters[9] = { &(geometry->GetSourceToIsocenterDistances()),
+                                               &(geometry->GetSourceToDetectorDistances()),
+                                               &(geometry->GetGantryAngles()),
+                                               &(geometry->GetProjectionOffsetsX()),
+                                               &(geometry->GetProjectionOffsetsY()),
+                                               &(geometry->GetOutOfPlaneAngles()),
+                                               &(geometry->GetInPlaneAngles()),
+                                               &(geometry->GetSourceOffsetsX()),
+                                               &(geometry->GetSourceOffsetsY()) };
+  std::vector<double> data;
+  data.reserve(21*nProj);
+  for(unsigned int k=0; k<9; k++)
+    data.insert(data.end(), parameters[k]->begin(), parameters[k]->end() );
+  for(size_t i=0; i<nProj; i++)
+    {
+    const double *m = geometry->GetMatrices()[i].GetVnlMatrix().data_block();
+    data.insert(data.end(), m, m+12);
+    }
+  if(nProj)
+    {
+    // Little-endian byte order whatever the system
+    itk::ByteSwapper<double>::SwapRangeFromSystemToLittleEndian(&(data[0]), data.size() );
+    output.write(reinterpret_cast<const char *>(&(data[0]) ), data.size()*sizeof(double) );
+    }
+  output.close();
+  if(output.fail() )
+    {
+    itksys::SystemTools::RemoveFile(fileName.c_str() );
+    return false;
+    }
+  return true;
+}
+
+void
+ThreeDCircularProjectionGeometryXMLFileReader::
+GenerateOutputInformation()
+{
+  m_LoadedFromSidecar = false;
+  if(IsBinaryFileName(this->m_Filename) )
+    {
+    if(!ReadBinaryFile(this->m_Filename, this->m_OutputObject) )
+      itkExceptionMacro(<< "Could not read binary geometry file " << this->m_Filename);
+    return;
+    }
+
+  const std::string sidecar = this->m_Filename + ".rtkgeo";
+  if(m_BinarySidecar && ReadBinaryFile(sidecar, this->m_OutputObject, this->m_Filename) )
+    {
+    m_LoadedFromSidecar = true;
+    return;
+    }
+
+  Superclass::GenerateOutputInformation();
+  FlushProjections();
+
+  // The sidecar is only a cache: failing to write it is not an error
+  if(m_BinarySidecar)
+    WriteBinaryFile(sidecar, this->m_OutputObject, this->m_Filename);
+}
+
+void
+ThreeDCircularProjectionGeometryXMLFileReader::
+FlushProjections()
+{
+  const size_t first = this->m_OutputObject->GetGantryAngles().size();
+  this->m_OutputObject->AddProjections(m_SourceToIsocenterDistances,
+                                       m_SourceToDetectorDistances,
+                                       m_GantryAngles,
+                                       m_ProjectionOffsetsX,
+                                       m_ProjectionOffsetsY,
+                                       m_OutOfPlaneAngles,
+                                       m_InPlaneAngles,
+                                       m_SourceOffsetsX,
+                                       m_SourceOffsetsY);
+  for(size_t i=0; i<m_Matrices.size(); i++)
+    CheckGeometryMatrix(m_Matrices[i], this->m_OutputObject->GetMatrices()[first+i]);
+
+  m_SourceToIsocenterDistances.clear();
+  m_SourceToDetectorDistances.clear();
+  m_GantryAngles.clear();
+  m_ProjectionOffsetsX.clear();
+  m_ProjectionOffsetsY.clear();
+  m_OutOfPlaneAngles.clear();
+  m_InPlaneAngles.clear();
+  m_SourceOffsetsX.clear();
+  m_SourceOffsetsY.clear();
+  m_Matrices.clear();
 }
 
 int
@@ -63,7 +307,7 @@ void
 ThreeDCircularProjectionGeometryXMLFileReader::
 StartElement(const char * name,const char **atts)
 {
-  m_CurCharacterData = "";
+  m_CurCharacterData.clear();
   this->StartElement(name);
 
   // Check on last version of file format. Warning if not.
@@ -88,75 +332,80 @@ StartElement(const char * itkNotUsed(name))
 {
 }
 
+ThreeDCircularProjectionGeometryXMLFileReader::TagType
+ThreeDCircularProjectionGeometryXMLFileReader::
+GetTag(const char *name)
+{
+  m_LowerCaseName = name;
+  std::transform(m_LowerCaseName.begin(), m_LowerCaseName.end(), m_LowerCaseName.begin(), ::tolower);
+  std::map<std::string, TagType>::const_iterator it = m_Tags.find(m_LowerCaseName);
+  if(it == m_Tags.end() )
+    return UNKNOWN_TAG;
+  return it->second;
+}
+
 void
 ThreeDCircularProjectionGeometryXMLFileReader::
 EndElement(const char *name)
 {
-  if(itksys::SystemTools::Strucmp(name, "InPlaneAngle") == 0)
-    m_InPlaneAngle = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "GantryAngle") == 0 ||
-     itksys::SystemTools::Strucmp(name, "Angle") == 0) // Second one for backward compatibility
-    m_GantryAngle = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "OutOfPlaneAngle") == 0)
-    m_OutOfPlaneAngle = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "SourceToIsocenterDistance") == 0)
-    m_SourceToIsocenterDistance = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "SourceOffsetX") == 0)
-    m_SourceOffsetX = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "SourceOffsetY") == 0)
-    m_SourceOffsetY = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "SourceToDetectorDistance") == 0)
-    m_SourceToDetectorDistance = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "ProjectionOffsetX") == 0)
-    m_ProjectionOffsetX = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "ProjectionOffsetY") == 0)
-    m_ProjectionOffsetY = atof(this->m_CurCharacterData.c_str() );
-
-  if(itksys::SystemTools::Strucmp(name, "Matrix") == 0)
+  const double value = atof(this->m_CurCharacterData.c_str() );
+  switch(GetTag(name) )
     {
-    std::istringstream iss(this->m_CurCharacterData);
-    double value = 0.;
-    for(unsigned int i=0; i<m_Matrix.RowDimensions; i++)
-      for(unsigned int j=0; j<m_Matrix.ColumnDimensions; j++)
-        {
-        iss >> value;
-        m_Matrix[i][j] = value;
-        }
-    }
-
-  if(itksys::SystemTools::Strucmp(name, "Projection") == 0)
-    {
-    this->m_OutputObject->AddProjection(m_SourceToIsocenterDistance,
-                                        m_SourceToDetectorDistance,
-                                        m_GantryAngle,
-                                        m_ProjectionOffsetX,
-                                        m_ProjectionOffsetY,
-                                        m_OutOfPlaneAngle,
-                                        m_InPlaneAngle,
-                                        m_SourceOffsetX,
-                                        m_SourceOffsetY);
-    for(unsigned int i=0; i<m_Matrix.RowDimensions; i++)
-      for(unsigned int j=0; j<m_Matrix.ColumnDimensions; j++)
-        {
-        // Tolerance can not be vcl_numeric_limits<double>::epsilon(), too strict
-        // 0.001 is a random choice to catch "large" inconsistencies
-        if( fabs(m_Matrix[i][j]-m_OutputObject->GetMatrices().back()[i][j]) > 0.001 )
+    case IN_PLANE_ANGLE:
+      m_InPlaneAngle = value;
+      break;
+    case GANTRY_ANGLE:
+      m_GantryAngle = value;
+      break;
+    case OUT_OF_PLANE_ANGLE:
+      m_OutOfPlaneAngle = value;
+      break;
+    case SOURCE_TO_ISOCENTER_DISTANCE:
+      m_SourceToIsocenterDistance = value;
+      break;
+    case SOURCE_OFFSET_X:
+      m_SourceOffsetX = value;
+      break;
+    case SOURCE_OFFSET_Y:
+      m_SourceOffsetY = value;
+      break;
+    case SOURCE_TO_DETECTOR_DISTANCE:
+      m_SourceToDetectorDistance = value;
+      break;
+    case PROJECTION_OFFSET_X:
+      m_ProjectionOffsetX = value;
+      break;
+    case PROJECTION_OFFSET_Y:
+      m_ProjectionOffsetY = value;
+      break;
+    case MATRIX:
+      {
+      const char *p = this->m_CurCharacterData.c_str();
+      char *end = NULL;
+      for(unsigned int i=0; i<m_Matrix.RowDimensions; i++)
+        for(unsigned int j=0; j<m_Matrix.ColumnDimensions; j++)
           {
-          itkGenericExceptionMacro(<< "Matrix and parameters are not consistent."
-                                   << std::endl << "Read matrix from geometry file: " 
-                                   << std::endl << m_Matrix
-                                   << std::endl << "Computed matrix from parameters:"
-                                   << std::endl << m_OutputObject->GetMatrices().back());
+          m_Matrix[i][j] = strtod(p, &end);
+          p = end;
           }
-        }
+      }
+      break;
+    case PROJECTION:
+      // The projections are added to the geometry at once at the end of the
+      // file, see FlushProjections
+      m_SourceToIsocenterDistances.push_back(m_SourceToIsocenterDistance);
+      m_SourceToDetectorDistances.push_back(m_SourceToDetectorDistance);
+      m_GantryAngles.push_back(m_GantryAngle);
+      m_ProjectionOffsetsX.push_back(m_ProjectionOffsetX);
+      m_ProjectionOffsetsY.push_back(m_ProjectionOffsetY);
+      m_OutOfPlaneAngles.push_back(m_OutOfPlaneAngle);
+      m_InPlaneAngles.push_back(m_InPlaneAngle);
+      m_SourceOffsetsX.push_back(m_SourceOffsetX);
+      m_SourceOffsetsY.push_back(m_SourceOffsetY);
+      m_Matrices.push_back(m_Matrix);
+      break;
+    default:
+      break;
     }
 }
 
@@ -164,8 +413,7 @@ void
 ThreeDCircularProjectionGeometryXMLFileReader::
 CharacterDataHandler(const char *inData, int inLength)
 {
-  for(int i = 0; i < inLength; i++)
-    m_CurCharacterData = m_CurCharacterData + inData[i];
+  m_CurCharacterData.append(inData, inLength);
 }
 
 int
@@ -183,6 +431,13 @@ int
 ThreeDCircularProjectionGeometryXMLFileWriter::
 WriteFile()
 {
+  if(ThreeDCircularProjectionGeometryXMLFileReader::IsBinaryFileName(this->m_Filename) )
+    {
+    if(!ThreeDCircularProjectionGeometryXMLFileReader::WriteBinaryFile(this->m_Filename, this->m_InputObject) )
+      itkExceptionMacro(<< "Could not write binary geometry file " << this->m_Filename);
+    return 0;
+    }
+
   std::ofstream output(this->m_Filename.c_str() );
   const int     maxDigits = 15;
 
@@ -27,12 +27,24 @@
 #include <itkXMLFile.h>
 #include "rtkThreeDCircularProjectionGeometry.h"
 
+#include <map>
+
 namespace rtk
 {
 
 /** \class ThreeDCircularProjectionGeometryXMLFileReader
  *
- * Reads an XML-format file containing geometry for reconstruction
+ * Reads an XML-format file containing geometry for reconstruction.
+ *
+ * Files with the extension .rtkgeo are read in the binary format written by
+ * ThreeDCircularProjectionGeometryXMLFileWriter, i.e., a 64 bytes text
+ * header followed by the 9 parameter arrays and the projection matrices in
+ * double precision and little-endian byte order, swapped on big-endian
+ * systems. If BinarySidecar is on, the geometry of an XML file is read from
+ * the binary file with the same name followed by .rtkgeo if it has been
+ * written from the current version of the XML file, and this binary file is
+ * written otherwise. The version is identified by the size, the modification
+ * time and a hash of the content of the XML file stored in the header.
  *
  * \test rtkgeometryfiletest.cxx, rtkvariantest.cxx, rtkxradtest.cxx,
  * rtkdigisenstest.cxx, rtkelektatest.cxx
@@ -65,6 +77,35 @@ public:
   /** Determine if a file can be read */
   int CanReadFile(const char* name);
 
+  /** Read the geometry, from the binary file or sidecar if possible. */
+  virtual void GenerateOutputInformation();
+
+  /** Use and maintain a binary sidecar of XML files, off by default. */
+  itkGetMacro(BinarySidecar, bool);
+  itkSetMacro(BinarySidecar, bool);
+  itkBooleanMacro(BinarySidecar);
+
+  /** True if the last read geometry has been loaded from the binary sidecar
+   * of the XML file. */
+  bool IsLoadedFromSidecar() const { return m_LoadedFromSidecar; }
+
+  /** Return true if fileName has the extension of binary geometry files. */
+  static bool IsBinaryFileName(const std::string &fileName);
+
+  /** Read a binary geometry file and add its projections to geometry. If
+   * xmlFileName is not empty, the file is only read if it has been written
+   * from the current version of this XML file. Return false if the file
+   * could not be read. */
+  static bool ReadBinaryFile(const std::string &fileName,
+                             GeometryType *geometry,
+                             const std::string &xmlFileName="");
+
+  /** Write geometry in a binary geometry file, possibly as the sidecar of
+   * the XML file xmlFileName. Return false on failure. */
+  static bool WriteBinaryFile(const std::string &fileName,
+                              GeometryType *geometry,
+                              const std::string &xmlFileName="");
+
 protected:
   ThreeDCircularProjectionGeometryXMLFileReader();
   ~ThreeDCircularProjectionGeometryXMLFileReader() { };
@@ -85,10 +126,36 @@ private:
   ThreeDCircularProjectionGeometryXMLFileReader(const Self&);
   void operator=(const Self&);
 
+  /** Add the projections read in the XML file to the geometry and check
+   * that the matrices are consistent with the parameters. */
+  void FlushProjections();
+
+  /** Tags of the XML file */
+  typedef enum
+    {
+    UNKNOWN_TAG = 0,
+    IN_PLANE_ANGLE,
+    GANTRY_ANGLE,
+    OUT_OF_PLANE_ANGLE,
+    SOURCE_TO_ISOCENTER_DISTANCE,
+    SOURCE_OFFSET_X,
+    SOURCE_OFFSET_Y,
+    SOURCE_TO_DETECTOR_DISTANCE,
+    PROJECTION_OFFSET_X,
+    PROJECTION_OFFSET_Y,
+    MATRIX,
+    PROJECTION
+    } TagType;
+  TagType GetTag(const char *name);
+
   GeometryType::Pointer m_Geometry;
 
   std::string m_CurCharacterData;
 
+  /** Lower case tag names and corresponding tag */
+  std::map<std::string, TagType> m_Tags;
+  std::string                    m_LowerCaseName;
+
   /** Projection parameters */
   double m_InPlaneAngle;
   double m_OutOfPlaneAngle;
@@ -103,13 +170,29 @@ private:
   /** Projection matrix */
   ThreeDCircularProjectionGeometry::MatrixType m_Matrix;
 
+  /** Projections read and not yet added to the geometry */
+  std::vector<double> m_SourceToIsocenterDistances;
+  std::vector<double> m_SourceToDetectorDistances;
+  std::vector<double> m_GantryAngles;
+  std::vector<double> m_ProjectionOffsetsX;
+  std::vector<double> m_ProjectionOffsetsY;
+  std::vector<double> m_OutOfPlaneAngles;
+  std::vector<double> m_InPlaneAngles;
+  std::vector<double> m_SourceOffsetsX;
+  std::vector<double> m_SourceOffsetsY;
+  std::vector<ThreeDCircularProjectionGeometry::MatrixType> m_Matrices;
+
   /** File format version */
   unsigned int m_Version;
+
+  bool m_BinarySidecar;
+  bool m_LoadedFromSidecar;
 };
 
 /** \class ThreeDCircularProjectionGeometryXMLFileWriter
  *
- * Writes an XML-format file containing geometry for reconstruction
+ * Writes an XML-format file containing geometry for reconstruction, or a
+ * binary file if the file name has the extension .rtkgeo.
  *
  * \author Simon Rit
  *
@@ -59,6 +59,9 @@ protected:
   TiffLookupTableImageFilter();
   virtual ~TiffLookupTableImageFilter() {}
 
+  /** Fill the lookup table shared by all instances. */
+  static void BuildLookupTable(LookupTableType *lut);
+
 private:
   TiffLookupTableImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&);     //purposely not implemented
@@ -70,12 +73,14 @@ private:
 template <class TInputImage, class TOutputImage>
 rtk::TiffLookupTableImageFilter<TInputImage, TOutputImage>::TiffLookupTableImageFilter()
 {
-  // Create the lut
-  typename LookupTableType::Pointer lut = LookupTableType::New();
-  typename LookupTableType::SizeType size;
-  size[0] = itk::NumericTraits<InputImagePixelType>::max()-itk::NumericTraits<InputImagePixelType>::min()+1;
-  lut->SetRegions( size );
-  lut->Allocate();
+  this->SetLookupTable( Superclass::GetOrCreateSharedLookupTable("Tiff", BuildLookupTable) );
+}
+
+template <class TInputImage, class TOutputImage>
+void
+rtk::TiffLookupTableImageFilter<TInputImage, TOutputImage>::BuildLookupTable(LookupTableType *lut)
+{
+  const typename LookupTableType::SizeType size = lut->GetBufferedRegion().GetSize();
 
   // Iterate and set lut
   OutputImagePixelType logRef = log(OutputImagePixelType(size[0]+1) );
@@ -91,8 +96,6 @@ rtk::TiffLookupTableImageFilter<TInputImage, TOutputImage>::TiffLookupTableImage
     it.Set( logRef - log( OutputImagePixelType(it.GetIndex()[0]+1) ) );
     ++it;
     }
-  // Set the lut to member and functor
-  this->SetLookupTable(lut);
 }
 
 #endif
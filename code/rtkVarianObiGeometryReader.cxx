@@ -19,10 +19,11 @@
 
 #include "rtkVarianObiGeometryReader.h"
 #include "rtkVarianObiXMLFileReader.h"
-#include "rtkHndImageIOFactory.h"
+#include "rtkHndImageIO.h"
 
-#include <itkImageFileReader.h>
+#include <itkMultiThreader.h>
 #include <itksys/SystemTools.hxx>
+#include <vnl/vnl_math.h>
 
 rtk::VarianObiGeometryReader
 ::VarianObiGeometryReader():
@@ -68,23 +69,46 @@ rtk::VarianObiGeometryReader
   const double offsety =
     dynamic_cast<MetaDataDoubleType *>(dic["CalibratedDetectorOffsetY"].GetPointer() )->GetMetaDataObjectValue();
 
-  // Projections reader (for angle)
-  rtk::HndImageIOFactory::RegisterOneFactory();
+  // Gantry angles, read from the hnd headers only in parallel
+  m_Angles.resize(m_ProjectionsFileNames.size());
+  m_ErrorMessage.clear();
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads( vnl_math_min((unsigned int)m_ProjectionsFileNames.size(),
+                                             (unsigned int)threader->GetNumberOfThreads()) );
+  threader->SetSingleMethod(ReadAnglesCallback, this);
+  threader->SingleMethodExecute();
+  if(!m_ErrorMessage.empty())
+    itkExceptionMacro(<< m_ErrorMessage);
 
   // Projection matrices
   for(unsigned int noProj=0; noProj<m_ProjectionsFileNames.size(); noProj++)
-    {
-    typedef unsigned int                    InputPixelType;
-    typedef itk::Image< InputPixelType, 2 > InputImageType;
-
-    typedef itk::ImageFileReader< InputImageType > ReaderType;
-    ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_ProjectionsFileNames[noProj] );
-    reader->UpdateOutputInformation();
+    m_Geometry->AddProjection(sid, sdd, m_Angles[noProj], offsetx, offsety);
+}
 
-    const double angle =
-      dynamic_cast<MetaDataDoubleType *>(reader->GetMetaDataDictionary()["dCTProjectionAngle"].GetPointer())->GetMetaDataObjectValue();
+ITK_THREAD_RETURN_TYPE
+rtk::VarianObiGeometryReader
+::ReadAnglesCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  Self *self = static_cast<Self *>(info->UserData);
 
-    m_Geometry->AddProjection(sid, sdd, angle, offsetx, offsety);
+  for(unsigned int noProj=info->ThreadID;
+      noProj<self->m_ProjectionsFileNames.size();
+      noProj+=info->NumberOfThreads)
+    {
+    try
+      {
+      HndImageIO::Hnd_header hnd;
+      HndImageIO::ReadHeader(self->m_ProjectionsFileNames[noProj], hnd);
+      self->m_Angles[noProj] = hnd.dCTProjectionAngle;
+      }
+    catch(itk::ExceptionObject &e)
+      {
+      self->m_ErrorMutex.Lock();
+      self->m_ErrorMessage = e.GetDescription();
+      self->m_ErrorMutex.Unlock();
+      break;
+      }
     }
+  return ITK_THREAD_RETURN_VALUE;
 }
@@ -20,6 +20,8 @@
 #define __rtkVarianObiGeometryReader_h
 
 #include <itkLightProcessObject.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
 #include "rtkThreeDCircularProjectionGeometry.h"
 
 namespace rtk
@@ -27,7 +29,9 @@ namespace rtk
 
 /** \class VarianObiGeometryReader
  *
- * Creates a 3D circular geometry from Varian OBI data. 
+ * Creates a 3D circular geometry from Varian OBI data. The gantry angle of
+ * each projection is read from the header of its hnd file only, the files
+ * being processed in parallel.
  *
  * \test rtkvariantest.cxx
  *
@@ -87,9 +91,17 @@ private:
 
   virtual void GenerateData();
 
+  /** Thread callback reading the angles of one out of NumberOfThreads files. */
+  static ITK_THREAD_RETURN_TYPE ReadAnglesCallback(void *arg);
+
   GeometryType::Pointer m_Geometry;
   std::string           m_XMLFileName;
   FileNamesContainer    m_ProjectionsFileNames;
+
+  /** Angles read in the headers and first error raised by the threads. */
+  std::vector<double>      m_Angles;
+  std::string              m_ErrorMessage;
+  itk::SimpleFastMutexLock m_ErrorMutex;
 };
 
 }
@@ -0,0 +1,52 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkVarianObiRawImageFilter_txx
+#define __rtkVarianObiRawImageFilter_txx
+
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+namespace rtk
+{
+
+template <class TInputImage, class TOutputImage>
+void
+VarianObiRawImageFilter<TInputImage, TOutputImage>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, ThreadIdType itkNotUsed(threadId))
+{
+  const TInputImage *input = this->GetInput();
+  TOutputImage *output = this->GetOutput();
+  const float scale = 1./HND_INTENSITY_MAX;
+
+  // Iterate over the first pixel of each row
+  OutputImageRegionType rows = outputRegionForThread;
+  rows.SetSize(0, 1);
+  const unsigned int n = outputRegionForThread.GetSize(0);
+  itk::ImageRegionConstIteratorWithIndex<TOutputImage> itRows(output, rows);
+  for(itRows.GoToBegin(); !itRows.IsAtEnd(); ++itRows)
+    {
+    NegativeLogRow(input->GetBufferPointer() + input->ComputeOffset( itRows.GetIndex() ),
+                   output->GetBufferPointer() + output->ComputeOffset( itRows.GetIndex() ),
+                   n,
+                   scale);
+    }
+}
+
+} // end namespace rtk
+
+#endif
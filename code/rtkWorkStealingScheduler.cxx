@@ -0,0 +1,119 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "rtkWorkStealingScheduler.h"
+
+namespace rtk
+{
+
+WorkStealingScheduler
+::WorkStealingScheduler():
+  m_Processor(NULL),
+  m_Blocks(NULL),
+  m_NumberOfBlocks(0),
+  m_NumberOfSteals(0)
+{
+}
+
+WorkStealingScheduler
+::~WorkStealingScheduler()
+{
+  delete [] m_Blocks;
+}
+
+void
+WorkStealingScheduler
+::Execute(TileProcessor *processor, const unsigned int numberOfTiles, const ThreadIdType numberOfThreads)
+{
+  m_NumberOfSteals = 0;
+  if(numberOfTiles==0)
+    return;
+
+  // One contiguous block of tiles per thread
+  const unsigned int nBlocks = GetNumberOfBlocks(numberOfTiles, numberOfThreads);
+  if(nBlocks != m_NumberOfBlocks)
+    {
+    delete [] m_Blocks;
+    m_Blocks = new TileBlock[nBlocks];
+    m_NumberOfBlocks = nBlocks;
+    }
+  for(unsigned int i=0; i<nBlocks; i++)
+    {
+    GetBlock(i, nBlocks, numberOfTiles, m_Blocks[i].Begin, m_Blocks[i].End);
+    m_Blocks[i].Steals = 0;
+    }
+  m_Processor = processor;
+
+  // The threader may use fewer threads than blocks, the remaining blocks are
+  // then stolen
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(nBlocks);
+  threader->SetSingleMethod(ExecuteCallback, this);
+  threader->SingleMethodExecute();
+
+  for(unsigned int i=0; i<nBlocks; i++)
+    m_NumberOfSteals += m_Blocks[i].Steals;
+  m_Processor = NULL;
+}
+
+ITK_THREAD_RETURN_TYPE
+WorkStealingScheduler
+::ExecuteCallback(void *arg)
+{
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(arg);
+  Self *self = (Self *)(info->UserData);
+  ThreadAffinity::ScopedPinning pinning(info->ThreadID, self->m_NumberOfBlocks);
+  unsigned int tile;
+  while( self->GetNextTile(info->ThreadID, tile) )
+    self->m_Processor->ProcessTile(tile, info->ThreadID);
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+bool
+WorkStealingScheduler
+::GetNextTile(const ThreadIdType threadId, unsigned int &tile)
+{
+  // Own block first, in increasing order for locality
+  TileBlock &own = m_Blocks[threadId];
+  own.Mutex.Lock();
+  const bool found = (own.Begin < own.End);
+  if(found)
+    tile = own.Begin++;
+  own.Mutex.Unlock();
+  if(found)
+    return true;
+
+  // Steal the last tile of the next non empty block
+  for(unsigned int i=1; i<m_NumberOfBlocks; i++)
+    {
+    TileBlock &victim = m_Blocks[(threadId+i) % m_NumberOfBlocks];
+    victim.Mutex.Lock();
+    const bool stolen = (victim.Begin < victim.End);
+    if(stolen)
+      tile = --victim.End;
+    victim.Mutex.Unlock();
+    if(stolen)
+      {
+      own.Steals++;
+      return true;
+      }
+    }
+  return false;
+}
+
+} // end namespace rtk
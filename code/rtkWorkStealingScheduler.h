@@ -0,0 +1,172 @@
+/*=========================================================================
+ *
+ *  Copyright RTK Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __rtkWorkStealingScheduler_h
+#define __rtkWorkStealingScheduler_h
+
+#include <vector>
+#include <algorithm>
+#include <itkObject.h>
+#include <itkObjectFactory.h>
+#include <itkMultiThreader.h>
+#include <itkSimpleFastMutexLock.h>
+
+#include "rtkThreadAffinity.h"
+
+namespace rtk
+{
+
+/** \class WorkStealingScheduler
+ * \brief Processes a set of tiles with threads which steal each other's work.
+ *
+ * itk::ImageSource splits the requested region in as many pieces as threads
+ * along its last dimension. The split is static and threads which are done
+ * wait for the slowest one, e.g., the backprojection of slabs at the edge of
+ * the field of view or the forward projection of projections with short
+ * rays. This class splits the work in many tiles instead. Each thread owns a
+ * contiguous block of tiles which it processes in increasing order. When
+ * its block is empty, it steals the last tile of the block of another
+ * thread, which keeps the remaining tiles of the victim contiguous.
+ *
+ * The work is done by a TileProcessor, typically a filter which maps the
+ * tile number to a region computed with SplitRegion and calls its
+ * ThreadedGenerateData.
+ *
+ * Thread i is pinned according to rtk::ThreadAffinity, block i of the tiles
+ * being processed on the same core by all filters.
+ *
+ * \author Simon Rit
+ */
+class WorkStealingScheduler : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef WorkStealingScheduler         Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingScheduler, itk::Object);
+
+  /** \class TileProcessor
+   * \brief Interface of the objects whose work is split in tiles. */
+  class TileProcessor
+  {
+  public:
+    virtual ~TileProcessor() {}
+    virtual void ProcessTile(const unsigned int tile, const ThreadIdType threadId) = 0;
+  };
+
+  /** Process tiles 0 to numberOfTiles-1 with at most numberOfThreads
+   * threads. Each tile is processed exactly once. */
+  void Execute(TileProcessor *processor, const unsigned int numberOfTiles, const ThreadIdType numberOfThreads);
+
+  /** Number of tiles processed by another thread than their owner during the
+   * last Execute. */
+  itkGetConstMacro(NumberOfSteals, unsigned int);
+
+  /** Number of blocks, i.e., of threads, used by Execute and tiles
+   * [begin, end) of block i. Filters which prepare data for the tiles, e.g.,
+   * the first touch of the pages of a volume, use the same partition. */
+  static unsigned int GetNumberOfBlocks(const unsigned int numberOfTiles, const ThreadIdType numberOfThreads)
+    {
+    return std::max(1u, std::min((unsigned int)numberOfThreads, numberOfTiles));
+    }
+  static void GetBlock(const unsigned int i, const unsigned int numberOfBlocks, const unsigned int numberOfTiles,
+                       unsigned int &begin, unsigned int &end)
+    {
+    begin = (unsigned long)numberOfTiles * i / numberOfBlocks;
+    end = (unsigned long)numberOfTiles * (i+1) / numberOfBlocks;
+    }
+
+  /** Split region in about numberOfTiles tiles. The outermost dimension
+   * larger than 1 is split first, as in itk::ImageSource, and each piece is
+   * split along the next dimension if there are fewer pieces than tiles.
+   * Dimensions lower than lowestSplitDimension are never split, e.g., 2 to
+   * keep entire projections in a tile. */
+  template<class TRegion>
+  static std::vector<TRegion> SplitRegion(const TRegion &region,
+                                          const unsigned int numberOfTiles,
+                                          const unsigned int lowestSplitDimension=0)
+    {
+    std::vector<TRegion> tiles;
+    if(region.GetNumberOfPixels()==0)
+      return tiles;
+    tiles.push_back(region);
+    for(int dim=TRegion::ImageDimension-1; dim>=(int)lowestSplitDimension && tiles.size()<numberOfTiles; dim--)
+      {
+      const unsigned int size = region.GetSize(dim);
+      const unsigned int nPieces = std::min(size, (unsigned int)(numberOfTiles+tiles.size()-1) / (unsigned int)tiles.size());
+      if(nPieces<2)
+        continue;
+      std::vector<TRegion> pieces;
+      pieces.reserve(tiles.size() * nPieces);
+      for(unsigned int t=0; t<tiles.size(); t++)
+        for(unsigned int p=0; p<nPieces; p++)
+          {
+          TRegion piece = tiles[t];
+          const unsigned int begin = (unsigned long)size * p / nPieces;
+          const unsigned int end = (unsigned long)size * (p+1) / nPieces;
+          piece.SetIndex(dim, region.GetIndex(dim) + begin);
+          piece.SetSize(dim, end - begin);
+          pieces.push_back(piece);
+          }
+      tiles.swap(pieces);
+      }
+    return tiles;
+    }
+
+protected:
+  WorkStealingScheduler();
+  virtual ~WorkStealingScheduler();
+
+  /** Thread callback of Execute */
+  static ITK_THREAD_RETURN_TYPE ExecuteCallback(void *arg);
+
+  /** Get the next tile of thread threadId, from its own block or stolen.
+   * Returns false when all tiles have been taken. */
+  bool GetNextTile(const ThreadIdType threadId, unsigned int &tile);
+
+private:
+  WorkStealingScheduler(const Self&); //purposely not implemented
+  void operator=(const Self&);        //purposely not implemented
+
+  /** Remaining tiles [Begin, End) of the block of one thread, padded to
+   * avoid false sharing of the cache lines of different blocks. */
+  struct TileBlock
+  {
+    itk::SimpleFastMutexLock Mutex;
+    unsigned int             Begin;
+    unsigned int             End;
+    unsigned int             Steals;
+    char                     Padding[64];
+  };
+
+  TileProcessor *m_Processor;
+  TileBlock     *m_Blocks;
+  unsigned int   m_NumberOfBlocks;
+  unsigned int   m_NumberOfSteals;
+};
+
+} // end namespace rtk
+
+#endif
@@ -102,13 +102,19 @@ bool rtk::XRadImageIO::CanReadFile(const char* FileNameToRead)
 } ////
 
 //--------------------------------------------------------------------
-// Read Image Content
-void rtk::XRadImageIO::Read(void * buffer)
+std::string rtk::XRadImageIO::GetRawFileName() const
 {
-  // Adapted from itkRawImageIO
   std::string rawFileName( m_FileName, 0, m_FileName.size()-6);
   rawFileName += "img";
+  return rawFileName;
+}
 
+//--------------------------------------------------------------------
+// Read Image Content
+void rtk::XRadImageIO::Read(void * buffer)
+{
+  // Adapted from itkRawImageIO
+  std::string rawFileName = GetRawFileName();
   std::ifstream is(rawFileName.c_str(), std::ios::binary);
   if(!is.is_open() )
     itkExceptionMacro(<<"Could not open file " << rawFileName);
@@ -57,6 +57,11 @@ public:
 
   virtual void Read(void * buffer);
 
+  /** Name of the file containing the pixel values and offset in bytes of the
+   * first pixel in this file. Valid after ReadImageInformation(). */
+  std::string GetRawFileName() const;
+  size_t GetRawDataOffset() const { return 0; }
+
   /*-------- This part of the interfaces deals with writing data. ----- */
   virtual void WriteImageInformation(bool keepOfStream);
 
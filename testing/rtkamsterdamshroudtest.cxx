@@ -1,7 +1,9 @@
 #include "rtkTestConfiguration.h"
 
+#include <algorithm>
 #include <itkImageFileReader.h>
 #include <itkPasteImageFilter.h>
+#include <itkMersenneTwisterRandomVariateGenerator.h>
 
 #include "rtkAmsterdamShroudImageFilter.h"
 #include "rtkConstantImageSource.h"
@@ -70,6 +72,61 @@ void CheckImageQuality(typename TInputImage::Pointer recon, typename TInputImage
 }
 #endif
 
+/** Reference signal of the DP algorithm computed without the optimizations
+ * of DPExtractShroudSignalImageFilter: the whole score and back-pointer
+ * images are stored and the amplitude window of each position is scanned
+ * explicitly. As in the filter, a score is never negative and ties are
+ * resolved towards the leftmost column. */
+template<class TShroudImage>
+std::vector<double> BruteForceDPSignal(const TShroudImage *shroud, const double amplitude)
+{
+  const typename TShroudImage::RegionType region = shroud->GetLargestPossibleRegion();
+  const int w = region.GetSize()[0];
+  const int h = region.GetSize()[1];
+  const double spacing = shroud->GetSpacing()[0];
+  const int a = amplitude / spacing;
+
+  std::vector<double> score(w*h, 0.);
+  std::vector<int>    from(w*h, 0);
+  itk::ImageRegionConstIterator<TShroudImage> it( shroud, region );
+  for(int t=0; t<w; t++, ++it)
+    score[t] = it.Get();
+  for(int i=1; i<h; i++)
+    for(int t=0; t<w; t++, ++it)
+      for(int s=std::max(0, t-a); s<=std::min(w-1, t+a); s++)
+        if(it.Get() + score[(i-1)*w+s] > score[i*w+t])
+          {
+          score[i*w+t] = it.Get() + score[(i-1)*w+s];
+          from[i*w+t] = s-t;
+          }
+
+  int pos = std::max_element(score.begin()+(h-1)*w, score.end()) - (score.begin()+(h-1)*w);
+  std::vector<double> signal(h, 0.);
+  for(int i=h-1; i>0; i--)
+    {
+    signal[i-1] = signal[i] - from[i*w+pos] * spacing;
+    pos += from[i*w+pos];
+    }
+  return signal;
+}
+
+template<class TSignal>
+void CheckDPSignal(const TSignal &signal, const std::vector<double> &ref)
+{
+  double sum = 0.;
+  for(unsigned int i=0; i<ref.size() && i<signal.size(); i++)
+    sum += vcl_abs(ref[i] - signal[i]);
+
+  if ( signal.size() == ref.size() && sum <= 1e-12 )
+    std::cout << "Test PASSED! " << std::endl;
+  else
+  {
+    std::cerr << "Test FAILED! " << "Breathing signal does not match the brute force DP, absolute difference "
+              << sum << " instead of 0." << std::endl;
+    exit( EXIT_FAILURE);
+  }
+}
+
 /**
  * \file rtkamsterdamshroudtest.cxx
  *
@@ -79,7 +136,8 @@ void CheckImageQuality(typename TInputImage::Pointer recon, typename TInputImage
  * and extracts the breathing signal using two different methods, reg1D and D
  * algorithms. The generated results are compared to the expected results,
  * read from a baseline image in the MetaIO file format and hard-coded,
- * respectively.
+ * respectively. The DP signals, computed online and on a random shroud large
+ * enough to be multithreaded, are also compared to a brute force DP.
  *
  * \author Marc Vila
  */
@@ -337,5 +395,57 @@ int main(int, char** )
   }
 #endif
 
+  std::cout << "\n\n****** Case 4: Breathing signal calculated online by DP algorithm ******\n" << std::endl;
+
+  // The shroud is added row by row as during an inline acquisition
+  typedef shroudFilterType::OutputImageType ShroudImageType;
+  ShroudImageType::Pointer shroud = reader2->GetOutput();
+  ShroudImageType::RegionType shroudRegion = shroud->GetLargestPossibleRegion();
+  DPFilterType::Pointer DPOnline = DPFilterType::New();
+  DPOnline->SetAmplitude( 20. );
+  DPOnline->StartOnline( shroudRegion.GetSize()[0], shroud->GetSpacing()[0] );
+  std::vector<reg1DPixelType> onlineSignal;
+  ShroudImageType::IndexType shroudIdx = shroudRegion.GetIndex();
+  for(unsigned int row=0; row<shroudRegion.GetSize()[1]; row++, shroudIdx[1]++)
+    {
+    DPOnline->AddShroudRow( shroud->GetBufferPointer() + shroud->ComputeOffset(shroudIdx) );
+    DPOnline->GetOnlineSignal( onlineSignal );
+    }
+
+  CheckDPSignal( onlineSignal, BruteForceDPSignal(shroud.GetPointer(), 20.) );
+
+  std::cout << "\n\n****** Case 5: Breathing signal calculated by multithreaded DP algorithm ******\n" << std::endl;
+
+  // Random shroud with rows of 1024 pixels and an amplitude of 64 pixels, i.e.,
+  // 1024*129 operations per row, which are split between 3 threads
+  ShroudImageType::Pointer randomShroud = ShroudImageType::New();
+  ShroudImageType::SizeType randomSize;
+  randomSize[0] = 1024;
+  randomSize[1] = 50;
+  ShroudImageType::SpacingType randomSpacing;
+  randomSpacing.Fill(0.5);
+  randomShroud->SetRegions( randomSize );
+  randomShroud->SetSpacing( randomSpacing );
+  randomShroud->Allocate();
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomType;
+  RandomType::Pointer generator = RandomType::New();
+  generator->Initialize(123456);
+  itk::ImageRegionIterator< ShroudImageType > itRandom( randomShroud, randomShroud->GetLargestPossibleRegion() );
+  for (itRandom.GoToBegin(); !itRandom.IsAtEnd(); ++itRandom)
+    itRandom.Set( generator->GetUniformVariate(-1., 1.) );
+
+  DPFilterType::Pointer DPThreaded = DPFilterType::New();
+  DPThreaded->SetInput( randomShroud );
+  DPThreaded->SetAmplitude( 32. );
+  DPThreaded->SetNumberOfThreads( 4 );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( DPThreaded->Update() );
+
+  std::vector<double> threadedSignal;
+  itk::ImageRegionConstIterator< reg1DImageType > itThreaded( DPThreaded->GetOutput(), DPThreaded->GetOutput()->GetLargestPossibleRegion() );
+  for (itThreaded.GoToBegin(); !itThreaded.IsAtEnd(); ++itThreaded)
+    threadedSignal.push_back( itThreaded.Get() );
+  CheckDPSignal( threadedSignal, BruteForceDPSignal(randomShroud.GetPointer(), 32.) );
+
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,186 @@
+#include <itkImageRegionConstIterator.h>
+
+#include "rtkTestConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkImageBufferPool.h"
+#include "rtkConstantImageSource.h"
+#include "rtkSheppLoganPhantomFilter.h"
+#include "rtkFDKConeBeamReconstructionFilter.h"
+
+typedef itk::Image<float, 3> ImageType;
+
+void CheckStatistics(const rtk::ImageBufferPool *pool,
+                     const unsigned long requests, const unsigned long reuses,
+                     const size_t bytesInUse)
+{
+  const rtk::ImageBufferPool::Statistics s = pool->GetStatistics();
+  pool->PrintStatistics(std::cout);
+  if(s.Requests != requests || s.Reuses != reuses || s.Allocations != requests-reuses || s.BytesInUse != bytesInUse)
+    {
+    std::cerr << "Test Failed, expected " << requests << " requests, " << reuses
+              << " reuses and " << bytesInUse << " bytes in use" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+void CheckAlignment(const void *buffer)
+{
+  if( (size_t)buffer % rtk::ImageBufferPool::Alignment )
+    {
+    std::cerr << "Test Failed, buffer " << buffer << " is not aligned" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \file rtkbufferpooltest.cxx
+ *
+ * \brief Functional test for the pool of image buffers
+ *
+ * This test checks that rtk::ImageBufferPool reuses the released buffers of
+ * the same size, that the buffers of images return to the pool when the
+ * images are destroyed or regenerated and that the mini-pipeline of the FDK
+ * reconstruction recycles its buffers.
+ *
+ * \author Simon Rit
+ */
+
+int main(int, char** )
+{
+  std::cout << "\n\n****** Case 1: acquire and release ******" << std::endl;
+  rtk::ImageBufferPool::Pointer pool = rtk::ImageBufferPool::New();
+  void *a = pool->Acquire(1000);
+  CheckAlignment(a);
+  pool->Release(a, 1000);
+  void *b = pool->Acquire(1000);
+  void *c = pool->Acquire(1000);
+  void *d = pool->Acquire(3);
+  CheckAlignment(b);
+  CheckAlignment(c);
+  CheckAlignment(d);
+  if(b!=a || c==a)
+    {
+    std::cerr << "Test Failed, the released buffer is not reused once" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  CheckStatistics(pool, 4, 1, 1024+1024+64);
+  pool->Release(b, 1000);
+  pool->Release(c, 1000);
+  pool->Release(d, 3);
+  // The largest buffers are freed first
+  pool->SetMaximumCachedBytes(1024);
+  if(pool->GetStatistics().BytesCached != 64)
+    {
+    std::cerr << "Test Failed, " << pool->GetStatistics().BytesCached << " bytes cached instead of 64" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  pool->Trim();
+  pool->ResetStatistics();
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 2: image buffer ******" << std::endl;
+  ImageType::RegionType region;
+  region.SetSize(0, 17);
+  region.SetSize(1, 11);
+  region.SetSize(2, 3);
+  const size_t bytes = 17*11*3*sizeof(float);
+  const size_t blockBytes = (bytes+63)/64*64;
+  for(unsigned int i=0; i<3; i++)
+    {
+    ImageType::Pointer image = ImageType::New();
+    image->SetRegions(region);
+    pool->Allocate(image.GetPointer());
+    CheckAlignment(image->GetBufferPointer());
+    image->FillBuffer(1.);
+    CheckStatistics(pool, i+1, i, blockBytes);
+    }
+  CheckStatistics(pool, 3, 2, 0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: watched filter ******" << std::endl;
+  typedef rtk::ConstantImageSource< ImageType > ConstantImageSourceType;
+  ConstantImageSourceType::Pointer source = ConstantImageSourceType::New();
+  ConstantImageSourceType::SizeType size;
+  size[0] = 17;
+  size[1] = 11;
+  size[2] = 3;
+  source->SetSize( size );
+  source->SetConstant( 2. );
+  pool->Watch( source.GetPointer() );
+  for(unsigned int i=0; i<3; i++)
+    {
+    source->Modified();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( source->Update() );
+    CheckAlignment(source->GetOutput()->GetBufferPointer());
+    itk::ImageRegionConstIterator<ImageType> it(source->GetOutput(), source->GetOutput()->GetBufferedRegion());
+    for(; !it.IsAtEnd(); ++it)
+      if(it.Get() != 2.)
+        {
+        std::cerr << "Test Failed, wrong value " << it.Get() << std::endl;
+        exit(EXIT_FAILURE);
+        }
+    }
+  CheckStatistics(pool, 6, 5, blockBytes);
+  source = NULL;
+  CheckStatistics(pool, 6, 5, 0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 4: FDK mini-pipeline ******" << std::endl;
+  const unsigned int NumberOfProjectionImages = 16;
+  typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
+  GeometryType::Pointer geometry = GeometryType::New();
+  for(unsigned int noProj=0; noProj<NumberOfProjectionImages; noProj++)
+    geometry->AddProjection(600., 1200., noProj*360./NumberOfProjectionImages);
+
+  ConstantImageSourceType::PointType origin;
+  ConstantImageSourceType::SpacingType spacing;
+  ConstantImageSourceType::Pointer projectionsSource = ConstantImageSourceType::New();
+  origin[0] = -254.;
+  origin[1] = -254.;
+  origin[2] = 0.;
+  size[0] = 32;
+  size[1] = 32;
+  size[2] = NumberOfProjectionImages;
+  spacing[0] = 16.;
+  spacing[1] = 16.;
+  spacing[2] = 1.;
+  projectionsSource->SetOrigin( origin );
+  projectionsSource->SetSpacing( spacing );
+  projectionsSource->SetSize( size );
+
+  typedef rtk::SheppLoganPhantomFilter<ImageType, ImageType> SLPType;
+  SLPType::Pointer slp = SLPType::New();
+  slp->SetInput( projectionsSource->GetOutput() );
+  slp->SetGeometry( geometry );
+
+  ConstantImageSourceType::Pointer volumeSource = ConstantImageSourceType::New();
+  origin.Fill(-127.);
+  size.Fill(32);
+  spacing.Fill(8.);
+  volumeSource->SetOrigin( origin );
+  volumeSource->SetSpacing( spacing );
+  volumeSource->SetSize( size );
+
+  typedef rtk::FDKConeBeamReconstructionFilter< ImageType > FDKType;
+  FDKType::Pointer feldkamp = FDKType::New();
+  feldkamp->SetInput( 0, volumeSource->GetOutput() );
+  feldkamp->SetInput( 1, slp->GetOutput() );
+  feldkamp->SetGeometry( geometry );
+  feldkamp->SetProjectionSubsetSize( 2 );
+
+  rtk::ImageBufferPool::Pointer shared = rtk::ImageBufferPool::GetInstance();
+  shared->ResetStatistics();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkamp->Update() );
+  const rtk::ImageBufferPool::Statistics s = shared->GetStatistics();
+  shared->PrintStatistics(std::cout);
+
+  // The 8 subsets have the same size, only the first one allocates
+  if(s.Reuses == 0 || s.Allocations >= s.Reuses)
+    {
+    std::cerr << "Test Failed, the buffers of the subsets are not reused" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -5,8 +5,13 @@
 #include "rtkGeometricPhantomFileReader.h"
 #include "rtkDrawGeometricPhantomImageFilter.h"
 #include "rtkDrawSheppLoganFilter.h"
+#include "rtkDrawCylinderImageFilter.h"
+#include "rtkDrawConeImageFilter.h"
 
 #include <itkRegularExpressionSeriesFileNames.h>
+#include <itkAddImageFilter.h>
+#include <itksys/SystemTools.hxx>
+#include <fstream>
 
 typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
 
@@ -71,6 +76,82 @@ void CheckImageQuality(typename TImage::Pointer recon, typename TImage::Pointer
 }
 #endif
 
+// Reference phantom computed like the former drawing filters, i.e., by
+// evaluating the quadric of each figure at every voxel of input
+template<class TImage>
+typename TImage::Pointer PerVoxelGeometricPhantom(const TImage *input, const std::string &configFile)
+{
+  typedef rtk::ConvertEllipsoidToQuadricParametersFunction EQPFunctionType;
+  rtk::GeometricPhantomFileReader::Pointer cfr = rtk::GeometricPhantomFileReader::New();
+  cfr->Config(configFile);
+  rtk::GeometricPhantomFileReader::VectorOfVectorType figParam = cfr->GetFig();
+
+  typename TImage::Pointer ref = TImage::New();
+  ref->CopyInformation(input);
+  ref->SetRegions(input->GetBufferedRegion());
+  ref->Allocate();
+
+  itk::ImageRegionConstIterator<TImage> itIn(input, input->GetBufferedRegion());
+  itk::ImageRegionIterator<TImage> itRef(ref, ref->GetBufferedRegion());
+  for(; !itRef.IsAtEnd(); ++itIn, ++itRef)
+    itRef.Set( itIn.Get() );
+
+  typename TImage::PointType point;
+  for(unsigned int i=0; i<figParam.size(); i++)
+    {
+    EQPFunctionType::VectorType semiprincipalaxis, center;
+    for(unsigned int j=0; j<3; j++)
+      {
+      semiprincipalaxis[j] = figParam[i][j+1];
+      center[j] = figParam[i][j+4];
+      }
+    EQPFunctionType::Pointer sqpFunctor = EQPFunctionType::New();
+    if(figParam[i][0] == 1)
+      sqpFunctor->SetFigure("Cylinder");
+    else if(figParam[i][0] == 2)
+      sqpFunctor->SetFigure("Cone");
+    else
+      sqpFunctor->SetFigure("Ellipsoid");
+    sqpFunctor->Translate(semiprincipalaxis);
+    sqpFunctor->Rotate(figParam[i][7], center);
+
+    for(itRef.GoToBegin(); !itRef.IsAtEnd(); ++itRef)
+      {
+      ref->TransformIndexToPhysicalPoint(itRef.GetIndex(), point);
+      double q = sqpFunctor->GetA()*point[0]*point[0]   +
+                 sqpFunctor->GetB()*point[1]*point[1]   +
+                 sqpFunctor->GetC()*point[2]*point[2]   +
+                 sqpFunctor->GetD()*point[0]*point[1]   +
+                 sqpFunctor->GetE()*point[0]*point[2]   +
+                 sqpFunctor->GetF()*point[1]*point[2]   +
+                 sqpFunctor->GetG()*point[0] + sqpFunctor->GetH()*point[1] +
+                 sqpFunctor->GetI()*point[2] + sqpFunctor->GetJ();
+      if(q<0)
+        itRef.Set( itRef.Get() + figParam[i][8] );
+      }
+    }
+  return ref;
+}
+
+// Checks that the voxels inside each figure are exactly those found by the
+// per-voxel evaluation, i.e., that no voxel differs by more than rounding
+template<class TImage>
+void CheckSameVoxels(const TImage *test, const TImage *ref)
+{
+  itk::ImageRegionConstIterator<TImage> itTest(test, test->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage> itRef(ref, ref->GetBufferedRegion());
+  unsigned int nDiff = 0;
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    if( vcl_abs(itTest.Get() - itRef.Get()) > 1e-5 )
+      nDiff++;
+  if(nDiff)
+    {
+    std::cerr << "Test Failed, " << nDiff
+              << " voxels differ from the per-voxel evaluation of the quadrics." << std::endl;
+    exit( EXIT_FAILURE);
+    }
+}
+
 /**
  * \file rtkdrawgeometricphantomtest.cxx
  *
@@ -80,7 +161,9 @@ void CheckImageQuality(typename TImage::Pointer recon, typename TImage::Pointer
  * This test generates several phantoms with different geometrical shapes
  * (Cone, Cylinder, Shepp-Logan...) specified by configuration files.
  * The generated results are compared to the expected results, which are
- * created through hard-coded geometric parameters.
+ * created through hard-coded geometric parameters, and to a per-voxel
+ * evaluation of the quadrics for figures whose surfaces go through voxel
+ * centers or are tangent to rows of voxels.
  *
  * \author Marc Vila
  */
@@ -211,5 +294,47 @@ int main(int, char** )
     CheckImageQuality<OutputImageType>(dgp->GetOutput(), addFilter->GetOutput());
     std::cout << "Test PASSED! " << std::endl;
 
+    //////////////////////////////////
+    // Part 3: comparison with a per-voxel evaluation, in place or not
+    //////////////////////////////////
+
+    // Voxel centers have odd coordinates with the 128^3 grid so that even
+    // semi-principal axes and odd centers put voxel centers on the surfaces
+    // and make rows tangent to them
+    std::string configFile("rtkdrawgeometricphantomtest.txt");
+    std::ofstream config(configFile.c_str());
+    config << "[Ellipsoid] A=20 B=40 C=60 x=1 y=1 z=1 beta=0 gray=1" << std::endl;
+    config << "[Ellipsoid] A=30 B=30 C=30 x=-41 y=21 z=-21 beta=0 gray=0.5" << std::endl;
+    config << "[Ellipsoid] A=40 B=20 C=10 x=31 y=-31 z=11 beta=90 gray=-0.25" << std::endl;
+    config << "[Cylinder] A=20 B=0 C=30 x=-31 y=1 z=41 beta=0 gray=2" << std::endl;
+    config << "[Cone] A=10 B=-20 C=10 x=41 y=41 z=-41 beta=0 gray=-0.54" << std::endl;
+    config << "[Box] A=16 B=8 C=24 x=-61 y=-61 z=-61 beta=30 gray=0.75" << std::endl;
+    config.close();
+
+    tomographySource->SetConstant( 1. );
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( tomographySource->Update() );
+    OutputImageType::Pointer ref = PerVoxelGeometricPhantom<OutputImageType>(tomographySource->GetOutput(),
+                                                                             configFile);
+
+    std::cout << "\n\n****** Per-voxel reference, not in place ******" << std::endl;
+    DGPType::Pointer dgpOut = DGPType::New();
+    dgpOut->SetInput( tomographySource->GetOutput() );
+    dgpOut->SetConfigFile( configFile );
+    dgpOut->InPlaceOff();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( dgpOut->Update() );
+    CheckSameVoxels<OutputImageType>(dgpOut->GetOutput(), ref);
+    std::cout << "Test PASSED! " << std::endl;
+
+    std::cout << "\n\n****** Per-voxel reference, in place ******" << std::endl;
+    DGPType::Pointer dgpIn = DGPType::New();
+    dgpIn->SetInput( tomographySource->GetOutput() );
+    dgpIn->SetConfigFile( configFile );
+    dgpIn->InPlaceOn();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( dgpIn->Update() );
+    CheckSameVoxels<OutputImageType>(dgpIn->GetOutput(), ref);
+    std::cout << "Test PASSED! " << std::endl;
+
+    itksys::SystemTools::RemoveFile(configFile.c_str());
+
     return EXIT_SUCCESS;
 }
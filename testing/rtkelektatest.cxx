@@ -1,10 +1,13 @@
 #include "rtkTestConfiguration.h"
 #include "rtkProjectionsReader.h"
+#include "rtkElektaSynergyRawToAttenuationImageFilter.h"
 #include "rtkMacro.h"
 #include "rtkElektaSynergyGeometryReader.h"
 #include "rtkThreeDCircularProjectionGeometryXMLFile.h"
+#include "rtkDbf.h"
 
 #include <itkRegularExpressionSeriesFileNames.h>
+#include <itksys/SystemTools.hxx>
 
 typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
 
@@ -144,6 +147,92 @@ int main(int, char** )
   // 1. Check geometries
   CheckGeometries(geoTargReader->GetGeometry(), geoRefReader->GetOutputObject() );
 
+  // Same with the binary sidecar of a copy of the reference geometry, first
+  // written and then used
+  const std::string geoCopyFileName("rtkelektatest_geometry.xml");
+  const std::string geoSidecarFileName = geoCopyFileName + ".rtkgeo";
+  const std::string geoRefFileName = std::string(RTK_DATA_ROOT) + std::string("/Baseline/Elekta/geometry.xml");
+  itksys::SystemTools::CopyFileAlways( geoRefFileName.c_str(), geoCopyFileName.c_str() );
+  itksys::SystemTools::RemoveFile(geoSidecarFileName.c_str());
+  for(unsigned int i=0; i<2; i++)
+    {
+    std::cout << "\n\n****** Reference geometry with binary sidecar, pass " << i << " ******" << std::endl;
+    rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer geoSidecarReader;
+    geoSidecarReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
+    geoSidecarReader->SetFilename( geoCopyFileName );
+    geoSidecarReader->BinarySidecarOn();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( geoSidecarReader->GenerateOutputInformation() )
+    if( geoSidecarReader->IsLoadedFromSidecar() != (i==1) )
+      {
+      std::cerr << "The binary sidecar has " << ((i==1)?"not ":"")
+                << "been used, pass " << i << std::endl;
+      exit(EXIT_FAILURE);
+      }
+    CheckGeometries(geoSidecarReader->GetOutputObject(), geoRefReader->GetOutputObject() );
+    }
+  itksys::SystemTools::RemoveFile(geoCopyFileName.c_str());
+  itksys::SystemTools::RemoveFile(geoSidecarFileName.c_str());
+
+  // Same with persistent indices, first created and then reused
+  itksys::SystemTools::RemoveFile("rtkelektatest_image.idx");
+  itksys::SystemTools::RemoveFile("rtkelektatest_frame.idx");
+  for(unsigned int i=0; i<2; i++)
+    {
+    std::cout << "\n\n****** Elekta geometry with dbf indices, pass " << i << " ******" << std::endl;
+    geoTargReader = rtk::ElektaSynergyGeometryReader::New();
+    geoTargReader->SetDicomUID("1.3.46.423632.135428.1351013645.166");
+    geoTargReader->SetImageDbfFileName( std::string(RTK_DATA_ROOT) +
+                                        std::string("/Input/Elekta/IMAGE.DBF") );
+    geoTargReader->SetFrameDbfFileName( std::string(RTK_DATA_ROOT) +
+                                        std::string("/Input/Elekta/FRAME.DBF") );
+    geoTargReader->SetImageDbfIndexFileName("rtkelektatest_image.idx");
+    geoTargReader->SetFrameDbfIndexFileName("rtkelektatest_frame.idx");
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( geoTargReader->UpdateOutputData() );
+    CheckGeometries(geoTargReader->GetGeometry(), geoRefReader->GetOutputObject() );
+    }
+
+  // The indices are now loaded from their sidecar files
+  const std::string uid("1.3.46.423632.135428.1351013645.166");
+  rtk::DbfFile dbImage( std::string(RTK_DATA_ROOT) + std::string("/Input/Elekta/IMAGE.DBF") );
+  rtk::DbfFile dbFrame( std::string(RTK_DATA_ROOT) + std::string("/Input/Elekta/FRAME.DBF") );
+  rtk::DbfIndex imageSidecarIndex(dbImage, "DICOM_UID", "rtkelektatest_image.idx");
+  rtk::DbfIndex frameSidecarIndex(dbFrame, "IMA_DBID", "rtkelektatest_frame.idx");
+  if( !imageSidecarIndex.is_valid() || !imageSidecarIndex.IsLoadedFromSidecar() ||
+      !frameSidecarIndex.is_valid() || !frameSidecarIndex.IsLoadedFromSidecar() )
+    {
+    std::cerr << "Dbf indices have not been reused from their sidecar files" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  itksys::SystemTools::RemoveFile("rtkelektatest_image.idx");
+  itksys::SystemTools::RemoveFile("rtkelektatest_frame.idx");
+
+  // Building an index does not move the current record and finds the same
+  // records as a scan of the table
+  const int uidIndex = dbImage.GetFieldIndex("DICOM_UID");
+  if( uidIndex<0 || !dbImage.ReadNextRecord() )
+    {
+    std::cerr << "Could not read the first record of IMAGE.DBF" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  const std::string firstUID = dbImage.GetFieldView(uidIndex).ToString();
+  rtk::DbfIndex imageIndex(dbImage, "DICOM_UID");
+  std::vector<unsigned int> records;
+  imageIndex.Find(uid, records);
+  unsigned int nScanned = (firstUID == uid);
+  if( imageIndex.IsLoadedFromSidecar() || dbImage.GetFieldView(uidIndex).ToString() != firstUID )
+    {
+    std::cerr << "The current record has been changed by the index" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  while( dbImage.ReadNextRecord() )
+    nScanned += (dbImage.GetFieldView(uidIndex) == uid);
+  if( records.empty() || records.size() != nScanned )
+    {
+    std::cerr << "Index finds " << records.size() << " records with DICOM_UID "
+              << uid << " instead of " << nScanned << std::endl;
+    exit(EXIT_FAILURE);
+    }
+
   // ******* COMPARING projections *******
   typedef float OutputPixelType;
   const unsigned int Dimension = 3;
@@ -196,6 +285,44 @@ int main(int, char** )
   // Compare the result of the full lut with the split lut
   CheckImageQuality< ImageType >(full->GetOutput(), log->GetOutput());
 
+  // ******* Test raw lookup table applied while decoding ******
+  std::cout << "\n\n****** Elekta raw lookup table shared by readers ******" << std::endl;
+  ReaderType::Pointer reader2 = ReaderType::New();
+  fileNames.clear();
+  fileNames.push_back( std::string(RTK_DATA_ROOT) +
+                       std::string("/Input/Elekta/raw.his") );
+  reader2->SetFileNames( fileNames );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( reader2->Update() );
+  if( reader->GetRawLookupTable() == NULL ||
+      reader->GetRawLookupTable() != reader2->GetRawLookupTable() ||
+      reader->GetRawLookupTable() != raw->GetLookupTable() )
+    {
+    std::cerr << "The raw lookup table is not shared by the readers and the filter" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+
+  // The projections must be identical to those of the lookup table filters
+  typedef rtk::ElektaSynergyRawToAttenuationImageFilter<InputImageType, ImageType> RawToAttenuationType;
+  RawToAttenuationType::Pointer rawToAttenuation = RawToAttenuationType::New();
+  rawToAttenuation->SetInput(r->GetOutput());
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( rawToAttenuation->Update() );
+  itk::ImageRegionConstIterator<ImageType> itRead(reader2->GetOutput(), reader2->GetOutput()->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> itLUT(rawToAttenuation->GetOutput(), rawToAttenuation->GetOutput()->GetBufferedRegion());
+  if( reader2->GetOutput()->GetBufferedRegion() != rawToAttenuation->GetOutput()->GetBufferedRegion() )
+    {
+    std::cerr << "The projections read with the raw lookup table do not have the expected region" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  for(; !itLUT.IsAtEnd(); ++itRead, ++itLUT)
+    {
+    if( itRead.Get() != itLUT.Get() )
+      {
+      std::cerr << "Projections read with the raw lookup table differ from the lookup table filters: "
+                << itRead.Get() << " instead of " << itLUT.Get() << std::endl;
+      exit(EXIT_FAILURE);
+      }
+    }
+
   // If all succeed
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
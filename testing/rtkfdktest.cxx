@@ -1,11 +1,14 @@
 #include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <itkStreamingImageFilter.h>
+#include <itkCastImageFilter.h>
 
 #include "rtkTestConfiguration.h"
 #include "rtkSheppLoganPhantomFilter.h"
 #include "rtkDrawSheppLoganFilter.h"
 #include "rtkConstantImageSource.h"
 #include "rtkFieldOfViewImageFilter.h"
+#include "rtkHalf.h"
 
 #ifdef USE_CUDA
 #  include "rtkCudaFDKConeBeamReconstructionFilter.h"
@@ -275,5 +278,75 @@ int main(int, char** )
   TRY_AND_EXIT_ON_ITK_EXCEPTION( dsl->UpdateLargestPossibleRegion() )
   CheckImageQuality<OutputImageType>(fov->GetOutput(), dsl->GetOutput());
   std::cout << "Test PASSED! " << std::endl;
+
+#if !defined(USE_CUDA) && !defined(USE_OPENCL)
+  std::cout << "\n\n****** Case 6: half precision projections ******" << std::endl;
+
+  // Keep the single precision reconstruction of the small ROI for comparison
+  OutputImageType::Pointer singleRecon = fov->GetOutput();
+  singleRecon->DisconnectPipeline();
+
+  typedef itk::Image< rtk::Half, Dimension > HalfImageType;
+  typedef itk::CastImageFilter< OutputImageType, HalfImageType > HalfCastType;
+  HalfCastType::Pointer halfCast = HalfCastType::New();
+  halfCast->SetInput( slp->GetOutput() );
+
+  typedef rtk::FDKConeBeamReconstructionFilter< OutputImageType, OutputImageType, double, HalfImageType > HalfFDKType;
+  HalfFDKType::Pointer halfFeldkamp = HalfFDKType::New();
+  halfFeldkamp->SetInput( 0, tomographySource->GetOutput() );
+  halfFeldkamp->SetProjectionStack( halfCast->GetOutput() );
+  halfFeldkamp->SetGeometry( geometry );
+  fov->SetInput( 0, halfFeldkamp->GetOutput() );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( fov->UpdateLargestPossibleRegion() );
+  CheckImageQuality<OutputImageType>(fov->GetOutput(), dsl->GetOutput());
+
+  // Accuracy loss compared to single precision projections
+  itk::ImageRegionConstIterator<OutputImageType> itHalf( fov->GetOutput(), fov->GetOutput()->GetBufferedRegion() );
+  itk::ImageRegionConstIterator<OutputImageType> itSingle( singleRecon, singleRecon->GetBufferedRegion() );
+  double maxDiff = 0.;
+  for(; !itSingle.IsAtEnd(); ++itHalf, ++itSingle)
+    maxDiff = std::max(maxDiff, double(vcl_abs(itHalf.Get()-itSingle.Get())));
+  std::cout << "Max difference with single precision projections = " << maxDiff << std::endl;
+
+  // The conversion to half changes each projection value p by less than
+  // epsilon*|p|. This error is amplified by the gain of FDK, i.e., the maximum
+  // reconstructed value of projections of magnitude 1. The worst case for the
+  // ramp filter are projections alternating between -1 and 1 along the rows.
+  const double halfEpsilon = float(rtk::Half::FromBits(0x3c01)) - 1.f;
+  double maxProjection = 0.;
+  itk::ImageRegionConstIterator<OutputImageType> itProj( slp->GetOutput(), slp->GetOutput()->GetBufferedRegion() );
+  for(; !itProj.IsAtEnd(); ++itProj)
+    maxProjection = std::max(maxProjection, double(vcl_abs(itProj.Get())));
+
+  OutputImageType::Pointer alternating = OutputImageType::New();
+  alternating->CopyInformation( slp->GetOutput() );
+  alternating->SetRegions( slp->GetOutput()->GetLargestPossibleRegion() );
+  alternating->Allocate();
+  itk::ImageRegionIteratorWithIndex<OutputImageType> itAlt( alternating, alternating->GetLargestPossibleRegion() );
+  for(; !itAlt.IsAtEnd(); ++itAlt)
+    itAlt.Set( (itAlt.GetIndex()[0] & 1)? -1.f : 1.f );
+
+  FDKType::Pointer gainFeldkamp = FDKType::New();
+  gainFeldkamp->SetInput( 0, tomographySource->GetOutput() );
+  gainFeldkamp->SetInput( 1, alternating );
+  gainFeldkamp->SetGeometry( geometry );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( gainFeldkamp->Update() );
+  double gain = 0.;
+  itk::ImageRegionConstIterator<OutputImageType> itGain( gainFeldkamp->GetOutput(), gainFeldkamp->GetOutput()->GetBufferedRegion() );
+  for(; !itGain.IsAtEnd(); ++itGain)
+    gain = std::max(gain, double(vcl_abs(itGain.Get())));
+
+  const double tolerance = halfEpsilon * maxProjection * gain;
+  std::cout << "Half precision tolerance = " << halfEpsilon << " * "
+            << maxProjection << " * " << gain << " = " << tolerance << std::endl;
+  if(maxDiff > tolerance)
+    {
+    std::cerr << "Test Failed, half precision projections differ by "
+              << maxDiff << " instead of " << tolerance << "." << std::endl;
+    exit( EXIT_FAILURE);
+    }
+  std::cout << "Test PASSED! " << std::endl;
+#endif
+
   return EXIT_SUCCESS;
 }
@@ -188,7 +188,26 @@ int main(int , char** )
   CheckImageQuality<OutputImageType>(fov->GetOutput(), threshold->GetOutput());
   std::cout << "\n\nTest PASSED! " << std::endl;
 
-  std::cout << "\n\n****** Case 2: offset detector ******" << std::endl;
+  std::cout << "\n\n****** Case 2: backprojection restricted to the field of view ******" << std::endl;
+
+  BPType::Pointer bpFOV = BPType::New();
+  bpFOV->SetInput( 0, bpInput->GetOutput() );
+  bpFOV->SetInput( 1, projectionsSource->GetOutput() );
+  bpFOV->SetGeometry( geometry.GetPointer() );
+  bpFOV->SetFieldOfViewSpanTable( fov->ComputeSpanTable(bpInput->GetOutput()) );
+
+  ThresholdType::Pointer thresholdFOV = ThresholdType::New();
+  thresholdFOV->SetInput(bpFOV->GetOutput());
+  thresholdFOV->SetOutsideValue(0.);
+  thresholdFOV->SetLowerThreshold(NumberOfProjectionImages-0.5);
+  thresholdFOV->SetUpperThreshold(NumberOfProjectionImages+0.5);
+  thresholdFOV->SetInsideValue(1.);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( thresholdFOV->Update() );
+
+  CheckImageQuality<OutputImageType>(fov->GetOutput(), thresholdFOV->GetOutput());
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: offset detector ******" << std::endl;
 
   origin[0] = -54.;
   projectionsSource->SetOrigin( origin );
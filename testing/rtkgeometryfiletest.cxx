@@ -2,12 +2,13 @@
 #include "rtkThreeDCircularProjectionGeometryXMLFile.h"
 #include "rtkMacro.h"
 #include <itksys/SystemTools.hxx>
+#include <fstream>
+#include <cstring>
 
 typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
 
-void WriteReadAndCheck(GeometryType *geometry)
+void WriteReadAndCheck(GeometryType *geometry, const char *fileName="rtkgeometryfiletest.out")
 {
-  const char fileName[] = "rtkgeometryfiletest.out";
   const double epsilon = 1e-13;
 
   rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
@@ -89,6 +90,119 @@ int main(int, char** )
   geometry->AddProjection(578., 68., 9879., -38.4, 2158.4, -158.4, -43.3, 3218.4, 325.4);
   WriteReadAndCheck(geometry);
 
+  // Same in the binary format
+  WriteReadAndCheck(geometry, "rtkgeometryfiletest.rtkgeo");
+
+  // Bulk addition of projections
+  std::vector<double> sids, sdds, angles, projX, projY, outAngles, inAngles, srcX, srcY;
+  for(unsigned int i=0; i<geometry->GetGantryAngles().size(); i++)
+    {
+    sids.push_back(geometry->GetSourceToIsocenterDistances()[i]);
+    sdds.push_back(geometry->GetSourceToDetectorDistances()[i]);
+    angles.push_back(geometry->GetGantryAngles()[i]);
+    projX.push_back(geometry->GetProjectionOffsetsX()[i]);
+    projY.push_back(geometry->GetProjectionOffsetsY()[i]);
+    outAngles.push_back(geometry->GetOutOfPlaneAngles()[i]);
+    inAngles.push_back(geometry->GetInPlaneAngles()[i]);
+    srcX.push_back(geometry->GetSourceOffsetsX()[i]);
+    srcY.push_back(geometry->GetSourceOffsetsY()[i]);
+    }
+  GeometryType::Pointer bulkGeometry = GeometryType::New();
+  bulkGeometry->AddProjections(sids, sdds, angles, projX, projY, outAngles, inAngles, srcX, srcY);
+  for(unsigned int i=0; i<geometry->GetGantryAngles().size(); i++)
+    for(unsigned int j=0; j<3; j++)
+      for(unsigned int k=0; k<4; k++)
+        if( std::abs(bulkGeometry->GetMatrices()[i][j][k] - geometry->GetMatrices()[i][j][k]) > 1e-10 )
+          {
+          std::cerr << "Matrices of AddProjections and AddProjection differ for projection "
+                    << i << std::endl;
+          exit(1);
+          }
+  WriteReadAndCheck(bulkGeometry);
+
+  // Derived quantities updated projection by projection must be equal to
+  // those computed at once
+  GeometryType::Pointer incGeometry = GeometryType::New();
+  for(unsigned int i=0; i<100; i++)
+    {
+    const double angle = (i%10==9)?angles[i%angles.size()]:(i*7.3+(i%3)*100.);
+    incGeometry->AddProjection(615., 548., angle, 1.3, 1.57, 0., 0., 5.42, 7.56);
+    incGeometry->GetAngularGaps();
+    }
+  GeometryType::Pointer refGeometry = GeometryType::New();
+  refGeometry->AddProjections(incGeometry->GetSourceToIsocenterDistances(),
+                              incGeometry->GetSourceToDetectorDistances(),
+                              incGeometry->GetGantryAngles(),
+                              incGeometry->GetProjectionOffsetsX(),
+                              incGeometry->GetProjectionOffsetsY(),
+                              incGeometry->GetOutOfPlaneAngles(),
+                              incGeometry->GetInPlaneAngles(),
+                              incGeometry->GetSourceOffsetsX(),
+                              incGeometry->GetSourceOffsetsY());
+  if( incGeometry->GetSortedAnglesPermutation() != refGeometry->GetSortedAnglesPermutation() ||
+      incGeometry->GetAngularGaps() != refGeometry->GetAngularGaps() ||
+      incGeometry->GetAngularGapsWithNext() != refGeometry->GetAngularGapsWithNext() )
+    {
+    std::cerr << "Angular gaps updated per projection differ from the reference." << std::endl;
+    exit(1);
+    }
+  for(unsigned int i=0; i<refGeometry->GetGantryAngles().size(); i++)
+    for(unsigned int j=0; j<4; j++)
+      if( std::abs(incGeometry->GetSourcePosition(i)[j] - refGeometry->GetSourcePosition(i)[j]) > 1e-10 )
+        {
+        std::cerr << "Source positions updated per projection differ from the reference." << std::endl;
+        exit(1);
+        }
+
+  // XML file with binary sidecar, written at the first read and read at the
+  // second one
+  const char xmlFileName[] = "rtkgeometryfiletest_sidecar.xml";
+  const std::string sidecarFileName = std::string(xmlFileName) + ".rtkgeo";
+  rtk::ThreeDCircularProjectionGeometryXMLFileWriter::Pointer xmlWriter =
+    rtk::ThreeDCircularProjectionGeometryXMLFileWriter::New();
+  xmlWriter->SetFilename(xmlFileName);
+  xmlWriter->SetObject(geometry);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlWriter->WriteFile() )
+  itksys::SystemTools::RemoveFile(sidecarFileName.c_str());
+  for(unsigned int i=0; i<2; i++)
+    {
+    rtk::ThreeDCircularProjectionGeometryXMLFileReader::Pointer xmlReader;
+    xmlReader = rtk::ThreeDCircularProjectionGeometryXMLFileReader::New();
+    xmlReader->SetFilename(xmlFileName);
+    xmlReader->BinarySidecarOn();
+    TRY_AND_EXIT_ON_ITK_EXCEPTION( xmlReader->GenerateOutputInformation() )
+    if( !itksys::SystemTools::FileExists(sidecarFileName.c_str()) ||
+        xmlReader->GetOutputObject()->GetGantryAngles() != geometry->GetGantryAngles() )
+      {
+      std::cerr << "Geometry read with binary sidecar differs, pass " << i << std::endl;
+      exit(1);
+      }
+    if( xmlReader->IsLoadedFromSidecar() != (i==1) )
+      {
+      std::cerr << "The binary sidecar has " << ((i==1)?"not ":"")
+                << "been used, pass " << i << std::endl;
+      exit(1);
+      }
+    }
+
+  // The first parameter of the sidecar, the SID 615 of the first projection,
+  // is stored in little-endian byte order after the 64 bytes header
+  const unsigned char sid615[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x83, 0x40};
+  std::ifstream sidecar(sidecarFileName.c_str(), std::ios_base::in | std::ios_base::binary);
+  char sidecarHeader[64], sidecarSID[8];
+  sidecar.read(sidecarHeader, 64);
+  sidecar.read(sidecarSID, 8);
+  if( sidecar.fail() ||
+      std::string(sidecarHeader, 9) != "RTKGEO 2 " ||
+      memcmp(sidecarSID, sid615, 8) != 0 )
+    {
+    std::cerr << "Unexpected header or byte order in the binary sidecar." << std::endl;
+    exit(1);
+    }
+  sidecar.close();
+  itksys::SystemTools::RemoveFile(xmlFileName);
+  itksys::SystemTools::RemoveFile(sidecarFileName.c_str());
+
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
 }
@@ -12,26 +12,37 @@
 #include "rtkElektaSynergyLookupTableImageFilter.h"
 #include "rtkElektaSynergyRawToAttenuationImageFilter.h"
 #include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkFDKBackProjectionKernel.h"
 #include "rtkFDKConeBeamReconstructionFilter.h"
 #include "rtkFDKWeightProjectionFilter.h"
 #include "rtkFFTRampImageFilter.h"
+#include "rtkFastLog.h"
 #include "rtkFieldOfViewImageFilter.h"
+#include "rtkFieldOfViewSpanTable.h"
 #include "rtkForwardProjectionImageFilter.h"
 #include "rtkGeometricPhantomFileReader.h"
 #include "rtkGgoFunctions.h"
 #include "rtkHisImageIO.h"
 #include "rtkHisImageIOFactory.h"
+#include "rtkHalf.h"
 #include "rtkHndImageIO.h"
 #include "rtkHndImageIOFactory.h"
 #include "rtkHomogeneousMatrix.h"
+#include "rtkImageBufferPool.h"
 #include "rtkJosephBackProjectionImageFilter.h"
 #include "rtkJosephForwardProjectionImageFilter.h"
 #include "rtkLookupTableImageFilter.h"
 #include "rtkMacro.h"
+#include "rtkMemoryMappedFile.h"
+#include "rtkMemoryMappedProjectionsReader.h"
 #include "rtkParkerShortScanImageFilter.h"
+#include "rtkPhilox.h"
 #include "rtkProjectGeometricPhantomImageFilter.h"
 #include "rtkProjectionGeometry.h"
+#include "rtkProjectionsCacheImageIO.h"
+#include "rtkProjectionsCacheImageIOFactory.h"
 #include "rtkProjectionsReader.h"
+#include "rtkQuadricScanlineFunction.h"
 #include "rtkRayBoxIntersectionFunction.h"
 #include "rtkRayBoxIntersectionImageFilter.h"
 #include "rtkRayCastInterpolateImageFunction.h"
@@ -42,10 +53,13 @@
 #include "rtkSARTConeBeamReconstructionFilter.h"
 #include "rtkConvertEllipsoidToQuadricParametersFunction.h"
 #include "rtkSheppLoganPhantomFilter.h"
+#include "rtkTelemetry.h"
+#include "rtkThreadAffinity.h"
 #include "rtkThreeDCircularProjectionGeometry.h"
 #include "rtkThreeDCircularProjectionGeometryXMLFile.h"
 #include "rtkTiffLookupTableImageFilter.h"
 #include "rtkVarianObiRawImageFilter.h"
+#include "rtkWorkStealingScheduler.h"
 #include "rtkXRadGeometryReader.h"
 
 //#ifdef USE_OPENCL
@@ -1,4 +1,6 @@
 #include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkLinearInterpolateImageFunction.h>
 #include <itkPasteImageFilter.h>
 #include <itksys/SystemTools.hxx>
 
@@ -68,6 +70,152 @@ void CheckImageQuality(typename TImage::Pointer recon, typename TImage::Pointer
 }
 #endif
 
+typedef itk::Vector<float,3>      DVFPixelType;
+typedef itk::Image< DVFPixelType, 3 > DVFImageType;
+
+/** Deformation which only provides SetFrame and the 3D DVF of the frame,
+ * i.e., without ComputeFrameInterpolation, to test the corresponding
+ * implementation of FDKWarpBackProjectionImageFilter. */
+class FrameDeformation : public itk::ImageSource<DVFImageType>
+{
+public:
+  typedef FrameDeformation                                  Self;
+  typedef itk::ImageSource<DVFImageType>                    Superclass;
+  typedef itk::SmartPointer<Self>                           Pointer;
+  typedef rtk::CyclicDeformationImageFilter< DVFImageType > CyclicType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(FrameDeformation, itk::ImageSource);
+
+  CyclicType * GetCyclicDeformation() { return m_Cyclic.GetPointer(); }
+
+  void SetFrame(const unsigned int frame)
+    {
+    m_Cyclic->SetFrame(frame);
+    this->Modified();
+    }
+
+protected:
+  FrameDeformation(): m_Cyclic( CyclicType::New() ) {}
+
+  virtual void GenerateOutputInformation()
+    {
+    m_Cyclic->UpdateOutputInformation();
+    this->GetOutput()->CopyInformation( m_Cyclic->GetOutput() );
+    }
+
+  virtual void GenerateData()
+    {
+    m_Cyclic->Update();
+    this->GraftOutput( m_Cyclic->GetOutput() );
+    }
+
+private:
+  CyclicType::Pointer m_Cyclic;
+};
+
+/** Warped backprojection as computed before the 4D DVF was interpolated on
+ * the fly: for each projection, the deformation is updated with the frame
+ * number and each voxel is warped and backprojected with
+ * itk::LinearInterpolateImageFunction. Returns the number of samples in the
+ * half pixel border of the detector. */
+template <class TImage, class TDeformation>
+unsigned int ReferenceWarpBackProjection(TImage *volume, const TImage *projections,
+                                         rtk::ThreeDCircularProjectionGeometry *geometry,
+                                         TDeformation *deformation)
+{
+  typedef itk::Image<typename TImage::PixelType, 2>                                      ProjectionType;
+  typedef itk::LinearInterpolateImageFunction< ProjectionType, double >                    InterpolatorType;
+  typedef itk::LinearInterpolateImageFunction< typename TDeformation::OutputImageType, double > WarpInterpolatorType;
+  typename InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  typename WarpInterpolatorType::Pointer warpInterpolator = WarpInterpolatorType::New();
+
+  const typename TImage::RegionType stack = projections->GetLargestPossibleRegion();
+  typename ProjectionType::SizeType pSize;
+  typename ProjectionType::PointType pOrigin;
+  typename ProjectionType::SpacingType pSpacing;
+  for(unsigned int i=0; i<2; i++)
+    {
+    pSize[i] = stack.GetSize(i);
+    pOrigin[i] = projections->GetOrigin()[i];
+    pSpacing[i] = projections->GetSpacing()[i];
+    }
+
+  unsigned int nBorder = 0;
+  for(unsigned int iProj=0; iProj<stack.GetSize(2); iProj++)
+    {
+    deformation->SetFrame(iProj);
+    deformation->Update();
+    warpInterpolator->SetInputImage( deformation->GetOutput() );
+
+    // Projection iProj as a 2D image
+    typename ProjectionType::Pointer projection = ProjectionType::New();
+    projection->SetRegions( pSize );
+    projection->SetOrigin( pOrigin );
+    projection->SetSpacing( pSpacing );
+    projection->Allocate();
+    itk::ImageRegionIteratorWithIndex<ProjectionType> itProj( projection, projection->GetLargestPossibleRegion() );
+    typename TImage::IndexType stackIndex;
+    stackIndex[2] = iProj;
+    for(itProj.GoToBegin(); !itProj.IsAtEnd(); ++itProj)
+      {
+      stackIndex[0] = itProj.GetIndex()[0];
+      stackIndex[1] = itProj.GetIndex()[1];
+      itProj.Set( projections->GetPixel(stackIndex) );
+      }
+    interpolator->SetInputImage( projection );
+
+    const rtk::ThreeDCircularProjectionGeometry::MatrixType &matrix = geometry->GetMatrices()[iProj];
+    itk::ImageRegionIteratorWithIndex<TImage> it( volume, volume->GetLargestPossibleRegion() );
+    for(it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+      typename TImage::PointType point;
+      volume->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+      if( warpInterpolator->IsInsideBuffer(point) )
+        point = point + warpInterpolator->Evaluate(point);
+
+      double h[3];
+      for(unsigned int r=0; r<3; r++)
+        h[r] = matrix[r][0] * point[0] + matrix[r][1] * point[1] + matrix[r][2] * point[2] + matrix[r][3];
+      typename ProjectionType::PointType pointProj;
+      pointProj[0] = h[0] / h[2];
+      pointProj[1] = h[1] / h[2];
+      itk::ContinuousIndex<double, 2> index;
+      projection->TransformPhysicalPointToContinuousIndex(pointProj, index);
+      if( interpolator->IsInsideBuffer(index) )
+        {
+        // Weight normalized to 1 at the isocenter
+        const double weight = matrix[2][3] / h[2];
+        it.Set( it.Get() + weight * weight * interpolator->EvaluateAtContinuousIndex(index) );
+        if(index[0]<0. || index[1]<0. || index[0]>=pSize[0]-1. || index[1]>=pSize[1]-1.)
+          nBorder++;
+        }
+      }
+    }
+  return nBorder;
+}
+
+template<class TImage>
+void CheckWarpBackProjection(TImage *bp, TImage *ref)
+{
+  itk::ImageRegionConstIterator<TImage> itTest( bp, bp->GetBufferedRegion() );
+  itk::ImageRegionConstIterator<TImage> itRef( ref, ref->GetBufferedRegion() );
+  double maxRef = 0.;
+  double maxDiff = 0.;
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    {
+    maxRef = std::max(maxRef, double(vcl_abs(itRef.Get())));
+    maxDiff = std::max(maxDiff, double(vcl_abs(itRef.Get() - itTest.Get())));
+    }
+  std::cout << "Maximum difference = " << maxDiff << " for a maximum of " << maxRef << std::endl;
+  if(maxRef == 0. || maxDiff > 1e-5 * maxRef)
+    {
+    std::cerr << "Test Failed, the warped backprojection differs from the reference by "
+              << maxDiff << " instead of less than " << 1e-5 * maxRef << std::endl;
+    exit( EXIT_FAILURE);
+    }
+}
+
 /**
  * \file rtkmotioncompensatedfdktest.cxx
  *
@@ -78,6 +226,8 @@ void CheckImageQuality(typename TImage::Pointer recon, typename TImage::Pointer
  * ellipsoids (one of them moving). The resulting moving phantom is
  * reconstructed using motion compensation techniques and these generated
  * results are compared to the expected results (analytical computation).
+ * The warped backprojection is also compared to the per voxel warp of the 3D
+ * DVF of each projection, with a volume projecting beyond the detector.
  *
  * \author Simon Rit and Marc Vila
  */
@@ -219,8 +369,6 @@ int main(int, char** )
     }
 
   // Create vector field
-  typedef itk::Vector<float,3>                                                 DVFPixelType;
-  typedef itk::Image< DVFPixelType, 3 >                                        DVFImageType;
   typedef rtk::CyclicDeformationImageFilter< DVFImageType >                    DeformationType;
   typedef itk::ImageRegionIteratorWithIndex< DeformationType::InputImageType > IteratorType;
 
@@ -328,7 +476,176 @@ int main(int, char** )
 
   std::cout << "Test PASSED! " << std::endl;
 
+  std::cout << "\n\n****** Warp backprojection compared to the per voxel warp ******" << std::endl;
+
+  // Volume projecting beyond the detector
+  const unsigned int nWarpProj = 8;
+  ConstantImageSourceType::Pointer warpVolumeSource = ConstantImageSourceType::New();
+  origin.Fill(-92.);
+  size.Fill(24);
+  spacing.Fill(8.);
+  warpVolumeSource->SetOrigin( origin );
+  warpVolumeSource->SetSpacing( spacing );
+  warpVolumeSource->SetSize( size );
+  warpVolumeSource->SetConstant( 0. );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( warpVolumeSource->Update() );
+
+  // Projections with varying values
+  OutputImageType::Pointer warpProjections = OutputImageType::New();
+  OutputImageType::SizeType warpProjSize;
+  warpProjSize[0] = 16;
+  warpProjSize[1] = 16;
+  warpProjSize[2] = nWarpProj;
+  origin.Fill(-60.);
+  warpProjections->SetRegions( warpProjSize );
+  warpProjections->SetOrigin( origin );
+  warpProjections->SetSpacing( spacing );
+  warpProjections->Allocate();
+  itk::ImageRegionIteratorWithIndex<OutputImageType> itWarpProj( warpProjections, warpProjections->GetLargestPossibleRegion() );
+  for(itWarpProj.GoToBegin(); !itWarpProj.IsAtEnd(); ++itWarpProj)
+    {
+    OutputImageType::IndexType idx = itWarpProj.GetIndex();
+    itWarpProj.Set( 1 + (idx[0] + 3*idx[1] + 5*idx[2]) % 7 );
+    }
+
+  GeometryType::Pointer warpGeometry = GeometryType::New();
+  std::ofstream warpSignalFile("warpsignal.txt");
+  for(unsigned int noProj=0; noProj<nWarpProj; noProj++)
+    {
+    warpGeometry->AddProjection(600., 1200., noProj*360./nWarpProj, 3., -2., 5., 10.);
+    warpSignalFile << noProj / double(nWarpProj) << std::endl;
+    }
+  warpSignalFile.close();
+
+  // 4D DVF on a coarse grid covering part of the volume. The values, the
+  // phases and the positions of the voxels in the DVF grid are exact in
+  // float so that both warps only differ by rounding errors.
+  DeformationType::InputImageType::Pointer coarseField = DeformationType::InputImageType::New();
+  sizeMotion.Fill(12);
+  sizeMotion[3] = 2;
+  regionMotion.SetSize( sizeMotion );
+  coarseField->SetRegions( regionMotion );
+  originMotion.Fill(-80.);
+  originMotion[3] = 0.;
+  coarseField->SetOrigin( originMotion );
+  DeformationType::InputImageType::SpacingType spacingMotion;
+  spacingMotion.Fill(16.);
+  spacingMotion[3] = 1.;
+  coarseField->SetSpacing( spacingMotion );
+  coarseField->Allocate();
+  IteratorType coarseIt( coarseField, coarseField->GetLargestPossibleRegion() );
+  for ( coarseIt.GoToBegin(); !coarseIt.IsAtEnd(); ++coarseIt)
+    {
+    DeformationType::InputImageType::IndexType idx = coarseIt.GetIndex();
+    const double sign = (idx[3]==0)?-1.:1.;
+    vec[0] = sign * (0.25 * ((idx[0] + 2*idx[1] + 3*idx[2]) % 8) + 1.);
+    vec[1] = 0.5 * ((idx[0] * idx[1]) % 4);
+    vec[2] = sign * 0.125 * (idx[2] % 5);
+    coarseIt.Set(vec);
+    }
+
+  // Reference
+  DeformationType::Pointer refDef = DeformationType::New();
+  refDef->SetInput( coarseField );
+  refDef->SetSignalFilename( "warpsignal.txt" );
+  OutputImageType::Pointer refWarpBP = OutputImageType::New();
+  refWarpBP->CopyInformation( warpVolumeSource->GetOutput() );
+  refWarpBP->SetRegions( warpVolumeSource->GetOutput()->GetLargestPossibleRegion() );
+  refWarpBP->Allocate();
+  refWarpBP->FillBuffer( 0. );
+  unsigned int nBorder = 0;
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( nBorder = ReferenceWarpBackProjection(refWarpBP.GetPointer(),
+                                                                       warpProjections.GetPointer(),
+                                                                       warpGeometry.GetPointer(),
+                                                                       refDef.GetPointer()) );
+  std::cout << nBorder << " samples in the half pixel border of the detector" << std::endl;
+  if(nBorder == 0)
+    {
+    std::cerr << "Test Failed, the detector border is not tested" << std::endl;
+    exit( EXIT_FAILURE);
+    }
+
+  // 4D DVF interpolated on the fly with ComputeFrameInterpolation
+  DeformationType::Pointer warpDef = DeformationType::New();
+  warpDef->SetInput( coarseField );
+  warpDef->SetSignalFilename( "warpsignal.txt" );
+  WarpBPType::Pointer warpBP = WarpBPType::New();
+  warpBP->SetInput( 0, warpVolumeSource->GetOutput() );
+  warpBP->SetInput( 1, warpProjections );
+  warpBP->SetGeometry( warpGeometry.GetPointer() );
+  warpBP->SetDeformation( warpDef );
+  warpBP->InPlaceOff();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( warpBP->Update() );
+  CheckWarpBackProjection<OutputImageType>( warpBP->GetOutput(), refWarpBP );
+
+  // 3D DVF updated for each projection by a deformation without
+  // ComputeFrameInterpolation
+  FrameDeformation::Pointer frameDef = FrameDeformation::New();
+  frameDef->GetCyclicDeformation()->SetInput( coarseField );
+  frameDef->GetCyclicDeformation()->SetSignalFilename( "warpsignal.txt" );
+  typedef rtk::FDKWarpBackProjectionImageFilter<OutputImageType, OutputImageType, FrameDeformation> FrameWarpBPType;
+  FrameWarpBPType::Pointer frameWarpBP = FrameWarpBPType::New();
+  frameWarpBP->SetInput( 0, warpVolumeSource->GetOutput() );
+  frameWarpBP->SetInput( 1, warpProjections );
+  frameWarpBP->SetGeometry( warpGeometry.GetPointer() );
+  frameWarpBP->SetDeformation( frameDef );
+  frameWarpBP->InPlaceOff();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( frameWarpBP->Update() );
+  CheckWarpBackProjection<OutputImageType>( frameWarpBP->GetOutput(), refWarpBP );
+
+  std::cout << "Test PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Coarse DVF compared to the full resolution DVF ******" << std::endl;
+
+  // DVF with the spacing of the volume obtained by trilinear interpolation of
+  // the coarse DVF, i.e., both describe the same deformation. The values are
+  // exact in float so the warped backprojections must be equal up to rounding
+  // errors, i.e., within 1e-5 times the maximum of the backprojection.
+  DeformationType::InputImageType::Pointer fineField = DeformationType::InputImageType::New();
+  DeformationType::InputImageType::SizeType fineSize = sizeMotion;
+  DeformationType::InputImageType::SpacingType fineSpacing = spacingMotion;
+  for(unsigned int i=0; i<3; i++)
+    {
+    fineSize[i] = 2*sizeMotion[i]-1;
+    fineSpacing[i] = 0.5*spacingMotion[i];
+    }
+  regionMotion.SetSize( fineSize );
+  fineField->SetRegions( regionMotion );
+  fineField->SetOrigin( originMotion );
+  fineField->SetSpacing( fineSpacing );
+  fineField->Allocate();
+  IteratorType fineIt( fineField, fineField->GetLargestPossibleRegion() );
+  for ( fineIt.GoToBegin(); !fineIt.IsAtEnd(); ++fineIt)
+    {
+    DeformationType::InputImageType::IndexType idx = fineIt.GetIndex();
+    DeformationType::InputImageType::IndexType coarseIdx = idx;
+    vec.Fill(0.);
+    for(unsigned int c=0; c<8; c++)
+      {
+      for(unsigned int i=0; i<3; i++)
+        coarseIdx[i] = (idx[i] + ((c>>i)&1)) / 2;
+      for(unsigned int i=0; i<3; i++)
+        vec[i] += 0.125 * coarseField->GetPixel(coarseIdx)[i];
+      }
+    fineIt.Set(vec);
+    }
+
+  DeformationType::Pointer fineDef = DeformationType::New();
+  fineDef->SetInput( fineField );
+  fineDef->SetSignalFilename( "warpsignal.txt" );
+  WarpBPType::Pointer fineWarpBP = WarpBPType::New();
+  fineWarpBP->SetInput( 0, warpVolumeSource->GetOutput() );
+  fineWarpBP->SetInput( 1, warpProjections );
+  fineWarpBP->SetGeometry( warpGeometry.GetPointer() );
+  fineWarpBP->SetDeformation( fineDef );
+  fineWarpBP->InPlaceOff();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( fineWarpBP->Update() );
+  CheckWarpBackProjection<OutputImageType>( warpBP->GetOutput(), fineWarpBP->GetOutput() );
+
+  std::cout << "Test PASSED! " << std::endl;
+
   itksys::SystemTools::RemoveFile("signal.txt");
+  itksys::SystemTools::RemoveFile("warpsignal.txt");
 
   return EXIT_SUCCESS;
 }
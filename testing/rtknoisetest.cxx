@@ -0,0 +1,149 @@
+#include <itkImageRegionConstIterator.h>
+#include <itkStreamingImageFilter.h>
+
+#include "rtkTestConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkConstantImageSource.h"
+#include "rtkAdditiveGaussianNoiseImageFilter.h"
+#include "rtkPhilox.h"
+
+typedef itk::Image<float, 3>                              ImageType;
+typedef rtk::AdditiveGaussianNoiseImageFilter<ImageType> NoiseType;
+
+void CheckIdentical(ImageType *test, ImageType *ref)
+{
+  itk::ImageRegionConstIterator<ImageType> itTest(test, ref->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> itRef(ref, ref->GetBufferedRegion());
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    {
+    if(itTest.Get() != itRef.Get())
+      {
+      std::cerr << "Test Failed, noise differs at " << itRef.GetIndex() << std::endl;
+      exit(EXIT_FAILURE);
+      }
+    }
+}
+
+/** Known answer of Philox4x32-10 from the Random123 distribution */
+void CheckPhilox(const uint32_t counter[4], const uint32_t key[2], const uint32_t expected[4])
+{
+  uint32_t out[4];
+  rtk::Philox4x32::Generate(counter, key, out);
+  for(unsigned int i=0; i<4; i++)
+    {
+    if(out[i] != expected[i])
+      {
+      std::cerr << "Test Failed, Philox4x32-10 word " << i << " is " << std::hex
+                << out[i] << " instead of " << expected[i] << std::endl;
+      exit(EXIT_FAILURE);
+      }
+    }
+}
+
+void CheckStatistics(ImageType *noisy, const double mean, const double variance)
+{
+  double sum = 0.;
+  double sum2 = 0.;
+  itk::ImageRegionConstIterator<ImageType> it(noisy, noisy->GetBufferedRegion());
+  for(; !it.IsAtEnd(); ++it)
+    {
+    sum += it.Get();
+    sum2 += it.Get() * it.Get();
+    }
+  const double n = noisy->GetBufferedRegion().GetNumberOfPixels();
+  const double m = sum / n;
+  const double v = sum2 / n - m * m;
+  std::cout << "Mean = " << m << " (expected " << mean << "), variance = "
+            << v << " (expected " << variance << ")" << std::endl;
+  if( vcl_abs(m - mean) > 5. * vcl_sqrt(variance / n) ||
+      vcl_abs(v - variance) > 0.05 * variance )
+    {
+    std::cerr << "Test Failed, wrong noise statistics" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+void CheckReproducibility(NoiseType *noisy)
+{
+  // Reference with a single thread
+  noisy->SetNumberOfThreads(1);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( noisy->UpdateLargestPossibleRegion() )
+  ImageType::Pointer ref = noisy->GetOutput();
+  ref->DisconnectPipeline();
+
+  // Default number of threads
+  noisy->SetNumberOfThreads( itk::MultiThreader::GetGlobalDefaultNumberOfThreads() );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( noisy->UpdateLargestPossibleRegion() )
+  CheckIdentical(noisy->GetOutput(), ref);
+
+  // Streamed, i.e., other requested regions
+  typedef itk::StreamingImageFilter<ImageType, ImageType> StreamingType;
+  StreamingType::Pointer streamer = StreamingType::New();
+  streamer->SetInput( noisy->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(7);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( streamer->Update() )
+  CheckIdentical(streamer->GetOutput(), ref);
+}
+
+/**
+ * \file rtknoisetest.cxx
+ *
+ * \brief Functional test for the noise generation
+ *
+ * This test checks the random number generator against known answers, then
+ * adds Gaussian and Poisson noise to a constant image and checks that the
+ * output does not depend on the number of threads or on the requested region
+ * and that the noise statistics are the expected ones.
+ *
+ * \author Simon Rit
+ */
+
+int main(int, char** )
+{
+  std::cout << "\n\n****** Case 0: Philox4x32-10 known answers ******" << std::endl;
+  const uint32_t counter0[4] = {0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u};
+  const uint32_t key0[2]     = {0x00000000u, 0x00000000u};
+  const uint32_t kat0[4]     = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+  CheckPhilox(counter0, key0, kat0);
+  const uint32_t counter1[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+  const uint32_t key1[2]     = {0xffffffffu, 0xffffffffu};
+  const uint32_t kat1[4]     = {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu};
+  CheckPhilox(counter1, key1, kat1);
+  const uint32_t counter2[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+  const uint32_t key2[2]     = {0xa4093822u, 0x299f31d0u};
+  const uint32_t kat2[4]     = {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u};
+  CheckPhilox(counter2, key2, kat2);
+  std::cout << "Test PASSED! " << std::endl;
+
+  typedef rtk::ConstantImageSource< ImageType > ConstantImageSourceType;
+  ConstantImageSourceType::SizeType size;
+  size[0] = 97;
+  size[1] = 64;
+  size[2] = 32;
+  ConstantImageSourceType::Pointer source = ConstantImageSourceType::New();
+  source->SetSize( size );
+  source->SetConstant( 2. );
+
+  std::cout << "\n\n****** Case 1: Gaussian noise ******" << std::endl;
+  NoiseType::Pointer noisy = NoiseType::New();
+  noisy->SetInput( source->GetOutput() );
+  noisy->SetMean( 1. );
+  noisy->SetStandardDeviation( 0.5 );
+  noisy->SetOutputMinimum( itk::NumericTraits<float>::NonpositiveMin() );
+  CheckReproducibility(noisy);
+  CheckStatistics(noisy->GetOutput(), 3., 0.25);
+  std::cout << "Test PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 2: Poisson noise ******" << std::endl;
+  // Line integrals of 2 with 1e4 incident photons, i.e., about 1353 detected
+  // photons. At first order, the line integral has a bias of 1/(2*1353) and
+  // a variance of 1/1353.
+  const double I0 = 1e4;
+  const double lambda = I0 * vcl_exp(-2.);
+  noisy->SetNumberOfIncidentPhotons( I0 );
+  CheckReproducibility(noisy);
+  CheckStatistics(noisy->GetOutput(), 2. + 0.5 / lambda, 1. / lambda );
+  std::cout << "Test PASSED! " << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,140 @@
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itksys/SystemTools.hxx>
+
+#include "rtkTestConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkConstantImageSource.h"
+#include "rtkSheppLoganPhantomFilter.h"
+#include "rtkProjectionsReader.h"
+#include "rtkProjectionsCacheImageIO.h"
+
+typedef itk::Image<float, 3> ImageType;
+
+void WriteReadAndCheck(ImageType *projections, const bool halfPrecision, const double tolerance)
+{
+  const char fileName[] = "rtkprojectionscachetest.rtkproj";
+  const std::string geometryXML("<?xml version=\"1.0\"?>\n<!DOCTYPE RTKGEOMETRY>\n<RTKThreeDCircularGeometry/>\n");
+
+  // Write the cache in several streamed pieces
+  rtk::ProjectionsCacheImageIO::Pointer io = rtk::ProjectionsCacheImageIO::New();
+  io->SetUseHalfPrecision(halfPrecision);
+  io->SetGeometryXML(geometryXML);
+  typedef itk::ImageFileWriter<ImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetImageIO(io);
+  writer->SetInput(projections);
+  writer->SetNumberOfStreamDivisions(3);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( writer->Update() )
+
+  // Header and embedded geometry
+  rtk::ProjectionsCacheImageIO::Pointer ioRead = rtk::ProjectionsCacheImageIO::New();
+  if( !ioRead->CanReadFile(fileName) )
+    {
+    std::cerr << "Test Failed, cannot read back the projections cache" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  ioRead->SetFileName(fileName);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( ioRead->ReadImageInformation() )
+  if( ioRead->GetGeometryXML() != geometryXML ||
+      ioRead->GetUseHalfPrecision() != halfPrecision ||
+      ioRead->GetRowPitch() % rtk::ProjectionsCacheImageIO::RowAlignment ||
+      ioRead->GetDataOffset() % rtk::ProjectionsCacheImageIO::DataAlignment )
+    {
+    std::cerr << "Test Failed, wrong projections cache header" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+
+  // Read a sub-region through the projections reader
+  typedef rtk::ProjectionsReader<ImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  ReaderType::FileNamesContainer fileNames;
+  fileNames.push_back(fileName);
+  reader->SetFileNames( fileNames );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->UpdateOutputInformation() )
+  ImageType::RegionType region = reader->GetOutput()->GetLargestPossibleRegion();
+  if( region != projections->GetLargestPossibleRegion() ||
+      reader->GetOutput()->GetSpacing() != projections->GetSpacing() ||
+      reader->GetOutput()->GetOrigin() != projections->GetOrigin() )
+    {
+    std::cerr << "Test Failed, wrong projections cache information" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  region.SetIndex(0, 3);
+  region.SetSize(0, region.GetSize(0)-7);
+  region.SetIndex(1, 2);
+  region.SetSize(1, region.GetSize(1)-4);
+  region.SetIndex(2, 1);
+  region.SetSize(2, region.GetSize(2)-2);
+  reader->GetOutput()->SetRequestedRegion(region);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( reader->Update() )
+
+  itk::ImageRegionConstIterator<ImageType> itTest(reader->GetOutput(), region);
+  itk::ImageRegionConstIterator<ImageType> itRef(projections, region);
+  double maxError = 0.;
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    maxError = std::max(maxError, double(vcl_abs(itTest.Get()-itRef.Get())));
+  std::cout << (halfPrecision?"Half":"Single") << " precision max error = " << maxError << std::endl;
+  if(maxError > tolerance)
+    {
+    std::cerr << "Test Failed, error " << maxError << " above " << tolerance << std::endl;
+    exit(EXIT_FAILURE);
+    }
+
+  itksys::SystemTools::RemoveFile(fileName);
+}
+
+/**
+ * \file rtkprojectionscachetest.cxx
+ *
+ * \brief Functional test for the projections cache written by rtkprojections
+ *
+ * This test writes the projections of a simulated Shepp-Logan phantom in a
+ * projections cache in single and half precision, reads back a sub-region
+ * with the projections reader and compares the result to the projections.
+ *
+ * \author Simon Rit
+ */
+
+int main(int, char** )
+{
+  // Rows are not a multiple of the row alignment to check the padding
+  typedef rtk::ConstantImageSource< ImageType > ConstantImageSourceType;
+  ConstantImageSourceType::PointType origin;
+  ConstantImageSourceType::SizeType size;
+  ConstantImageSourceType::SpacingType spacing;
+  ConstantImageSourceType::Pointer projectionsSource = ConstantImageSourceType::New();
+  origin[0] = -254.;
+  origin[1] = -200.;
+  origin[2] = 0.;
+  size[0] = 61;
+  size[1] = 50;
+  size[2] = 8;
+  spacing[0] = 8.;
+  spacing[1] = 8.;
+  spacing[2] = 1.;
+  projectionsSource->SetOrigin( origin );
+  projectionsSource->SetSpacing( spacing );
+  projectionsSource->SetSize( size );
+  projectionsSource->SetConstant( 0. );
+
+  typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
+  GeometryType::Pointer geometry = GeometryType::New();
+  for(unsigned int noProj=0; noProj<size[2]; noProj++)
+    geometry->AddProjection(600., 1200., noProj*360./size[2]);
+
+  typedef rtk::SheppLoganPhantomFilter<ImageType, ImageType> SLPType;
+  SLPType::Pointer slp=SLPType::New();
+  slp->SetInput( projectionsSource->GetOutput() );
+  slp->SetGeometry(geometry);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( slp->Update() );
+
+  // Single precision is exact, half precision has 11 significant bits and
+  // the Shepp-Logan line integrals are below 512
+  WriteReadAndCheck(slp->GetOutput(), false, 0.);
+  WriteReadAndCheck(slp->GetOutput(), true, 0.25);
+
+  std::cout << "\n\nTest PASSED! " << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -100,6 +100,35 @@ void CheckImageQuality(typename TImage::Pointer recon,
 }
 #endif
 
+template<class TImage>
+#if FAST_TESTS_NO_CHECKS
+void CheckSameImages(typename TImage::Pointer itkNotUsed(recon), typename TImage::Pointer itkNotUsed(ref))
+{
+}
+#else
+void CheckSameImages(typename TImage::Pointer recon, typename TImage::Pointer ref)
+{
+  typedef itk::ImageRegionConstIterator<TImage> ImageIteratorType;
+  ImageIteratorType itTest( recon, recon->GetBufferedRegion() );
+  ImageIteratorType itRef( ref, ref->GetBufferedRegion() );
+
+  double maxDiff = 0.;
+  double maxRef = 0.;
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    {
+    maxDiff = std::max(maxDiff, double(vcl_abs(itTest.Get() - itRef.Get())));
+    maxRef = std::max(maxRef, double(vcl_abs(itRef.Get())));
+    }
+  std::cout << "Max difference with a new filter = " << maxDiff << std::endl;
+  if (maxDiff > 1e-5 * maxRef)
+  {
+    std::cerr << "Test Failed, the reconstruction differs by " << maxDiff
+              << " from the one of a new filter instead of " << 1e-5 * maxRef << std::endl;
+    exit( EXIT_FAILURE);
+  }
+}
+#endif
+
 /**
  * \file rtkrampfiltertest.cxx
  *
@@ -247,6 +276,55 @@ int main(int , char** )
 
   CheckImageQuality<OutputImageType>(feldkampCropped->GetOutput(), dsl->GetOutput(), 1.015, 1.025, 26, 0.05);
 
+  std::cout << "\n\n****** Test 3: update of the ramp kernel ******" << std::endl;
+
+  // The kernel is reused as long as the ramp filter and its input do not change
+  const itk::DataObject *kernel = feldkampCropped->GetRampFilter()->GetRampKernel();
+  feldkampCropped->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkampCropped->Update() );
+  if( feldkampCropped->GetRampFilter()->GetRampKernel() != kernel )
+    {
+    std::cerr << "Test Failed, the ramp kernel has been recomputed without change." << std::endl;
+    exit( EXIT_FAILURE);
+    }
+
+  // Changing the truncation correction recomputes the kernel
+  feldkampCropped->GetRampFilter()->SetTruncationCorrection(0.2);
+  feldkampCropped->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkampCropped->Update() );
+  if( feldkampCropped->GetRampFilter()->GetRampKernel() == kernel )
+    {
+    std::cerr << "Test Failed, the ramp kernel has not been recomputed after a change of the truncation correction." << std::endl;
+    exit( EXIT_FAILURE);
+    }
+  kernel = feldkampCropped->GetRampFilter()->GetRampKernel();
+
+  FDKType::Pointer feldkampReference = FDKType::New();
+  feldkampReference->SetInput( 0, tomographySource->GetOutput() );
+  feldkampReference->SetInput( 1, slp->GetOutput() );
+  feldkampReference->SetGeometry( geometry );
+  feldkampReference->GetRampFilter()->SetTruncationCorrection(0.2);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkampReference->Update() );
+  CheckSameImages<OutputImageType>(feldkampCropped->GetOutput(), feldkampReference->GetOutput());
+
+  // Changing the spacing of the projections recomputes the kernel
+  spacing[0] *= 1.1;
+  projectionsSource->SetSpacing( spacing );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkampCropped->Update() );
+  if( feldkampCropped->GetRampFilter()->GetRampKernel() == kernel )
+    {
+    std::cerr << "Test Failed, the ramp kernel has not been recomputed after a change of the projection spacing." << std::endl;
+    exit( EXIT_FAILURE);
+    }
+
+  feldkampReference = FDKType::New();
+  feldkampReference->SetInput( 0, tomographySource->GetOutput() );
+  feldkampReference->SetInput( 1, slp->GetOutput() );
+  feldkampReference->SetGeometry( geometry );
+  feldkampReference->GetRampFilter()->SetTruncationCorrection(0.2);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( feldkampReference->Update() );
+  CheckSameImages<OutputImageType>(feldkampCropped->GetOutput(), feldkampReference->GetOutput());
+
   std::cout << "\n\nTest PASSED! " << std::endl;
   return EXIT_SUCCESS;
 }
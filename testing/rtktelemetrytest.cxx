@@ -0,0 +1,320 @@
+#include <sstream>
+#include <cstring>
+#include <cctype>
+
+#include "rtkTestConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkTelemetry.h"
+#include "rtkConstantImageSource.h"
+#include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkThreeDCircularProjectionGeometry.h"
+
+typedef itk::Image<float, 3> ImageType;
+
+/** Minimal recursive descent parser of the JSON grammar (RFC 4627) which
+ * returns false at the first syntax error. */
+class JSONChecker
+{
+public:
+  JSONChecker(const std::string &s): m_String(s), m_Pos(0) {}
+
+  bool Check()
+    {
+    return Value() && (SkipSpaces(), m_Pos == m_String.size());
+    }
+
+private:
+  void SkipSpaces()
+    {
+    while(m_Pos<m_String.size() && strchr(" \t\r\n", m_String[m_Pos]))
+      m_Pos++;
+    }
+  bool Accept(const char c)
+    {
+    SkipSpaces();
+    if(m_Pos<m_String.size() && m_String[m_Pos]==c)
+      {
+      m_Pos++;
+      return true;
+      }
+    return false;
+    }
+  bool Digits()
+    {
+    const size_t begin = m_Pos;
+    while(m_Pos<m_String.size() && isdigit(m_String[m_Pos]))
+      m_Pos++;
+    return m_Pos>begin;
+    }
+  bool Literal(const char *word)
+    {
+    if(m_String.compare(m_Pos, strlen(word), word) != 0)
+      return false;
+    m_Pos += strlen(word);
+    return true;
+    }
+  bool String()
+    {
+    if(!Accept('"'))
+      return false;
+    while(m_Pos<m_String.size() && m_String[m_Pos]!='"')
+      {
+      if((unsigned char)m_String[m_Pos] < 0x20)
+        return false;
+      if(m_String[m_Pos]=='\\')
+        {
+        m_Pos++;
+        if(m_Pos>=m_String.size() || !strchr("\"\\/bfnrtu", m_String[m_Pos]))
+          return false;
+        }
+      m_Pos++;
+      }
+    return Accept('"');
+    }
+  bool Number()
+    {
+    SkipSpaces();
+    if(m_Pos<m_String.size() && m_String[m_Pos]=='-')
+      m_Pos++;
+    if(!Digits())
+      return false;
+    if(m_Pos<m_String.size() && m_String[m_Pos]=='.')
+      {
+      m_Pos++;
+      if(!Digits())
+        return false;
+      }
+    if(m_Pos<m_String.size() && (m_String[m_Pos]=='e' || m_String[m_Pos]=='E'))
+      {
+      m_Pos++;
+      if(m_Pos<m_String.size() && (m_String[m_Pos]=='+' || m_String[m_Pos]=='-'))
+        m_Pos++;
+      if(!Digits())
+        return false;
+      }
+    return true;
+    }
+  bool Value()
+    {
+    SkipSpaces();
+    if(m_Pos>=m_String.size())
+      return false;
+    switch(m_String[m_Pos])
+      {
+      case '{':
+        Accept('{');
+        if(Accept('}'))
+          return true;
+        do
+          {
+          if(!String() || !Accept(':') || !Value())
+            return false;
+          }
+        while(Accept(','));
+        return Accept('}');
+      case '[':
+        Accept('[');
+        if(Accept(']'))
+          return true;
+        do
+          {
+          if(!Value())
+            return false;
+          }
+        while(Accept(','));
+        return Accept(']');
+      case '"':
+        return String();
+      case 't':
+        return Literal("true");
+      case 'f':
+        return Literal("false");
+      case 'n':
+        return Literal("null");
+      default:
+        return Number();
+      }
+    }
+
+  const std::string &m_String;
+  size_t             m_Pos;
+};
+
+void CheckEvent(const rtk::Telemetry::StageEvent &e, const std::string &stage,
+                const unsigned int depth, const double work)
+{
+  std::cout << e.stage << " (" << e.className << "): depth " << e.depth
+            << ", " << e.work << ' ' << rtk::Telemetry::GetWorkUnit(e.workType)
+            << ", " << e.wallTime << " s" << std::endl;
+  if(e.stage != stage || e.depth != depth || e.work != work || e.wallTime < 0.)
+    {
+    std::cerr << "Test Failed, expected stage " << stage << " at depth " << depth
+              << " with work " << work << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+void CheckNumberOfEvents(const rtk::Telemetry *telemetry, const unsigned int n)
+{
+  if(telemetry->GetEvents().size() != n)
+    {
+    std::cerr << "Test Failed, " << telemetry->GetEvents().size()
+              << " events recorded instead of " << n << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * \file rtktelemetrytest.cxx
+ *
+ * \brief Functional test for the telemetry of the pipelines
+ *
+ * This test checks the events recorded by rtk::Telemetry for nested stages
+ * and for a backprojection pipeline, the work in voxel updates of the
+ * backprojection, the syntax of the JSON export and that nothing is recorded
+ * when the telemetry is disabled.
+ *
+ * \author Simon Rit
+ */
+
+int main(int, char** )
+{
+  std::cout << "\n\n****** Case 1: nested stages ******" << std::endl;
+  rtk::Telemetry::Pointer telemetry = rtk::Telemetry::New();
+  telemetry->StartStage("outer");
+  telemetry->StartStage("inner");
+  telemetry->StopStage(8., 2.);
+  telemetry->StopStage();
+  CheckNumberOfEvents(telemetry, 2);
+  CheckEvent(telemetry->GetEvents()[0], "inner", 1, 2.);
+  CheckEvent(telemetry->GetEvents()[1], "outer", 0, 0.);
+  if(telemetry->GetEvents()[0].bytes != 8.)
+    {
+    std::cerr << "Test Failed, wrong number of bytes of stage inner" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  bool exceptionCaught = false;
+  try
+    {
+    telemetry->StopStage();
+    }
+  catch(itk::ExceptionObject &)
+    {
+    exceptionCaught = true;
+    }
+  if(!exceptionCaught)
+    {
+    std::cerr << "Test Failed, StopStage without StartStage did not throw" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  // Backprojection of 8 projections in a 16^3 volume
+  const unsigned int NumberOfProjectionImages = 8;
+  typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
+  GeometryType::Pointer geometry = GeometryType::New();
+  for(unsigned int noProj=0; noProj<NumberOfProjectionImages; noProj++)
+    geometry->AddProjection(600., 1200., noProj*360./NumberOfProjectionImages);
+
+  typedef rtk::ConstantImageSource< ImageType > ConstantImageSourceType;
+  ConstantImageSourceType::PointType origin;
+  ConstantImageSourceType::SizeType size;
+  ConstantImageSourceType::SpacingType spacing;
+
+  ConstantImageSourceType::Pointer volumeSource = ConstantImageSourceType::New();
+  origin.Fill(-30.);
+  size.Fill(16);
+  spacing.Fill(4.);
+  volumeSource->SetOrigin( origin );
+  volumeSource->SetSpacing( spacing );
+  volumeSource->SetSize( size );
+  volumeSource->SetConstant( 0. );
+
+  ConstantImageSourceType::Pointer projectionsSource = ConstantImageSourceType::New();
+  origin[0] = -62.;
+  origin[1] = -62.;
+  origin[2] = 0.;
+  size[0] = 32;
+  size[1] = 32;
+  size[2] = NumberOfProjectionImages;
+  projectionsSource->SetOrigin( origin );
+  projectionsSource->SetSpacing( spacing );
+  projectionsSource->SetSize( size );
+  projectionsSource->SetConstant( 1. );
+
+  typedef rtk::FDKBackProjectionImageFilter<ImageType, ImageType> BPType;
+  BPType::Pointer bp = BPType::New();
+  bp->SetInput( 0, volumeSource->GetOutput() );
+  bp->SetInput( 1, projectionsSource->GetOutput() );
+  bp->SetGeometry( geometry );
+  bp->InPlaceOff();
+
+  std::cout << "\n\n****** Case 2: backprojection pipeline ******" << std::endl;
+  telemetry = rtk::Telemetry::New();
+  telemetry->Watch(volumeSource.GetPointer(), "volume");
+  telemetry->Watch(projectionsSource.GetPointer(), "projections");
+  telemetry->Watch(bp.GetPointer(), "backprojection", rtk::Telemetry::VOXEL_UPDATES);
+  telemetry->Watch(bp.GetPointer(), "ignored");
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( bp->Update() );
+  CheckNumberOfEvents(telemetry, 3);
+  CheckEvent(telemetry->GetEvents()[2], "backprojection", 0, 16.*16.*16.*NumberOfProjectionImages);
+  for(unsigned int i=0; i<2; i++)
+    {
+    const rtk::Telemetry::StageEvent &e = telemetry->GetEvents()[i];
+    if(e.stage == "volume")
+      CheckEvent(e, "volume", 0, 16.*16.*16.);
+    else
+      CheckEvent(e, "projections", 0, 32.*32.*NumberOfProjectionImages);
+    }
+
+  // A second execution nested in a stage
+  telemetry->StartStage("update");
+  bp->Modified();
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( bp->Update() );
+  telemetry->StopStage();
+  CheckNumberOfEvents(telemetry, 5);
+  CheckEvent(telemetry->GetEvents()[3], "backprojection", 1, 16.*16.*16.*NumberOfProjectionImages);
+  CheckEvent(telemetry->GetEvents()[4], "update", 0, 0.);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: JSON export ******" << std::endl;
+  std::ostringstream json;
+  telemetry->WriteJSON(json);
+  const std::string jsonString = json.str();
+  unsigned int nTraceEvents = 0;
+  for(size_t pos = jsonString.find("\"ph\": \"X\""); pos != std::string::npos;
+      pos = jsonString.find("\"ph\": \"X\"", pos+1))
+    nTraceEvents++;
+  if( !JSONChecker(jsonString).Check() ||
+      nTraceEvents != telemetry->GetEvents().size() ||
+      jsonString.find("\"voxel updates\"") == std::string::npos )
+    {
+    std::cerr << "Test Failed, invalid JSON export:\n" << jsonString << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  telemetry->PrintTiming(std::cout);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 4: disabled telemetry ******" << std::endl;
+  BPType::Pointer bp2 = BPType::New();
+  bp2->SetInput( 0, volumeSource->GetOutput() );
+  bp2->SetInput( 1, projectionsSource->GetOutput() );
+  bp2->SetGeometry( geometry );
+  telemetry = rtk::Telemetry::New();
+  telemetry->SetEnabled(false);
+  telemetry->Watch(bp2.GetPointer(), "backprojection", rtk::Telemetry::VOXEL_UPDATES);
+  telemetry->StartStage("stage");
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( bp2->Update() );
+  telemetry->StopStage();
+  CheckNumberOfEvents(telemetry, 0);
+  std::ostringstream emptyJSON;
+  telemetry->WriteJSON(emptyJSON);
+  if( !JSONChecker(emptyJSON.str()).Check() )
+    {
+    std::cerr << "Test Failed, invalid JSON export:\n" << emptyJSON.str() << std::endl;
+    exit(EXIT_FAILURE);
+    }
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  return EXIT_SUCCESS;
+}
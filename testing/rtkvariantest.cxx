@@ -53,11 +53,12 @@ void CheckImageQuality(typename TImage::Pointer recon, typename TImage::Pointer
   ErrorType QI = (255.0-ErrorPerPixel)/255.0;
   std::cout << "QI = " << QI << std::endl;
 
-  // Checking results
-  if (ErrorPerPixel > 1e-8)
+  // Checking results. The conversion to attenuation is computed in single
+  // precision, see rtkfastlogtest.cxx.
+  if (ErrorPerPixel > 1e-7)
     {
     std::cerr << "Test Failed, Error per pixel not valid! "
-              << ErrorPerPixel << " instead of 1e-8" << std::endl;
+              << ErrorPerPixel << " instead of 1e-7" << std::endl;
     exit( EXIT_FAILURE);
     }
   if (PSNR < 100.)
@@ -0,0 +1,245 @@
+#include <itkImageRegionConstIterator.h>
+#include <vector>
+
+#include "rtkTestConfiguration.h"
+#include "rtkMacro.h"
+#include "rtkWorkStealingScheduler.h"
+#include "rtkThreadAffinity.h"
+#include "rtkConstantImageSource.h"
+#include "rtkSheppLoganPhantomFilter.h"
+#include "rtkDrawSheppLoganFilter.h"
+#include "rtkFFTRampImageFilter.h"
+#include "rtkFDKBackProjectionImageFilter.h"
+#include "rtkJosephForwardProjectionImageFilter.h"
+
+typedef itk::Image<float, 3> ImageType;
+
+/** Counts how many times each tile is processed, with a cost increasing with
+ * the tile number to force steals. */
+class CountingTileProcessor : public rtk::WorkStealingScheduler::TileProcessor
+{
+public:
+  CountingTileProcessor(const unsigned int n) : m_Counts(n, 0), m_Sink(n, 0.) {}
+  virtual void ProcessTile(const unsigned int tile, const ThreadIdType itkNotUsed(threadId))
+    {
+    m_Counts[tile]++;
+    for(unsigned int i=0; i<100*tile; i++)
+      m_Sink[tile] += vcl_sqrt(double(i));
+    }
+  std::vector<unsigned int> m_Counts;
+  std::vector<double>       m_Sink;
+};
+
+void CheckScheduler(const unsigned int numberOfTiles, const unsigned int numberOfThreads)
+{
+  CountingTileProcessor processor(numberOfTiles);
+  rtk::WorkStealingScheduler::Pointer scheduler = rtk::WorkStealingScheduler::New();
+  scheduler->Execute(&processor, numberOfTiles, numberOfThreads);
+  for(unsigned int i=0; i<numberOfTiles; i++)
+    if(processor.m_Counts[i] != 1)
+      {
+      std::cerr << "Test Failed, tile " << i << " of " << numberOfTiles << " processed "
+                << processor.m_Counts[i] << " times with " << numberOfThreads << " threads" << std::endl;
+      exit(EXIT_FAILURE);
+      }
+  std::cout << numberOfTiles << " tiles, " << numberOfThreads << " threads, "
+            << scheduler->GetNumberOfSteals() << " steals" << std::endl;
+}
+
+void CheckSplit(const ImageType::RegionType &region, const unsigned int numberOfTiles,
+                const unsigned int lowestSplitDimension)
+{
+  std::vector<ImageType::RegionType> tiles;
+  tiles = rtk::WorkStealingScheduler::SplitRegion(region, numberOfTiles, lowestSplitDimension);
+  itk::SizeValueType nPixels = 0;
+  for(unsigned int i=0; i<tiles.size(); i++)
+    {
+    nPixels += tiles[i].GetNumberOfPixels();
+    if( !region.IsInside(tiles[i]) || tiles[i].GetNumberOfPixels()==0 )
+      {
+      std::cerr << "Test Failed, tile " << tiles[i] << " is not in " << region << std::endl;
+      exit(EXIT_FAILURE);
+      }
+    for(unsigned int d=0; d<lowestSplitDimension; d++)
+      if(tiles[i].GetSize(d) != region.GetSize(d))
+        {
+        std::cerr << "Test Failed, tile split along dimension " << d << std::endl;
+        exit(EXIT_FAILURE);
+        }
+    }
+  if(nPixels != region.GetNumberOfPixels())
+    {
+    std::cerr << "Test Failed, the tiles do not cover the region" << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+void CheckSameImages(ImageType *test, ImageType *ref, const double tolerance)
+{
+  itk::ImageRegionConstIterator<ImageType> itTest(test, ref->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> itRef(ref, ref->GetBufferedRegion());
+  double maxError = 0.;
+  for(; !itRef.IsAtEnd(); ++itTest, ++itRef)
+    maxError = std::max(maxError, double(vcl_abs(itTest.Get()-itRef.Get())));
+  std::cout << "Max difference with the static split = " << maxError << std::endl;
+  if(maxError > tolerance)
+    {
+    std::cerr << "Test Failed, difference " << maxError << " above " << tolerance << std::endl;
+    exit(EXIT_FAILURE);
+    }
+}
+
+/** Update filter with the static split and with tiles and compare outputs */
+template<class TFilter>
+void CheckTiledFilter(TFilter *filter, const double tolerance)
+{
+  filter->SetNumberOfThreads(4);
+  filter->SetTilesPerThread(0);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( filter->Update() );
+  ImageType::Pointer ref = filter->GetOutput();
+  ref->DisconnectPipeline();
+
+  filter->SetTilesPerThread(8);
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( filter->Update() );
+  CheckSameImages(filter->GetOutput(), ref, tolerance);
+}
+
+/**
+ * \file rtkworkstealingtest.cxx
+ *
+ * \brief Functional test for the work stealing scheduler of the projectors
+ *
+ * This test checks that rtk::WorkStealingScheduler processes each tile once
+ * and that its tiles cover the region. The FDK backprojection, the Joseph
+ * forward projection, the ramp filter and the constant image source are then
+ * compared with and without tiles, and with pinned threads.
+ *
+ * \author Simon Rit
+ */
+
+int main(int, char** )
+{
+  std::cout << "\n\n****** Case 1: scheduler ******" << std::endl;
+  CheckScheduler(0, 4);
+  CheckScheduler(1, 4);
+  CheckScheduler(3, 8);
+  CheckScheduler(100, 1);
+  CheckScheduler(1000, 7);
+
+  ImageType::RegionType region;
+  region.SetIndex(0, -3);
+  region.SetIndex(1, 2);
+  region.SetIndex(2, 5);
+  region.SetSize(0, 17);
+  region.SetSize(1, 11);
+  region.SetSize(2, 3);
+  CheckSplit(region, 1, 0);
+  CheckSplit(region, 2, 0);
+  CheckSplit(region, 64, 0);
+  CheckSplit(region, 64, 1);
+  CheckSplit(region, 64, 2);
+  CheckSplit(region, 10000, 0);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  // Geometry, volume and projections
+  const unsigned int NumberOfProjectionImages = 24;
+  typedef rtk::ThreeDCircularProjectionGeometry GeometryType;
+  GeometryType::Pointer geometry = GeometryType::New();
+  for(unsigned int noProj=0; noProj<NumberOfProjectionImages; noProj++)
+    geometry->AddProjection(600., 1200., noProj*360./NumberOfProjectionImages + 0.123);
+
+  typedef rtk::ConstantImageSource< ImageType > ConstantImageSourceType;
+  ConstantImageSourceType::PointType origin;
+  ConstantImageSourceType::SizeType size;
+  ConstantImageSourceType::SpacingType spacing;
+
+  ConstantImageSourceType::Pointer volumeSource = ConstantImageSourceType::New();
+  origin.Fill(-127.);
+  size.Fill(64);
+  spacing.Fill(4.);
+  volumeSource->SetOrigin( origin );
+  volumeSource->SetSpacing( spacing );
+  volumeSource->SetSize( size );
+  volumeSource->SetConstant( 0. );
+
+  typedef rtk::DrawSheppLoganFilter<ImageType, ImageType> DSLType;
+  DSLType::Pointer dsl = DSLType::New();
+  dsl->SetInput( volumeSource->GetOutput() );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( dsl->Update() );
+
+  ConstantImageSourceType::Pointer projectionsSource = ConstantImageSourceType::New();
+  origin[0] = -254.;
+  origin[1] = -254.;
+  origin[2] = 0.;
+  size[0] = 64;
+  size[1] = 64;
+  size[2] = NumberOfProjectionImages;
+  spacing[0] = 8.;
+  spacing[1] = 8.;
+  spacing[2] = 1.;
+  projectionsSource->SetOrigin( origin );
+  projectionsSource->SetSpacing( spacing );
+  projectionsSource->SetSize( size );
+  projectionsSource->SetConstant( 0. );
+
+  typedef rtk::SheppLoganPhantomFilter<ImageType, ImageType> SLPType;
+  SLPType::Pointer slp = SLPType::New();
+  slp->SetInput( projectionsSource->GetOutput() );
+  slp->SetGeometry( geometry );
+  TRY_AND_EXIT_ON_ITK_EXCEPTION( slp->Update() );
+
+  // Each voxel and each pixel is computed by the same code with and without
+  // tiles, the results are identical
+  std::cout << "\n\n****** Case 2: FDK backprojection ******" << std::endl;
+  typedef rtk::FDKBackProjectionImageFilter<ImageType, ImageType> BPType;
+  BPType::Pointer bp = BPType::New();
+  bp->SetInput( 0, volumeSource->GetOutput() );
+  bp->SetInput( 1, slp->GetOutput() );
+  bp->SetGeometry( geometry );
+  bp->InPlaceOff();
+  CheckTiledFilter(bp.GetPointer(), 0.);
+  // Copy of the projections above the limit, static split
+  bp->SetProjectionsCacheMaximumBytes(1024);
+  CheckTiledFilter(bp.GetPointer(), 0.);
+  bp->SetProjectionsCacheMaximumBytes(size_t(1)<<30);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  std::cout << "\n\n****** Case 3: Joseph forward projection ******" << std::endl;
+  typedef rtk::JosephForwardProjectionImageFilter<ImageType, ImageType> FPType;
+  FPType::Pointer fp = FPType::New();
+  fp->SetInput( 0, projectionsSource->GetOutput() );
+  fp->SetInput( 1, dsl->GetOutput() );
+  fp->SetGeometry( geometry );
+  fp->InPlaceOff();
+  CheckTiledFilter(fp.GetPointer(), 0.);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  // The FFT sizes depend on the tiles, up to rounding errors
+  std::cout << "\n\n****** Case 4: ramp filter ******" << std::endl;
+  typedef rtk::FFTRampImageFilter<ImageType, ImageType, double> RampType;
+  RampType::Pointer ramp = RampType::New();
+  ramp->SetInput( slp->GetOutput() );
+  CheckTiledFilter(ramp.GetPointer(), 1e-4);
+  ramp->SetHannCutFrequencyY(0.8);
+  CheckTiledFilter(ramp.GetPointer(), 1e-4);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  // Per node replicas of the projections and first touch of the volume by
+  // the tiles of the backprojection, which do not change the values. The
+  // output of the source is disconnected by the check, it is done last.
+  std::cout << "\n\n****** Case 5: pinned threads ******" << std::endl;
+  std::cout << rtk::ThreadAffinity::GetNumberOfNodes() << " NUMA node(s)" << std::endl;
+  rtk::ThreadAffinity::SetPolicy(rtk::ThreadAffinity::COMPACT);
+  CheckTiledFilter(bp.GetPointer(), 0.);
+  rtk::ThreadAffinity::SetReplicateReadOnlyData(true);
+  rtk::ThreadAffinity::SetPolicy(rtk::ThreadAffinity::SPREAD);
+  CheckTiledFilter(bp.GetPointer(), 0.);
+  rtk::ThreadAffinity::SetReplicateReadOnlyData(false);
+  volumeSource->SetConstant( 1. );
+  CheckTiledFilter(volumeSource.GetPointer(), 0.);
+  rtk::ThreadAffinity::SetPolicy(rtk::ThreadAffinity::NONE);
+  CheckTiledFilter(volumeSource.GetPointer(), 0.);
+  std::cout << "\n\nTest PASSED! " << std::endl;
+
+  return EXIT_SUCCESS;
+}